@@ -1,7 +1,9 @@
 #include <filesystem>
+#include <optional>
 
 #include <glog/logging.h>
 #include <wavemap/core/common.h>
+#include <wavemap/core/map/hashed_chunked_wavelet_octree.h>
 #include <wavemap/core/map/hashed_wavelet_octree.h>
 #include <wavemap/core/map/map_base.h>
 #include <wavemap/core/utils/sdf/quasi_euclidean_sdf_generator.h>
@@ -28,15 +30,9 @@ int main(int argc, char** argv) {
   io::fileToMap(map_file_path, occupancy_map);
   CHECK_NOTNULL(occupancy_map);
 
-  // Currently, only hashed wavelet octree maps are supported as input
-  const auto hashed_map =
-      std::dynamic_pointer_cast<HashedWaveletOctree>(occupancy_map);
-  if (!hashed_map) {
-    LOG(ERROR)
-        << "Only hashed wavelet octree occupancy maps are currently supported.";
-  }
-
   // Generate the ESDF
+  // NOTE: Currently, only hashed (chunked) wavelet octree maps are supported
+  //       as input.
   const std::filesystem::path esdf_file_path =
       std::filesystem::path(map_file_path).replace_extension(".sdf.wvmp");
   LOG(INFO) << "Generating ESDF";
@@ -44,11 +40,25 @@ int main(int argc, char** argv) {
   constexpr FloatingPoint kMaxDistance = 10.f;
   const QuasiEuclideanSDFGenerator sdf_generator{kMaxDistance,
                                                  kOccupancyThreshold};
-  const auto esdf = sdf_generator.generate(*hashed_map);
+  std::optional<HashedBlocks> esdf;
+  if (const auto hashed_map =
+          std::dynamic_pointer_cast<HashedWaveletOctree>(occupancy_map);
+      hashed_map) {
+    esdf.emplace(sdf_generator.generate(*hashed_map));
+  } else if (const auto hashed_chunked_map =
+                 std::dynamic_pointer_cast<HashedChunkedWaveletOctree>(
+                     occupancy_map);
+             hashed_chunked_map) {
+    esdf.emplace(sdf_generator.generate(*hashed_chunked_map));
+  } else {
+    LOG(ERROR) << "Only hashed wavelet octree and hashed chunked wavelet "
+                  "octree occupancy maps are currently supported.";
+    return EXIT_FAILURE;
+  }
 
   // Save the ESDF
   LOG(INFO) << "Saving ESDF to path: " << esdf_file_path;
-  if (!io::mapToFile(esdf, esdf_file_path)) {
+  if (!io::mapToFile(*esdf, esdf_file_path)) {
     LOG(ERROR) << "Could not save ESDF";
     return EXIT_FAILURE;
   }
@@ -25,7 +25,8 @@ namespace wavemap {
 /**
  * Config struct for wavemap's ROS server.
  */
-struct RosServerConfig : ConfigBase<RosServerConfig, 4, RosLoggingLevel> {
+struct RosServerConfig
+    : ConfigBase<RosServerConfig, 6, RosLoggingLevel, PipelineAsyncConfig> {
   //! Name of the coordinate frame in which to store the map.
   //! Will be used as the frame_id for ROS TF lookups.
   std::string world_frame = "odom";
@@ -37,6 +38,13 @@ struct RosServerConfig : ConfigBase<RosServerConfig, 4, RosLoggingLevel> {
       std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
   //! Whether or not to allow resetting the map through the reset_map service.
   bool allow_reset_map_service = false;
+  //! Whether to integrate the measurements on a dedicated thread, such that
+  //! the inputs can prepare the next measurement while the map is being
+  //! updated.
+  bool run_pipeline_async = false;
+  //! Properties of the queue of measurements waiting to be integrated when
+  //! run_pipeline_async is enabled.
+  PipelineAsyncConfig pipeline_async_queue;
 
   static MemberMap memberMap;
 
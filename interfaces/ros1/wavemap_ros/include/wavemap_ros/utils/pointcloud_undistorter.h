@@ -9,6 +9,7 @@
 
 #include <wavemap/core/common.h>
 #include <wavemap/core/data_structure/pointcloud.h>
+#include <wavemap/core/utils/thread_pool.h>
 #include <wavemap/core/utils/undistortion/stamped_pointcloud.h>
 
 #include "wavemap_ros/utils/tf_transformer.h"
@@ -23,11 +24,14 @@ class PointcloudUndistorter {
     kSuccess
   };
 
-  explicit PointcloudUndistorter(std::shared_ptr<TfTransformer> transformer,
-                                 int num_interpolation_intervals_per_cloud)
+  explicit PointcloudUndistorter(
+      std::shared_ptr<TfTransformer> transformer,
+      int num_interpolation_intervals_per_cloud,
+      std::shared_ptr<ThreadPool> thread_pool = nullptr)
       : transformer_(std::move(transformer)),
         num_interpolation_intervals_per_cloud_(
-            num_interpolation_intervals_per_cloud) {}
+            num_interpolation_intervals_per_cloud),
+        thread_pool_(std::move(thread_pool)) {}
 
   Result undistortPointcloud(
       undistortion::StampedPointcloud& stamped_pointcloud,
@@ -37,6 +41,9 @@ class PointcloudUndistorter {
  private:
   std::shared_ptr<TfTransformer> transformer_;
   const int num_interpolation_intervals_per_cloud_;
+  // NOTE: Large pointclouds are undistorted in parallel if a thread pool is
+  //       provided, and serially otherwise.
+  const std::shared_ptr<ThreadPool> thread_pool_;
 };
 }  // namespace wavemap
 
@@ -112,14 +112,26 @@ void DepthImageTopicInput::processQueue() {
                      << print::eigen::oneLine(posed_depth_image.getDimensions())
                      << " points. Remaining pointclouds in queue: "
                      << depth_image_queue_.size() - 1 << ".");
-    integration_timer_.start();
-    pipeline_->runPipeline(config_.measurement_integrator_names,
-                           posed_depth_image);
-    integration_timer_.stop();
-    ROS_DEBUG_STREAM("Integrated new depth image in "
-                     << integration_timer_.getLastEpisodeDuration()
-                     << "s. Total integration time: "
-                     << integration_timer_.getTotalDuration() << "s.");
+    if (pipeline_->isAsync()) {
+      // Queue the depth image, such that the next one can be prepared while
+      // this one updates the map
+      pipeline_->runPipelineAsync(config_.measurement_integrator_names,
+                                  posed_depth_image);
+      const auto stats = pipeline_->getAsyncStats();
+      ROS_DEBUG_STREAM("Queued new depth image. Measurements in queue: "
+                       << stats.queue_depth << ", dropped so far: "
+                       << stats.num_dropped << ", mean latency: "
+                       << stats.mean_latency << "s.");
+    } else {
+      integration_timer_.start();
+      pipeline_->runPipeline(config_.measurement_integrator_names,
+                             posed_depth_image);
+      integration_timer_.stop();
+      ROS_DEBUG_STREAM("Integrated new depth image in "
+                       << integration_timer_.getLastEpisodeDuration()
+                       << "s. Total integration time: "
+                       << integration_timer_.getTotalDuration() << "s.");
+    }
 
     // Publish debugging visualizations
     publishProjectedPointcloudIfEnabled(stamp, posed_depth_image);
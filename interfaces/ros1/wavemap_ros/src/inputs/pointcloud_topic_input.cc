@@ -55,7 +55,8 @@ PointcloudTopicInput::PointcloudTopicInput(
       config_(config.checkValid()),
       pointcloud_undistorter_(
           transformer,
-          config_.num_undistortion_interpolation_intervals_per_cloud) {
+          config_.num_undistortion_interpolation_intervals_per_cloud,
+          pipeline_->getThreadPool()) {
   // Subscribe to the pointcloud input
   registerCallback(config_.topic_type, [this, &nh](auto callback_ptr) {
     pointcloud_sub_ = nh.subscribe(
@@ -259,14 +260,26 @@ void PointcloudTopicInput::processQueue() {
                      << posed_pointcloud.size()
                      << " points. Remaining pointclouds in queue: "
                      << pointcloud_queue_.size() - 1 << ".");
-    integration_timer_.start();
-    pipeline_->runPipeline(config_.measurement_integrator_names,
-                           posed_pointcloud);
-    integration_timer_.stop();
-    ROS_DEBUG_STREAM("Integrated new pointcloud in "
-                     << integration_timer_.getLastEpisodeDuration()
-                     << "s. Total integration time: "
-                     << integration_timer_.getTotalDuration() << "s.");
+    if (pipeline_->isAsync()) {
+      // Queue the pointcloud, such that the next one can be prepared while
+      // this one updates the map
+      pipeline_->runPipelineAsync(config_.measurement_integrator_names,
+                                  posed_pointcloud);
+      const auto stats = pipeline_->getAsyncStats();
+      ROS_DEBUG_STREAM("Queued new pointcloud. Measurements in queue: "
+                       << stats.queue_depth << ", dropped so far: "
+                       << stats.num_dropped << ", mean latency: "
+                       << stats.mean_latency << "s.");
+    } else {
+      integration_timer_.start();
+      pipeline_->runPipeline(config_.measurement_integrator_names,
+                             posed_pointcloud);
+      integration_timer_.stop();
+      ROS_DEBUG_STREAM("Integrated new pointcloud in "
+                       << integration_timer_.getLastEpisodeDuration()
+                       << "s. Total integration time: "
+                       << integration_timer_.getTotalDuration() << "s.");
+    }
 
     // Publish debugging visualizations
     publishProjectedRangeImageIfEnabled(
@@ -18,7 +18,9 @@ DECLARE_CONFIG_MEMBERS(RosServerConfig,
                       (world_frame)
                       (num_threads)
                       (logging_level)
-                      (allow_reset_map_service));
+                      (allow_reset_map_service)
+                      (run_pipeline_async)
+                      (pipeline_async_queue));
 
 bool RosServerConfig::isValid(bool verbose) const {
   bool all_valid = true;
@@ -26,6 +28,7 @@ bool RosServerConfig::isValid(bool verbose) const {
   all_valid &= IS_PARAM_NE(world_frame, "", verbose);
   all_valid &= IS_PARAM_GT(num_threads, 0, verbose);
   all_valid &= IS_PARAM_TRUE(logging_level.isValid(), verbose);
+  all_valid &= pipeline_async_queue.isValid(verbose);
 
   return all_valid;
 }
@@ -62,6 +65,12 @@ RosServer::RosServer(ros::NodeHandle nh, ros::NodeHandle nh_private,
   // Setup the pipeline
   pipeline_ = std::make_shared<Pipeline>(occupancy_map_, thread_pool_);
   CHECK_NOTNULL(pipeline_);
+  if (config_.run_pipeline_async) {
+    ROS_INFO_STREAM("Integrating measurements asynchronously, with up to "
+                    << config_.pipeline_async_queue.max_queue_size
+                    << " queued measurements.");
+    pipeline_->startAsync(config_.pipeline_async_queue);
+  }
 
   // Add map operations to pipeline
   const param::Array map_operation_param_array =
@@ -140,8 +149,8 @@ MapOperationBase* RosServer::addOperation(const param::Value& operation_params,
   }
 
   if (const auto type = MapOperationType{type_name.value()}; type.isValid()) {
-    auto operation =
-        MapOperationFactory::create(type, operation_params, occupancy_map_);
+    auto operation = MapOperationFactory::create(type, operation_params,
+                                                 occupancy_map_, thread_pool_);
     return pipeline_->addOperation(std::move(operation));
   }
 
@@ -155,6 +164,10 @@ MapOperationBase* RosServer::addOperation(const param::Value& operation_params,
 }
 
 bool RosServer::saveMap(const std::filesystem::path& file_path) const {
+  // Finish integrating the queued measurements first
+  if (pipeline_) {
+    pipeline_->waitForAsync();
+  }
   if (occupancy_map_) {
     occupancy_map_->threshold();
     return io::mapToFile(*occupancy_map_, file_path);
@@ -165,6 +178,9 @@ bool RosServer::saveMap(const std::filesystem::path& file_path) const {
 }
 
 bool RosServer::loadMap(const std::filesystem::path& file_path) {
+  if (pipeline_) {
+    pipeline_->waitForAsync();
+  }
   return io::fileToMap(file_path, occupancy_map_);
 }
 
@@ -174,6 +190,7 @@ void RosServer::advertiseServices(ros::NodeHandle& nh_private) {
       "reset_map", [this](auto& /*request*/, auto& response) {
         response.success = false;
         if (config_.allow_reset_map_service) {
+          pipeline_->waitForAsync();
           if (occupancy_map_) {
             occupancy_map_->clear();
           }
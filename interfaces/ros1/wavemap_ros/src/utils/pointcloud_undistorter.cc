@@ -57,7 +57,8 @@ PointcloudUndistorter::Result PointcloudUndistorter::undistortPointcloud(
 
   // Apply motion undistortion and return the result
   undistorted_pointcloud =
-      undistortion::compensate_motion(pose_buffer, stamped_pointcloud);
+      undistortion::compensate_motion(pose_buffer, stamped_pointcloud,
+                                      thread_pool_.get());
   return Result::kSuccess;
 }
 }  // namespace wavemap
@@ -309,7 +309,7 @@ void mapToRosMsg(
       auto& block_msg = msg.blocks[block_idx++];
       // If a thread pool was provided, use it
       if (thread_pool) {
-        thread_pool->add_task(
+        thread_pool->add_detached_task(
             [block_index, block, min_log_odds, max_log_odds, &block_msg]() {
               blockToRosMsg(block_index, *block, min_log_odds, max_log_odds,
                             block_msg);
@@ -508,8 +508,9 @@ void mapToRosMsg(
       auto& block_msg = msg.blocks[block_idx++];
       // If a thread pool was provided, use it
       if (thread_pool) {
-        thread_pool->add_task([block_index, block, min_log_odds, max_log_odds,
-                               tree_height, &block_msg]() {
+        thread_pool->add_detached_task([block_index, block, min_log_odds,
+                                        max_log_odds, tree_height,
+                                        &block_msg]() {
           blockToRosMsg(block_index, *block, min_log_odds, max_log_odds,
                         block_msg);
         });
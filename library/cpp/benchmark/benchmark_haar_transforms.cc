@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <benchmark/benchmark.h>
 
 #include "wavemap/core/map/cell_types/haar_coefficients.h"
@@ -36,12 +38,22 @@ static void ForwardLiftedTransform(benchmark::State& state) {
   }
 }
 
+template <typename ValueT, int dim>
+static void ForwardVectorizedTransform(benchmark::State& state) {
+  const typename HaarCoefficients<ValueT, dim>::CoefficientsArray child_scales =
+      GenerateRandomCoefficientsArray<ValueT, dim>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ForwardVectorized<ValueT, dim>(child_scales));
+  }
+}
+
 BENCHMARK_TEMPLATE(ForwardParallelTransform, FloatingPoint, 1);
 BENCHMARK_TEMPLATE(ForwardLiftedTransform, FloatingPoint, 1);
 BENCHMARK_TEMPLATE(ForwardParallelTransform, FloatingPoint, 2);
 BENCHMARK_TEMPLATE(ForwardLiftedTransform, FloatingPoint, 2);
 BENCHMARK_TEMPLATE(ForwardParallelTransform, FloatingPoint, 3);
 BENCHMARK_TEMPLATE(ForwardLiftedTransform, FloatingPoint, 3);
+BENCHMARK_TEMPLATE(ForwardVectorizedTransform, FloatingPoint, 3);
 BENCHMARK_TEMPLATE(ForwardParallelTransform, FloatingPoint, 4);
 BENCHMARK_TEMPLATE(ForwardLiftedTransform, FloatingPoint, 4);
 
@@ -63,15 +75,147 @@ static void BackwardLiftedTransform(benchmark::State& state) {
   }
 }
 
+template <typename ValueT, int dim>
+static void BackwardVectorizedTransform(benchmark::State& state) {
+  const typename HaarCoefficients<ValueT, dim>::Parent parent(
+      GenerateRandomCoefficientsArray<ValueT, dim>());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BackwardVectorized<ValueT, dim>(parent));
+  }
+}
+
 BENCHMARK_TEMPLATE(BackwardParallelTransform, FloatingPoint, 1);
 BENCHMARK_TEMPLATE(BackwardLiftedTransform, FloatingPoint, 1);
 BENCHMARK_TEMPLATE(BackwardParallelTransform, FloatingPoint, 2);
 BENCHMARK_TEMPLATE(BackwardLiftedTransform, FloatingPoint, 2);
 BENCHMARK_TEMPLATE(BackwardParallelTransform, FloatingPoint, 3);
 BENCHMARK_TEMPLATE(BackwardLiftedTransform, FloatingPoint, 3);
+BENCHMARK_TEMPLATE(BackwardVectorizedTransform, FloatingPoint, 3);
 BENCHMARK_TEMPLATE(BackwardParallelTransform, FloatingPoint, 4);
 BENCHMARK_TEMPLATE(BackwardLiftedTransform, FloatingPoint, 4);
 
+// Transform many independent nodes, as when processing a whole tree level
+template <typename ValueT, int dim>
+static void ForwardLiftedTransformLoop(benchmark::State& state) {
+  const auto num_nodes = static_cast<size_t>(state.range(0));
+  std::vector<typename HaarCoefficients<ValueT, dim>::CoefficientsArray>
+      child_scales(num_nodes, GenerateRandomCoefficientsArray<ValueT, dim>());
+  std::vector<typename HaarCoefficients<ValueT, dim>::Parent> parents(
+      num_nodes);
+  for (auto _ : state) {
+    for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+      parents[node_idx] = ForwardLifted<ValueT, dim>(child_scales[node_idx]);
+    }
+    benchmark::DoNotOptimize(parents.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+
+template <typename ValueT, int dim>
+static void ForwardVectorizedTransformLoop(benchmark::State& state) {
+  const auto num_nodes = static_cast<size_t>(state.range(0));
+  std::vector<typename HaarCoefficients<ValueT, dim>::CoefficientsArray>
+      child_scales(num_nodes, GenerateRandomCoefficientsArray<ValueT, dim>());
+  std::vector<typename HaarCoefficients<ValueT, dim>::Parent> parents(
+      num_nodes);
+  for (auto _ : state) {
+    for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+      parents[node_idx] =
+          ForwardVectorized<ValueT, dim>(child_scales[node_idx]);
+    }
+    benchmark::DoNotOptimize(parents.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+
+template <typename ValueT, int dim>
+static void ForwardBatchTransform(benchmark::State& state) {
+  const auto num_nodes = static_cast<size_t>(state.range(0));
+  constexpr auto kNumCoefficients =
+      HaarCoefficients<ValueT, dim>::kNumCoefficients;
+  const auto random_coefficients =
+      GenerateRandomCoefficientsArray<ValueT, dim>();
+  std::vector<ValueT> child_scales(kNumCoefficients * num_nodes);
+  for (size_t idx = 0; idx < child_scales.size(); ++idx) {
+    child_scales[idx] = random_coefficients[idx / num_nodes];
+  }
+  std::vector<ValueT> parents(kNumCoefficients * num_nodes);
+  for (auto _ : state) {
+    ForwardLiftedBatch<ValueT, dim>(child_scales.data(), parents.data(),
+                                    num_nodes);
+    benchmark::DoNotOptimize(parents.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+
+BENCHMARK_TEMPLATE(ForwardLiftedTransformLoop, FloatingPoint, 3)->Arg(1024);
+BENCHMARK_TEMPLATE(ForwardVectorizedTransformLoop, FloatingPoint, 3)->Arg(1024);
+BENCHMARK_TEMPLATE(ForwardBatchTransform, FloatingPoint, 3)->Arg(1024);
+
+template <typename ValueT, int dim>
+static void BackwardLiftedTransformLoop(benchmark::State& state) {
+  const auto num_nodes = static_cast<size_t>(state.range(0));
+  std::vector<typename HaarCoefficients<ValueT, dim>::Parent> parents(
+      num_nodes, GenerateRandomCoefficientsArray<ValueT, dim>());
+  std::vector<typename HaarCoefficients<ValueT, dim>::CoefficientsArray>
+      child_scales(num_nodes);
+  for (auto _ : state) {
+    for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+      child_scales[node_idx] = BackwardLifted<ValueT, dim>(parents[node_idx]);
+    }
+    benchmark::DoNotOptimize(child_scales.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+
+template <typename ValueT, int dim>
+static void BackwardVectorizedTransformLoop(benchmark::State& state) {
+  const auto num_nodes = static_cast<size_t>(state.range(0));
+  std::vector<typename HaarCoefficients<ValueT, dim>::Parent> parents(
+      num_nodes, GenerateRandomCoefficientsArray<ValueT, dim>());
+  std::vector<typename HaarCoefficients<ValueT, dim>::CoefficientsArray>
+      child_scales(num_nodes);
+  for (auto _ : state) {
+    for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+      child_scales[node_idx] =
+          BackwardVectorized<ValueT, dim>(parents[node_idx]);
+    }
+    benchmark::DoNotOptimize(child_scales.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+
+template <typename ValueT, int dim>
+static void BackwardBatchTransform(benchmark::State& state) {
+  const auto num_nodes = static_cast<size_t>(state.range(0));
+  constexpr auto kNumCoefficients =
+      HaarCoefficients<ValueT, dim>::kNumCoefficients;
+  const auto random_coefficients =
+      GenerateRandomCoefficientsArray<ValueT, dim>();
+  std::vector<ValueT> parents(kNumCoefficients * num_nodes);
+  for (size_t idx = 0; idx < parents.size(); ++idx) {
+    parents[idx] = random_coefficients[idx / num_nodes];
+  }
+  std::vector<ValueT> child_scales(kNumCoefficients * num_nodes);
+  for (auto _ : state) {
+    BackwardLiftedBatch<ValueT, dim>(parents.data(), child_scales.data(),
+                                     num_nodes);
+    benchmark::DoNotOptimize(child_scales.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+
+BENCHMARK_TEMPLATE(BackwardLiftedTransformLoop, FloatingPoint, 3)->Arg(1024);
+BENCHMARK_TEMPLATE(BackwardVectorizedTransformLoop, FloatingPoint, 3)
+    ->Arg(1024);
+BENCHMARK_TEMPLATE(BackwardBatchTransform, FloatingPoint, 3)->Arg(1024);
+
 template <typename ValueT, int dim>
 static void ForwardSingleChildTransform(benchmark::State& state) {
   RandomNumberGenerator random_number_generator;
@@ -0,0 +1,619 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/config/param.h"
+#include "wavemap/core/data_structure/image.h"
+#include "wavemap/core/data_structure/pointcloud.h"
+#include "wavemap/core/integrator/projection_model/projector_factory.h"
+#include "wavemap/core/map/map_factory.h"
+#include "wavemap/core/utils/thread_pool.h"
+#include "wavemap/core/utils/time/stopwatch.h"
+#include "wavemap/pipeline/pipeline.h"
+
+// End-to-end benchmarks that run the full mapping pipeline, i.e. measurement
+// integration followed by the map operations, on sequences of scans. Each
+// benchmark iteration integrates one scan, cycling through the sequence, and
+// the map is thresholded and pruned once every fixed number of scans.
+// Throughput is reported in scans per second, together with the per-scan
+// latency percentiles and the map's memory usage after the last scan.
+//
+// The scans are either rendered from deterministic synthetic scenes through
+// each projection model, or replayed from a file passed with
+// --replay_file=<path>. Replayed scans are integrated with the projection
+// model selected by --replay_projector=<spherical|ouster|pinhole>, which
+// defaults to spherical. Replay files are plain text, where lines starting
+// with '#' are ignored and each scan consists of a header line
+//   <num_points> <tx> <ty> <tz> <qw> <qx> <qy> <qz>
+// with the sensor's pose in the world frame, followed by one line per point
+//   <x> <y> <z>
+// with the point's coordinates in the sensor frame.
+//
+// Depth cameras are fed depth images, whereas LiDARs are fed pointclouds such
+// that their import into the integrators' range images is also measured.
+
+namespace wavemap {
+namespace {
+// Helpers to assemble param trees, matching the layout of wavemap's configs
+param::Value paramStr(const std::string& value) { return param::Value{value}; }
+param::Value paramInt(int value) { return param::Value{value}; }
+param::Value paramFloat(FloatingPoint value) { return param::Value{value}; }
+param::Value paramUnit(const std::string& unit, FloatingPoint value) {
+  return param::Value{param::Map{{unit, paramFloat(value)}}};
+}
+param::Value paramMap(param::Map map) { return param::Value{std::move(map)}; }
+
+struct Scan {
+  PosedPointcloud<> pointcloud;
+  // Image storing each ray's coordinate along the projection model's sensor Z
+  // axis, as produced by depth cameras. Only available for synthetic scans
+  // rendered through depth cameras.
+  std::optional<PosedImage<>> sensor_z_image;
+};
+using ScanSequence = std::vector<Scan>;
+
+// Synthetic scene with a sensor trajectory through it, whose surfaces are
+// defined analytically such that rays can be cast against them directly
+class SyntheticScene {
+ public:
+  static constexpr FloatingPoint kMaxRange = 40.f;
+  static constexpr int kNumScans = 20;
+
+  using DistanceFn = std::function<std::optional<FloatingPoint>(
+      const Point3D& W_origin, const Vector3D& W_direction)>;
+  using TrajectoryFn = std::function<Transformation3D(FloatingPoint progress)>;
+
+  SyntheticScene(std::string name, DistanceFn cast_ray_fn,
+                 TrajectoryFn trajectory_fn)
+      : name_(std::move(name)),
+        cast_ray_fn_(std::move(cast_ray_fn)),
+        trajectory_fn_(std::move(trajectory_fn)) {}
+
+  const std::string& getName() const { return name_; }
+
+  // Render the scans seen by the given projection model along the trajectory,
+  // including their depth images if the projection model is a depth camera
+  ScanSequence render(const ProjectorBase& projector,
+                      const Transformation3D& T_B_C,
+                      bool is_depth_camera) const;
+
+  static SyntheticScene room();
+  static SyntheticScene corridor();
+  static SyntheticScene terrain();
+
+ private:
+  const std::string name_;
+  const DistanceFn cast_ray_fn_;
+  const TrajectoryFn trajectory_fn_;
+};
+
+// Distance to the nearest face of a box, for a ray starting inside it
+FloatingPoint castRayFromInsideBox(const AABB<Point3D>& box,
+                                   const Point3D& origin,
+                                   const Vector3D& direction) {
+  FloatingPoint distance = std::numeric_limits<FloatingPoint>::max();
+  for (int dim_idx = 0; dim_idx < 3; ++dim_idx) {
+    if (direction[dim_idx] == 0.f) {
+      continue;
+    }
+    const FloatingPoint face = 0.f < direction[dim_idx] ? box.max[dim_idx]
+                                                        : box.min[dim_idx];
+    distance = std::min(distance,
+                        (face - origin[dim_idx]) / direction[dim_idx]);
+  }
+  return distance;
+}
+
+// Distance to a solid box, for a ray starting outside it
+std::optional<FloatingPoint> castRayAtBox(const AABB<Point3D>& box,
+                                          const Point3D& origin,
+                                          const Vector3D& direction) {
+  FloatingPoint distance_near = 0.f;
+  FloatingPoint distance_far = std::numeric_limits<FloatingPoint>::max();
+  for (int dim_idx = 0; dim_idx < 3; ++dim_idx) {
+    if (direction[dim_idx] == 0.f) {
+      if (origin[dim_idx] < box.min[dim_idx] ||
+          box.max[dim_idx] < origin[dim_idx]) {
+        return std::nullopt;
+      }
+      continue;
+    }
+    FloatingPoint distance_min =
+        (box.min[dim_idx] - origin[dim_idx]) / direction[dim_idx];
+    FloatingPoint distance_max =
+        (box.max[dim_idx] - origin[dim_idx]) / direction[dim_idx];
+    if (distance_max < distance_min) {
+      std::swap(distance_min, distance_max);
+    }
+    distance_near = std::max(distance_near, distance_min);
+    distance_far = std::min(distance_far, distance_max);
+  }
+  if (distance_far < distance_near) {
+    return std::nullopt;
+  }
+  return distance_near;
+}
+
+// Distance to the nearest surface of an enclosing box containing solid boxes
+std::optional<FloatingPoint> castRayInBoxes(
+    const AABB<Point3D>& enclosure, const std::vector<AABB<Point3D>>& obstacles,
+    const Point3D& origin, const Vector3D& direction) {
+  FloatingPoint distance = castRayFromInsideBox(enclosure, origin, direction);
+  for (const auto& obstacle : obstacles) {
+    if (const auto obstacle_distance =
+            castRayAtBox(obstacle, origin, direction);
+        obstacle_distance) {
+      distance = std::min(distance, obstacle_distance.value());
+    }
+  }
+  if (SyntheticScene::kMaxRange < distance) {
+    return std::nullopt;
+  }
+  return distance;
+}
+
+// Pose of a sensor platform at the given position, driving along the given
+// heading with its z-axis pointing up
+Transformation3D getPlatformPose(const Point3D& position,
+                                 FloatingPoint heading) {
+  return Transformation3D{Rotation3D{Vector3D{0.f, 0.f, heading}}, position};
+}
+
+ScanSequence SyntheticScene::render(const ProjectorBase& projector,
+                                    const Transformation3D& T_B_C,
+                                    bool is_depth_camera) const {
+  ScanSequence scans;
+  const Index2D dimensions = projector.getDimensions();
+  for (int scan_idx = 0; scan_idx < kNumScans; ++scan_idx) {
+    const FloatingPoint progress = static_cast<FloatingPoint>(scan_idx) /
+                                   static_cast<FloatingPoint>(kNumScans);
+    const Transformation3D T_W_C = trajectory_fn_(progress) * T_B_C;
+    const Point3D& W_origin = T_W_C.getPosition();
+    std::vector<Point3D> C_points;
+    Image<> sensor_z_image(dimensions);
+    for (Index2D index = Index2D::Zero(); index.x() < dimensions.x();
+         ++index.x()) {
+      for (index.y() = 0; index.y() < dimensions.y(); ++index.y()) {
+        const Vector3D C_direction =
+            projector.sensorToCartesian(projector.indexToImage(index), 1.f)
+                .normalized();
+        const auto distance =
+            cast_ray_fn_(W_origin, T_W_C.getRotation().rotate(C_direction));
+        if (!distance) {
+          continue;
+        }
+        const Point3D C_point = distance.value() * C_direction;
+        C_points.emplace_back(C_point);
+        sensor_z_image.at(index) = projector.cartesianToSensorZ(C_point);
+      }
+    }
+    Scan& scan = scans.emplace_back(
+        Scan{PosedPointcloud<>{T_W_C, Pointcloud<>{C_points}}, std::nullopt});
+    if (is_depth_camera) {
+      scan.sensor_z_image = PosedImage<>{T_W_C, std::move(sensor_z_image)};
+    }
+  }
+  return scans;
+}
+
+SyntheticScene SyntheticScene::room() {
+  const AABB<Point3D> room{{-5.f, -4.f, 0.f}, {5.f, 4.f, 3.f}};
+  const std::vector<AABB<Point3D>> furniture{
+      {{1.f, 1.f, 0.f}, {2.5f, 2.f, 0.8f}},
+      {{-3.f, -2.5f, 0.f}, {-2.5f, -2.f, 3.f}},
+      {{-4.8f, 1.5f, 0.f}, {-4.f, 3.5f, 2.f}},
+      {{3.f, -3.8f, 0.f}, {4.8f, -3.f, 1.2f}}};
+  return {"room",
+          [room, furniture](const Point3D& W_origin,
+                            const Vector3D& W_direction) {
+            return castRayInBoxes(room, furniture, W_origin, W_direction);
+          },
+          [](FloatingPoint progress) {
+            // Drive an ellipse around the room's center
+            const FloatingPoint angle = kTwoPi * progress;
+            return getPlatformPose(
+                {2.5f * std::cos(angle), 2.f * std::sin(angle), 1.4f},
+                angle + kHalfPi);
+          }};
+}
+
+SyntheticScene SyntheticScene::corridor() {
+  const AABB<Point3D> corridor{{-2.f, -1.25f, 0.f}, {42.f, 1.25f, 2.6f}};
+  std::vector<AABB<Point3D>> cabinets;
+  for (int cabinet_idx = 0; cabinet_idx < 8; ++cabinet_idx) {
+    const auto x = 5.f * static_cast<FloatingPoint>(cabinet_idx) + 2.f;
+    const FloatingPoint side = cabinet_idx % 2 ? 1.f : -1.f;
+    cabinets.push_back({{x, std::min(0.8f * side, 1.25f * side), 0.f},
+                        {x + 1.f, std::max(0.8f * side, 1.25f * side), 1.8f}});
+  }
+  return {"corridor",
+          [corridor, cabinets](const Point3D& W_origin,
+                               const Vector3D& W_direction) {
+            return castRayInBoxes(corridor, cabinets, W_origin, W_direction);
+          },
+          [](FloatingPoint progress) {
+            // Walk down the corridor, swaying slightly from side to side
+            const FloatingPoint x = 36.f * progress;
+            return getPlatformPose({x, 0.3f * std::sin(x), 1.2f},
+                                   0.2f * std::cos(x));
+          }};
+}
+
+SyntheticScene SyntheticScene::terrain() {
+  auto height_fn = [](FloatingPoint x, FloatingPoint y) {
+    return 1.5f * std::sin(0.15f * x) * std::cos(0.1f * y) +
+           0.4f * std::sin(0.7f * x + 0.5f * y) + 0.2f * std::cos(1.3f * y);
+  };
+  auto cast_ray_fn = [height_fn](const Point3D& W_origin,
+                                const Vector3D& W_direction)
+      -> std::optional<FloatingPoint> {
+    // March along the ray with steps proportional to its height above the
+    // terrain, which are small enough given the terrain's slopes
+    constexpr FloatingPoint kMinHeight = 1e-2f;
+    constexpr int kMaxNumSteps = 1000;
+    FloatingPoint distance = 0.f;
+    for (int step_idx = 0; step_idx < kMaxNumSteps && distance < kMaxRange;
+         ++step_idx) {
+      const Point3D W_point = W_origin + distance * W_direction;
+      const FloatingPoint height =
+          W_point.z() - height_fn(W_point.x(), W_point.y());
+      if (height < kMinHeight) {
+        return distance;
+      }
+      distance += 0.5f * height;
+    }
+    return std::nullopt;
+  };
+  return {"terrain", cast_ray_fn, [height_fn](FloatingPoint progress) {
+            // Drive across the hills, staying at a fixed height above ground
+            const FloatingPoint x = -20.f + 40.f * progress;
+            const FloatingPoint y = 0.3f * x;
+            return getPlatformPose({x, y, height_fn(x, y) + 1.8f},
+                                   std::atan2(0.3f, 1.f));
+          }};
+}
+
+// Load the scans of a replay file, formatted as documented at the top
+std::optional<ScanSequence> loadReplayFile(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    LOG(ERROR) << "Could not open replay file \"" << file_path << "\".";
+    return std::nullopt;
+  }
+  auto read_line = [&file](std::istringstream& line_stream) {
+    std::string line;
+    while (std::getline(file, line)) {
+      if (!line.empty() && line.front() != '#') {
+        line_stream = std::istringstream(line);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  ScanSequence scans;
+  std::istringstream line_stream;
+  while (read_line(line_stream)) {
+    size_t num_points = 0u;
+    Point3D W_t_W_C;
+    FloatingPoint qw, qx, qy, qz;  // NOLINT
+    if (!(line_stream >> num_points >> W_t_W_C.x() >> W_t_W_C.y() >>
+          W_t_W_C.z() >> qw >> qx >> qy >> qz)) {
+      LOG(ERROR) << "Malformed scan header in replay file \"" << file_path
+                 << "\".";
+      return std::nullopt;
+    }
+    Pointcloud<> C_points;
+    C_points.resize(num_points);
+    for (size_t point_idx = 0; point_idx < num_points; ++point_idx) {
+      Point3D C_point;
+      if (!read_line(line_stream) ||
+          !(line_stream >> C_point.x() >> C_point.y() >> C_point.z())) {
+        LOG(ERROR) << "Malformed or missing point in replay file \""
+                   << file_path << "\".";
+        return std::nullopt;
+      }
+      C_points[static_cast<Eigen::Index>(point_idx)] = C_point;
+    }
+    const Rotation3D R_W_C{
+        Eigen::Quaternion<FloatingPoint>{qw, qx, qy, qz}.normalized()};
+    scans.push_back(
+        {PosedPointcloud<>{Transformation3D{R_W_C, W_t_W_C}, C_points},
+         std::nullopt});
+  }
+  if (scans.empty()) {
+    LOG(ERROR) << "Replay file \"" << file_path << "\" contains no scans.";
+    return std::nullopt;
+  }
+  return scans;
+}
+
+// Projection models, together with their mounting on the sensor platform
+struct ProjectorSetup {
+  std::string name;
+  param::Value params;
+  Transformation3D T_B_C;
+  bool is_depth_camera;
+};
+
+std::vector<ProjectorSetup> getProjectorSetups() {
+  auto get_lidar_axis = [](int num_cells, FloatingPoint min_angle,
+                           FloatingPoint max_angle) {
+    return paramMap({{"num_cells", paramInt(num_cells)},
+                     {"min_angle", paramUnit("degrees", min_angle)},
+                     {"max_angle", paramUnit("degrees", max_angle)}});
+  };
+  // Cameras look along their z-axis, which we point forward
+  const Transformation3D T_B_Ccamera{
+      Rotation3D{(Rotation3D::RotationMatrix{} << 0.f, 0.f, 1.f,  // NOLINT
+                  -1.f, 0.f, 0.f,                                  // NOLINT
+                  0.f, -1.f, 0.f)                                  // NOLINT
+                     .finished()},
+      Point3D::Zero()};
+  return {
+      {"spherical",
+       paramMap({{"type", paramStr("spherical_projector")},
+                 {"elevation", get_lidar_axis(32, -30.67f, 10.67f)},
+                 {"azimuth", get_lidar_axis(1024, -180.f, 180.f)}}),
+       Transformation3D{}, false},
+      {"ouster",
+       paramMap(
+           {{"type", paramStr("ouster_projector")},
+            {"lidar_origin_to_beam_origin", paramUnit("millimeters", 27.67f)},
+            {"lidar_origin_to_sensor_origin_z_offset",
+             paramUnit("millimeters", 36.18f)},
+            {"elevation", get_lidar_axis(64, -45.73f, 46.27f)},
+            {"azimuth", get_lidar_axis(1024, -180.f, 180.f)}}),
+       Transformation3D{}, false},
+      {"pinhole",
+       paramMap({{"type", paramStr("pinhole_camera_projector")},
+                 {"width", paramInt(320)},
+                 {"height", paramInt(240)},
+                 {"fx", paramFloat(160.f)},
+                 {"fy", paramFloat(160.f)},
+                 {"cx", paramFloat(160.f)},
+                 {"cy", paramFloat(120.f)}}),
+       T_B_Ccamera, true}};
+}
+
+// Measurement models, where the ray tracing integrator always uses its own
+std::map<std::string, param::Value> getMeasurementModels() {
+  return {{"continuous_ray",
+           paramMap({{"type", paramStr("continuous_ray")},
+                     {"range_sigma", paramUnit("meters", 0.05f)},
+                     {"scaling_free", paramFloat(0.2f)},
+                     {"scaling_occupied", paramFloat(0.4f)}})},
+          {"continuous_beam",
+           paramMap({{"type", paramStr("continuous_beam")},
+                     {"angle_sigma", paramUnit("degrees", 0.1f)},
+                     {"range_sigma", paramUnit("meters", 0.05f)},
+                     {"scaling_free", paramFloat(0.2f)},
+                     {"scaling_occupied", paramFloat(0.4f)}})}};
+}
+
+// The map types that each integrator supports
+std::vector<std::pair<std::string, std::vector<std::string>>>
+getIntegratorMapTypes() {
+  const std::vector<std::string> all_map_types{MapType::names.begin(),
+                                               MapType::names.end()};
+  return {{"ray_tracing_integrator", all_map_types},
+          {"fixed_resolution_integrator", all_map_types},
+          {"coarse_to_fine_integrator", {"octree"}},
+          {"wavelet_integrator", {"wavelet_octree"}},
+          {"hashed_wavelet_integrator", {"hashed_wavelet_octree"}},
+          {"hashed_chunked_wavelet_integrator",
+           {"hashed_chunked_wavelet_octree"}}};
+}
+
+// Scan sequence that is only generated once a benchmark that uses it runs,
+// such that benchmarks excluded with --benchmark_filter cost nothing
+class LazyScanSequence {
+ public:
+  explicit LazyScanSequence(std::function<ScanSequence()> generator)
+      : generator_(std::move(generator)) {}
+
+  const ScanSequence& get() {
+    if (!scans_) {
+      scans_ = generator_();
+    }
+    return scans_.value();
+  }
+
+ private:
+  std::function<ScanSequence()> generator_;
+  std::optional<ScanSequence> scans_;
+};
+
+struct PipelineSetup {
+  param::Value map_params;
+  param::Value integrator_params;
+  bool use_sensor_z_image;
+};
+
+void IntegrateScans(benchmark::State& state, const PipelineSetup& setup,
+                    const ScanSequence& scans,
+                    std::shared_ptr<ThreadPool> thread_pool) {
+  MapBase::Ptr occupancy_map = MapFactory::create(setup.map_params);
+  CHECK(occupancy_map);
+  Pipeline pipeline{occupancy_map, std::move(thread_pool)};
+  const std::vector<std::string> integrator_names{"integrator"};
+  CHECK_NOTNULL(pipeline.addIntegrator(integrator_names.front(),
+                                       setup.integrator_params));
+  MapOperationBase* threshold_operation = CHECK_NOTNULL(
+      pipeline.addOperation(paramMap({{"type", paramStr("threshold_map")}})));
+  MapOperationBase* prune_operation = CHECK_NOTNULL(
+      pipeline.addOperation(paramMap({{"type", paramStr("prune_map")}})));
+
+  // The map operations are triggered by scan count rather than wall-clock
+  // time, such that the same scans pay for them on every machine and the
+  // latency percentiles are comparable across runs. The periods correspond to
+  // the operations' default periods of 2 s and 10 s for a 10 Hz sensor.
+  constexpr size_t kThresholdEveryNScans = 20u;
+  constexpr size_t kPruneEveryNScans = 100u;
+
+  std::vector<double> scan_durations;
+  Stopwatch stopwatch;
+  size_t scan_idx = 0u;
+  for (auto _ : state) {
+    const Scan& scan = scans[scan_idx % scans.size()];
+    ++scan_idx;
+    stopwatch.start();
+    if (setup.use_sensor_z_image && scan.sensor_z_image) {
+      pipeline.runIntegrators(integrator_names, scan.sensor_z_image.value());
+    } else {
+      pipeline.runIntegrators(integrator_names, scan.pointcloud);
+    }
+    if (scan_idx % kThresholdEveryNScans == 0u) {
+      threshold_operation->run(true);
+    }
+    if (scan_idx % kPruneEveryNScans == 0u) {
+      prune_operation->run(true);
+    }
+    stopwatch.stop();
+    scan_durations.emplace_back(stopwatch.getLastEpisodeDuration());
+  }
+
+  // Report the throughput, latency percentiles and memory usage
+  std::sort(scan_durations.begin(), scan_durations.end());
+  auto get_percentile_ms = [&scan_durations](double percentile) {
+    const auto idx = static_cast<size_t>(
+        percentile * static_cast<double>(scan_durations.size() - 1u));
+    return 1e3 * scan_durations[idx];
+  };
+  state.SetItemsProcessed(state.iterations());
+  state.counters["p50_ms"] = get_percentile_ms(0.5);
+  state.counters["p90_ms"] = get_percentile_ms(0.9);
+  state.counters["p99_ms"] = get_percentile_ms(0.99);
+  state.counters["max_ms"] = 1e3 * scan_durations.back();
+  state.counters["map_memory"] = benchmark::Counter(
+      static_cast<double>(occupancy_map->getMemoryUsage()),
+      benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+}
+
+// Register one benchmark per integrator, map, projector and measurement model
+// combination for the given scene
+void registerBenchmarks(
+    const std::string& scene_name,
+    const std::vector<ProjectorSetup>& projector_setups,
+    std::function<ScanSequence(const ProjectorSetup& projector_setup)>
+        get_scans,
+    const std::shared_ptr<ThreadPool>& thread_pool) {
+  for (const auto& projector_setup : projector_setups) {
+    auto scans = std::make_shared<LazyScanSequence>(
+        [get_scans, projector_setup]() { return get_scans(projector_setup); });
+    for (const auto& [integrator_type, map_types] : getIntegratorMapTypes()) {
+      const bool is_ray_tracing = integrator_type == "ray_tracing_integrator";
+      auto measurement_models = getMeasurementModels();
+      if (is_ray_tracing) {
+        measurement_models = {{"constant_ray", paramMap({})}};
+      }
+      for (const auto& [model_name, model_params] : measurement_models) {
+        for (const auto& map_type : map_types) {
+          PipelineSetup setup{
+              paramMap({{"type", paramStr(map_type)},
+                        {"min_cell_width", paramUnit("meters", 0.1f)}}),
+              paramMap({{"projection_model", projector_setup.params},
+                        {"measurement_model", model_params},
+                        {"integration_method",
+                         paramMap({{"type", paramStr(integrator_type)},
+                                   {"min_range", paramUnit("meters", 0.5f)},
+                                   {"max_range",
+                                    paramUnit("meters", 15.f)}})}}),
+              !is_ray_tracing};
+          const std::string name = "Integration/" + scene_name + "/" +
+                                   projector_setup.name + "/" + model_name +
+                                   "/" + integrator_type + "/" + map_type;
+          benchmark::RegisterBenchmark(
+              name.c_str(),
+              [setup = std::move(setup), scans,
+               thread_pool](benchmark::State& state) {
+                IntegrateScans(state, setup, scans->get(), thread_pool);
+              })
+              ->Unit(benchmark::kMillisecond)
+              ->UseRealTime();
+        }
+      }
+    }
+  }
+}
+}  // namespace
+}  // namespace wavemap
+
+int main(int argc, char** argv) {
+  using namespace wavemap;  // NOLINT
+  benchmark::Initialize(&argc, argv);
+
+  // Parse the arguments that are not handled by google benchmark
+  std::optional<std::string> replay_file_path;
+  std::string replay_projector_name = "spherical";
+  for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+    const std::string arg = argv[arg_idx];
+    const std::string replay_file_flag = "--replay_file=";
+    const std::string replay_projector_flag = "--replay_projector=";
+    if (arg.rfind(replay_file_flag, 0) == 0) {
+      replay_file_path = arg.substr(replay_file_flag.size());
+    } else if (arg.rfind(replay_projector_flag, 0) == 0) {
+      replay_projector_name = arg.substr(replay_projector_flag.size());
+    } else {
+      LOG(ERROR) << "Unrecognized argument \"" << arg << "\".";
+      return 1;
+    }
+  }
+
+  auto thread_pool = std::make_shared<ThreadPool>();
+  const std::vector<ProjectorSetup> projector_setups = getProjectorSetups();
+  if (replay_file_path) {
+    const auto replay_projector_it = std::find_if(
+        projector_setups.begin(), projector_setups.end(),
+        [&replay_projector_name](const ProjectorSetup& projector_setup) {
+          return projector_setup.name == replay_projector_name;
+        });
+    if (replay_projector_it == projector_setups.end()) {
+      LOG(ERROR) << "Unknown replay projector \"" << replay_projector_name
+                 << "\".";
+      return 1;
+    }
+    auto scans = loadReplayFile(replay_file_path.value());
+    if (!scans) {
+      return 1;
+    }
+    registerBenchmarks(
+        "replay", {*replay_projector_it},
+        [scans = std::move(scans.value())](const ProjectorSetup&) {
+          return scans;
+        },
+        thread_pool);
+  } else {
+    for (const auto& scene :
+         {std::make_shared<SyntheticScene>(SyntheticScene::room()),
+          std::make_shared<SyntheticScene>(SyntheticScene::corridor()),
+          std::make_shared<SyntheticScene>(SyntheticScene::terrain())}) {
+      registerBenchmarks(
+          scene->getName(), projector_setups,
+          [scene](const ProjectorSetup& projector_setup) {
+            const auto projector = ProjectorFactory::create(paramMap(
+                {{"projection_model", projector_setup.params}}));
+            CHECK(projector);
+            return scene->render(*projector, projector_setup.T_B_C,
+                                 projector_setup.is_depth_camera);
+          },
+          thread_pool);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
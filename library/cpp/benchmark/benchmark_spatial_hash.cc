@@ -0,0 +1,98 @@
+#include <array>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/data_structure/spatial_hash.h"
+#include "wavemap/core/utils/random_number_generator.h"
+
+namespace wavemap {
+using BlockData = std::array<FloatingPoint, 8>;
+template <template <typename, int> typename BlockHashMapT>
+using BlockHash = SpatialHash<BlockData, 3, BlockHashMapT>;
+
+// Generate the indices of the blocks in a shell around the origin, similar to
+// the blocks that are observed when mapping the surfaces of a room
+static std::vector<Index3D> getShellBlockIndices(IndexElement radius) {
+  std::vector<Index3D> block_indices;
+  for (IndexElement x = -radius; x <= radius; ++x) {
+    for (IndexElement y = -radius; y <= radius; ++y) {
+      for (IndexElement z = -radius; z <= radius; ++z) {
+        const Index3D block_index{x, y, z};
+        if (block_index.cwiseAbs().maxCoeff() == radius) {
+          block_indices.emplace_back(block_index);
+        }
+      }
+    }
+  }
+  return block_indices;
+}
+
+template <template <typename, int> typename BlockHashMapT>
+static void GetBlock(benchmark::State& state) {
+  RandomNumberGenerator random_number_generator;
+  const IndexElement radius = static_cast<IndexElement>(state.range(0));
+  const std::vector<Index3D> block_indices = getShellBlockIndices(radius);
+  BlockHash<BlockHashMapT> block_hash;
+  for (const Index3D& block_index : block_indices) {
+    block_hash.getOrAllocateBlock(block_index);
+  }
+
+  // Query a random mix of allocated and unallocated blocks
+  std::vector<Index3D> query_indices(1024);
+  for (Index3D& query_index : query_indices) {
+    for (int dim_idx = 0; dim_idx < 3; ++dim_idx) {
+      query_index[dim_idx] =
+          random_number_generator.getRandomInteger(-radius, radius);
+    }
+  }
+
+  for (auto _ : state) {
+    for (const Index3D& query_index : query_indices) {
+      benchmark::DoNotOptimize(block_hash.getBlock(query_index));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * query_indices.size());
+}
+BENCHMARK(GetBlock<StdBlockHashMap>)->Arg(8)->Arg(32);
+BENCHMARK(GetBlock<FlatBlockHashMap>)->Arg(8)->Arg(32);
+
+template <template <typename, int> typename BlockHashMapT>
+static void AllocateBlocks(benchmark::State& state) {
+  const IndexElement radius = static_cast<IndexElement>(state.range(0));
+  const std::vector<Index3D> block_indices = getShellBlockIndices(radius);
+  for (auto _ : state) {
+    BlockHash<BlockHashMapT> block_hash;
+    for (const Index3D& block_index : block_indices) {
+      benchmark::DoNotOptimize(&block_hash.getOrAllocateBlock(block_index));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * block_indices.size());
+}
+BENCHMARK(AllocateBlocks<StdBlockHashMap>)->Arg(8)->Arg(32);
+BENCHMARK(AllocateBlocks<FlatBlockHashMap>)->Arg(8)->Arg(32);
+
+template <template <typename, int> typename BlockHashMapT>
+static void ForEachBlock(benchmark::State& state) {
+  const IndexElement radius = static_cast<IndexElement>(state.range(0));
+  const std::vector<Index3D> block_indices = getShellBlockIndices(radius);
+  BlockHash<BlockHashMapT> block_hash;
+  for (const Index3D& block_index : block_indices) {
+    block_hash.getOrAllocateBlock(block_index);
+  }
+
+  for (auto _ : state) {
+    block_hash.forEachBlock(
+        [](const Index3D& block_index, const BlockData& block) {
+          benchmark::DoNotOptimize(block_index);
+          benchmark::DoNotOptimize(block);
+        });
+  }
+  state.SetItemsProcessed(state.iterations() * block_indices.size());
+}
+BENCHMARK(ForEachBlock<StdBlockHashMap>)->Arg(8)->Arg(32);
+BENCHMARK(ForEachBlock<FlatBlockHashMap>)->Arg(8)->Arg(32);
+}  // namespace wavemap
+
+BENCHMARK_MAIN();
@@ -7,6 +7,8 @@ option(USE_TSAN "Compile with thread sanitizer enabled" OFF)
 option(ENABLE_COVERAGE_TESTING
     "Compile with necessary flags for coverage testing" OFF)
 option(USE_CLANG_TIDY "Generate necessary files to run clang-tidy" OFF)
+option(USE_STD_BLOCK_HASH_MAP
+    "Store the blocks of hashed maps in std::unordered_maps" OFF)
 
 # Adds the include paths of the wavemap library to the given target.
 function(add_wavemap_include_directories target)
@@ -34,6 +36,9 @@ function(set_wavemap_target_properties target)
   target_compile_options(${target} PRIVATE
       -Wall -Wextra -Wpedantic
       -Wno-unused-result -Wno-deprecated-copy -Wno-class-memaccess)
+  # Math functions such as std::sqrt do not need to set errno, which allows the
+  # compiler to vectorize loops that call them
+  target_compile_options(${target} PRIVATE -fno-math-errno)
 
   # General C++ defines
   target_compile_definitions(${target} PUBLIC EIGEN_INITIALIZE_MATRICES_BY_NAN)
@@ -42,6 +47,9 @@ function(set_wavemap_target_properties target)
   if (DCHECK_ALWAYS_ON)
     target_compile_definitions(${target} PUBLIC DCHECK_ALWAYS_ON)
   endif ()
+  if (USE_STD_BLOCK_HASH_MAP)
+    target_compile_definitions(${target} PUBLIC WAVEMAP_USE_STD_BLOCK_HASH_MAP)
+  endif ()
   if (USE_UBSAN)
     target_compile_options(${target} PUBLIC
         -fsanitize=undefined
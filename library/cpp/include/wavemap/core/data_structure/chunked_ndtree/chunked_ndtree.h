@@ -1,7 +1,9 @@
 #ifndef WAVEMAP_CORE_DATA_STRUCTURE_CHUNKED_NDTREE_CHUNKED_NDTREE_H_
 #define WAVEMAP_CORE_DATA_STRUCTURE_CHUNKED_NDTREE_CHUNKED_NDTREE_H_
 
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -10,27 +12,40 @@
 #include "wavemap/core/data_structure/chunked_ndtree/chunked_ndtree_node_address.h"
 #include "wavemap/core/indexing/ndtree_index.h"
 #include "wavemap/core/utils/iterate/subtree_iterator.h"
+#include "wavemap/core/utils/memory/heap_allocator.h"
 
 namespace wavemap {
-template <typename NodeDataT, int dim, int chunk_height>
+/**
+ * N-dimensional tree whose nodes are stored in chunks of chunk_height levels.
+ *
+ * Like the Ndtree, the chunks are allocated with the AllocatorT. When it
+ * supports it, all chunks are freed at once when the tree is cleared or
+ * destroyed.
+ */
+template <typename NodeDataT, int dim, int chunk_height,
+          typename AllocatorT = HeapAllocator>
 class ChunkedNdtree {
  public:
   using IndexType = NdtreeIndex<dim>;
   using HeightType = IndexElement;
-  using ChunkType = ChunkedNdtreeChunk<NodeDataT, dim, chunk_height>;
+  using ChunkType =
+      ChunkedNdtreeChunk<NodeDataT, dim, chunk_height, AllocatorT>;
   using NodeRefType = ChunkedNdtreeNodeRef<ChunkType>;
   using NodeConstRefType = ChunkedNdtreeNodeRef<const ChunkType>;
   using NodePtrType = ChunkedNdtreeNodePtr<ChunkType>;
   using NodeConstPtrType = ChunkedNdtreeNodePtr<const ChunkType>;
   using NodeDataType = NodeDataT;
+  using AllocatorType = AllocatorT;
   static constexpr HeightType kChunkHeight = chunk_height;
 
   explicit ChunkedNdtree(HeightType max_height);
-  ~ChunkedNdtree() = default;
+  ~ChunkedNdtree();
+
+  ChunkedNdtree(ChunkedNdtree&&) noexcept = default;
 
   bool empty() const { return root_chunk_.empty(); }
   size_t size() const;
-  void clear() { root_chunk_.clear(); }
+  void clear();
   void prune();
 
   HeightType getMaxHeight() const { return max_height_; }
@@ -64,16 +79,27 @@ class ChunkedNdtree {
   auto getChunkIterator() const;
 
  private:
+  // Chunks can only be freed in bulk if skipping their destructors is safe
+  static constexpr bool kReleasesInBulk =
+      AllocatorT::kReleasesInBulk &&
+      std::is_trivially_destructible_v<NodeDataT>;
+
+  // NOTE: The allocator is declared before the root chunk, such that it
+  //       outlives it. It is only instantiated for stateful allocators.
+  std::unique_ptr<AllocatorT> allocator_;
   ChunkType root_chunk_;
   const HeightType max_height_;
 };
 
-template <typename NodeDataT, int chunk_height>
-using ChunkedBinaryTree = ChunkedNdtree<NodeDataT, 1, chunk_height>;
-template <typename NodeDataT, int chunk_height>
-using ChunkedQuadtree = ChunkedNdtree<NodeDataT, 2, chunk_height>;
-template <typename NodeDataT, int chunk_height>
-using ChunkedOctree = ChunkedNdtree<NodeDataT, 3, chunk_height>;
+template <typename NodeDataT, int chunk_height,
+          typename AllocatorT = HeapAllocator>
+using ChunkedBinaryTree = ChunkedNdtree<NodeDataT, 1, chunk_height, AllocatorT>;
+template <typename NodeDataT, int chunk_height,
+          typename AllocatorT = HeapAllocator>
+using ChunkedQuadtree = ChunkedNdtree<NodeDataT, 2, chunk_height, AllocatorT>;
+template <typename NodeDataT, int chunk_height,
+          typename AllocatorT = HeapAllocator>
+using ChunkedOctree = ChunkedNdtree<NodeDataT, 3, chunk_height, AllocatorT>;
 }  // namespace wavemap
 
 #include "wavemap/core/data_structure/chunked_ndtree/impl/chunked_ndtree_inl.h"
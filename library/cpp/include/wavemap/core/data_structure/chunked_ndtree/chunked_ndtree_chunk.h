@@ -4,15 +4,20 @@
 #include <array>
 #include <bitset>
 #include <limits>
-#include <memory>
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/indexing/ndtree_index.h"
 #include "wavemap/core/utils/math/tree_math.h"
+#include "wavemap/core/utils/memory/allocator_ref.h"
+#include "wavemap/core/utils/memory/heap_allocator.h"
 
 namespace wavemap {
-template <typename DataT, int dim, int height>
-class ChunkedNdtreeChunk {
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+class ChunkedNdtree;
+
+template <typename DataT, int dim, int height,
+          typename AllocatorT = HeapAllocator>
+class ChunkedNdtreeChunk : private AllocatorRef<AllocatorT> {
  public:
   static constexpr int kDim = dim;
   static constexpr int kHeight = height;
@@ -22,10 +27,19 @@ class ChunkedNdtreeChunk {
       tree_math::perfect_tree::num_leaf_nodes<dim>(height + 1);
 
   using DataType = DataT;
+  using AllocatorType = AllocatorT;
   using BitRef = typename std::bitset<kNumInnerNodes>::reference;
+  using NodeDataArray = std::array<DataT, kNumInnerNodes>;
+  using NodeChildBitset = std::bitset<kNumInnerNodes>;
 
   ChunkedNdtreeChunk() = default;
-  ~ChunkedNdtreeChunk() = default;
+  ~ChunkedNdtreeChunk() { deleteChildrenArray(); }
+
+  // Chunks own their children, so they can be moved but not copied
+  ChunkedNdtreeChunk(ChunkedNdtreeChunk&& other) noexcept;
+  ChunkedNdtreeChunk& operator=(ChunkedNdtreeChunk&& other) noexcept;
+  ChunkedNdtreeChunk(const ChunkedNdtreeChunk&) = delete;
+  ChunkedNdtreeChunk& operator=(const ChunkedNdtreeChunk&) = delete;
 
   bool empty() const;
   void clear();
@@ -36,9 +50,17 @@ class ChunkedNdtreeChunk {
   bool hasNonzeroData() const;
   bool hasNonzeroData(FloatingPoint threshold) const;
 
+  // Direct access to the data of all nodes, e.g. for bulk (de)serialization
+  NodeDataArray& getNodeDataArray() { return node_data_; }
+  const NodeDataArray& getNodeDataArray() const { return node_data_; }
+  NodeChildBitset& getNodeChildBitset() { return node_has_at_least_one_child_; }
+  const NodeChildBitset& getNodeChildBitset() const {
+    return node_has_at_least_one_child_;
+  }
+
   bool hasChildrenArray() const { return static_cast<bool>(child_chunks_); }
   bool hasAtLeastOneChild() const;
-  void deleteChildrenArray() { child_chunks_.reset(); }
+  void deleteChildrenArray();
 
   bool hasChild(LinearIndex relative_child_index) const;
   bool eraseChild(LinearIndex relative_child_index);
@@ -66,14 +88,22 @@ class ChunkedNdtreeChunk {
   }
 
  private:
-  using NodeDataArray = std::array<DataT, kNumInnerNodes>;
-  using NodeChildBitset = std::bitset<kNumInnerNodes>;
-  using ChunkPtr = std::unique_ptr<ChunkedNdtreeChunk>;
-  using ChildChunkArray = std::array<ChunkPtr, kNumChildren>;
+  using ChildChunkArray = std::array<ChunkedNdtreeChunk*, kNumChildren>;
 
   NodeDataArray node_data_{};
   NodeChildBitset node_has_at_least_one_child_{};
-  std::unique_ptr<ChildChunkArray> child_chunks_;
+  ChildChunkArray* child_chunks_ = nullptr;
+
+  // The tree sets the allocator of its root chunk, and releases all chunks at
+  // once if the allocator supports it
+  template <typename NodeDataT, int tree_dim, int chunk_height,
+            typename TreeAllocatorT>
+  friend class ChunkedNdtree;
+  void setAllocator(AllocatorT* allocator) {
+    static_cast<AllocatorRef<AllocatorT>&>(*this) =
+        AllocatorRef<AllocatorT>{allocator};
+  }
+  void releaseChildrenArray() { child_chunks_ = nullptr; }
 };
 }  // namespace wavemap
 
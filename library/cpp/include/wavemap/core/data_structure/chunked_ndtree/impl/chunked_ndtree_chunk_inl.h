@@ -1,41 +1,64 @@
 #ifndef WAVEMAP_CORE_DATA_STRUCTURE_CHUNKED_NDTREE_IMPL_CHUNKED_NDTREE_CHUNK_INL_H_
 #define WAVEMAP_CORE_DATA_STRUCTURE_CHUNKED_NDTREE_IMPL_CHUNKED_NDTREE_CHUNK_INL_H_
 
-#include <memory>
 #include <utility>
 
 #include "wavemap/core/utils/data/comparisons.h"
 
 namespace wavemap {
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::empty() const {
+template <typename DataT, int dim, int height, typename AllocatorT>
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::ChunkedNdtreeChunk(
+    ChunkedNdtreeChunk&& other) noexcept
+    : AllocatorRef<AllocatorT>(std::move(other)),
+      node_data_(std::move(other.node_data_)),
+      node_has_at_least_one_child_(other.node_has_at_least_one_child_),
+      child_chunks_(std::exchange(other.child_chunks_, nullptr)) {}
+
+template <typename DataT, int dim, int height, typename AllocatorT>
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>&
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::operator=(
+    ChunkedNdtreeChunk&& other) noexcept {
+  if (this != &other) {
+    deleteChildrenArray();
+    AllocatorRef<AllocatorT>::operator=(std::move(other));
+    node_data_ = std::move(other.node_data_);
+    node_has_at_least_one_child_ = other.node_has_at_least_one_child_;
+    child_chunks_ = std::exchange(other.child_chunks_, nullptr);
+  }
+  return *this;
+}
+
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::empty() const {
   return !hasChildrenArray() && !hasNonzeroData();
 }
 
-template <typename DataT, int dim, int height>
-void ChunkedNdtreeChunk<DataT, dim, height>::clear() {
+template <typename DataT, int dim, int height, typename AllocatorT>
+void ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::clear() {
   deleteChildrenArray();
   std::fill(node_data_.begin(), node_data_.end(), DataT{});
 }
 
-template <typename DataT, int dim, int height>
-size_t ChunkedNdtreeChunk<DataT, dim, height>::getMemoryUsage() const {
-  size_t memory_usage = sizeof(ChunkedNdtreeChunk<DataT, dim, height>);
+template <typename DataT, int dim, int height, typename AllocatorT>
+size_t ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::getMemoryUsage()
+    const {
+  size_t memory_usage = sizeof(ChunkedNdtreeChunk);
   if (hasChildrenArray()) {
     memory_usage += sizeof(ChildChunkArray);
   }
   return memory_usage;
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::hasNonzeroData() const {
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::hasNonzeroData()
+    const {
   return std::any_of(
       node_data_.cbegin(), node_data_.cend(),
       [](const auto& node_data) { return data::is_nonzero(node_data); });
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::hasNonzeroData(
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::hasNonzeroData(
     FloatingPoint threshold) const {
   return std::any_of(node_data_.cbegin(), node_data_.cend(),
                      [threshold](const auto& node_data) {
@@ -43,117 +66,136 @@ bool ChunkedNdtreeChunk<DataT, dim, height>::hasNonzeroData(
                      });
 }
 
-template <typename DataT, int dim, int height>
-DataT& ChunkedNdtreeChunk<DataT, dim, height>::nodeData(
+template <typename DataT, int dim, int height, typename AllocatorT>
+DataT& ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::nodeData(
     LinearIndex relative_node_index) {
   CHECK_GE(relative_node_index, 0u);
   CHECK_LT(relative_node_index, kNumInnerNodes);
   return node_data_[relative_node_index];
 }
 
-template <typename DataT, int dim, int height>
-const DataT& ChunkedNdtreeChunk<DataT, dim, height>::nodeData(
+template <typename DataT, int dim, int height, typename AllocatorT>
+const DataT& ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::nodeData(
     LinearIndex relative_node_index) const {
   CHECK_GE(relative_node_index, 0u);
   CHECK_LT(relative_node_index, kNumInnerNodes);
   return node_data_[relative_node_index];
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::hasAtLeastOneChild() const {
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::hasAtLeastOneChild()
+    const {
   if (hasChildrenArray()) {
     return std::any_of(
         child_chunks_->cbegin(), child_chunks_->cend(),
-        [](const auto& child_ptr) { return static_cast<bool>(child_ptr); });
+        [](const auto* child_ptr) { return static_cast<bool>(child_ptr); });
   }
   return false;
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::hasChild(
+template <typename DataT, int dim, int height, typename AllocatorT>
+void ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::deleteChildrenArray() {
+  if (hasChildrenArray()) {
+    AllocatorT& allocator = this->getAllocator();
+    for (ChunkedNdtreeChunk* child : *child_chunks_) {
+      allocator.destroy(child);
+    }
+    allocator.destroy(child_chunks_);
+    child_chunks_ = nullptr;
+  }
+}
+
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::hasChild(
     LinearIndex relative_child_index) const {
   return getChild(relative_child_index);
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::eraseChild(
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::eraseChild(
     LinearIndex relative_child_index) {
   if (hasChild(relative_child_index)) {
-    child_chunks_->operator[](relative_child_index).reset();
+    ChunkedNdtreeChunk*& child_ptr =
+        child_chunks_->operator[](relative_child_index);
+    this->getAllocator().destroy(child_ptr);
+    child_ptr = nullptr;
     return true;
   }
   return false;
 }
 
-template <typename DataT, int dim, int height>
-ChunkedNdtreeChunk<DataT, dim, height>*
-ChunkedNdtreeChunk<DataT, dim, height>::getChild(
+template <typename DataT, int dim, int height, typename AllocatorT>
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>*
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::getChild(
     LinearIndex relative_child_index) {
   CHECK_GE(relative_child_index, 0u);
   CHECK_LT(relative_child_index, kNumChildren);
   if (hasChildrenArray()) {
-    return child_chunks_->operator[](relative_child_index).get();
+    return child_chunks_->operator[](relative_child_index);
   }
   return nullptr;
 }
 
-template <typename DataT, int dim, int height>
-const ChunkedNdtreeChunk<DataT, dim, height>*
-ChunkedNdtreeChunk<DataT, dim, height>::getChild(
+template <typename DataT, int dim, int height, typename AllocatorT>
+const ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>*
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::getChild(
     LinearIndex relative_child_index) const {
   CHECK_GE(relative_child_index, 0u);
   CHECK_LT(relative_child_index, kNumChildren);
   if (hasChildrenArray()) {
-    return child_chunks_->operator[](relative_child_index).get();
+    return child_chunks_->operator[](relative_child_index);
   }
   return nullptr;
 }
 
-template <typename DataT, int dim, int height>
+template <typename DataT, int dim, int height, typename AllocatorT>
 template <typename... DefaultArgs>
-ChunkedNdtreeChunk<DataT, dim, height>&
-ChunkedNdtreeChunk<DataT, dim, height>::getOrAllocateChild(
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>&
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::getOrAllocateChild(
     LinearIndex relative_child_index, DefaultArgs&&... args) {
   CHECK_GE(relative_child_index, 0u);
   CHECK_LT(relative_child_index, kNumChildren);
+  AllocatorT& allocator = this->getAllocator();
   // Make sure the children array is allocated
   if (!hasChildrenArray()) {
-    child_chunks_ = std::make_unique<ChildChunkArray>();
+    child_chunks_ = allocator.template create<ChildChunkArray>();
   }
   // Get the child, allocating it if needed
-  ChunkPtr& child_smart_ptr = child_chunks_->operator[](relative_child_index);
-  if (!child_smart_ptr) {
-    child_smart_ptr = std::make_unique<ChunkedNdtreeChunk>(
+  ChunkedNdtreeChunk*& child_ptr =
+      child_chunks_->operator[](relative_child_index);
+  if (!child_ptr) {
+    child_ptr = allocator.template create<ChunkedNdtreeChunk>(
         std::forward<DefaultArgs>(args)...);
+    child_ptr->setAllocator(&allocator);
   }
   // Return a reference to the child
-  return *child_smart_ptr;
+  return *child_ptr;
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::nodeHasNonzeroData(
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::nodeHasNonzeroData(
     LinearIndex relative_node_index) const {
   DCHECK_LT(relative_node_index, kNumInnerNodes);
   return data::is_nonzero(node_data_[relative_node_index]);
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::nodeHasNonzeroData(
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::nodeHasNonzeroData(
     LinearIndex relative_node_index, FloatingPoint threshold) const {
   DCHECK_LT(relative_node_index, kNumInnerNodes);
   return data::is_nonzero(node_data_[relative_node_index], threshold);
 }
 
-template <typename DataT, int dim, int height>
-typename ChunkedNdtreeChunk<DataT, dim, height>::BitRef
-ChunkedNdtreeChunk<DataT, dim, height>::nodeHasAtLeastOneChild(
+template <typename DataT, int dim, int height, typename AllocatorT>
+typename ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::BitRef
+ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::nodeHasAtLeastOneChild(
     LinearIndex relative_node_index) {
   DCHECK_LT(relative_node_index, kNumInnerNodes);
   return node_has_at_least_one_child_[relative_node_index];
 }
 
-template <typename DataT, int dim, int height>
-bool ChunkedNdtreeChunk<DataT, dim, height>::nodeHasAtLeastOneChild(
+template <typename DataT, int dim, int height, typename AllocatorT>
+bool ChunkedNdtreeChunk<DataT, dim, height, AllocatorT>::nodeHasAtLeastOneChild(
     LinearIndex relative_node_index) const {
   DCHECK_LT(relative_node_index, kNumInnerNodes);
   return node_has_at_least_one_child_[relative_node_index];
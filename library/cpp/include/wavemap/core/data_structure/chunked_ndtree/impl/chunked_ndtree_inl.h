@@ -9,15 +9,49 @@
 #include "wavemap/core/indexing/index_conversions.h"
 
 namespace wavemap {
-template <typename NodeDataT, int dim, int chunk_height>
-ChunkedNdtree<NodeDataT, dim, chunk_height>::ChunkedNdtree(int max_height)
-    : max_height_(chunk_height *
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::ChunkedNdtree(
+    int max_height)
+    : allocator_(std::is_empty_v<AllocatorT> ? nullptr
+                                             : std::make_unique<AllocatorT>()),
+      max_height_(chunk_height *
                   int_math::div_round_up(max_height, chunk_height)) {
   CHECK_EQ(max_height_ % chunk_height, 0);
+  root_chunk_.setAllocator(allocator_.get());
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-size_t ChunkedNdtree<NodeDataT, dim, chunk_height>::size() const {
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::~ChunkedNdtree() {
+  if constexpr (kReleasesInBulk) {
+    // Drop all chunks at once, when the allocator is destroyed
+    root_chunk_.releaseChildrenArray();
+  }
+}
+
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+void ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::clear() {
+  if constexpr (kReleasesInBulk) {
+    root_chunk_.releaseChildrenArray();
+    root_chunk_.clear();
+    if (allocator_) {
+      allocator_->clear();
+    }
+  } else {
+    root_chunk_.clear();
+  }
+
+  // Trees that were moved from no longer own an allocator, so we give them a
+  // new one such that they can be reused
+  if constexpr (!std::is_empty_v<AllocatorT>) {
+    if (!allocator_) {
+      allocator_ = std::make_unique<AllocatorT>();
+      root_chunk_.setAllocator(allocator_.get());
+    }
+  }
+}
+
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+size_t ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::size() const {
   auto subtree_iterator =
       getChunkIterator<TraversalOrder::kDepthFirstPreorder>();
   const size_t num_chunks =
@@ -25,8 +59,8 @@ size_t ChunkedNdtree<NodeDataT, dim, chunk_height>::size() const {
   return num_chunks * ChunkType::kNumInnerNodes;
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-void ChunkedNdtree<NodeDataT, dim, chunk_height>::prune() {
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+void ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::prune() {
   for (ChunkType& chunk :
        getChunkIterator<TraversalOrder::kDepthFirstPostorder>()) {
     if (chunk.hasChildrenArray()) {
@@ -51,8 +85,15 @@ void ChunkedNdtree<NodeDataT, dim, chunk_height>::prune() {
   }
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-size_t ChunkedNdtree<NodeDataT, dim, chunk_height>::getMemoryUsage() const {
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+size_t ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::getMemoryUsage()
+    const {
+  // All chunks except for the root live in the arena's slabs, if there is one
+  if constexpr (AllocatorT::kReleasesInBulk) {
+    return sizeof(ChunkType) +
+           (allocator_ ? allocator_->getMemoryUsage() : 0u);
+  }
+
   size_t memory_usage = 0u;
 
   std::stack<const ChunkType*> stack;
@@ -75,9 +116,9 @@ size_t ChunkedNdtree<NodeDataT, dim, chunk_height>::getMemoryUsage() const {
   return memory_usage;
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-typename ChunkedNdtree<NodeDataT, dim, chunk_height>::NodePtrType
-ChunkedNdtree<NodeDataT, dim, chunk_height>::getNode(
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+typename ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::NodePtrType
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::getNode(
     const ChunkedNdtree::IndexType& index) {
   NodePtrType node = &getRootNode();
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
@@ -95,9 +136,10 @@ ChunkedNdtree<NodeDataT, dim, chunk_height>::getNode(
   return node;
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-typename ChunkedNdtree<NodeDataT, dim, chunk_height>::NodeConstPtrType
-ChunkedNdtree<NodeDataT, dim, chunk_height>::getNode(
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+typename ChunkedNdtree<NodeDataT, dim, chunk_height,
+                       AllocatorT>::NodeConstPtrType
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::getNode(
     const ChunkedNdtree::IndexType& index) const {
   NodeConstPtrType node = &getRootNode();
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
@@ -115,10 +157,10 @@ ChunkedNdtree<NodeDataT, dim, chunk_height>::getNode(
   return node;
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
 template <typename... DefaultArgs>
-typename ChunkedNdtree<NodeDataT, dim, chunk_height>::NodeRefType
-ChunkedNdtree<NodeDataT, dim, chunk_height>::getOrAllocateNode(
+typename ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::NodeRefType
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::getOrAllocateNode(
     const ChunkedNdtree::IndexType& index, DefaultArgs&&... args) {
   NodePtrType node = &getRootNode();
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
@@ -133,10 +175,12 @@ ChunkedNdtree<NodeDataT, dim, chunk_height>::getOrAllocateNode(
   return *node;
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-std::pair<typename ChunkedNdtree<NodeDataT, dim, chunk_height>::NodePtrType,
-          typename ChunkedNdtree<NodeDataT, dim, chunk_height>::HeightType>
-ChunkedNdtree<NodeDataT, dim, chunk_height>::getNodeOrAncestor(
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+std::pair<typename ChunkedNdtree<NodeDataT, dim, chunk_height,
+                                AllocatorT>::NodePtrType,
+          typename ChunkedNdtree<NodeDataT, dim, chunk_height,
+                                 AllocatorT>::HeightType>
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::getNodeOrAncestor(
     const ChunkedNdtree::IndexType& index) {
   NodePtrType node = &getRootNode();
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
@@ -154,11 +198,12 @@ ChunkedNdtree<NodeDataT, dim, chunk_height>::getNodeOrAncestor(
   return {node, index.height};
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
-std::pair<
-    typename ChunkedNdtree<NodeDataT, dim, chunk_height>::NodeConstPtrType,
-    typename ChunkedNdtree<NodeDataT, dim, chunk_height>::HeightType>
-ChunkedNdtree<NodeDataT, dim, chunk_height>::getNodeOrAncestor(
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
+std::pair<typename ChunkedNdtree<NodeDataT, dim, chunk_height,
+                                AllocatorT>::NodeConstPtrType,
+          typename ChunkedNdtree<NodeDataT, dim, chunk_height,
+                                 AllocatorT>::HeightType>
+ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::getNodeOrAncestor(
     const ChunkedNdtree::IndexType& index) const {
   NodeConstPtrType node = &getRootNode();
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
@@ -176,15 +221,17 @@ ChunkedNdtree<NodeDataT, dim, chunk_height>::getNodeOrAncestor(
   return {node, index.height};
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
 template <TraversalOrder traversal_order>
-auto ChunkedNdtree<NodeDataT, dim, chunk_height>::getChunkIterator() {
+auto ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::
+    getChunkIterator() {
   return Subtree<ChunkType, traversal_order>(&root_chunk_);
 }
 
-template <typename NodeDataT, int dim, int chunk_height>
+template <typename NodeDataT, int dim, int chunk_height, typename AllocatorT>
 template <TraversalOrder traversal_order>
-auto ChunkedNdtree<NodeDataT, dim, chunk_height>::getChunkIterator() const {
+auto ChunkedNdtree<NodeDataT, dim, chunk_height, AllocatorT>::
+    getChunkIterator() const {
   return Subtree<const ChunkType, traversal_order>(&root_chunk_);
 }
 }  // namespace wavemap
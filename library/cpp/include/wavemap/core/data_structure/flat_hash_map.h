@@ -0,0 +1,171 @@
+#ifndef WAVEMAP_CORE_DATA_STRUCTURE_FLAT_HASH_MAP_H_
+#define WAVEMAP_CORE_DATA_STRUCTURE_FLAT_HASH_MAP_H_
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wavemap {
+/**
+ * Hash map based on open addressing with Robin Hood hashing.
+ *
+ * The keys are stored in a flat array of slots, together with a pointer to
+ * their entry. Lookups therefore probe a few contiguous slots and only follow
+ * a single pointer once the key has been found. Since the entries themselves
+ * are never moved, pointers and references to them remain valid until they
+ * are erased, as for std::unordered_map. Iterators are invalidated by any
+ * insertion or erasure.
+ *
+ * The interface follows the subset of std::unordered_map's interface that is
+ * used by the SpatialHash.
+ */
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>>
+class FlatHashMap {
+ public:
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = std::pair<const KeyT, ValueT>;
+  using hasher = HashT;
+
+  template <bool is_const>
+  class Iterator;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() = default;
+  ~FlatHashMap() { clear(); }
+
+  FlatHashMap(const FlatHashMap& other);
+  FlatHashMap(FlatHashMap&& other) noexcept;
+  FlatHashMap& operator=(const FlatHashMap& other);
+  FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  void clear();
+  void reserve(size_t num_entries);
+
+  iterator begin() { return iterator{slots_.data(), slotsEnd()}; }
+  iterator end() { return iterator{slotsEnd(), slotsEnd()}; }
+  const_iterator begin() const {
+    return const_iterator{slots_.data(), slotsEnd()};
+  }
+  const_iterator end() const { return const_iterator{slotsEnd(), slotsEnd()}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  size_t count(const KeyT& key) const { return findSlot(key) ? 1u : 0u; }
+  iterator find(const KeyT& key);
+  const_iterator find(const KeyT& key) const;
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const KeyT& key, Args&&... args);
+
+  size_t erase(const KeyT& key);
+  iterator erase(iterator pos);
+
+ private:
+  struct Slot {
+    // Distance from the slot the key hashes to, plus one. Zero marks an empty
+    // slot.
+    uint32_t distance = 0;
+    KeyT key{};
+    value_type* entry = nullptr;
+  };
+
+  // NOTE: The table does not wrap around. Instead, it is extended with
+  //       max_distance_ overflow slots, and grown whenever a key would have to
+  //       be placed further than that from its ideal slot. This keeps the
+  //       slots in a cluster in order, such that erasing while iterating
+  //       never causes entries to be skipped or visited twice.
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+  size_t num_buckets_ = 0;
+  uint32_t max_distance_ = 0;
+  int hash_shift_ = 64;
+
+  static constexpr size_t kMinNumBuckets = 8;
+  static constexpr size_t kMaxLoadFactorPercent = 80;
+  static constexpr uint32_t kMinMaxDistance = 8;
+
+  const Slot* slotsEnd() const { return slots_.data() + slots_.size(); }
+  Slot* slotsEnd() { return slots_.data() + slots_.size(); }
+
+  size_t getIdealSlotIdx(const KeyT& key) const;
+  const Slot* findSlot(const KeyT& key) const;
+  Slot* findSlot(const KeyT& key) {
+    return const_cast<Slot*>(std::as_const(*this).findSlot(key));
+  }
+  // Place the entry with Robin Hood hashing, without growing the table.
+  // Returns the slot the entry was stored in and, if some entry was displaced
+  // beyond the table's max distance, the entry that could not be placed.
+  std::pair<Slot*, value_type*> placeEntry(value_type* entry);
+  void eraseSlot(Slot* slot);
+  void rehash(size_t num_buckets);
+};
+
+template <typename KeyT, typename ValueT, typename HashT>
+template <bool is_const>
+class FlatHashMap<KeyT, ValueT, HashT>::Iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = FlatHashMap::value_type;
+  using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+  using reference =
+      std::conditional_t<is_const, const value_type&, value_type&>;
+  using SlotPtr = std::conditional_t<is_const, const Slot*, Slot*>;
+
+  Iterator() = default;
+  Iterator(SlotPtr slot, SlotPtr end) : slot_(slot), end_(end) {
+    skipEmptySlots();
+  }
+  // Allow conversions from iterators to const_iterators
+  template <bool other_is_const,
+            std::enable_if_t<is_const && !other_is_const, bool> = true>
+  Iterator(const Iterator<other_is_const>& other)  // NOLINT
+      : slot_(other.slot_), end_(other.end_) {}
+
+  reference operator*() const { return *slot_->entry; }
+  pointer operator->() const { return slot_->entry; }
+
+  Iterator& operator++() {
+    ++slot_;
+    skipEmptySlots();
+    return *this;
+  }
+  Iterator operator++(int) {
+    Iterator previous = *this;
+    ++(*this);
+    return previous;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+    return lhs.slot_ == rhs.slot_;
+  }
+  friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  SlotPtr slot_ = nullptr;
+  SlotPtr end_ = nullptr;
+
+  void skipEmptySlots() {
+    while (slot_ != end_ && slot_->distance == 0) {
+      ++slot_;
+    }
+  }
+
+  friend class FlatHashMap;
+  template <bool>
+  friend class Iterator;
+};
+}  // namespace wavemap
+
+#include "wavemap/core/data_structure/impl/flat_hash_map_inl.h"
+
+#endif  // WAVEMAP_CORE_DATA_STRUCTURE_FLAT_HASH_MAP_H_
@@ -0,0 +1,233 @@
+#ifndef WAVEMAP_CORE_DATA_STRUCTURE_IMPL_FLAT_HASH_MAP_INL_H_
+#define WAVEMAP_CORE_DATA_STRUCTURE_IMPL_FLAT_HASH_MAP_INL_H_
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "wavemap/core/utils/math/int_math.h"
+
+namespace wavemap {
+template <typename KeyT, typename ValueT, typename HashT>
+FlatHashMap<KeyT, ValueT, HashT>::FlatHashMap(const FlatHashMap& other) {
+  reserve(other.size());
+  for (const auto& [key, value] : other) {
+    try_emplace(key, value);
+  }
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+FlatHashMap<KeyT, ValueT, HashT>::FlatHashMap(FlatHashMap&& other) noexcept
+    : slots_(std::move(other.slots_)),
+      size_(std::exchange(other.size_, 0)),
+      num_buckets_(std::exchange(other.num_buckets_, 0)),
+      max_distance_(std::exchange(other.max_distance_, 0)),
+      hash_shift_(std::exchange(other.hash_shift_, 64)) {
+  other.slots_.clear();
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+FlatHashMap<KeyT, ValueT, HashT>& FlatHashMap<KeyT, ValueT, HashT>::operator=(
+    const FlatHashMap& other) {
+  if (this != &other) {
+    *this = FlatHashMap(other);
+  }
+  return *this;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+FlatHashMap<KeyT, ValueT, HashT>& FlatHashMap<KeyT, ValueT, HashT>::operator=(
+    FlatHashMap&& other) noexcept {
+  if (this != &other) {
+    clear();
+    slots_ = std::move(other.slots_);
+    other.slots_.clear();
+    size_ = std::exchange(other.size_, 0);
+    num_buckets_ = std::exchange(other.num_buckets_, 0);
+    max_distance_ = std::exchange(other.max_distance_, 0);
+    hash_shift_ = std::exchange(other.hash_shift_, 64);
+  }
+  return *this;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+void FlatHashMap<KeyT, ValueT, HashT>::clear() {
+  for (Slot& slot : slots_) {
+    delete slot.entry;
+  }
+  slots_ = std::vector<Slot>{};
+  size_ = 0;
+  num_buckets_ = 0;
+  max_distance_ = 0;
+  hash_shift_ = 64;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+void FlatHashMap<KeyT, ValueT, HashT>::reserve(size_t num_entries) {
+  const size_t min_num_buckets =
+      int_math::div_round_up(num_entries * 100, kMaxLoadFactorPercent);
+  size_t num_buckets = kMinNumBuckets;
+  while (num_buckets < min_num_buckets) {
+    num_buckets *= 2;
+  }
+  if (num_buckets_ < num_buckets) {
+    rehash(num_buckets);
+  }
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+typename FlatHashMap<KeyT, ValueT, HashT>::iterator
+FlatHashMap<KeyT, ValueT, HashT>::find(const KeyT& key) {
+  if (Slot* slot = findSlot(key); slot) {
+    return iterator{slot, slotsEnd()};
+  }
+  return end();
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+typename FlatHashMap<KeyT, ValueT, HashT>::const_iterator
+FlatHashMap<KeyT, ValueT, HashT>::find(const KeyT& key) const {
+  if (const Slot* slot = findSlot(key); slot) {
+    return const_iterator{slot, slotsEnd()};
+  }
+  return end();
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+template <typename... Args>
+std::pair<typename FlatHashMap<KeyT, ValueT, HashT>::iterator, bool>
+FlatHashMap<KeyT, ValueT, HashT>::try_emplace(const KeyT& key,
+                                              Args&&... args) {
+  if (Slot* slot = findSlot(key); slot) {
+    return {iterator{slot, slotsEnd()}, false};
+  }
+
+  // Grow the table if its maximum load factor would be exceeded
+  if ((size_ + 1) * 100 > num_buckets_ * kMaxLoadFactorPercent) {
+    rehash(std::max(kMinNumBuckets, 2 * num_buckets_));
+  }
+
+  // Insert the new entry, growing the table while its keys cannot be placed
+  auto* entry =
+      new value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                     std::forward_as_tuple(std::forward<Args>(args)...));
+  auto [slot, pending_entry] = placeEntry(entry);
+  if (pending_entry) {
+    do {
+      rehash(2 * num_buckets_);
+      pending_entry = placeEntry(pending_entry).second;
+    } while (pending_entry);
+    slot = findSlot(key);
+  }
+  ++size_;
+
+  return {iterator{slot, slotsEnd()}, true};
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+size_t FlatHashMap<KeyT, ValueT, HashT>::erase(const KeyT& key) {
+  if (Slot* slot = findSlot(key); slot) {
+    eraseSlot(slot);
+    return 1u;
+  }
+  return 0u;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+typename FlatHashMap<KeyT, ValueT, HashT>::iterator
+FlatHashMap<KeyT, ValueT, HashT>::erase(iterator pos) {
+  // NOTE: Erasing shifts the next entries of the cluster back by one slot,
+  //       such that the next entry to visit is now in the erased slot.
+  Slot* slot = pos.slot_;
+  eraseSlot(slot);
+  return iterator{slot, slotsEnd()};
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+size_t FlatHashMap<KeyT, ValueT, HashT>::getIdealSlotIdx(
+    const KeyT& key) const {
+  // Fibonacci hashing, to spread keys whose hashes only differ in their lower
+  // bits, such as Morton codes of nearby indices, across the whole table
+  constexpr uint64_t kFibonacciMultiplier = 11400714819323198485ull;
+  return (static_cast<uint64_t>(HashT{}(key)) * kFibonacciMultiplier) >>
+         hash_shift_;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+const typename FlatHashMap<KeyT, ValueT, HashT>::Slot*
+FlatHashMap<KeyT, ValueT, HashT>::findSlot(const KeyT& key) const {
+  if (empty()) {
+    return nullptr;
+  }
+  const Slot* slot = &slots_[getIdealSlotIdx(key)];
+  for (uint32_t distance = 1; distance <= max_distance_; ++distance, ++slot) {
+    // Thanks to the Robin Hood invariant, the key cannot be stored further
+    // than the first slot whose entry is closer to its ideal slot
+    if (slot->distance < distance) {
+      return nullptr;
+    }
+    if (slot->distance == distance && slot->key == key) {
+      return slot;
+    }
+  }
+  return nullptr;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+std::pair<typename FlatHashMap<KeyT, ValueT, HashT>::Slot*,
+          typename FlatHashMap<KeyT, ValueT, HashT>::value_type*>
+FlatHashMap<KeyT, ValueT, HashT>::placeEntry(value_type* entry) {
+  Slot carried{1, entry->first, entry};
+  Slot* slot = &slots_[getIdealSlotIdx(carried.key)];
+  Slot* entry_slot = nullptr;
+  for (; carried.distance <= max_distance_; ++carried.distance, ++slot) {
+    if (slot->distance == 0) {
+      *slot = std::move(carried);
+      return {entry_slot ? entry_slot : slot, nullptr};
+    }
+    // Take the slot from entries that are closer to their ideal slot
+    if (slot->distance < carried.distance) {
+      std::swap(*slot, carried);
+      if (!entry_slot) {
+        entry_slot = slot;
+      }
+    }
+  }
+  return {entry_slot, carried.entry};
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+void FlatHashMap<KeyT, ValueT, HashT>::eraseSlot(Slot* slot) {
+  delete slot->entry;
+  // Shift the next entries of the cluster back by one slot (backward shift
+  // deletion), such that no tombstones are needed
+  for (Slot* next = slot + 1; next != slotsEnd() && 1 < next->distance;
+       slot = next++) {
+    *slot = std::move(*next);
+    --slot->distance;
+  }
+  *slot = Slot{};
+  --size_;
+}
+
+template <typename KeyT, typename ValueT, typename HashT>
+void FlatHashMap<KeyT, ValueT, HashT>::rehash(size_t num_buckets) {
+  std::vector<Slot> old_slots = std::move(slots_);
+  for (bool success = false; !success; num_buckets *= 2) {
+    const int num_buckets_log2 = int_math::log2_floor(num_buckets);
+    num_buckets_ = num_buckets;
+    hash_shift_ = 64 - num_buckets_log2;
+    max_distance_ =
+        std::max(kMinMaxDistance, static_cast<uint32_t>(num_buckets_log2));
+    slots_.assign(num_buckets_ + max_distance_, Slot{});
+    success = std::all_of(old_slots.begin(), old_slots.end(),
+                          [this](const Slot& old_slot) {
+                            return old_slot.distance == 0 ||
+                                   !placeEntry(old_slot.entry).second;
+                          });
+  }
+}
+}  // namespace wavemap
+
+#endif  // WAVEMAP_CORE_DATA_STRUCTURE_IMPL_FLAT_HASH_MAP_INL_H_
@@ -13,8 +13,10 @@ Index<dim> indexToBlockIndex(const Index<dim>& index,
 }
 }  // namespace convert
 
-template <typename BlockDataT, int dim>
-Index<dim> SpatialHash<BlockDataT, dim>::getMinBlockIndex() const {
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+Index<dim> SpatialHash<BlockDataT, dim, BlockHashMapT>::getMinBlockIndex()
+    const {
   if (empty()) {
     return Index<kDim>::Zero();
   }
@@ -28,8 +30,10 @@ Index<dim> SpatialHash<BlockDataT, dim>::getMinBlockIndex() const {
   return min_block_index;
 }
 
-template <typename BlockDataT, int dim>
-Index<dim> SpatialHash<BlockDataT, dim>::getMaxBlockIndex() const {
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+Index<dim> SpatialHash<BlockDataT, dim, BlockHashMapT>::getMaxBlockIndex()
+    const {
   if (empty()) {
     return Index<kDim>::Zero();
   }
@@ -43,21 +47,24 @@ Index<dim> SpatialHash<BlockDataT, dim>::getMaxBlockIndex() const {
   return max_block_index;
 }
 
-template <typename BlockDataT, int dim>
-bool SpatialHash<BlockDataT, dim>::hasBlock(
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+bool SpatialHash<BlockDataT, dim, BlockHashMapT>::hasBlock(
     const SpatialHash::BlockIndex& block_index) const {
   return block_map_.count(block_index);
 }
 
-template <typename BlockDataT, int dim>
-bool SpatialHash<BlockDataT, dim>::eraseBlock(
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+bool SpatialHash<BlockDataT, dim, BlockHashMapT>::eraseBlock(
     const SpatialHash::BlockIndex& block_index) {
   return block_map_.erase(block_index);
 }
 
-template <typename BlockDataT, int dim>
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
 template <typename IndexedBlockVisitor>
-void SpatialHash<BlockDataT, dim>::eraseBlockIf(
+void SpatialHash<BlockDataT, dim, BlockHashMapT>::eraseBlockIf(
     IndexedBlockVisitor indicator_fn) {
   for (auto it = block_map_.begin(); it != block_map_.end();) {
     const BlockIndex& block_index = it->first;
@@ -70,9 +77,10 @@ void SpatialHash<BlockDataT, dim>::eraseBlockIf(
   }
 }
 
-template <typename BlockDataT, int dim>
-typename SpatialHash<BlockDataT, dim>::BlockData*
-SpatialHash<BlockDataT, dim>::getBlock(
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+typename SpatialHash<BlockDataT, dim, BlockHashMapT>::BlockData*
+SpatialHash<BlockDataT, dim, BlockHashMapT>::getBlock(
     const SpatialHash::BlockIndex& block_index) {
   const auto& it = block_map_.find(block_index);
   if (it != block_map_.end()) {
@@ -82,9 +90,10 @@ SpatialHash<BlockDataT, dim>::getBlock(
   }
 }
 
-template <typename BlockDataT, int dim>
-const typename SpatialHash<BlockDataT, dim>::BlockData*
-SpatialHash<BlockDataT, dim>::getBlock(
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+const typename SpatialHash<BlockDataT, dim, BlockHashMapT>::BlockData*
+SpatialHash<BlockDataT, dim, BlockHashMapT>::getBlock(
     const SpatialHash::BlockIndex& block_index) const {
   const auto& it = block_map_.find(block_index);
   if (it != block_map_.end()) {
@@ -94,27 +103,30 @@ SpatialHash<BlockDataT, dim>::getBlock(
   }
 }
 
-template <typename BlockDataT, int dim>
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
 template <typename... DefaultArgs>
-typename SpatialHash<BlockDataT, dim>::BlockData&
-SpatialHash<BlockDataT, dim>::getOrAllocateBlock(
+typename SpatialHash<BlockDataT, dim, BlockHashMapT>::BlockData&
+SpatialHash<BlockDataT, dim, BlockHashMapT>::getOrAllocateBlock(
     const SpatialHash::BlockIndex& block_index, DefaultArgs&&... args) {
   return block_map_.try_emplace(block_index, std::forward<DefaultArgs>(args)...)
       .first->second;
 }
 
-template <typename BlockDataT, int dim>
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
 template <typename IndexedBlockVisitor>
-void SpatialHash<BlockDataT, dim>::forEachBlock(
+void SpatialHash<BlockDataT, dim, BlockHashMapT>::forEachBlock(
     IndexedBlockVisitor visitor_fn) {
   for (auto& [block_index, block_data] : block_map_) {
     std::invoke(visitor_fn, block_index, block_data);
   }
 }
 
-template <typename BlockDataT, int dim>
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
 template <typename IndexedBlockVisitor>
-void SpatialHash<BlockDataT, dim>::forEachBlock(
+void SpatialHash<BlockDataT, dim, BlockHashMapT>::forEachBlock(
     IndexedBlockVisitor visitor_fn) const {
   for (const auto& [block_index, block_data] : block_map_) {
     std::invoke(visitor_fn, block_index, block_data);
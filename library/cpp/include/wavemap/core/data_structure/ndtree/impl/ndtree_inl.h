@@ -9,21 +9,56 @@
 #include "wavemap/core/indexing/index_conversions.h"
 
 namespace wavemap {
-template <typename NodeDataT, int dim>
+template <typename NodeDataT, int dim, typename AllocatorT>
 template <typename... RootNodeArgs>
-Ndtree<NodeDataT, dim>::Ndtree(int max_height, RootNodeArgs&&... args)
-    : max_height_(max_height), root_node_(std::forward<RootNodeArgs>(args)...) {
+Ndtree<NodeDataT, dim, AllocatorT>::Ndtree(int max_height,
+                                           RootNodeArgs&&... args)
+    : max_height_(max_height),
+      allocator_(std::is_empty_v<AllocatorT> ? nullptr
+                                             : std::make_unique<AllocatorT>()),
+      root_node_(std::forward<RootNodeArgs>(args)...) {
   CHECK_LE(max_height_, morton::kMaxTreeHeight<dim>);
+  root_node_.setAllocator(allocator_.get());
 }
 
-template <typename NodeDataT, int dim>
-size_t Ndtree<NodeDataT, dim>::size() const {
+template <typename NodeDataT, int dim, typename AllocatorT>
+Ndtree<NodeDataT, dim, AllocatorT>::~Ndtree() {
+  if constexpr (kReleasesInBulk) {
+    // Drop all nodes at once, when the allocator is destroyed
+    root_node_.releaseChildrenArray();
+  }
+}
+
+template <typename NodeDataT, int dim, typename AllocatorT>
+void Ndtree<NodeDataT, dim, AllocatorT>::clear() {
+  if constexpr (kReleasesInBulk) {
+    root_node_.releaseChildrenArray();
+    root_node_.data() = NodeDataT{};
+    if (allocator_) {
+      allocator_->clear();
+    }
+  } else {
+    root_node_.clear();
+  }
+
+  // Trees that were moved from no longer own an allocator, so we give them a
+  // new one such that they can be reused
+  if constexpr (!std::is_empty_v<AllocatorT>) {
+    if (!allocator_) {
+      allocator_ = std::make_unique<AllocatorT>();
+      root_node_.setAllocator(allocator_.get());
+    }
+  }
+}
+
+template <typename NodeDataT, int dim, typename AllocatorT>
+size_t Ndtree<NodeDataT, dim, AllocatorT>::size() const {
   auto subtree_iterator = getIterator<TraversalOrder::kDepthFirstPreorder>();
   return std::distance(subtree_iterator.begin(), subtree_iterator.end());
 }
 
-template <typename NodeDataT, int dim>
-void Ndtree<NodeDataT, dim>::prune() {
+template <typename NodeDataT, int dim, typename AllocatorT>
+void Ndtree<NodeDataT, dim, AllocatorT>::prune() {
   for (NodeType& node : getIterator<TraversalOrder::kDepthFirstPostorder>()) {
     if (node.hasChildrenArray()) {
       bool has_non_empty_child = false;
@@ -46,8 +81,13 @@ void Ndtree<NodeDataT, dim>::prune() {
   }
 }
 
-template <typename NodeDataT, int dim>
-size_t Ndtree<NodeDataT, dim>::getMemoryUsage() const {
+template <typename NodeDataT, int dim, typename AllocatorT>
+size_t Ndtree<NodeDataT, dim, AllocatorT>::getMemoryUsage() const {
+  // All nodes except for the root live in the arena's slabs, if there is one
+  if constexpr (AllocatorT::kReleasesInBulk) {
+    return sizeof(NodeType) + (allocator_ ? allocator_->getMemoryUsage() : 0u);
+  }
+
   size_t memory_usage = 0u;
   for (const NodeType& node :
        getIterator<TraversalOrder::kDepthFirstPreorder>()) {
@@ -56,8 +96,8 @@ size_t Ndtree<NodeDataT, dim>::getMemoryUsage() const {
   return memory_usage;
 }
 
-template <typename NodeDataT, int dim>
-bool Ndtree<NodeDataT, dim>::eraseNode(const IndexType& index) {
+template <typename NodeDataT, int dim, typename AllocatorT>
+bool Ndtree<NodeDataT, dim, AllocatorT>::eraseNode(const IndexType& index) {
   IndexType parent_index = index.computeParentIndex();
   NodeType* parent_node = getNode(parent_index);
   if (parent_node) {
@@ -66,15 +106,15 @@ bool Ndtree<NodeDataT, dim>::eraseNode(const IndexType& index) {
   return false;
 }
 
-template <typename NodeDataT, int dim>
-typename Ndtree<NodeDataT, dim>::NodeType* Ndtree<NodeDataT, dim>::getNode(
-    const IndexType& index) {
+template <typename NodeDataT, int dim, typename AllocatorT>
+typename Ndtree<NodeDataT, dim, AllocatorT>::NodeType*
+Ndtree<NodeDataT, dim, AllocatorT>::getNode(const IndexType& index) {
   return const_cast<NodeType*>(std::as_const(*this).getNode(index));
 }
 
-template <typename NodeDataT, int dim>
-const typename Ndtree<NodeDataT, dim>::NodeType*
-Ndtree<NodeDataT, dim>::getNode(const IndexType& index) const {
+template <typename NodeDataT, int dim, typename AllocatorT>
+const typename Ndtree<NodeDataT, dim, AllocatorT>::NodeType*
+Ndtree<NodeDataT, dim, AllocatorT>::getNode(const IndexType& index) const {
   const NodeType* node = &root_node_;
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
   for (int node_height = max_height_; index.height < node_height;
@@ -91,11 +131,11 @@ Ndtree<NodeDataT, dim>::getNode(const IndexType& index) const {
   return node;
 }
 
-template <typename NodeDataT, int dim>
+template <typename NodeDataT, int dim, typename AllocatorT>
 template <typename... DefaultArgs>
-typename Ndtree<NodeDataT, dim>::NodeType&
-Ndtree<NodeDataT, dim>::getOrAllocateNode(const Ndtree::IndexType& index,
-                                          DefaultArgs&&... args) {
+typename Ndtree<NodeDataT, dim, AllocatorT>::NodeType&
+Ndtree<NodeDataT, dim, AllocatorT>::getOrAllocateNode(
+    const Ndtree::IndexType& index, DefaultArgs&&... args) {
   NodeType* node = &root_node_;
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
   for (int node_height = max_height_; index.height < node_height;
@@ -109,16 +149,18 @@ Ndtree<NodeDataT, dim>::getOrAllocateNode(const Ndtree::IndexType& index,
   return *node;
 }
 
-template <typename NodeDataT, int dim>
-std::pair<typename Ndtree<NodeDataT, dim>::NodeType*, IndexElement>
-Ndtree<NodeDataT, dim>::getNodeOrAncestor(const Ndtree::IndexType& index) {
+template <typename NodeDataT, int dim, typename AllocatorT>
+std::pair<typename Ndtree<NodeDataT, dim, AllocatorT>::NodeType*, IndexElement>
+Ndtree<NodeDataT, dim, AllocatorT>::getNodeOrAncestor(
+    const Ndtree::IndexType& index) {
   auto rv = std::as_const(*this).getNodeOrAncestor(index);
   return {const_cast<NodeType*>(rv.first), rv.second};
 }
 
-template <typename NodeDataT, int dim>
-std::pair<const typename Ndtree<NodeDataT, dim>::NodeType*, IndexElement>
-Ndtree<NodeDataT, dim>::getNodeOrAncestor(
+template <typename NodeDataT, int dim, typename AllocatorT>
+std::pair<const typename Ndtree<NodeDataT, dim, AllocatorT>::NodeType*,
+          IndexElement>
+Ndtree<NodeDataT, dim, AllocatorT>::getNodeOrAncestor(
     const Ndtree::IndexType& index) const {
   const NodeType* node = &root_node_;
   const MortonIndex morton_code = convert::nodeIndexToMorton(index);
@@ -136,15 +178,15 @@ Ndtree<NodeDataT, dim>::getNodeOrAncestor(
   return {node, index.height};
 }
 
-template <typename NodeDataT, int dim>
+template <typename NodeDataT, int dim, typename AllocatorT>
 template <TraversalOrder traversal_order>
-auto Ndtree<NodeDataT, dim>::getIterator() {
+auto Ndtree<NodeDataT, dim, AllocatorT>::getIterator() {
   return Subtree<NodeType, traversal_order>(&root_node_);
 }
 
-template <typename NodeDataT, int dim>
+template <typename NodeDataT, int dim, typename AllocatorT>
 template <TraversalOrder traversal_order>
-auto Ndtree<NodeDataT, dim>::getIterator() const {
+auto Ndtree<NodeDataT, dim, AllocatorT>::getIterator() const {
   return Subtree<const NodeType, traversal_order>(&root_node_);
 }
 }  // namespace wavemap
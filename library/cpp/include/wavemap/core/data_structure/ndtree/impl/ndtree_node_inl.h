@@ -1,44 +1,62 @@
 #ifndef WAVEMAP_CORE_DATA_STRUCTURE_NDTREE_IMPL_NDTREE_NODE_INL_H_
 #define WAVEMAP_CORE_DATA_STRUCTURE_NDTREE_IMPL_NDTREE_NODE_INL_H_
 
-#include <memory>
 #include <utility>
 
 #include "wavemap/core/utils/data/comparisons.h"
 
 namespace wavemap {
-template <typename DataT, int dim>
-bool NdtreeNode<DataT, dim>::empty() const {
+template <typename DataT, int dim, typename AllocatorT>
+NdtreeNode<DataT, dim, AllocatorT>::NdtreeNode(NdtreeNode&& other) noexcept
+    : AllocatorRef<AllocatorT>(std::move(other)),
+      data_(std::move(other.data_)),
+      children_(std::exchange(other.children_, nullptr)) {}
+
+template <typename DataT, int dim, typename AllocatorT>
+NdtreeNode<DataT, dim, AllocatorT>&
+NdtreeNode<DataT, dim, AllocatorT>::operator=(NdtreeNode&& other) noexcept {
+  if (this != &other) {
+    deleteChildrenArray();
+    AllocatorRef<AllocatorT>::operator=(std::move(other));
+    data_ = std::move(other.data_);
+    children_ = std::exchange(other.children_, nullptr);
+  }
+  return *this;
+}
+
+template <typename DataT, int dim, typename AllocatorT>
+bool NdtreeNode<DataT, dim, AllocatorT>::empty() const {
   return !hasChildrenArray() && !hasNonzeroData();
 }
 
-template <typename DataT, int dim>
-void NdtreeNode<DataT, dim>::clear() {
+template <typename DataT, int dim, typename AllocatorT>
+void NdtreeNode<DataT, dim, AllocatorT>::clear() {
   deleteChildrenArray();
   data() = DataT{};
 }
 
-template <typename DataT, int dim>
-size_t NdtreeNode<DataT, dim>::getMemoryUsage() const {
-  size_t memory_usage = sizeof(NdtreeNode<DataT, dim>);
+template <typename DataT, int dim, typename AllocatorT>
+size_t NdtreeNode<DataT, dim, AllocatorT>::getMemoryUsage() const {
+  size_t memory_usage = sizeof(NdtreeNode<DataT, dim, AllocatorT>);
   if (hasChildrenArray()) {
     memory_usage += sizeof(ChildrenArray);
   }
   return memory_usage;
 }
 
-template <typename DataT, int dim>
-bool NdtreeNode<DataT, dim>::hasNonzeroData() const {
+template <typename DataT, int dim, typename AllocatorT>
+bool NdtreeNode<DataT, dim, AllocatorT>::hasNonzeroData() const {
   return data::is_nonzero(data_);
 }
 
-template <typename DataT, int dim>
-bool NdtreeNode<DataT, dim>::hasNonzeroData(FloatingPoint threshold) const {
+template <typename DataT, int dim, typename AllocatorT>
+bool NdtreeNode<DataT, dim, AllocatorT>::hasNonzeroData(
+    FloatingPoint threshold) const {
   return data::is_nonzero(data_, threshold);
 }
 
-template <typename DataT, int dim>
-bool NdtreeNode<DataT, dim>::hasAtLeastOneChild() const {
+template <typename DataT, int dim, typename AllocatorT>
+bool NdtreeNode<DataT, dim, AllocatorT>::hasAtLeastOneChild() const {
   if (hasChildrenArray()) {
     for (NdtreeIndexRelativeChild child_idx = 0; child_idx < kNumChildren;
          ++child_idx) {
@@ -50,61 +68,81 @@ bool NdtreeNode<DataT, dim>::hasAtLeastOneChild() const {
   return false;
 }
 
-template <typename DataT, int dim>
-bool NdtreeNode<DataT, dim>::hasChild(
+template <typename DataT, int dim, typename AllocatorT>
+void NdtreeNode<DataT, dim, AllocatorT>::deleteChildrenArray() {
+  if (hasChildrenArray()) {
+    AllocatorT& allocator = this->getAllocator();
+    for (NdtreeNode* child : *children_) {
+      allocator.destroy(child);
+    }
+    allocator.destroy(children_);
+    children_ = nullptr;
+  }
+}
+
+template <typename DataT, int dim, typename AllocatorT>
+bool NdtreeNode<DataT, dim, AllocatorT>::hasChild(
     NdtreeIndexRelativeChild child_index) const {
   return getChild(child_index);
 }
 
-template <typename DataT, int dim>
-bool NdtreeNode<DataT, dim>::eraseChild(NdtreeIndexRelativeChild child_index) {
+template <typename DataT, int dim, typename AllocatorT>
+bool NdtreeNode<DataT, dim, AllocatorT>::eraseChild(
+    NdtreeIndexRelativeChild child_index) {
   CHECK_GE(child_index, 0u);
   CHECK_LT(child_index, kNumChildren);
   if (hasChildrenArray()) {
-    children_->operator[](child_index).reset();
+    NdtreeNode*& child_ptr = children_->operator[](child_index);
+    this->getAllocator().destroy(child_ptr);
+    child_ptr = nullptr;
     return true;
   }
   return false;
 }
 
-template <typename DataT, int dim>
-NdtreeNode<DataT, dim>* NdtreeNode<DataT, dim>::getChild(
+template <typename DataT, int dim, typename AllocatorT>
+NdtreeNode<DataT, dim, AllocatorT>*
+NdtreeNode<DataT, dim, AllocatorT>::getChild(
     NdtreeIndexRelativeChild child_index) {
   CHECK_GE(child_index, 0u);
   CHECK_LT(child_index, kNumChildren);
   if (hasChildrenArray()) {
-    return children_->operator[](child_index).get();
+    return children_->operator[](child_index);
   }
   return nullptr;
 }
 
-template <typename DataT, int dim>
-const NdtreeNode<DataT, dim>* NdtreeNode<DataT, dim>::getChild(
+template <typename DataT, int dim, typename AllocatorT>
+const NdtreeNode<DataT, dim, AllocatorT>*
+NdtreeNode<DataT, dim, AllocatorT>::getChild(
     NdtreeIndexRelativeChild child_index) const {
   if (hasChildrenArray()) {
-    return children_->operator[](child_index).get();
+    return children_->operator[](child_index);
   }
   return nullptr;
 }
 
-template <typename DataT, int dim>
+template <typename DataT, int dim, typename AllocatorT>
 template <typename... DefaultArgs>
-NdtreeNode<DataT, dim>& NdtreeNode<DataT, dim>::getOrAllocateChild(
+NdtreeNode<DataT, dim, AllocatorT>&
+NdtreeNode<DataT, dim, AllocatorT>::getOrAllocateChild(
     NdtreeIndexRelativeChild child_index, DefaultArgs&&... args) {
   CHECK_GE(child_index, 0u);
   CHECK_LT(child_index, kNumChildren);
+  AllocatorT& allocator = this->getAllocator();
   // Make sure the children array is allocated
   if (!hasChildrenArray()) {
-    children_ = std::make_unique<ChildrenArray>();
+    children_ = allocator.template create<ChildrenArray>();
   }
   // Get the child, allocating it if needed
-  ChildPtr& child_smart_ptr = children_->operator[](child_index);
-  if (!child_smart_ptr) {
-    child_smart_ptr =
-        std::make_unique<NdtreeNode>(std::forward<DefaultArgs>(args)...);
+  NdtreeNode*& child_ptr = children_->operator[](child_index);
+  if (!child_ptr) {
+    child_ptr = allocator.template create<NdtreeNode>(
+        std::forward<DefaultArgs>(args)...);
+    child_ptr->setAllocator(&allocator);
   }
   // Return a reference to the child
-  return *child_smart_ptr;
+  return *child_ptr;
 }
 }  // namespace wavemap
 
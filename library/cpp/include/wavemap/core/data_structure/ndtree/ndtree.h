@@ -1,7 +1,9 @@
 #ifndef WAVEMAP_CORE_DATA_STRUCTURE_NDTREE_NDTREE_H_
 #define WAVEMAP_CORE_DATA_STRUCTURE_NDTREE_NDTREE_H_
 
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -9,24 +11,36 @@
 #include "wavemap/core/data_structure/ndtree/ndtree_node.h"
 #include "wavemap/core/indexing/ndtree_index.h"
 #include "wavemap/core/utils/iterate/subtree_iterator.h"
+#include "wavemap/core/utils/memory/heap_allocator.h"
 
 namespace wavemap {
-template <typename NodeDataT, int dim>
+/**
+ * Pointer-based n-dimensional tree.
+ *
+ * The nodes are allocated with the AllocatorT, which defaults to individual
+ * heap allocations. Trees that use an allocator which supports it, such as the
+ * ArenaAllocator, own a private allocator instance and free all their nodes at
+ * once when they are cleared or destroyed.
+ */
+template <typename NodeDataT, int dim, typename AllocatorT = HeapAllocator>
 class Ndtree {
  public:
   using IndexType = NdtreeIndex<dim>;
   using HeightType = IndexElement;
-  using NodeType = NdtreeNode<NodeDataT, dim>;
+  using NodeType = NdtreeNode<NodeDataT, dim, AllocatorT>;
   using NodeDataType = NodeDataT;
+  using AllocatorType = AllocatorT;
   static constexpr HeightType kChunkHeight = 1;
 
   template <typename... RootNodeArgs>
   explicit Ndtree(HeightType max_height, RootNodeArgs&&... args);
-  ~Ndtree() = default;
+  ~Ndtree();
+
+  Ndtree(Ndtree&&) noexcept = default;
 
   bool empty() const { return root_node_.empty(); }
   size_t size() const;
-  void clear() { root_node_.clear(); }
+  void clear();
   void prune();
 
   HeightType getMaxHeight() const { return max_height_; }
@@ -52,16 +66,24 @@ class Ndtree {
   auto getIterator() const;
 
  private:
+  // Nodes can only be freed in bulk if skipping their destructors is safe
+  static constexpr bool kReleasesInBulk =
+      AllocatorT::kReleasesInBulk &&
+      std::is_trivially_destructible_v<NodeDataT>;
+
   const HeightType max_height_;
+  // NOTE: The allocator is declared before the root node, such that it outlives
+  //       it. It is only instantiated for stateful allocators.
+  std::unique_ptr<AllocatorT> allocator_;
   NodeType root_node_;
 };
 
-template <typename NodeDataT>
-using BinaryTree = Ndtree<NodeDataT, 1>;
-template <typename NodeDataT>
-using Quadtree = Ndtree<NodeDataT, 2>;
-template <typename NodeDataT>
-using Octree = Ndtree<NodeDataT, 3>;
+template <typename NodeDataT, typename AllocatorT = HeapAllocator>
+using BinaryTree = Ndtree<NodeDataT, 1, AllocatorT>;
+template <typename NodeDataT, typename AllocatorT = HeapAllocator>
+using Quadtree = Ndtree<NodeDataT, 2, AllocatorT>;
+template <typename NodeDataT, typename AllocatorT = HeapAllocator>
+using Octree = Ndtree<NodeDataT, 3, AllocatorT>;
 }  // namespace wavemap
 
 #include "wavemap/core/data_structure/ndtree/impl/ndtree_inl.h"
@@ -2,23 +2,34 @@
 #define WAVEMAP_CORE_DATA_STRUCTURE_NDTREE_NDTREE_NODE_H_
 
 #include <array>
-#include <memory>
 #include <utility>
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/indexing/ndtree_index.h"
+#include "wavemap/core/utils/memory/allocator_ref.h"
+#include "wavemap/core/utils/memory/heap_allocator.h"
 
 namespace wavemap {
-template <typename DataT, int dim>
-class NdtreeNode {
+template <typename NodeDataT, int dim, typename AllocatorT>
+class Ndtree;
+
+template <typename DataT, int dim, typename AllocatorT = HeapAllocator>
+class NdtreeNode : private AllocatorRef<AllocatorT> {
  public:
   using DataType = DataT;
+  using AllocatorType = AllocatorT;
   static constexpr int kNumChildren = NdtreeIndex<dim>::kNumChildren;
 
   NdtreeNode() = default;
   template <typename... Args>
   explicit NdtreeNode(Args&&... args) : data_(std::forward<Args>(args)...) {}
-  ~NdtreeNode() = default;
+  ~NdtreeNode() { deleteChildrenArray(); }
+
+  // Nodes own their children, so they can be moved but not copied
+  NdtreeNode(NdtreeNode&& other) noexcept;
+  NdtreeNode& operator=(NdtreeNode&& other) noexcept;
+  NdtreeNode(const NdtreeNode&) = delete;
+  NdtreeNode& operator=(const NdtreeNode&) = delete;
 
   bool empty() const;
   void clear();
@@ -32,7 +43,7 @@ class NdtreeNode {
 
   bool hasChildrenArray() const { return static_cast<bool>(children_); }
   bool hasAtLeastOneChild() const;
-  void deleteChildrenArray() { children_.reset(); }
+  void deleteChildrenArray();
 
   bool hasChild(NdtreeIndexRelativeChild child_index) const;
   bool eraseChild(NdtreeIndexRelativeChild child_index);
@@ -48,11 +59,19 @@ class NdtreeNode {
   }
 
  private:
-  using ChildPtr = std::unique_ptr<NdtreeNode>;
-  using ChildrenArray = std::array<ChildPtr, kNumChildren>;
+  using ChildrenArray = std::array<NdtreeNode*, kNumChildren>;
 
   DataT data_{};
-  std::unique_ptr<ChildrenArray> children_;
+  ChildrenArray* children_ = nullptr;
+
+  // The tree sets the allocator of its root node, and releases all nodes at
+  // once if the allocator supports it
+  friend class Ndtree<DataT, dim, AllocatorT>;
+  void setAllocator(AllocatorT* allocator) {
+    static_cast<AllocatorRef<AllocatorT>&>(*this) =
+        AllocatorRef<AllocatorT>{allocator};
+  }
+  void releaseChildrenArray() { children_ = nullptr; }
 };
 }  // namespace wavemap
 
@@ -4,6 +4,7 @@
 #include <unordered_map>
 
 #include "wavemap/core/common.h"
+#include "wavemap/core/data_structure/flat_hash_map.h"
 #include "wavemap/core/indexing/index_conversions.h"
 #include "wavemap/core/indexing/index_hashes.h"
 #include "wavemap/core/utils/math/int_math.h"
@@ -15,7 +16,26 @@ Index<dim> indexToBlockIndex(const Index<dim>& index,
                              IndexElement cells_per_block_side_log_2);
 }  // namespace convert
 
+// Hash maps that can be used to store the blocks of a SpatialHash
 template <typename BlockDataT, int dim>
+using FlatBlockHashMap =
+    FlatHashMap<Index<dim>, BlockDataT, MortonIndexHash<dim>>;
+template <typename BlockDataT, int dim>
+using StdBlockHashMap =
+    std::unordered_map<Index<dim>, BlockDataT, IndexHash<dim>>;
+
+// The hash map used by default, which can be switched to the
+// std::unordered_map by building with the USE_STD_BLOCK_HASH_MAP option
+#ifdef WAVEMAP_USE_STD_BLOCK_HASH_MAP
+template <typename BlockDataT, int dim>
+using DefaultBlockHashMap = StdBlockHashMap<BlockDataT, dim>;
+#else
+template <typename BlockDataT, int dim>
+using DefaultBlockHashMap = FlatBlockHashMap<BlockDataT, dim>;
+#endif
+
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT = DefaultBlockHashMap>
 class SpatialHash {
  public:
   static constexpr IndexElement kDim = dim;
@@ -50,7 +70,7 @@ class SpatialHash {
   void forEachBlock(IndexedBlockVisitor visitor_fn) const;
 
  private:
-  std::unordered_map<Index<dim>, BlockDataT, IndexHash<dim>> block_map_;
+  BlockHashMapT<BlockDataT, dim> block_map_;
 };
 }  // namespace wavemap
 
@@ -5,6 +5,7 @@
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/indexing/ndtree_index.h"
+#include "wavemap/core/utils/bits/morton_encoding.h"
 
 namespace wavemap {
 template <int dim>
@@ -20,6 +21,21 @@ struct IndexHash {
 using Index2DHash = IndexHash<2>;
 using Index3DHash = IndexHash<3>;
 
+// Hashes indices to the Morton code of their lower bits. Note that the codes
+// are not mixed, so this hash should only be used with hash maps that spread
+// them over their buckets, such as the FlatHashMap.
+template <int dim>
+struct MortonIndexHash {
+  size_t operator()(const Index<dim>& index) const {
+    // Wrap the coordinates into the range supported by the Morton encoding,
+    // such that arbitrary indices can be hashed
+    constexpr IndexElement kCoordinateMask = morton::kMaxSingleCoordinate<dim>;
+    const Index<dim> wrapped_index = index.unaryExpr(
+        [](IndexElement coordinate) { return coordinate & kCoordinateMask; });
+    return morton::encode<dim, /*check_sign=*/true>(wrapped_index);
+  }
+};
+
 template <int dim>
 struct NdtreeIndexHash {
   static constexpr auto coefficients =
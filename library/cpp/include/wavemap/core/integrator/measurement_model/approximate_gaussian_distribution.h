@@ -24,6 +24,27 @@ struct ApproximateGaussianDistribution {
       return 1.f;
     }
   }
+
+  // Branch-free version of the above, which evaluates the cumulative
+  // distribution for all coefficients of an Eigen array at once
+  template <typename Derived>
+  static typename Derived::PlainObject cumulative(
+      const Eigen::ArrayBase<Derived>& t) {
+    using ArrayT = typename Derived::PlainObject;
+    const ArrayT t_plus_three = t + 3.f;
+    const ArrayT three_min_t = 3.f - t;
+    const ArrayT below_minus_one =
+        (1.f / 48.f) * t_plus_three * t_plus_three * t_plus_three;
+    const ArrayT between_plus_minus_one =
+        (1.f / 2.f) + (1.f / 24.f) * t * t_plus_three * three_min_t;
+    const ArrayT above_one =
+        1.f - (1.f / 48.f) * three_min_t * three_min_t * three_min_t;
+    return (t < -3.f).select(
+        0.f, (t <= -1.f).select(
+                 below_minus_one,
+                 (t < 1.f).select(between_plus_minus_one,
+                                  (t <= 3.f).select(above_one, 1.f))));
+  }
 };
 }  // namespace wavemap
 
@@ -2,6 +2,7 @@
 #define WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_CONTINUOUS_BEAM_H_
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <utility>
 
@@ -79,6 +80,14 @@ class ContinuousBeam : public MeasurementModelBase {
 
   FloatingPoint computeUpdate(
       const SensorCoordinates& sensor_coordinates) const override;
+  UpdateBatch computeUpdates(
+      const SensorCoordinatesBatch& sensor_coordinates) const override {
+    return computeUpdates<kBatchSize>(sensor_coordinates);
+  }
+  // Compute the updates for N cells at once, with SIMD instructions
+  template <size_t N>
+  std::array<FloatingPoint, N> computeUpdates(
+      const std::array<SensorCoordinates, N>& sensor_coordinates) const;
 
  private:
   const ContinuousBeamConfig config_;
@@ -112,6 +121,19 @@ class ContinuousBeam : public MeasurementModelBase {
       FloatingPoint cell_to_sensor_distance,
       FloatingPoint cell_to_beam_image_error_norm_squared,
       FloatingPoint measured_distance) const;
+
+  // Batched update for N cells, considering NumNeighbors beams per cell
+  template <size_t N, int NumNeighbors>
+  std::array<FloatingPoint, N> computeUpdatesImpl(
+      const std::array<SensorCoordinates, N>& sensor_coordinates) const;
+
+  // Branch-free version of computeBeamUpdate, which evaluates the updates for
+  // all coefficients of the given Eigen arrays at once
+  template <typename ArrayT>
+  ArrayT computeBeamUpdates(
+      const ArrayT& cell_to_sensor_distances,
+      const ArrayT& cell_to_beam_image_error_norms_squared,
+      const ArrayT& measured_distances) const;
 };
 }  // namespace wavemap
 
@@ -1,6 +1,7 @@
 #ifndef WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_CONTINUOUS_RAY_H_
 #define WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_CONTINUOUS_RAY_H_
 
+#include <array>
 #include <memory>
 #include <utility>
 
@@ -65,6 +66,14 @@ class ContinuousRay : public MeasurementModelBase {
 
   FloatingPoint computeUpdate(
       const SensorCoordinates& sensor_coordinates) const override;
+  UpdateBatch computeUpdates(
+      const SensorCoordinatesBatch& sensor_coordinates) const override {
+    return computeUpdates<kBatchSize>(sensor_coordinates);
+  }
+  // Compute the updates for N cells at once, with SIMD instructions
+  template <size_t N>
+  std::array<FloatingPoint, N> computeUpdates(
+      const std::array<SensorCoordinates, N>& sensor_coordinates) const;
 
  private:
   const ContinuousRayConfig config_;
@@ -89,6 +98,20 @@ class ContinuousRay : public MeasurementModelBase {
   // NOTE: Using this method is optional. It's slightly cheaper and more
   // accurate, but the difference is minor.
   FloatingPoint computeFreeSpaceBeamUpdate() const;
+
+  // Batched update for N cells, considering NumNeighbors beams per cell
+  template <size_t N, int NumNeighbors>
+  std::array<FloatingPoint, N> computeUpdatesImpl(
+      const std::array<SensorCoordinates, N>& sensor_coordinates) const;
+
+  // Branch-free versions of computeBeamUpdate and computeFullBeamUpdate, which
+  // evaluate the updates for all coefficients of the given Eigen arrays at once
+  template <typename ArrayT>
+  ArrayT computeBeamUpdates(const ArrayT& cell_to_sensor_distances,
+                            const ArrayT& measured_distances) const;
+  template <typename ArrayT>
+  ArrayT computeFullBeamUpdates(const ArrayT& cell_to_sensor_distances,
+                                const ArrayT& measured_distances) const;
 };
 }  // namespace wavemap
 
@@ -2,6 +2,7 @@
 #define WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_IMPL_CONTINUOUS_BEAM_INL_H_
 
 #include <algorithm>
+#include <array>
 
 #include "wavemap/core/integrator/measurement_model/approximate_gaussian_distribution.h"
 
@@ -46,6 +47,19 @@ inline FloatingPoint ContinuousBeam::computeUpdate(
   }
 }
 
+template <size_t N>
+std::array<FloatingPoint, N> ContinuousBeam::computeUpdates(
+    const std::array<SensorCoordinates, N>& sensor_coordinates) const {
+  switch (config_.beam_selector_type) {
+    case BeamSelectorType::kNearestNeighbor:
+      return computeUpdatesImpl<N, 1>(sensor_coordinates);
+    case BeamSelectorType::kAllNeighbors:
+      return computeUpdatesImpl<N, 4>(sensor_coordinates);
+    default:
+      return {};
+  }
+}
+
 inline FloatingPoint ContinuousBeam::computeBeamUpdateNearestNeighbor(
     const Image<>& range_image, const Image<Vector2D>& beam_offset_image,
     const ProjectorBase& projection_model,
@@ -113,6 +127,80 @@ inline FloatingPoint ContinuousBeam::computeBeamUpdateAllNeighbors(
   return update;
 }
 
+template <size_t N, int NumNeighbors>
+std::array<FloatingPoint, N> ContinuousBeam::computeUpdatesImpl(
+    const std::array<SensorCoordinates, N>& sensor_coordinates) const {
+  constexpr int kNumCells = static_cast<int>(N);
+  using CellArray = Eigen::Array<FloatingPoint, kNumCells, 1>;
+  using NeighborArray = Eigen::Array<FloatingPoint, kNumCells, NumNeighbors>;
+  using NeighborMask = Eigen::Array<bool, kNumCells, NumNeighbors>;
+
+  // Gather the measured distances and image error norms of each cell's
+  // neighboring beams
+  // NOTE: As in the scalar versions, beams that fall outside the range image
+  //       are skipped by the nearest neighbor selector, whereas the all
+  //       neighbors selector evaluates them with a measured distance of zero.
+  NeighborArray cell_to_sensor_distances;
+  NeighborArray cell_to_beam_image_error_norms_squared;
+  NeighborArray measured_distances = NeighborArray::Zero();
+  NeighborMask is_within_bounds = NeighborMask::Constant(NumNeighbors != 1);
+  for (int cell_idx = 0; cell_idx < kNumCells; ++cell_idx) {
+    const SensorCoordinates& cell_coordinates = sensor_coordinates[cell_idx];
+    cell_to_sensor_distances.row(cell_idx).setConstant(cell_coordinates.depth);
+    if constexpr (NumNeighbors == 1) {
+      const auto [image_index, cell_offset] =
+          projection_model_->imageToNearestIndexAndOffset(
+              cell_coordinates.image);
+      if (range_image_->isIndexWithinBounds(image_index)) {
+        measured_distances(cell_idx) = range_image_->at(image_index);
+        cell_to_beam_image_error_norms_squared(cell_idx) =
+            projection_model_->imageOffsetToErrorSquaredNorm(
+                cell_coordinates.image,
+                beam_offset_image_->at(image_index) - cell_offset);
+        is_within_bounds(cell_idx) = true;
+      } else {
+        cell_to_beam_image_error_norms_squared(cell_idx) = 0.f;
+      }
+    } else {
+      auto [image_indices, cell_to_beam_offsets] =
+          projection_model_->imageToNearestIndicesAndOffsets(
+              cell_coordinates.image);
+      for (int neighbor_idx = 0; neighbor_idx < 4; ++neighbor_idx) {
+        const Index2D& image_index = image_indices.col(neighbor_idx);
+        if (range_image_->isIndexWithinBounds(image_index)) {
+          measured_distances(cell_idx, neighbor_idx) =
+              range_image_->at(image_index);
+          cell_to_beam_offsets.col(neighbor_idx) -=
+              beam_offset_image_->at(image_index);
+        }
+      }
+      const auto error_norms_squared =
+          projection_model_->imageOffsetsToErrorSquaredNorms(
+              cell_coordinates.image, cell_to_beam_offsets);
+      for (int neighbor_idx = 0; neighbor_idx < 4; ++neighbor_idx) {
+        cell_to_beam_image_error_norms_squared(cell_idx, neighbor_idx) =
+            error_norms_squared[neighbor_idx];
+      }
+    }
+  }
+
+  // Evaluate the measurement model for all cells at once, one neighboring
+  // beam at a time, and sum the contributions of each cell's beams
+  // NOTE: Evaluating the model on a single column at a time keeps the arrays
+  //       as wide as one SIMD register, instead of spanning several.
+  std::array<FloatingPoint, N> updates;
+  auto updates_map = Eigen::Map<CellArray>(updates.data());
+  updates_map.setZero();
+  for (int neighbor_idx = 0; neighbor_idx < NumNeighbors; ++neighbor_idx) {
+    const CellArray beam_updates = computeBeamUpdates<CellArray>(
+        cell_to_sensor_distances.col(neighbor_idx),
+        cell_to_beam_image_error_norms_squared.col(neighbor_idx),
+        measured_distances.col(neighbor_idx));
+    updates_map += is_within_bounds.col(neighbor_idx).select(beam_updates, 0.f);
+  }
+  return updates;
+}
+
 inline FloatingPoint ContinuousBeam::computeBeamUpdate(
     FloatingPoint cell_to_sensor_distance,
     FloatingPoint cell_to_beam_image_error_norm_squared,
@@ -155,6 +243,40 @@ inline FloatingPoint ContinuousBeam::computeBeamUpdate(
   DCHECK(!std::isnan(log_odds) && std::isfinite(log_odds));
   return log_odds;
 }
+
+template <typename ArrayT>
+ArrayT ContinuousBeam::computeBeamUpdates(
+    const ArrayT& cell_to_sensor_distances,
+    const ArrayT& cell_to_beam_image_error_norms_squared,
+    const ArrayT& measured_distances) const {
+  const auto fully_in_unknown_space =
+      angle_threshold_squared < cell_to_beam_image_error_norms_squared ||
+      measured_distances + range_threshold_back_ < cell_to_sensor_distances;
+
+  const ArrayT g =
+      cell_to_beam_image_error_norms_squared.sqrt() / config_.angle_sigma;
+  const ArrayT angle_contrib =
+      1.f - ApproximateGaussianDistribution::cumulative(g - 3.f);
+
+  const auto fully_in_free_space =
+      cell_to_sensor_distances < measured_distances - range_threshold_front;
+  constexpr FloatingPoint kFreeSpaceRangeContrib = -0.5f;
+  const ArrayT f =
+      (cell_to_sensor_distances - measured_distances) / config_.range_sigma;
+  const ArrayT range_contrib = fully_in_free_space.select(
+      kFreeSpaceRangeContrib,
+      ApproximateGaussianDistribution::cumulative(f) -
+          0.5f * ApproximateGaussianDistribution::cumulative(f - 3.f) - 0.5f);
+
+  const ArrayT contribs = range_contrib * angle_contrib;
+  const ArrayT scaled_contribs =
+      (fully_in_free_space || contribs < 0.f)
+          .select(config_.scaling_free * contribs,
+                  config_.scaling_occupied * contribs);
+
+  const ArrayT p = scaled_contribs + 0.5f;
+  return fully_in_unknown_space.select(0.f, (p / (1.f - p)).log());
+}
 }  // namespace wavemap
 
 #endif  // WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_IMPL_CONTINUOUS_BEAM_INL_H_
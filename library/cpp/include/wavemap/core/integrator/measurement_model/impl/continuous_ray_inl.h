@@ -1,6 +1,8 @@
 #ifndef WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_IMPL_CONTINUOUS_RAY_INL_H_
 #define WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_IMPL_CONTINUOUS_RAY_INL_H_
 
+#include <array>
+
 #include "wavemap/core/integrator/measurement_model/approximate_gaussian_distribution.h"
 
 namespace wavemap {
@@ -47,6 +49,66 @@ inline FloatingPoint ContinuousRay::computeUpdate(
   }
 }
 
+template <size_t N>
+std::array<FloatingPoint, N> ContinuousRay::computeUpdates(
+    const std::array<SensorCoordinates, N>& sensor_coordinates) const {
+  switch (config_.beam_selector_type) {
+    case BeamSelectorType::kNearestNeighbor:
+      return computeUpdatesImpl<N, 1>(sensor_coordinates);
+    case BeamSelectorType::kAllNeighbors:
+      return computeUpdatesImpl<N, 4>(sensor_coordinates);
+    default:
+      return {};
+  }
+}
+
+template <size_t N, int NumNeighbors>
+std::array<FloatingPoint, N> ContinuousRay::computeUpdatesImpl(
+    const std::array<SensorCoordinates, N>& sensor_coordinates) const {
+  constexpr int kNumCells = static_cast<int>(N);
+  using CellArray = Eigen::Array<FloatingPoint, kNumCells, 1>;
+  using NeighborArray = Eigen::Array<FloatingPoint, kNumCells, NumNeighbors>;
+  using NeighborMask = Eigen::Array<bool, kNumCells, NumNeighbors>;
+
+  // Gather the measured distances of each cell's neighboring beams
+  NeighborArray cell_to_sensor_distances;
+  NeighborArray measured_distances = NeighborArray::Zero();
+  NeighborMask is_within_bounds = NeighborMask::Constant(false);
+  for (int cell_idx = 0; cell_idx < kNumCells; ++cell_idx) {
+    const SensorCoordinates& cell_coordinates = sensor_coordinates[cell_idx];
+    cell_to_sensor_distances.row(cell_idx).setConstant(cell_coordinates.depth);
+    const auto image_indices = [&]() {
+      if constexpr (NumNeighbors == 1) {
+        return projection_model_->imageToNearestIndex(cell_coordinates.image);
+      } else {
+        return projection_model_->imageToNearestIndices(
+            cell_coordinates.image);
+      }
+    }();
+    for (int neighbor_idx = 0; neighbor_idx < NumNeighbors; ++neighbor_idx) {
+      const Index2D& image_index = image_indices.col(neighbor_idx);
+      if (range_image_->isIndexWithinBounds(image_index)) {
+        measured_distances(cell_idx, neighbor_idx) =
+            range_image_->at(image_index);
+        is_within_bounds(cell_idx, neighbor_idx) = true;
+      }
+    }
+  }
+
+  // Evaluate the measurement model and sum the contributions of each cell's
+  // beams, one column at a time as in ContinuousBeam::computeUpdatesImpl
+  std::array<FloatingPoint, N> updates;
+  auto updates_map = Eigen::Map<CellArray>(updates.data());
+  updates_map.setZero();
+  for (int neighbor_idx = 0; neighbor_idx < NumNeighbors; ++neighbor_idx) {
+    const CellArray beam_updates = computeBeamUpdates<CellArray>(
+        cell_to_sensor_distances.col(neighbor_idx),
+        measured_distances.col(neighbor_idx));
+    updates_map += is_within_bounds.col(neighbor_idx).select(beam_updates, 0.f);
+  }
+  return updates;
+}
+
 inline FloatingPoint ContinuousRay::computeBeamUpdate(
     const SensorCoordinates& sensor_coordinates,
     const Index2D& image_index) const {
@@ -92,6 +154,38 @@ inline FloatingPoint ContinuousRay::computeFreeSpaceBeamUpdate() const {
   DCHECK(!std::isnan(log_odds) && std::isfinite(log_odds));
   return log_odds;
 }
+
+template <typename ArrayT>
+ArrayT ContinuousRay::computeBeamUpdates(
+    const ArrayT& cell_to_sensor_distances,
+    const ArrayT& measured_distances) const {
+  const ArrayT full_beam_updates =
+      computeFullBeamUpdates(cell_to_sensor_distances, measured_distances);
+  return (range_threshold_back_ <
+          cell_to_sensor_distances - measured_distances)
+      .select(0.f, (cell_to_sensor_distances <
+                    measured_distances - range_threshold_front_)
+                       .select(computeFreeSpaceBeamUpdate(), full_beam_updates));
+}
+
+template <typename ArrayT>
+ArrayT ContinuousRay::computeFullBeamUpdates(
+    const ArrayT& cell_to_sensor_distances,
+    const ArrayT& measured_distances) const {
+  const ArrayT f =
+      (cell_to_sensor_distances - measured_distances) / config_.range_sigma;
+  const ArrayT range_contrib =
+      ApproximateGaussianDistribution::cumulative(f) -
+      0.5f * ApproximateGaussianDistribution::cumulative(f - 3.f) - 0.5f;
+
+  const ArrayT scaled_contribs =
+      (range_contrib < 0.f)
+          .select(config_.scaling_free * range_contrib,
+                  config_.scaling_occupied * range_contrib);
+
+  const ArrayT p = scaled_contribs + 0.5f;
+  return (p / (1.f - p)).log();
+}
 }  // namespace wavemap
 
 #endif  // WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_IMPL_CONTINUOUS_RAY_INL_H_
@@ -1,11 +1,13 @@
 #ifndef WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_MEASUREMENT_MODEL_BASE_H_
 #define WAVEMAP_CORE_INTEGRATOR_MEASUREMENT_MODEL_MEASUREMENT_MODEL_BASE_H_
 
+#include <array>
 #include <memory>
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/config/type_selector.h"
 #include "wavemap/core/data_structure/image.h"
+#include "wavemap/core/indexing/ndtree_index.h"
 #include "wavemap/core/integrator/projection_model/projector_base.h"
 #include "wavemap/core/integrator/projective/update_type.h"
 
@@ -44,6 +46,22 @@ class MeasurementModelBase {
 
   virtual FloatingPoint computeUpdate(
       const SensorCoordinates& sensor_coordinates) const = 0;
+
+  // Batched version of computeUpdate, which evaluates the updates for all the
+  // children of an octree node with a single virtual call
+  // NOTE: The default implementation calls computeUpdate in a loop, while the
+  //       continuous ray and beam models override it with SIMD kernels.
+  static constexpr int kBatchSize = OctreeIndex::kNumChildren;
+  using SensorCoordinatesBatch = std::array<SensorCoordinates, kBatchSize>;
+  using UpdateBatch = std::array<FloatingPoint, kBatchSize>;
+  virtual UpdateBatch computeUpdates(
+      const SensorCoordinatesBatch& sensor_coordinates) const {
+    UpdateBatch updates{};
+    for (int cell_idx = 0; cell_idx < kBatchSize; ++cell_idx) {
+      updates[cell_idx] = computeUpdate(sensor_coordinates[cell_idx]);
+    }
+    return updates;
+  }
 };
 }  // namespace wavemap
 
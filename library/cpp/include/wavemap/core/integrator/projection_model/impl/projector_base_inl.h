@@ -4,6 +4,20 @@
 #include <utility>
 
 namespace wavemap {
+inline void ProjectorBase::cartesianToSensor(
+    const Pointcloud<>& C_points, ImageCoordinatesBatch& image_coordinates,
+    SensorZBatch& sensor_z) const {
+  const Eigen::Index num_points = C_points.data().cols();
+  image_coordinates.resize(2, num_points);
+  sensor_z.resize(num_points);
+  for (Eigen::Index point_idx = 0; point_idx < num_points; ++point_idx) {
+    const SensorCoordinates sensor_coordinates =
+        cartesianToSensor(Point3D{C_points[point_idx]});
+    image_coordinates.col(point_idx) = sensor_coordinates.image;
+    sensor_z[point_idx] = sensor_coordinates.depth;
+  }
+}
+
 inline Index2D ProjectorBase::imageToNearestIndex(
     const ImageCoordinates& image_coordinates) const {
   return imageToIndexReal(image_coordinates)
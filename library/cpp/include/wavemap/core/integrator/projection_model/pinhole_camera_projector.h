@@ -54,9 +54,13 @@ class PinholeCameraProjector : public ProjectorBase {
     return {false, false, false};
   }
   SiUnit getImageCoordinatesUnit() const final { return SiUnit::kPixels; }
+  bool isEquivalentTo(const ProjectorBase& other) const final;
 
   // Coordinate transforms between Cartesian and sensor space
   SensorCoordinates cartesianToSensor(const Point3D& C_point) const final;
+  void cartesianToSensor(const Pointcloud<>& C_points,
+                         ImageCoordinatesBatch& image_coordinates,
+                         SensorZBatch& sensor_z) const final;
   Point3D sensorToCartesian(const SensorCoordinates& coordinates) const final;
   FloatingPoint imageOffsetToErrorSquaredNorm(
       const ImageCoordinates& /*linearization_point*/,
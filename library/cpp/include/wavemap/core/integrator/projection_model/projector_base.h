@@ -8,6 +8,7 @@
 #include "wavemap/core/config/type_selector.h"
 #include "wavemap/core/config/value_with_unit.h"
 #include "wavemap/core/data_structure/aabb.h"
+#include "wavemap/core/data_structure/pointcloud.h"
 
 namespace wavemap {
 struct ProjectorType : TypeSelector<ProjectorType> {
@@ -51,6 +52,9 @@ class ProjectorBase {
   virtual Eigen::Matrix<bool, 3, 1> sensorAxisIsPeriodic() const = 0;
   virtual Eigen::Matrix<bool, 3, 1> sensorAxisCouldBePeriodic() const = 0;
   virtual SiUnit getImageCoordinatesUnit() const = 0;
+  // Returns true if the other projector is of the same type and has the same
+  // config, such that both project all points identically
+  virtual bool isEquivalentTo(const ProjectorBase& other) const = 0;
 
   // Coordinate transforms between Cartesian and sensor space
   virtual SensorCoordinates cartesianToSensor(const Point3D& C_point) const = 0;
@@ -61,6 +65,17 @@ class ProjectorBase {
     return sensorToCartesian({image_coordinates, normal});
   }
 
+  // Batched transform from Cartesian to sensor space, which converts all the
+  // points of a pointcloud with a single virtual call
+  // NOTE: The outputs are resized to match the number of points. The default
+  //       implementation calls the single point transform in a loop, while the
+  //       built-in projectors override it with kernels that can be vectorized.
+  using ImageCoordinatesBatch = Eigen::Matrix<FloatingPoint, 2, Eigen::Dynamic>;
+  using SensorZBatch = Eigen::Matrix<FloatingPoint, 1, Eigen::Dynamic>;
+  virtual void cartesianToSensor(const Pointcloud<>& C_points,
+                                 ImageCoordinatesBatch& image_coordinates,
+                                 SensorZBatch& sensor_z) const;
+
   // Projection from Cartesian space onto the sensor's image surface
   virtual ImageCoordinates cartesianToImage(const Point3D& C_point) const = 0;
   virtual FloatingPoint cartesianToSensorZ(const Point3D& C_point) const = 0;
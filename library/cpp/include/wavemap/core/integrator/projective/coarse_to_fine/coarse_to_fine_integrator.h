@@ -24,6 +24,12 @@ class CoarseToFineIntegrator : public ProjectiveIntegrator {
         occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))),
         min_cell_width_(occupancy_map_->getMinCellWidth()) {}
 
+  const HierarchicalRangeBounds* getHierarchicalRangeBounds() const override {
+    return range_image_intersector_
+               ? &range_image_intersector_->getHierarchicalRangeBounds()
+               : nullptr;
+  }
+
  private:
   const VolumetricOctree::Ptr occupancy_map_;
   const FloatingPoint min_cell_width_;
@@ -22,18 +22,24 @@ class HashedChunkedWaveletIntegrator : public ProjectiveIntegrator {
       MeasurementModelBase::ConstPtr measurement_model,
       HashedChunkedWaveletOctree::Ptr occupancy_map,
       std::shared_ptr<ThreadPool> thread_pool = nullptr)
-      : ProjectiveIntegrator(
-            config, std::move(projection_model), std::move(posed_range_image),
-            std::move(beam_offset_image), std::move(measurement_model)),
-        occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))),
-        thread_pool_(thread_pool ? std::move(thread_pool)
-                                 : std::make_shared<ThreadPool>()) {}
+      : ProjectiveIntegrator(config, std::move(projection_model),
+                             std::move(posed_range_image),
+                             std::move(beam_offset_image),
+                             std::move(measurement_model),
+                             thread_pool ? std::move(thread_pool)
+                                         : std::make_shared<ThreadPool>()),
+        occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))) {}
+
+  const HierarchicalRangeBounds* getHierarchicalRangeBounds() const override {
+    return range_image_intersector_
+               ? &range_image_intersector_->getHierarchicalRangeBounds()
+               : nullptr;
+  }
 
  private:
   using BlockList = std::vector<HashedChunkedWaveletOctree::BlockIndex>;
 
   const HashedChunkedWaveletOctree::Ptr occupancy_map_;
-  std::shared_ptr<ThreadPool> thread_pool_;
   std::shared_ptr<RangeImageIntersector> range_image_intersector_;
 
   // Cache/pre-compute commonly used values
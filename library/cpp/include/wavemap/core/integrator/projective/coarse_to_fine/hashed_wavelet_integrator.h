@@ -21,16 +21,22 @@ class HashedWaveletIntegrator : public ProjectiveIntegrator {
                           MeasurementModelBase::ConstPtr measurement_model,
                           HashedWaveletOctree::Ptr occupancy_map,
                           std::shared_ptr<ThreadPool> thread_pool = nullptr)
-      : ProjectiveIntegrator(
-            config, std::move(projection_model), std::move(posed_range_image),
-            std::move(beam_offset_image), std::move(measurement_model)),
-        occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))),
-        thread_pool_(thread_pool ? std::move(thread_pool)
-                                 : std::make_shared<ThreadPool>()) {}
+      : ProjectiveIntegrator(config, std::move(projection_model),
+                             std::move(posed_range_image),
+                             std::move(beam_offset_image),
+                             std::move(measurement_model),
+                             thread_pool ? std::move(thread_pool)
+                                         : std::make_shared<ThreadPool>()),
+        occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))) {}
+
+  const HierarchicalRangeBounds* getHierarchicalRangeBounds() const override {
+    return range_image_intersector_
+               ? &range_image_intersector_->getHierarchicalRangeBounds()
+               : nullptr;
+  }
 
  private:
   const HashedWaveletOctree::Ptr occupancy_map_;
-  std::shared_ptr<ThreadPool> thread_pool_;
   std::shared_ptr<RangeImageIntersector> range_image_intersector_;
 
   // Cache/pre-compute commonly used values
@@ -58,6 +64,20 @@ class HashedWaveletIntegrator : public ProjectiveIntegrator {
   void updateMap() override;
   void updateBlock(HashedWaveletOctree::Block& block,
                    const OctreeIndex& block_index);
+
+  // Update the subtree rooted at the given node. Subtrees higher than the
+  // configured min_parallel_subtree_height fork their children as tasks.
+  void updateSubtree(HashedWaveletOctreeBlock::NodeType& subtree_root_node,
+                     const OctreeIndex& subtree_root_index,
+                     FloatingPoint& subtree_root_scale,
+                     bool& needs_thresholding);
+  // Update the given node directly if the current resolution is sufficient and
+  // return nullptr. Otherwise, return a pointer to the (allocated) node such
+  // that it can be refined.
+  HashedWaveletOctreeBlock::NodeType* updateOrAllocateNode(
+      HashedWaveletOctreeBlock::NodeType& parent_node,
+      const OctreeIndex& node_index, FloatingPoint& node_value,
+      bool& needs_thresholding);
 };
 }  // namespace wavemap
 
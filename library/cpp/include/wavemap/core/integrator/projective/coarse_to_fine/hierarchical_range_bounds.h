@@ -31,10 +31,18 @@ class HierarchicalRangeBounds {
         << "For scale: " << image_to_pyramid_scale_factor_;
     CHECK((image_to_pyramid_scale_factor_.array() <= 2).all())
         << "For scale: " << image_to_pyramid_scale_factor_;
-    DCHECK_EQ(lower_bound_levels_.size(), max_height_);
-    DCHECK_EQ(upper_bound_levels_.size(), max_height_);
+    update();
   }
 
+  // Recompute the pyramids after the range image changed
+  // NOTE: The pyramids are rebuilt in place, such that no memory is allocated
+  //       as long as the range image's dimensions stay the same.
+  void update();
+  // Copy the pyramids of another instance whose range image holds the same
+  // values, with the same min_range and projection model, instead of
+  // recomputing them
+  void update(const HierarchicalRangeBounds& other);
+
   IndexElement getMaxHeight() const { return max_height_; }
   FloatingPoint getMinRange() const { return min_range_; }
   static FloatingPoint getUnknownValueLowerBound() {
@@ -97,26 +105,38 @@ class HierarchicalRangeBounds {
   static Index2D computeImageToPyramidScaleFactor(
       const ProjectorBase* projector = nullptr);
 
-  const std::vector<Image<>> lower_bound_levels_ = computeReducedPyramid(
-      range_image_->transform(
-          [=](auto val) { return valueOrInit(val, kUnknownValueLowerBound); }),
-      [](auto a, auto b) { return std::min(a, b); }, kUnknownValueLowerBound);
-  const std::vector<Image<>> upper_bound_levels_ = computeReducedPyramid(
-      range_image_->transform(
-          [=](auto val) { return valueOrInit(val, kUnknownValueUpperBound); }),
-      [](auto a, auto b) { return std::max(a, b); }, kUnknownValueUpperBound);
-  const std::vector<Image<bool>> unobserved_mask_levels_ =
-      computeReducedPyramid(
-          range_image_->transform([=](auto val) { return isUnobserved(val); }),
-          [](auto a, auto b) { return a || b; }, true);
-
-  const IndexElement max_height_ =
-      static_cast<IndexElement>(lower_bound_levels_.size());
-
-  template <typename T = FloatingPoint, typename BinaryFunctor>
-  std::vector<Image<T>> computeReducedPyramid(const Image<T>& range_image,
-                                              BinaryFunctor reduction_functor,
-                                              T init);
+  std::vector<Image<>> lower_bound_levels_;
+  std::vector<Image<>> upper_bound_levels_;
+  std::vector<Image<bool>> unobserved_mask_levels_;
+  IndexElement max_height_ = 0;
+
+  // The values of all three pyramids at a given pixel, such that they can be
+  // reduced jointly in a single pass over each level
+  struct PixelBounds {
+    FloatingPoint lower;
+    FloatingPoint upper;
+    bool has_unobserved;
+  };
+  static constexpr PixelBounds kUnknownPixelBounds{
+      kUnknownValueLowerBound, kUnknownValueUpperBound, true};
+  static PixelBounds reducePixelBounds(const PixelBounds& a,
+                                       const PixelBounds& b) {
+    return {std::min(a.lower, b.lower), std::max(a.upper, b.upper),
+            a.has_unobserved || b.has_unobserved};
+  }
+  PixelBounds rangeToPixelBounds(FloatingPoint range) const {
+    return {valueOrInit(range, kUnknownValueLowerBound),
+            valueOrInit(range, kUnknownValueUpperBound), isUnobserved(range)};
+  }
+
+  template <typename SampleFn>
+  void reduceLevel(IndexElement level_idx, const Index2D& previous_level_dims,
+                   const Index2D& child_stride, SampleFn sample_fn);
+  template <typename SampleFn>
+  PixelBounds reduceBorderPixel(const Index2D& min_child_idx,
+                                const Index2D& max_child_idx,
+                                const Index2D& previous_level_dims,
+                                SampleFn sample_fn) const;
 
   bool isUnobserved(FloatingPoint value) const { return value < min_range_; }
   FloatingPoint valueOrInit(FloatingPoint value, FloatingPoint init) const {
@@ -45,7 +45,7 @@ inline void HashedChunkedWaveletIntegrator::updateLeavesBatch(
       {parent_value, parent_details});
 
   // Get child center points in world frame W
-  Eigen::Matrix<FloatingPoint, 3, OctreeIndex::kNumChildren> child_centers;
+  CellCenterBatch child_centers;
   for (int child_idx = 0; child_idx < OctreeIndex::kNumChildren; ++child_idx) {
     const auto child_index = parent_index.computeChildIndex(child_idx);
     child_centers.col(child_idx) =
@@ -59,10 +59,10 @@ inline void HashedChunkedWaveletIntegrator::updateLeavesBatch(
   }
 
   // Compute updated values
+  const auto samples = computeUpdates(child_centers);
   for (int child_idx = 0; child_idx < OctreeIndex::kNumChildren; ++child_idx) {
-    const FloatingPoint sample = computeUpdate(child_centers.col(child_idx));
     FloatingPoint& child_value = child_values[child_idx];
-    child_value = sample + child_value;
+    child_value = samples[child_idx] + child_value;
   }
 
   // Threshold
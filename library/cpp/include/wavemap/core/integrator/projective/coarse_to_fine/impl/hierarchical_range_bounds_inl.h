@@ -5,7 +5,9 @@
 #include <vector>
 
 #include "wavemap/core/utils/bits/bit_operations.h"
+#include "wavemap/core/utils/data/eigen_checks.h"
 #include "wavemap/core/utils/iterate/grid_iterator.h"
+#include "wavemap/core/utils/math/int_math.h"
 
 namespace wavemap {
 inline Bounds<FloatingPoint> HierarchicalRangeBounds::getBounds(
@@ -290,92 +292,174 @@ inline Index2D HierarchicalRangeBounds::computeImageToPyramidScaleFactor(
   }
 }
 
-template <typename T, typename BinaryFunctor>
-std::vector<Image<T>> HierarchicalRangeBounds::computeReducedPyramid(
-    const Image<T>& range_image, BinaryFunctor reduction_functor, T init) {
-  CHECK(!azimuth_wraps_pi_ || bit_ops::popcount(range_image.getNumColumns()))
+inline void HierarchicalRangeBounds::update(
+    const HierarchicalRangeBounds& other) {
+  CHECK_EQ(min_range_, other.min_range_);
+  CHECK_EQ(azimuth_wraps_pi_, other.azimuth_wraps_pi_);
+  CHECK_EIGEN_EQ(image_to_pyramid_scale_factor_,
+                 other.image_to_pyramid_scale_factor_);
+  CHECK_EIGEN_EQ(range_image_->getDimensions(),
+                 other.range_image_->getDimensions());
+
+  // NOTE: Copy-assigning images of the same size reuses their memory.
+  max_height_ = other.max_height_;
+  lower_bound_levels_ = other.lower_bound_levels_;
+  upper_bound_levels_ = other.upper_bound_levels_;
+  unobserved_mask_levels_ = other.unobserved_mask_levels_;
+}
+
+inline void HierarchicalRangeBounds::update() {
+  CHECK(!azimuth_wraps_pi_ ||
+        bit_ops::popcount(range_image_->getNumColumns()))
       << "For LiDAR range images that wrap around horizontally (FoV of "
          "360deg), only column numbers that are exact powers of 2 are "
          "currently supported.";
 
-  const Index2D range_image_dims = range_image.getDimensions();
+  const Index2D range_image_dims = range_image_->getDimensions();
   const Index2D range_image_dims_scaled =
       image_to_pyramid_scale_factor_.cwiseProduct(range_image_dims);
-  const int max_num_halvings =
-      int_math::log2_ceil(range_image_dims_scaled.maxCoeff());
+  max_height_ = int_math::log2_ceil(range_image_dims_scaled.maxCoeff());
 
-  std::vector<Image<T>> pyramid;
-  pyramid.reserve(max_num_halvings);
-  for (int level_idx = 0; level_idx < max_num_halvings; ++level_idx) {
-    // Initialize the current level
+  // Resize the pyramids
+  // NOTE: Resizing to the current size is a no-op, and images whose number of
+  //       pixels stays the same are reshaped without reallocating.
+  const auto num_levels = static_cast<size_t>(max_height_);
+  lower_bound_levels_.resize(num_levels, Image<>(0, 0));
+  upper_bound_levels_.resize(num_levels, Image<>(0, 0));
+  unobserved_mask_levels_.resize(num_levels, Image<bool>(0, 0));
+  for (IndexElement level_idx = 0; level_idx < max_height_; ++level_idx) {
     const Index2D level_dims =
         int_math::div_exp2_ceil(range_image_dims_scaled, level_idx + 1);
-    Image<T>& current_level =
-        pyramid.emplace_back(level_dims.x(), level_dims.y(), init);
-
-    // Reduce from the previous level or from the range image (for level 0)
-    const Image<T>& previous_level =
-        level_idx == 0 ? range_image : pyramid[level_idx - 1];
-    const Index2D previous_level_dims = previous_level.getDimensions();
-
-    for (const Index2D& idx :
-         Grid<2>(Index2D::Zero(), level_dims - Index2D::Ones())) {
-      Index2D min_child_idx = 2 * idx;
-      Index2D max_child_idx = min_child_idx + Index2D::Ones();
-      if (level_idx == 0) {
-        min_child_idx =
-            min_child_idx.cwiseQuotient(image_to_pyramid_scale_factor_);
-        max_child_idx =
-            max_child_idx.cwiseQuotient(image_to_pyramid_scale_factor_);
-      }
+    lower_bound_levels_[level_idx].resize(level_dims.x(), level_dims.y());
+    upper_bound_levels_[level_idx].resize(level_dims.x(), level_dims.y());
+    unobserved_mask_levels_[level_idx].resize(level_dims.x(), level_dims.y());
+  }
 
-      // Reduce the values in the 2x2 block of the previous level from
-      // min_child_idx to max_child_idx while avoiding out-of-bounds access if
-      // we're on the border. Where out-of-bounds access would occur, we
-      // virtually pad the previous level with initial value 'init'.
-      if ((min_child_idx.array() < previous_level_dims.array()).all()) {
-        const T r00 = previous_level.at({min_child_idx.x(), min_child_idx.y()});
-        if (max_child_idx.x() < previous_level_dims.x()) {
-          const T r10 =
-              previous_level.at({max_child_idx.x(), min_child_idx.y()});
-          const T first_col_reduced = reduction_functor(r00, r10);
-          if (max_child_idx.y() < previous_level_dims.y()) {
-            const T r01 =
-                previous_level.at({min_child_idx.x(), max_child_idx.y()});
-            const T r11 =
-                previous_level.at({max_child_idx.x(), max_child_idx.y()});
-            const T second_col_reduced = reduction_functor(r01, r11);
-            current_level.at(idx) =
-                reduction_functor(first_col_reduced, second_col_reduced);
-          } else if (azimuth_wraps_pi_ &&
-                     max_child_idx.y() <= previous_level_dims.y()) {
-            const T r01 = previous_level.at({min_child_idx.x(), 0});
-            const T r11 = previous_level.at({max_child_idx.x(), 0});
-            const T second_col_reduced = reduction_functor(r01, r11);
-            current_level.at(idx) =
-                reduction_functor(first_col_reduced, second_col_reduced);
-          } else {
-            current_level.at(idx) = reduction_functor(first_col_reduced, init);
-          }
-        } else if (max_child_idx.y() < previous_level_dims.y()) {
-          const T r01 =
-              previous_level.at({min_child_idx.x(), max_child_idx.y()});
-          const T first_row_reduced = reduction_functor(r00, r01);
-          current_level.at(idx) = reduction_functor(first_row_reduced, init);
-        } else if (azimuth_wraps_pi_ &&
-                   max_child_idx.y() <= previous_level_dims.y()) {
-          const T r01 = previous_level.at({min_child_idx.x(), 0});
-          const T first_row_reduced = reduction_functor(r00, r01);
-          current_level.at(idx) = reduction_functor(first_row_reduced, init);
-        } else {
-          current_level.at(idx) = reduction_functor(r00, init);
-        }
-      } else {
-        current_level.at(idx) = init;
-      }
+  // Reduce the first level from the range image
+  // NOTE: Along the axes where the pyramid is scaled by a factor of 2, each
+  //       pixel of the first level only covers one range image pixel.
+  if (0 < max_height_) {
+    const Index2D child_stride =
+        Index2D::Constant(2).cwiseQuotient(image_to_pyramid_scale_factor_);
+    reduceLevel(0, range_image_dims, child_stride,
+                [this](const Index2D& child_idx) {
+                  return rangeToPixelBounds(range_image_->at(child_idx));
+                });
+  }
+
+  // Reduce all other levels from the level below
+  for (IndexElement level_idx = 1; level_idx < max_height_; ++level_idx) {
+    const Image<>& lower_bounds = lower_bound_levels_[level_idx - 1];
+    const Image<>& upper_bounds = upper_bound_levels_[level_idx - 1];
+    const Image<bool>& unobserved_mask = unobserved_mask_levels_[level_idx - 1];
+    reduceLevel(level_idx, lower_bounds.getDimensions(), Index2D::Constant(2),
+                [&](const Index2D& child_idx) {
+                  return PixelBounds{lower_bounds.at(child_idx),
+                                     upper_bounds.at(child_idx),
+                                     unobserved_mask.at(child_idx)};
+                });
+  }
+}
+
+template <typename SampleFn>
+void HierarchicalRangeBounds::reduceLevel(IndexElement level_idx,
+                                          const Index2D& previous_level_dims,
+                                          const Index2D& child_stride,
+                                          SampleFn sample_fn) {
+  Image<>& lower_bounds = lower_bound_levels_[level_idx];
+  Image<>& upper_bounds = upper_bound_levels_[level_idx];
+  Image<bool>& unobserved_mask = unobserved_mask_levels_[level_idx];
+  const Index2D level_dims = lower_bounds.getDimensions();
+  const Index2D child_offset = child_stride - Index2D::Ones();
+
+  // Reduce the pixels whose children all lie within the previous level
+  // NOTE: This is the bulk of the work. The loop is kept branch free and
+  //       reduces the lower bounds, upper bounds and unobserved masks in one
+  //       pass, in the images' storage order.
+  const Index2D interior_dims =
+      previous_level_dims.cwiseQuotient(child_stride).cwiseMin(level_dims);
+  for (IndexElement col_idx = 0; col_idx < interior_dims.y(); ++col_idx) {
+    const IndexElement min_child_col = child_stride.y() * col_idx;
+    const IndexElement max_child_col = min_child_col + child_offset.y();
+    for (IndexElement row_idx = 0; row_idx < interior_dims.x(); ++row_idx) {
+      const IndexElement min_child_row = child_stride.x() * row_idx;
+      const IndexElement max_child_row = min_child_row + child_offset.x();
+      const PixelBounds first_col_reduced =
+          reducePixelBounds(sample_fn({min_child_row, min_child_col}),
+                            sample_fn({max_child_row, min_child_col}));
+      const PixelBounds second_col_reduced =
+          reducePixelBounds(sample_fn({min_child_row, max_child_col}),
+                            sample_fn({max_child_row, max_child_col}));
+      const PixelBounds reduced =
+          reducePixelBounds(first_col_reduced, second_col_reduced);
+      const Index2D idx{row_idx, col_idx};
+      lower_bounds.at(idx) = reduced.lower;
+      upper_bounds.at(idx) = reduced.upper;
+      unobserved_mask.at(idx) = reduced.has_unobserved;
+    }
+  }
+
+  // Reduce the remaining pixels along the bottom and right borders
+  for (IndexElement col_idx = 0; col_idx < level_dims.y(); ++col_idx) {
+    const IndexElement first_border_row_idx =
+        col_idx < interior_dims.y() ? interior_dims.x() : 0;
+    for (IndexElement row_idx = first_border_row_idx;
+         row_idx < level_dims.x(); ++row_idx) {
+      const Index2D idx{row_idx, col_idx};
+      const Index2D min_child_idx = child_stride.cwiseProduct(idx);
+      const Index2D max_child_idx = min_child_idx + child_offset;
+      const PixelBounds reduced = reduceBorderPixel(
+          min_child_idx, max_child_idx, previous_level_dims, sample_fn);
+      lower_bounds.at(idx) = reduced.lower;
+      upper_bounds.at(idx) = reduced.upper;
+      unobserved_mask.at(idx) = reduced.has_unobserved;
     }
   }
-  return pyramid;
+}
+
+template <typename SampleFn>
+HierarchicalRangeBounds::PixelBounds HierarchicalRangeBounds::reduceBorderPixel(
+    const Index2D& min_child_idx, const Index2D& max_child_idx,
+    const Index2D& previous_level_dims, SampleFn sample_fn) const {
+  // Reduce the values in the 2x2 block of the previous level from
+  // min_child_idx to max_child_idx while avoiding out-of-bounds access. Where
+  // out-of-bounds access would occur, we virtually pad the previous level with
+  // unknown values.
+  if (!(min_child_idx.array() < previous_level_dims.array()).all()) {
+    return kUnknownPixelBounds;
+  }
+  const PixelBounds r00 = sample_fn({min_child_idx.x(), min_child_idx.y()});
+  if (max_child_idx.x() < previous_level_dims.x()) {
+    const PixelBounds r10 = sample_fn({max_child_idx.x(), min_child_idx.y()});
+    const PixelBounds first_col_reduced = reducePixelBounds(r00, r10);
+    if (max_child_idx.y() < previous_level_dims.y()) {
+      const PixelBounds r01 =
+          sample_fn({min_child_idx.x(), max_child_idx.y()});
+      const PixelBounds r11 =
+          sample_fn({max_child_idx.x(), max_child_idx.y()});
+      const PixelBounds second_col_reduced = reducePixelBounds(r01, r11);
+      return reducePixelBounds(first_col_reduced, second_col_reduced);
+    } else if (azimuth_wraps_pi_ &&
+               max_child_idx.y() <= previous_level_dims.y()) {
+      const PixelBounds r01 = sample_fn({min_child_idx.x(), 0});
+      const PixelBounds r11 = sample_fn({max_child_idx.x(), 0});
+      const PixelBounds second_col_reduced = reducePixelBounds(r01, r11);
+      return reducePixelBounds(first_col_reduced, second_col_reduced);
+    } else {
+      return reducePixelBounds(first_col_reduced, kUnknownPixelBounds);
+    }
+  } else if (max_child_idx.y() < previous_level_dims.y()) {
+    const PixelBounds r01 = sample_fn({min_child_idx.x(), max_child_idx.y()});
+    const PixelBounds first_row_reduced = reducePixelBounds(r00, r01);
+    return reducePixelBounds(first_row_reduced, kUnknownPixelBounds);
+  } else if (azimuth_wraps_pi_ &&
+             max_child_idx.y() <= previous_level_dims.y()) {
+    const PixelBounds r01 = sample_fn({min_child_idx.x(), 0});
+    const PixelBounds first_row_reduced = reducePixelBounds(r00, r01);
+    return reducePixelBounds(first_row_reduced, kUnknownPixelBounds);
+  } else {
+    return reducePixelBounds(r00, kUnknownPixelBounds);
+  }
 }
 }  // namespace wavemap
 
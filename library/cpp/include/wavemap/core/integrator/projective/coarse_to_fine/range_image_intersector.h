@@ -30,13 +30,28 @@ class RangeImageIntersector {
         range_threshold_in_front_(measurement_model.getPaddingSurfaceFront()),
         range_threshold_behind_(measurement_model.getPaddingSurfaceBack()) {}
 
+  // Update the intersector after the range image changed, reusing its buffers
+  // NOTE: If the range bounds of another intersector whose range image holds
+  //       the same values are provided, they are copied instead of recomputed.
+  void update(const HierarchicalRangeBounds* range_bounds = nullptr) {
+    if (range_bounds) {
+      hierarchical_range_image_.update(*range_bounds);
+    } else {
+      hierarchical_range_image_.update();
+    }
+  }
+
+  const HierarchicalRangeBounds& getHierarchicalRangeBounds() const {
+    return hierarchical_range_image_;
+  }
+
   UpdateType determineUpdateType(const AABB<Point3D>& W_cell_aabb,
                                  const Transformation3D::RotationMatrix& R_C_W,
                                  const Point3D& t_W_C) const;
 
  private:
   const bool y_axis_wraps_around_;
-  const HierarchicalRangeBounds hierarchical_range_image_;
+  HierarchicalRangeBounds hierarchical_range_image_;
 
   const ProjectorBase::ConstPtr projection_model_;
 
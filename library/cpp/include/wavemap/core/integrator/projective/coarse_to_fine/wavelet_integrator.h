@@ -24,6 +24,12 @@ class WaveletIntegrator : public ProjectiveIntegrator {
         occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))),
         min_cell_width_(occupancy_map_->getMinCellWidth()) {}
 
+  const HierarchicalRangeBounds* getHierarchicalRangeBounds() const override {
+    return range_image_intersector_
+               ? &range_image_intersector_->getHierarchicalRangeBounds()
+               : nullptr;
+  }
+
  private:
   const WaveletOctree::Ptr occupancy_map_;
   std::shared_ptr<RangeImageIntersector> range_image_intersector_;
@@ -3,10 +3,13 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "wavemap/core/data_structure/aabb.h"
 #include "wavemap/core/data_structure/image.h"
+#include "wavemap/core/integrator/projective/coarse_to_fine/range_image_intersector.h"
 #include "wavemap/core/integrator/projective/projective_integrator.h"
+#include "wavemap/core/map/hashed_blocks.h"
 
 namespace wavemap {
 class FixedResolutionIntegrator : public ProjectiveIntegrator {
@@ -16,20 +19,59 @@ class FixedResolutionIntegrator : public ProjectiveIntegrator {
                             PosedImage<>::Ptr posed_range_image,
                             Image<Vector2D>::Ptr beam_offset_image,
                             MeasurementModelBase::ConstPtr measurement_model,
-                            MapBase::Ptr occupancy_map)
+                            MapBase::Ptr occupancy_map,
+                            std::shared_ptr<ThreadPool> thread_pool = nullptr)
       : ProjectiveIntegrator(
             config, std::move(projection_model), std::move(posed_range_image),
-            std::move(beam_offset_image), std::move(measurement_model)),
+            std::move(beam_offset_image), std::move(measurement_model),
+            std::move(thread_pool)),
         occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))) {}
 
+  // The AABB of the imported measurement depends on the max range and the
+  // measurement model, so imports can only be reused from fixed resolution
+  // integrators that match them
+  bool canReuseImportOf(const ProjectiveIntegrator& other) const override;
+
+  const HierarchicalRangeBounds* getHierarchicalRangeBounds() const override {
+    return range_image_intersector_
+               ? &range_image_intersector_->getHierarchicalRangeBounds()
+               : nullptr;
+  }
+
  private:
   const MapBase::Ptr occupancy_map_;
   AABB<Point3D> aabb_;
+  std::shared_ptr<RangeImageIntersector> range_image_intersector_;
+
+  // The AABB is split into blocks of this height, which matches the blocks of
+  // HashedBlocks maps such that they can be accessed directly
+  static constexpr IndexElement kBlockHeight = HashedBlocks::kCellsPerSideLog2;
 
   void importPointcloud(const PosedPointcloud<>& pointcloud) override;
   void importRangeImage(const PosedImage<>& range_image_input) override;
+  void importFrom(const ProjectiveIntegrator& source) override;
 
   void updateMap() override;
+
+  // Returns the indices of the blocks overlapping the AABB that are not fully
+  // unobserved, according to the range image intersector
+  std::vector<Index3D> selectBlocksToUpdate(const Index3D& aabb_min_index,
+                                            const Index3D& aabb_max_index) const;
+  // Updates the blocks of a HashedBlocks map, in parallel if a thread pool is
+  // available, directly accessing each block instead of looking up each cell
+  void updateHashedBlocks(HashedBlocks& hashed_blocks,
+                          const std::vector<Index3D>& blocks_to_update,
+                          const Index3D& aabb_min_index,
+                          const Index3D& aabb_max_index);
+
+  // Calls update_fn(index, update) for each cell of the block that lies within
+  // the AABB and whose update is not negligible. Stops and returns false as
+  // soon as update_fn returns false.
+  template <typename UpdateFn>
+  bool forEachCellUpdate(const Index3D& block_index,
+                         const Index3D& aabb_min_index,
+                         const Index3D& aabb_max_index,
+                         UpdateFn update_fn) const;
 };
 }  // namespace wavemap
 
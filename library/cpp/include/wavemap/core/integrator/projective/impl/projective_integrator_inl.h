@@ -18,6 +18,35 @@ inline FloatingPoint ProjectiveIntegrator::computeUpdate(
 
   return measurement_model_->computeUpdate(sensor_coordinates);
 }
+
+inline MeasurementModelBase::UpdateBatch ProjectiveIntegrator::computeUpdates(
+    const CellCenterBatch& C_cell_centers) const {
+  constexpr int kBatchSize = MeasurementModelBase::kBatchSize;
+  MeasurementModelBase::SensorCoordinatesBatch sensor_coordinates;
+  bool all_within_range = true;
+  for (int cell_idx = 0; cell_idx < kBatchSize; ++cell_idx) {
+    sensor_coordinates[cell_idx] =
+        projection_model_->cartesianToSensor(C_cell_centers.col(cell_idx));
+    const FloatingPoint depth = sensor_coordinates[cell_idx].depth;
+    all_within_range &=
+        !(depth < config_.min_range || config_.max_range < depth);
+  }
+
+  // Evaluate the whole batch at once, unless some of its cells lie outside the
+  // min/max range, which only happens close to the range limits
+  if (all_within_range) {
+    return measurement_model_->computeUpdates(sensor_coordinates);
+  }
+  MeasurementModelBase::UpdateBatch updates{};
+  for (int cell_idx = 0; cell_idx < kBatchSize; ++cell_idx) {
+    const FloatingPoint depth = sensor_coordinates[cell_idx].depth;
+    if (!(depth < config_.min_range || config_.max_range < depth)) {
+      updates[cell_idx] =
+          measurement_model_->computeUpdate(sensor_coordinates[cell_idx]);
+    }
+  }
+  return updates;
+}
 }  // namespace wavemap
 
 #endif  // WAVEMAP_CORE_INTEGRATOR_PROJECTIVE_IMPL_PROJECTIVE_INTEGRATOR_INL_H_
@@ -3,19 +3,24 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "wavemap/core/config/type_selector.h"
+#include "wavemap/core/data_structure/aabb.h"
 #include "wavemap/core/data_structure/image.h"
 #include "wavemap/core/integrator/integrator_base.h"
 #include "wavemap/core/integrator/measurement_model/measurement_model_base.h"
 #include "wavemap/core/integrator/projection_model/projector_base.h"
+#include "wavemap/core/integrator/projective/coarse_to_fine/hierarchical_range_bounds.h"
+#include "wavemap/core/integrator/projective/coarse_to_fine/range_image_intersector.h"
 #include "wavemap/core/map/map_base.h"
+#include "wavemap/core/utils/thread_pool.h"
 
 namespace wavemap {
 /**
  * Config struct for projective integrators.
  */
-struct ProjectiveIntegratorConfig : ConfigBase<ProjectiveIntegratorConfig, 4> {
+struct ProjectiveIntegratorConfig : ConfigBase<ProjectiveIntegratorConfig, 5> {
   //! Minimum range measurements should have to be considered.
   //! Measurements below this threshold are ignored.
   Meters<FloatingPoint> min_range = 0.5f;
@@ -34,6 +39,13 @@ struct ProjectiveIntegratorConfig : ConfigBase<ProjectiveIntegratorConfig, 4> {
   //! please refer to: https://www.roboticsproceedings.org/rss19/p065.pdf.
   FloatingPoint termination_update_error = 0.1f;
 
+  //! Minimum height, in octree levels above the map's maximum resolution, of
+  //! the subtrees that the hashed coarse-to-fine integrators process as
+  //! separate tasks on the thread pool. This balances the load when a few
+  //! blocks require most of the refinement. Set it above the map's tree height
+  //! to update each block on a single thread.
+  IndexElement min_parallel_subtree_height = 3;
+
   static MemberMap memberMap;
 
   // Constructors
@@ -53,17 +65,46 @@ class ProjectiveIntegrator : public IntegratorBase {
       ProjectorBase::ConstPtr projection_model,
       PosedImage<>::Ptr posed_range_image,
       Image<Vector2D>::Ptr beam_offset_image,
-      MeasurementModelBase::ConstPtr measurement_model)
+      MeasurementModelBase::ConstPtr measurement_model,
+      std::shared_ptr<ThreadPool> thread_pool = nullptr)
       : config_(config.checkValid()),
         projection_model_(std::move(CHECK_NOTNULL(projection_model))),
         posed_range_image_(std::move(CHECK_NOTNULL(posed_range_image))),
         beam_offset_image_(std::move(CHECK_NOTNULL(beam_offset_image))),
-        measurement_model_(std::move(CHECK_NOTNULL(measurement_model))) {}
+        measurement_model_(std::move(CHECK_NOTNULL(measurement_model))),
+        thread_pool_(std::move(thread_pool)) {}
 
   // Methods to integrate new pointclouds / depth images into the map
   void integrate(const PosedPointcloud<>& pointcloud) override;
   void integrate(const PosedImage<>& range_image) override;
 
+  // Methods to integrate a measurement that the given source integrator just
+  // integrated, reusing its range image, beam offsets and range bounds such
+  // that only the map update runs on this integrator
+  // NOTE: The source must be compatible, as checked by canReuseImportOf().
+  void integrate(const PosedPointcloud<>& pointcloud,
+                 const ProjectiveIntegrator& source);
+  void integrate(const PosedImage<>& range_image,
+                 const ProjectiveIntegrator& source);
+  // Returns true if this integrator imports measurements exactly like the
+  // other integrator, such that it can reuse the other's imported measurements
+  virtual bool canReuseImportOf(const ProjectiveIntegrator& other) const;
+
+  // Methods to integrate a measurement in two steps, as done by the methods
+  // above. The import only updates the integrator's range image, beam offsets
+  // and related buffers, not the map. It returns false if the measurement is
+  // ignored, in which case the map must not be updated with it.
+  // NOTE: This allows other work on the map to run while the next measurement
+  //       is imported, as long as the previous import was already applied.
+  bool importMeasurement(const PosedPointcloud<>& pointcloud);
+  bool importMeasurement(const PosedImage<>& range_image);
+  bool importMeasurement(const PosedPointcloud<>& pointcloud,
+                         const ProjectiveIntegrator& source);
+  bool importMeasurement(const PosedImage<>& range_image,
+                         const ProjectiveIntegrator& source);
+  // Update the map with the last imported measurement
+  void updateMapWithImport();
+
   // Accessors for debugging and visualization
   // NOTE: These accessors are for introspection only, not for modifying the
   //       internal state. They therefore only expose const references or
@@ -80,6 +121,10 @@ class ProjectiveIntegrator : public IntegratorBase {
   Image<Vector2D>::ConstPtr getBeamOffsetImage() const {
     return beam_offset_image_;
   }
+  // Returns nullptr for integrators that do not compute range bounds
+  virtual const HierarchicalRangeBounds* getHierarchicalRangeBounds() const {
+    return nullptr;
+  }
 
  protected:
   const ProjectiveIntegratorConfig config_;
@@ -90,12 +135,86 @@ class ProjectiveIntegrator : public IntegratorBase {
 
   const MeasurementModelBase::ConstPtr measurement_model_;
 
+  // Thread pool used to parallelize the integration, serial if nullptr
+  const std::shared_ptr<ThreadPool> thread_pool_;
+
   virtual void importPointcloud(const PosedPointcloud<>& pointcloud);
   virtual void importRangeImage(const PosedImage<>& range_image_input);
+  // Copy the range and beam offset images imported by a compatible integrator
+  virtual void importFrom(const ProjectiveIntegrator& source);
+  // Range bounds that the integrator whose import is being reused already
+  // computed for the current measurement, or nullptr if there are none
+  const HierarchicalRangeBounds* getReusableRangeBounds() const {
+    return import_source_ ? import_source_->getHierarchicalRangeBounds()
+                          : nullptr;
+  }
+  // Updates the range image intersector for the current measurement, reusing
+  // the range bounds of the import source if available, or creates it if it
+  // does not yet exist
+  void updateRangeImageIntersector(
+      std::shared_ptr<RangeImageIntersector>& range_image_intersector) const;
+
+  // Projects a pointcloud into the range and beam offset images, keeping the
+  // closest point per pixel. If W_aabb is given, it is grown to include all
+  // the imported points, truncated to max_range, in world frame.
+  // NOTE: Large pointclouds are imported in parallel if a thread pool is
+  //       available. The result is identical to that of the serial import.
+  void importPointcloudIntoRangeImage(const PosedPointcloud<>& pointcloud,
+                                      AABB<Point3D>* W_aabb = nullptr);
 
   virtual void updateMap() = 0;
 
   FloatingPoint computeUpdate(const Point3D& C_cell_center) const;
+  // Batched version of computeUpdate, for the cells of an octree node's
+  // children, that evaluates the measurement model with a single call
+  using CellCenterBatch =
+      Eigen::Matrix<FloatingPoint, 3, MeasurementModelBase::kBatchSize>;
+  MeasurementModelBase::UpdateBatch computeUpdates(
+      const CellCenterBatch& C_cell_centers) const;
+
+ private:
+  // Integrator whose import is reused while integrating the current
+  // measurement, or nullptr if this integrator imported the measurement itself
+  const ProjectiveIntegrator* import_source_ = nullptr;
+  bool isRangeImageValid(const PosedImage<>& range_image) const;
+  void importFromSource(const ProjectiveIntegrator& source);
+
+  // Pointclouds are only split into parallel import tasks with at least this
+  // many points each
+  static constexpr Eigen::Index kMinNumPointsPerImportTask = 16384;
+
+  // Buffers for the batched projection of pointclouds, kept between calls to
+  // avoid reallocating them for every pointcloud
+  ProjectorBase::ImageCoordinatesBatch image_coordinates_batch_;
+  ProjectorBase::SensorZBatch sensor_z_batch_;
+
+  // Per-task range and beam offset images for the parallel import, which also
+  // record whether each pixel was hit and whether any of its points fell below
+  // min_range, such that they can be merged as if imported serially
+  struct RangeImageTile {
+    static constexpr uint8_t kNotHit = 0;
+    static constexpr uint8_t kHit = 1;
+    static constexpr uint8_t kHitBelowMinRange = 2;
+
+    explicit RangeImageTile(const Index2D& dimensions)
+        : range_image(dimensions),
+          beam_offset_image(dimensions),
+          pixel_states(dimensions, kNotHit) {}
+
+    Image<> range_image;
+    Image<Vector2D> beam_offset_image;
+    Image<uint8_t> pixel_states;
+    AABB<Point3D> W_aabb;
+  };
+  std::vector<RangeImageTile> range_image_tiles_;
+
+  void importPoints(const PosedPointcloud<>& pointcloud,
+                    Eigen::Index begin_point_idx, Eigen::Index end_point_idx,
+                    Image<>& range_image, Image<Vector2D>& beam_offset_image,
+                    Image<uint8_t>* pixel_states,
+                    AABB<Point3D>* W_aabb) const;
+  void importPointsInParallel(const PosedPointcloud<>& pointcloud,
+                              size_t num_tasks, AABB<Point3D>* W_aabb);
 };
 }  // namespace wavemap
 
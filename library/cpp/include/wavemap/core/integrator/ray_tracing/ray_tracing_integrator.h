@@ -1,21 +1,33 @@
 #ifndef WAVEMAP_CORE_INTEGRATOR_RAY_TRACING_RAY_TRACING_INTEGRATOR_H_
 #define WAVEMAP_CORE_INTEGRATOR_RAY_TRACING_RAY_TRACING_INTEGRATOR_H_
 
+#include <memory>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "wavemap/core/indexing/index_hashes.h"
 #include "wavemap/core/integrator/integrator_base.h"
 #include "wavemap/core/integrator/measurement_model/constant_ray.h"
 #include "wavemap/core/map/map_base.h"
 #include "wavemap/core/utils/iterate/ray_iterator.h"
+#include "wavemap/core/utils/thread_pool.h"
 
 namespace wavemap {
 /**
  * Config struct for the ray-tracing integrator.
  */
-struct RayTracingIntegratorConfig : ConfigBase<RayTracingIntegratorConfig, 2> {
+struct RayTracingIntegratorConfig : ConfigBase<RayTracingIntegratorConfig, 3> {
   Meters<FloatingPoint> min_range = 0.5f;
   Meters<FloatingPoint> max_range = 20.f;
 
+  //! Whether to merge the rays whose end points fall into the same cell. Only
+  //! one ray is then traced per cell, towards the cell's center, and each cell
+  //! it crosses is updated once with the update scaled by the number of merged
+  //! rays. This greatly reduces the number of redundant free-space updates
+  //! near the sensor, at the cost of slightly shifting the rays.
+  bool merge_rays = false;
+
   static MemberMap memberMap;
 
   // Constructors
@@ -26,12 +38,23 @@ struct RayTracingIntegratorConfig : ConfigBase<RayTracingIntegratorConfig, 2> {
   bool isValid(bool verbose) const override;
 };
 
+/**
+ * Integrator that traces each ray through the map, updating every cell it
+ * crosses.
+ * If a thread pool is provided and the map is hashed, large pointclouds are
+ * integrated in parallel. The rays are then traced concurrently, their cell
+ * updates are bucketed by map block, and each block applies its updates in a
+ * single pass on a single thread. Since the updates of each block are applied
+ * in the order of the rays, the result matches serial integration exactly.
+ */
 class RayTracingIntegrator : public IntegratorBase {
  public:
   RayTracingIntegrator(const RayTracingIntegratorConfig& config,
-                       MapBase::Ptr occupancy_map)
+                       MapBase::Ptr occupancy_map,
+                       std::shared_ptr<ThreadPool> thread_pool = nullptr)
       : config_(config.checkValid()),
-        occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))) {}
+        occupancy_map_(std::move(CHECK_NOTNULL(occupancy_map))),
+        thread_pool_(std::move(thread_pool)) {}
 
   void integrate(const PosedPointcloud<>& pointcloud) override;
 
@@ -46,6 +69,44 @@ class RayTracingIntegrator : public IntegratorBase {
 
   const RayTracingIntegratorConfig config_;
   const MapBase::Ptr occupancy_map_;
+  const std::shared_ptr<ThreadPool> thread_pool_;
+
+  // Pointclouds are only traced in parallel with at least this many rays per
+  // task, and are processed in batches of at most this many rays to bound the
+  // memory used to buffer the cell updates
+  static constexpr Eigen::Index kMinNumRaysPerTask = 4096;
+  static constexpr Eigen::Index kMaxNumRaysPerBatch = 65536;
+
+  struct CellUpdate {
+    Index3D index;
+    FloatingPoint update;
+  };
+  using CellUpdateList = std::vector<CellUpdate>;
+  using BlockUpdateMap =
+      std::unordered_map<Index3D, CellUpdateList, IndexHash<3>>;
+
+  // Replaces the end points by the centers of the cells they fall into, with
+  // one end point per cell, and sets each ray's weight to the number of end
+  // points that fell into its cell
+  void mergeRays(const Point3D& W_start_point, Pointcloud<>& W_end_points,
+                 std::vector<FloatingPoint>& ray_weights) const;
+
+  // Calls update_fn(index, update) for every cell crossed by the rays from
+  // W_start_point to W_end_points[begin_ray_idx, end_ray_idx), in order
+  // NOTE: If ray_weights is not empty, each ray's updates are scaled by its
+  //       weight.
+  template <typename UpdateFn>
+  void traceRays(const Point3D& W_start_point,
+                 const Pointcloud<>& W_end_points,
+                 const std::vector<FloatingPoint>& ray_weights,
+                 Eigen::Index begin_ray_idx, Eigen::Index end_ray_idx,
+                 UpdateFn update_fn) const;
+
+  template <typename MapT>
+  void integrateInParallel(const Point3D& W_start_point,
+                           const Pointcloud<>& W_end_points,
+                           const std::vector<FloatingPoint>& ray_weights,
+                           MapT& map);
 };
 }  // namespace wavemap
 
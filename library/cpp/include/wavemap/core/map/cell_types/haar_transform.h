@@ -1,6 +1,7 @@
 #ifndef WAVEMAP_CORE_MAP_CELL_TYPES_HAAR_TRANSFORM_H_
 #define WAVEMAP_CORE_MAP_CELL_TYPES_HAAR_TRANSFORM_H_
 
+#include <cstddef>
 #include <string>
 
 #include "wavemap/core/common.h"
@@ -42,6 +43,36 @@ typename HaarCoefficients<ValueT, dim>::Scale BackwardSingleChild(
     const typename HaarCoefficients<ValueT, dim>::Parent& parent,
     NdtreeIndexRelativeChild child_idx);
 
+// Vectorized versions of the lifted transforms. In 3D, the 8 coefficients of
+// single precision transforms are processed together using AVX, SSE4.1 or NEON
+// instructions, depending on which instruction sets are enabled at compile
+// time. All other cases fall back to the scalar lifted transforms. The
+// vectorized transforms perform the same operations in the same order as their
+// scalar counterparts, so their results are identical.
+template <typename ValueT, int dim>
+typename HaarCoefficients<ValueT, dim>::Parent ForwardVectorized(
+    const typename HaarCoefficients<ValueT, dim>::CoefficientsArray&
+        child_scales);
+
+template <typename ValueT, int dim>
+typename HaarCoefficients<ValueT, dim>::CoefficientsArray BackwardVectorized(
+    const typename HaarCoefficients<ValueT, dim>::Parent& parent);
+
+// Batched versions of the lifted transforms, which transform num_nodes nodes
+// stored in a structure-of-arrays layout. Coefficient coeff_idx of node
+// node_idx is stored at [coeff_idx * num_nodes + node_idx], with each node's
+// coefficients ordered like in a CoefficientsArray. Every lifting step thereby
+// becomes a loop over contiguous arrays, which the compiler vectorizes across
+// nodes for all value types and dimensions. The results are identical to
+// those of the scalar lifted transforms.
+template <typename ValueT, int dim>
+void ForwardLiftedBatch(const ValueT* child_scales, ValueT* parents,
+                        size_t num_nodes);
+
+template <typename ValueT, int dim>
+void BackwardLiftedBatch(const ValueT* parents, ValueT* child_scales,
+                         size_t num_nodes);
+
 // NOTE: The parallel and lifted transform implementations trade off data
 //       parallelism (i.e. short instruction dependency chains) and efficiency
 //       (i.e. less required operations in total). Benchmarks show the lifting
@@ -54,13 +85,13 @@ struct HaarTransform {
   static typename HaarCoefficients<ValueT, kDim>::Parent forward(
       const typename HaarCoefficients<ValueT, kDim>::CoefficientsArray&
           child_scale_coefficients) {
-    return ForwardLifted<ValueT, kDim>(child_scale_coefficients);
+    return ForwardVectorized<ValueT, kDim>(child_scale_coefficients);
   }
 
   static typename HaarCoefficients<ValueT, kDim>::CoefficientsArray backward(
       const typename HaarCoefficients<ValueT, kDim>::Parent&
           parent_coefficients) {
-    return BackwardLifted<ValueT, kDim>(parent_coefficients);
+    return BackwardVectorized<ValueT, kDim>(parent_coefficients);
   }
 
   static typename HaarCoefficients<ValueT, kDim>::Parent forwardSingleChild(
@@ -74,6 +105,19 @@ struct HaarTransform {
       NdtreeIndexRelativeChild child_idx) {
     return BackwardSingleChild<ValueT, kDim>(parent, child_idx);
   }
+
+  static void forwardBatch(const ValueT* child_scale_coefficients,
+                           ValueT* parent_coefficients, size_t num_nodes) {
+    ForwardLiftedBatch<ValueT, kDim>(child_scale_coefficients,
+                                     parent_coefficients, num_nodes);
+  }
+
+  static void backwardBatch(const ValueT* parent_coefficients,
+                            ValueT* child_scale_coefficients,
+                            size_t num_nodes) {
+    BackwardLiftedBatch<ValueT, kDim>(parent_coefficients,
+                                      child_scale_coefficients, num_nodes);
+  }
 };
 
 template <typename ValueT>
@@ -103,6 +147,19 @@ struct HaarTransform<ValueT, 1> {
       NdtreeIndexRelativeChild child_idx) {
     return BackwardSingleChild<ValueT, kDim>(parent, child_idx);
   }
+
+  static void forwardBatch(const ValueT* child_scale_coefficients,
+                           ValueT* parent_coefficients, size_t num_nodes) {
+    ForwardLiftedBatch<ValueT, kDim>(child_scale_coefficients,
+                                     parent_coefficients, num_nodes);
+  }
+
+  static void backwardBatch(const ValueT* parent_coefficients,
+                            ValueT* child_scale_coefficients,
+                            size_t num_nodes) {
+    BackwardLiftedBatch<ValueT, kDim>(parent_coefficients,
+                                      child_scale_coefficients, num_nodes);
+  }
 };
 
 template <typename ValueT>
@@ -132,6 +189,19 @@ struct HaarTransform<ValueT, 2> {
       NdtreeIndexRelativeChild child_idx) {
     return BackwardSingleChild<ValueT, kDim>(parent, child_idx);
   }
+
+  static void forwardBatch(const ValueT* child_scale_coefficients,
+                           ValueT* parent_coefficients, size_t num_nodes) {
+    ForwardLiftedBatch<ValueT, kDim>(child_scale_coefficients,
+                                     parent_coefficients, num_nodes);
+  }
+
+  static void backwardBatch(const ValueT* parent_coefficients,
+                            ValueT* child_scale_coefficients,
+                            size_t num_nodes) {
+    BackwardLiftedBatch<ValueT, kDim>(parent_coefficients,
+                                      child_scale_coefficients, num_nodes);
+  }
 };
 }  // namespace wavemap
 
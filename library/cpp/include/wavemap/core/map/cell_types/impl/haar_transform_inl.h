@@ -1,6 +1,18 @@
 #ifndef WAVEMAP_CORE_MAP_CELL_TYPES_IMPL_HAAR_TRANSFORM_INL_H_
 #define WAVEMAP_CORE_MAP_CELL_TYPES_IMPL_HAAR_TRANSFORM_INL_H_
 
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "wavemap/core/utils/bits/bit_operations.h"
 #include "wavemap/core/utils/math/int_math.h"
 
@@ -156,6 +168,288 @@ typename HaarCoefficients<ValueT, dim>::Scale BackwardSingleChild(
 
   return scale;
 }
+
+namespace detail {
+// Kernels applying the 3D lifted transforms to 8 contiguous floats
+// NOTE: For each axis, the lifting step of the scalar implementation updates
+//       the pairs of coefficients whose indices only differ in the axis' bit.
+//       The kernels below perform the same steps, with each pair's scale
+//       coefficient (bit unset) and detail coefficient (bit set) in different
+//       SIMD lanes. In the forward step, the scale lanes compute s - 0.5*(s-t)
+//       instead of s + 0.5*(t-s). This is exact since IEEE 754 subtraction is
+//       antisymmetric, such that the results match the scalar transform.
+#if defined(__AVX__)
+// Swaps the lanes whose indices only differ in the given axis' bit
+template <int axis>
+inline __m256 swapLanes(__m256 values) {
+  if constexpr (axis == 0) {
+    return _mm256_permute_ps(values, 0b10110001);
+  } else if constexpr (axis == 1) {
+    return _mm256_permute_ps(values, 0b01001110);
+  } else {
+    return _mm256_permute2f128_ps(values, values, 0x01);
+  }
+}
+
+// Takes the scale lanes from the first and the detail lanes, whose index has
+// the given axis' bit set, from the second argument
+template <int axis>
+inline __m256 blendLanes(__m256 scales, __m256 details) {
+  constexpr int kMask = axis == 0 ? 0b10101010 : (axis == 1 ? 0b11001100
+                                                            : 0b11110000);
+  return _mm256_blend_ps(scales, details, kMask);
+}
+
+template <int axis>
+inline __m256 haarForwardStep3D(__m256 values) {
+  const __m256 difference = _mm256_sub_ps(values, swapLanes<axis>(values));
+  const __m256 scales =
+      _mm256_sub_ps(values, _mm256_mul_ps(_mm256_set1_ps(0.5f), difference));
+  return blendLanes<axis>(scales, difference);
+}
+
+template <int axis>
+inline __m256 haarBackwardStep3D(__m256 values) {
+  const __m256 scales = _mm256_sub_ps(
+      values, _mm256_mul_ps(_mm256_set1_ps(0.5f), swapLanes<axis>(values)));
+  return blendLanes<axis>(scales,
+                          _mm256_add_ps(values, swapLanes<axis>(scales)));
+}
+
+inline void haarForward3D(const float* child_scales, float* parent) {
+  __m256 values = _mm256_loadu_ps(child_scales);
+  values = haarForwardStep3D<0>(values);
+  values = haarForwardStep3D<1>(values);
+  values = haarForwardStep3D<2>(values);
+  _mm256_storeu_ps(parent, values);
+}
+
+inline void haarBackward3D(const float* parent, float* child_scales) {
+  __m256 values = _mm256_loadu_ps(parent);
+  values = haarBackwardStep3D<0>(values);
+  values = haarBackwardStep3D<1>(values);
+  values = haarBackwardStep3D<2>(values);
+  _mm256_storeu_ps(child_scales, values);
+}
+#define WAVEMAP_HAAR_TRANSFORM_VECTORIZED
+#elif defined(__SSE4_1__) || defined(__ARM_NEON)
+#if defined(__SSE4_1__)
+using Float4 = __m128;
+inline Float4 load4(const float* ptr) { return _mm_loadu_ps(ptr); }
+inline void store4(float* ptr, Float4 values) { _mm_storeu_ps(ptr, values); }
+inline Float4 add4(Float4 lhs, Float4 rhs) { return _mm_add_ps(lhs, rhs); }
+inline Float4 sub4(Float4 lhs, Float4 rhs) { return _mm_sub_ps(lhs, rhs); }
+inline Float4 mulHalf4(Float4 values) {
+  return _mm_mul_ps(_mm_set1_ps(0.5f), values);
+}
+// Swaps the lanes whose indices only differ in the given axis' bit
+template <int axis>
+inline Float4 swapLanes(Float4 values) {
+  if constexpr (axis == 0) {
+    return _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1));
+  } else {
+    return _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2));
+  }
+}
+// Takes the scale lanes from the first and the detail lanes, whose index has
+// the given axis' bit set, from the second argument
+template <int axis>
+inline Float4 blendLanes(Float4 scales, Float4 details) {
+  return _mm_blend_ps(scales, details, axis == 0 ? 0b1010 : 0b1100);
+}
+#else
+using Float4 = float32x4_t;
+inline Float4 load4(const float* ptr) { return vld1q_f32(ptr); }
+inline void store4(float* ptr, Float4 values) { vst1q_f32(ptr, values); }
+inline Float4 add4(Float4 lhs, Float4 rhs) { return vaddq_f32(lhs, rhs); }
+inline Float4 sub4(Float4 lhs, Float4 rhs) { return vsubq_f32(lhs, rhs); }
+inline Float4 mulHalf4(Float4 values) { return vmulq_n_f32(values, 0.5f); }
+// Swaps the lanes whose indices only differ in the given axis' bit
+template <int axis>
+inline Float4 swapLanes(Float4 values) {
+  if constexpr (axis == 0) {
+    return vrev64q_f32(values);
+  } else {
+    return vextq_f32(values, values, 2);
+  }
+}
+// Takes the scale lanes from the first and the detail lanes, whose index has
+// the given axis' bit set, from the second argument
+template <int axis>
+inline Float4 blendLanes(Float4 scales, Float4 details) {
+  const uint32x4_t mask = axis == 0 ? uint32x4_t{0u, ~0u, 0u, ~0u}
+                                    : uint32x4_t{0u, 0u, ~0u, ~0u};
+  return vbslq_f32(mask, details, scales);
+}
+#endif
+
+template <int axis>
+inline Float4 haarForwardStep3D(Float4 values) {
+  const Float4 difference = sub4(values, swapLanes<axis>(values));
+  return blendLanes<axis>(sub4(values, mulHalf4(difference)), difference);
+}
+
+template <int axis>
+inline Float4 haarBackwardStep3D(Float4 values) {
+  const Float4 scales = sub4(values, mulHalf4(swapLanes<axis>(values)));
+  return blendLanes<axis>(scales, add4(values, swapLanes<axis>(scales)));
+}
+
+// NOTE: Axes 0 and 1 are processed within each register. Along axis 2, the
+//       scale and detail coefficients are in the low and high register.
+inline void haarForward3D(const float* child_scales, float* parent) {
+  Float4 low = load4(child_scales);
+  Float4 high = load4(child_scales + 4);
+  low = haarForwardStep3D<0>(low);
+  high = haarForwardStep3D<0>(high);
+  low = haarForwardStep3D<1>(low);
+  high = haarForwardStep3D<1>(high);
+  high = sub4(high, low);
+  low = add4(low, mulHalf4(high));
+  store4(parent, low);
+  store4(parent + 4, high);
+}
+
+inline void haarBackward3D(const float* parent, float* child_scales) {
+  Float4 low = load4(parent);
+  Float4 high = load4(parent + 4);
+  low = haarBackwardStep3D<0>(low);
+  high = haarBackwardStep3D<0>(high);
+  low = haarBackwardStep3D<1>(low);
+  high = haarBackwardStep3D<1>(high);
+  low = sub4(low, mulHalf4(high));
+  high = add4(high, low);
+  store4(child_scales, low);
+  store4(child_scales + 4, high);
+}
+#define WAVEMAP_HAAR_TRANSFORM_VECTORIZED
+#endif
+
+// The vectorized transforms copy the parent's coefficients to and from the
+// kernels' buffers with a single memcpy, which the compiler turns into one
+// vector load or store. This requires the scale and detail coefficients to be
+// laid out contiguously, in the same order as in a CoefficientsArray.
+using HaarParent3D = HaarCoefficients<float, 3>::Parent;
+static_assert(std::is_trivially_copyable_v<HaarParent3D>);
+static_assert(sizeof(HaarParent3D) == 8 * sizeof(float));
+static_assert(offsetof(HaarParent3D, details) == sizeof(float));
+}  // namespace detail
+
+template <typename ValueT, int dim>
+typename HaarCoefficients<ValueT, dim>::Parent ForwardVectorized(
+    const typename HaarCoefficients<ValueT, dim>::CoefficientsArray&
+        child_scales) {
+#ifdef WAVEMAP_HAAR_TRANSFORM_VECTORIZED
+  if constexpr (std::is_same_v<ValueT, float> && dim == 3) {
+    float parent_coefficients[8];
+    detail::haarForward3D(child_scales.data(), parent_coefficients);
+    typename HaarCoefficients<ValueT, dim>::Parent parent;
+    std::memcpy(&parent, parent_coefficients, sizeof(parent));
+    return parent;
+  }
+#endif
+  return ForwardLifted<ValueT, dim>(child_scales);
+}
+
+template <typename ValueT, int dim>
+typename HaarCoefficients<ValueT, dim>::CoefficientsArray BackwardVectorized(
+    const typename HaarCoefficients<ValueT, dim>::Parent& parent) {
+#ifdef WAVEMAP_HAAR_TRANSFORM_VECTORIZED
+  if constexpr (std::is_same_v<ValueT, float> && dim == 3) {
+    float parent_coefficients[8];
+    std::memcpy(parent_coefficients, &parent, sizeof(parent));
+    typename HaarCoefficients<ValueT, dim>::CoefficientsArray child_scales;
+    detail::haarBackward3D(parent_coefficients, child_scales.data());
+    return child_scales;
+  }
+#endif
+  return BackwardLifted<ValueT, dim>(parent);
+}
+#undef WAVEMAP_HAAR_TRANSFORM_VECTORIZED
+
+template <typename ValueT, int dim>
+void ForwardLiftedBatch(const ValueT* child_scales, ValueT* parents,
+                        size_t num_nodes) {
+  // Apply the same lifting steps as ForwardLifted, each to all nodes at once
+  constexpr IndexElement kNumBeams = int_math::exp2(dim - 1);
+  // Perform the transform along axis 0 while moving the data into the arrays
+  for (IndexElement beam_idx = 0; beam_idx < kNumBeams; ++beam_idx) {
+    const size_t scale_offset =
+        bit_ops::squeeze_in(beam_idx, false, 0) * num_nodes;
+    const size_t detail_offset =
+        bit_ops::squeeze_in(beam_idx, true, 0) * num_nodes;
+    const ValueT* child_scale = child_scales + scale_offset;
+    const ValueT* child_detail = child_scales + detail_offset;
+    ValueT* parent_scale = parents + scale_offset;
+    ValueT* parent_detail = parents + detail_offset;
+    for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+      const ValueT detail = child_detail[node_idx] - child_scale[node_idx];
+      parent_scale[node_idx] =
+          child_scale[node_idx] + static_cast<ValueT>(0.5) * detail;
+      parent_detail[node_idx] = detail;
+    }
+  }
+  // Perform the transform along the remaining axes in-place
+  for (IndexElement dim_idx = 1; dim_idx < dim; ++dim_idx) {
+    for (IndexElement beam_idx = 0; beam_idx < kNumBeams; ++beam_idx) {
+      const size_t scale_offset =
+          bit_ops::squeeze_in(beam_idx, false, dim_idx) * num_nodes;
+      const size_t detail_offset =
+          bit_ops::squeeze_in(beam_idx, true, dim_idx) * num_nodes;
+      ValueT* parent_scale = parents + scale_offset;
+      ValueT* parent_detail = parents + detail_offset;
+      for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+        const ValueT scale = parent_scale[node_idx];
+        const ValueT detail = parent_detail[node_idx] - scale;
+        parent_scale[node_idx] = scale + static_cast<ValueT>(0.5) * detail;
+        parent_detail[node_idx] = detail;
+      }
+    }
+  }
+}
+
+template <typename ValueT, int dim>
+void BackwardLiftedBatch(const ValueT* parents, ValueT* child_scales,
+                         size_t num_nodes) {
+  // Apply the same lifting steps as BackwardLifted, each to all nodes at once
+  constexpr IndexElement kNumBeams = int_math::exp2(dim - 1);
+  // Perform the transform along axis 0 while moving the data into the arrays
+  for (IndexElement beam_idx = 0; beam_idx < kNumBeams; ++beam_idx) {
+    const size_t scale_offset =
+        bit_ops::squeeze_in(beam_idx, false, 0) * num_nodes;
+    const size_t detail_offset =
+        bit_ops::squeeze_in(beam_idx, true, 0) * num_nodes;
+    const ValueT* parent_scale = parents + scale_offset;
+    const ValueT* parent_detail = parents + detail_offset;
+    ValueT* child_scale = child_scales + scale_offset;
+    ValueT* child_detail = child_scales + detail_offset;
+    for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+      const ValueT detail = parent_detail[node_idx];
+      const ValueT scale =
+          parent_scale[node_idx] - static_cast<ValueT>(0.5) * detail;
+      child_scale[node_idx] = scale;
+      child_detail[node_idx] = detail + scale;
+    }
+  }
+  // Perform the transform along the remaining axes in-place
+  for (IndexElement dim_idx = 1; dim_idx < dim; ++dim_idx) {
+    for (IndexElement beam_idx = 0; beam_idx < kNumBeams; ++beam_idx) {
+      const size_t scale_offset =
+          bit_ops::squeeze_in(beam_idx, false, dim_idx) * num_nodes;
+      const size_t detail_offset =
+          bit_ops::squeeze_in(beam_idx, true, dim_idx) * num_nodes;
+      ValueT* child_scale = child_scales + scale_offset;
+      ValueT* child_detail = child_scales + detail_offset;
+      for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+        const ValueT detail = child_detail[node_idx];
+        const ValueT scale =
+            child_scale[node_idx] - static_cast<ValueT>(0.5) * detail;
+        child_scale[node_idx] = scale;
+        child_detail[node_idx] = detail + scale;
+      }
+    }
+  }
+}
 }  // namespace wavemap
 
 #endif  // WAVEMAP_CORE_MAP_CELL_TYPES_IMPL_HAAR_TRANSFORM_INL_H_
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/config/config_base.h"
@@ -11,6 +12,7 @@
 #include "wavemap/core/map/hashed_chunked_wavelet_octree_block.h"
 #include "wavemap/core/map/map_base.h"
 #include "wavemap/core/utils/math/int_math.h"
+#include "wavemap/core/utils/thread_pool.h"
 
 namespace wavemap {
 /**
@@ -81,11 +83,20 @@ class HashedChunkedWaveletOctree : public MapBase {
 
   bool empty() const override { return block_map_.empty(); }
   size_t size() const override;
-  void threshold() override;
-  void prune() override;
-  void pruneSmart() override;
+  void threshold() override { threshold(nullptr); }
+  void prune() override { prune(nullptr); }
+  void pruneSmart() override { pruneSmart(nullptr); }
   void clear() override { block_map_.clear(); }
 
+  //! Variants of threshold(), prune() and pruneSmart() that process the blocks
+  //! in parallel on the given thread pool, or serially if it is null
+  //! @note Only blocks that are flagged as needing thresholding or pruning are
+  //!       visited. Blocks that end up empty are erased in a single batch
+  //!       after all blocks have been processed.
+  void threshold(ThreadPool* thread_pool);
+  void prune(ThreadPool* thread_pool);
+  void pruneSmart(ThreadPool* thread_pool);
+
   size_t getMemoryUsage() const override;
 
   Index3D getMinIndex() const override;
@@ -124,6 +135,9 @@ class HashedChunkedWaveletOctree : public MapBase {
   void forEachLeaf(
       typename MapBase::IndexedLeafVisitorFunction visitor_fn) const override;
 
+  BlockIndex indexToBlockIndex(const OctreeIndex& node_index) const;
+  CellIndex indexToCellIndex(OctreeIndex index) const;
+
  private:
   const HashedChunkedWaveletOctreeConfig config_;
   const IndexElement cells_per_block_side_ =
@@ -131,8 +145,8 @@ class HashedChunkedWaveletOctree : public MapBase {
 
   BlockHashMap block_map_;
 
-  BlockIndex indexToBlockIndex(const OctreeIndex& node_index) const;
-  CellIndex indexToCellIndex(OctreeIndex index) const;
+  void eraseEmptyBlocks(const std::vector<BlockIndex>& block_indices,
+                        const std::vector<Block*>& blocks);
 };
 }  // namespace wavemap
 
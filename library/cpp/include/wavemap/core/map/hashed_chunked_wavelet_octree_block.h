@@ -6,6 +6,7 @@
 #include "wavemap/core/map/cell_types/haar_coefficients.h"
 #include "wavemap/core/map/cell_types/haar_transform.h"
 #include "wavemap/core/map/map_base.h"
+#include "wavemap/core/utils/memory/arena_allocator.h"
 #include "wavemap/core/utils/time/time.h"
 
 namespace wavemap {
@@ -17,7 +18,10 @@ class HashedChunkedWaveletOctreeBlock {
   using BlockIndex = Index3D;
   using Coefficients = HaarCoefficients<FloatingPoint, kDim>;
   using Transform = HaarTransform<FloatingPoint, kDim>;
-  using ChunkedOctreeType = ChunkedOctree<Coefficients::Details, kChunkHeight>;
+  // NOTE: The chunks of each block are allocated from a private arena, such
+  //       that erasing a block frees all of them at once.
+  using ChunkedOctreeType =
+      ChunkedOctree<Coefficients::Details, kChunkHeight, ArenaAllocator>;
 
   explicit HashedChunkedWaveletOctreeBlock(IndexElement tree_height,
                                            FloatingPoint min_log_odds,
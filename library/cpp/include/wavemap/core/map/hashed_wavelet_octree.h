@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/config/config_base.h"
@@ -11,6 +12,7 @@
 #include "wavemap/core/map/hashed_wavelet_octree_block.h"
 #include "wavemap/core/map/map_base.h"
 #include "wavemap/core/utils/math/int_math.h"
+#include "wavemap/core/utils/thread_pool.h"
 
 namespace wavemap {
 /**
@@ -76,11 +78,20 @@ class HashedWaveletOctree : public MapBase {
 
   bool empty() const override { return block_map_.empty(); }
   size_t size() const override;
-  void threshold() override;
-  void prune() override;
-  void pruneSmart() override;
+  void threshold() override { threshold(nullptr); }
+  void prune() override { prune(nullptr); }
+  void pruneSmart() override { pruneSmart(nullptr); }
   void clear() override { block_map_.clear(); }
 
+  //! Variants of threshold(), prune() and pruneSmart() that process the blocks
+  //! in parallel on the given thread pool, or serially if it is null
+  //! @note Only blocks that are flagged as needing thresholding or pruning are
+  //!       visited. Blocks that end up empty are erased in a single batch
+  //!       after all blocks have been processed.
+  void threshold(ThreadPool* thread_pool);
+  void prune(ThreadPool* thread_pool);
+  void pruneSmart(ThreadPool* thread_pool);
+
   size_t getMemoryUsage() const override;
 
   Index3D getMinIndex() const override;
@@ -127,6 +138,9 @@ class HashedWaveletOctree : public MapBase {
       int_math::exp2(config_.tree_height);
 
   BlockHashMap block_map_;
+
+  void eraseEmptyBlocks(const std::vector<BlockIndex>& block_indices,
+                        const std::vector<Block*>& blocks);
 };
 }  // namespace wavemap
 
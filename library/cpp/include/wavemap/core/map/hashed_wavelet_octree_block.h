@@ -6,6 +6,7 @@
 #include "wavemap/core/map/cell_types/haar_coefficients.h"
 #include "wavemap/core/map/cell_types/haar_transform.h"
 #include "wavemap/core/map/map_base.h"
+#include "wavemap/core/utils/memory/arena_allocator.h"
 #include "wavemap/core/utils/time/time.h"
 
 namespace wavemap {
@@ -15,7 +16,9 @@ class HashedWaveletOctreeBlock {
   using BlockIndex = Index3D;
   using Coefficients = HaarCoefficients<FloatingPoint, kDim>;
   using Transform = HaarTransform<FloatingPoint, kDim>;
-  using OctreeType = Octree<Coefficients::Details>;
+  // NOTE: The nodes of each block are allocated from a private arena, such
+  //       that erasing a block frees all of them at once.
+  using OctreeType = Octree<Coefficients::Details, ArenaAllocator>;
   using NodeType = OctreeType::NodeType;
 
   explicit HashedWaveletOctreeBlock(IndexElement tree_height,
@@ -115,15 +115,18 @@ class MapBase {
       std::function<void(const OctreeIndex& index, FloatingPoint value)>;
   virtual void forEachLeaf(IndexedLeafVisitorFunction visitor_fn) const = 0;
 
- protected:
-  const MapBaseConfig config_;
-
+  //! Clamp an occupancy value to the map's min and max log-odds
   FloatingPoint clamp(FloatingPoint value) const {
     return std::clamp(value, config_.min_log_odds, config_.max_log_odds);
   }
+  //! Add an update to an occupancy value, clamping the result like
+  //! addToCellValue(...) does
   FloatingPoint clampedAdd(FloatingPoint value, FloatingPoint update) const {
     return clamp(value + update);
   }
+
+ protected:
+  const MapBaseConfig config_;
 };
 }  // namespace wavemap
 
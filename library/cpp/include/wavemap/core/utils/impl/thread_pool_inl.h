@@ -0,0 +1,132 @@
+#ifndef WAVEMAP_CORE_UTILS_IMPL_THREAD_POOL_INL_H_
+#define WAVEMAP_CORE_UTILS_IMPL_THREAD_POOL_INL_H_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace wavemap {
+template <typename Callable, typename... Args>
+std::future<std::result_of_t<Callable(Args...)>> ThreadPool::add_task(
+    Callable&& callable, Args&&... args) {
+  using ReturnType = std::result_of_t<Callable(Args...)>;
+
+  auto task = std::packaged_task<ReturnType()>(
+      std::bind(std::forward<Callable>(callable), std::forward<Args>(args)...));
+  auto future = task.get_future();
+  push_task(Task{std::move(task)});
+
+  return future;
+}
+
+template <typename Callable>
+void ThreadPool::add_detached_task(Callable&& callable) {
+  push_task(Task{std::forward<Callable>(callable)});
+}
+
+template <typename IndexT, typename Body>
+void ThreadPool::parallel_for(IndexT begin, IndexT end, Body&& body,
+                              size_t grain_size) {
+  if (end <= begin) {
+    return;
+  }
+
+  // Split the range into a few chunks per worker, such that idle workers can
+  // still steal work if the per-index cost is unbalanced
+  constexpr size_t kChunksPerWorker = 4;
+  const size_t num_indices = static_cast<size_t>(end - begin);
+  if (grain_size == 0) {
+    grain_size =
+        std::max(size_t{1}, num_indices / (kChunksPerWorker * num_workers_));
+  }
+
+  // Share a single copy of the body among all chunks
+  auto shared_body =
+      std::make_shared<std::decay_t<Body>>(std::forward<Body>(body));
+  for (size_t chunk_begin = 0; chunk_begin < num_indices;
+       chunk_begin += grain_size) {
+    const size_t chunk_end = std::min(chunk_begin + grain_size, num_indices);
+    const IndexT first = begin + static_cast<IndexT>(chunk_begin);
+    const IndexT last = begin + static_cast<IndexT>(chunk_end);
+    add_detached_task([shared_body, first, last]() {
+      for (IndexT idx = first; idx < last; ++idx) {
+        (*shared_body)(idx);
+      }
+    });
+  }
+}
+
+template <typename Callable>
+void ThreadPool::TaskGroup::add_task(Callable&& callable) {
+  pending_count_.fetch_add(1, std::memory_order_relaxed);
+  pool_.add_detached_task(
+      [this, task = std::forward<Callable>(callable)]() mutable {
+        task();
+        pending_count_.fetch_sub(1, std::memory_order_release);
+      });
+}
+
+template <typename Callable, typename>
+ThreadPool::Task::Task(Callable&& callable) {
+  using CallableT = std::decay_t<Callable>;
+  if constexpr (kStoredInline<CallableT>) {
+    new (storage_) CallableT(std::forward<Callable>(callable));
+  } else {
+    new (storage_) CallableT*(new CallableT(std::forward<Callable>(callable)));
+  }
+  ops_ = getOps<CallableT>();
+}
+
+template <typename CallableT>
+const ThreadPool::Task::Ops* ThreadPool::Task::getOps() {
+  if constexpr (kStoredInline<CallableT>) {
+    static constexpr Ops kOps{
+        [](void* storage) {
+          (*std::launder(static_cast<CallableT*>(storage)))();
+        },
+        [](void* dst, void* src) {
+          auto* src_callable = std::launder(static_cast<CallableT*>(src));
+          new (dst) CallableT(std::move(*src_callable));
+          src_callable->~CallableT();
+        },
+        [](void* storage) {
+          std::launder(static_cast<CallableT*>(storage))->~CallableT();
+        }};
+    return &kOps;
+  } else {
+    static constexpr Ops kOps{
+        [](void* storage) { (**static_cast<CallableT**>(storage))(); },
+        [](void* dst, void* src) {
+          new (dst) CallableT*(*static_cast<CallableT**>(src));
+        },
+        [](void* storage) { delete *static_cast<CallableT**>(storage); }};
+    return &kOps;
+  }
+}
+
+inline ThreadPool::Task& ThreadPool::Task::operator=(Task&& other) noexcept {
+  if (this != &other) {
+    reset();
+    moveFrom(other);
+  }
+  return *this;
+}
+
+inline void ThreadPool::Task::moveFrom(Task& other) noexcept {
+  if (other.ops_) {
+    other.ops_->relocate(storage_, other.storage_);
+    ops_ = std::exchange(other.ops_, nullptr);
+  }
+}
+
+inline void ThreadPool::Task::reset() noexcept {
+  if (ops_) {
+    ops_->destroy(storage_);
+    ops_ = nullptr;
+  }
+}
+}  // namespace wavemap
+
+#endif  // WAVEMAP_CORE_UTILS_IMPL_THREAD_POOL_INL_H_
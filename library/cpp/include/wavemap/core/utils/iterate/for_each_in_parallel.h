@@ -0,0 +1,34 @@
+#ifndef WAVEMAP_CORE_UTILS_ITERATE_FOR_EACH_IN_PARALLEL_H_
+#define WAVEMAP_CORE_UTILS_ITERATE_FOR_EACH_IN_PARALLEL_H_
+
+#include <vector>
+
+#include "wavemap/core/utils/thread_pool.h"
+
+namespace wavemap {
+/**
+ * \brief Calls fn(*item) for each of the given items, on the thread pool if
+ *        one is provided and serially otherwise.
+ *
+ * \note The tasks are joined through a ThreadPool::TaskGroup. The call is
+ *       therefore also safe from within tasks running on the same pool, and
+ *       it does not wait for unrelated work that shares the pool.
+ */
+template <typename ItemT, typename Fn>
+void forEachInParallel(const std::vector<ItemT*>& items, Fn fn,
+                       ThreadPool* thread_pool) {
+  if (!thread_pool || items.size() <= 1) {
+    for (ItemT* item : items) {
+      fn(*item);
+    }
+    return;
+  }
+  ThreadPool::TaskGroup task_group{*thread_pool};
+  for (ItemT* item : items) {
+    task_group.add_task([&fn, item]() { fn(*item); });
+  }
+  task_group.wait();
+}
+}  // namespace wavemap
+
+#endif  // WAVEMAP_CORE_UTILS_ITERATE_FOR_EACH_IN_PARALLEL_H_
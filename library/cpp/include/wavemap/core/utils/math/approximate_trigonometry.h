@@ -68,9 +68,9 @@ struct atan2 {
     // If swapped, adjust atan output
     res = swap ? std::copysign(kHalfPi, atan_input) - res : res;
     // Adjust the result depending on the input quadrant
-    if (x < 0.0f) {
-      res = std::copysign(kPi, y) + res;
-    }
+    // NOTE: This is written as a select instead of a branch, such that loops
+    //       calling atan2 can be vectorized by the compiler.
+    res = x < 0.0f ? std::copysign(kPi, y) + res : res;
 
     // Return the result
     return res;
@@ -0,0 +1,42 @@
+#ifndef WAVEMAP_CORE_UTILS_MEMORY_ALLOCATOR_REF_H_
+#define WAVEMAP_CORE_UTILS_MEMORY_ALLOCATOR_REF_H_
+
+#include <type_traits>
+
+#include <glog/logging.h>
+
+namespace wavemap {
+/**
+ * @brief Non-owning reference to the allocator a node allocates its children
+ *        with.
+ *
+ * For stateless allocators, such as the HeapAllocator, the reference is an
+ * empty class. Nodes that inherit from it therefore take up no additional
+ * memory (empty base optimization).
+ */
+template <typename AllocatorT, bool = std::is_empty_v<AllocatorT>>
+class AllocatorRef {
+ public:
+  AllocatorRef() = default;
+  explicit AllocatorRef(AllocatorT* /*allocator*/) {}
+
+  AllocatorT& getAllocator() const {
+    static AllocatorT allocator;
+    return allocator;
+  }
+};
+
+template <typename AllocatorT>
+class AllocatorRef<AllocatorT, false> {
+ public:
+  AllocatorRef() = default;
+  explicit AllocatorRef(AllocatorT* allocator) : allocator_(allocator) {}
+
+  AllocatorT& getAllocator() const { return *DCHECK_NOTNULL(allocator_); }
+
+ private:
+  AllocatorT* allocator_ = nullptr;
+};
+}  // namespace wavemap
+
+#endif  // WAVEMAP_CORE_UTILS_MEMORY_ALLOCATOR_REF_H_
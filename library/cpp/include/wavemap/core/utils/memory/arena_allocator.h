@@ -0,0 +1,83 @@
+#ifndef WAVEMAP_CORE_UTILS_MEMORY_ARENA_ALLOCATOR_H_
+#define WAVEMAP_CORE_UTILS_MEMORY_ARENA_ALLOCATOR_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace wavemap {
+/**
+ * @brief Allocator that carves objects out of large memory slabs.
+ *
+ * Objects are handed out from the current slab by bumping a pointer. Destroyed
+ * objects are kept in free lists, one per object size, and reused by later
+ * allocations of the same size. All memory is returned to the system at once
+ * when the allocator is cleared or destroyed, without visiting the individual
+ * objects. This makes it well suited for data structures that are built and
+ * freed as a whole, such as the trees of hashed map blocks.
+ *
+ * @note Allocations and deallocations are thread safe. Calling clear() while
+ *       other threads still use the allocator is not.
+ */
+class ArenaAllocator {
+ public:
+  //! Whether all objects can be freed at once by destroying the allocator
+  static constexpr bool kReleasesInBulk = true;
+
+  ArenaAllocator() = default;
+  ~ArenaAllocator() = default;
+
+  // Prevent copying and moving, since the allocated objects point into it
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args);
+  template <typename T>
+  void destroy(T* object);
+
+  void* allocate(size_t num_bytes);
+  void deallocate(void* ptr, size_t num_bytes);
+
+  //! Free all slabs at once. Note that the destructors of the objects that are
+  //! still alive are not called.
+  void clear();
+
+  //! Memory reserved by the slabs, in bytes
+  size_t getMemoryUsage() const;
+
+ private:
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+  static constexpr size_t kMinSlabSize = 4096;
+  static constexpr size_t kMaxSlabSize = 65536;
+
+  struct FreeListNode {
+    FreeListNode* next = nullptr;
+  };
+  struct FreeList {
+    size_t object_size;
+    FreeListNode* head;
+  };
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<std::byte[]>> slabs_;
+  std::byte* slab_cursor_ = nullptr;
+  std::byte* slab_end_ = nullptr;
+  size_t next_slab_size_ = kMinSlabSize;
+  size_t reserved_bytes_ = 0;
+  // NOTE: The trees only allocate objects of a couple of different sizes, so
+  //       a linear search over the free lists is faster than a hash map.
+  std::vector<FreeList> free_lists_;
+
+  static constexpr size_t roundUpToAlignment(size_t num_bytes) {
+    return (num_bytes + kAlignment - 1) / kAlignment * kAlignment;
+  }
+  FreeList& getFreeList(size_t object_size);
+};
+}  // namespace wavemap
+
+#include "wavemap/core/utils/memory/impl/arena_allocator_inl.h"
+
+#endif  // WAVEMAP_CORE_UTILS_MEMORY_ARENA_ALLOCATOR_H_
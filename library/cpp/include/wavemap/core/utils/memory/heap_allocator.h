@@ -0,0 +1,30 @@
+#ifndef WAVEMAP_CORE_UTILS_MEMORY_HEAP_ALLOCATOR_H_
+#define WAVEMAP_CORE_UTILS_MEMORY_HEAP_ALLOCATOR_H_
+
+#include <utility>
+
+namespace wavemap {
+/**
+ * @brief Stateless allocator that creates each object with its own heap
+ *        allocation.
+ *
+ * This is the default allocator of the tree data structures. Since it holds no
+ * state, nodes that refer to it take up no additional memory.
+ */
+struct HeapAllocator {
+  //! Whether all objects can be freed at once by destroying the allocator
+  static constexpr bool kReleasesInBulk = false;
+
+  template <typename T, typename... Args>
+  static T* create(Args&&... args) {
+    return new T(std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  static void destroy(T* object) {
+    delete object;
+  }
+};
+}  // namespace wavemap
+
+#endif  // WAVEMAP_CORE_UTILS_MEMORY_HEAP_ALLOCATOR_H_
@@ -0,0 +1,25 @@
+#ifndef WAVEMAP_CORE_UTILS_MEMORY_IMPL_ARENA_ALLOCATOR_INL_H_
+#define WAVEMAP_CORE_UTILS_MEMORY_IMPL_ARENA_ALLOCATOR_INL_H_
+
+#include <new>
+#include <utility>
+
+namespace wavemap {
+template <typename T, typename... Args>
+T* ArenaAllocator::create(Args&&... args) {
+  static_assert(alignof(T) <= kAlignment,
+                "Over-aligned types are not supported.");
+  void* ptr = allocate(sizeof(T));
+  return new (ptr) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void ArenaAllocator::destroy(T* object) {
+  if (object) {
+    object->~T();
+    deallocate(object, sizeof(T));
+  }
+}
+}  // namespace wavemap
+
+#endif  // WAVEMAP_CORE_UTILS_MEMORY_IMPL_ARENA_ALLOCATOR_INL_H_
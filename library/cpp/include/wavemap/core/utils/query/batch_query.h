@@ -0,0 +1,47 @@
+#ifndef WAVEMAP_CORE_UTILS_QUERY_BATCH_QUERY_H_
+#define WAVEMAP_CORE_UTILS_QUERY_BATCH_QUERY_H_
+
+#include <vector>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/indexing/ndtree_index.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
+#include "wavemap/core/map/hashed_wavelet_octree.h"
+#include "wavemap/core/map/map_base.h"
+#include "wavemap/core/utils/thread_pool.h"
+
+/**
+ * Functions to query the values of many cells at once.
+ *
+ * For hashed wavelet octrees, the queries are sorted by block and by Morton
+ * code within each block. Consecutive queries can then reuse the block lookups
+ * and the wavelet decompression steps they have in common. The values are
+ * written to the output vector in the order of the original queries, which is
+ * resized as needed. If a thread pool is provided, the queries are split into
+ * shards of whole blocks that are processed in parallel.
+ * @note For map types without a specialized implementation, the queries are
+ *       evaluated one by one in their original order.
+ */
+namespace wavemap::query {
+//! Query the values of the map at the given indices
+void getCellValues(const MapBase& map, const std::vector<Index3D>& indices,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool = nullptr);
+
+//! Query the values of the map at the cells closest to the given positions
+void getCellValues(const MapBase& map, const std::vector<Point3D>& positions,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool = nullptr);
+
+//! Query the values of the map at the given octree node indices
+void getCellValues(const HashedWaveletOctree& map,
+                   const std::vector<OctreeIndex>& node_indices,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool = nullptr);
+void getCellValues(const HashedChunkedWaveletOctree& map,
+                   const std::vector<OctreeIndex>& node_indices,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool = nullptr);
+}  // namespace wavemap::query
+
+#endif  // WAVEMAP_CORE_UTILS_QUERY_BATCH_QUERY_H_
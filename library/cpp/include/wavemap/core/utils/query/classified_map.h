@@ -3,14 +3,18 @@
 
 #include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "wavemap/core/data_structure/ndtree/ndtree.h"
 #include "wavemap/core/data_structure/ndtree_block_hash.h"
 #include "wavemap/core/map/hashed_blocks.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 #include "wavemap/core/utils/query/occupancy_classifier.h"
 #include "wavemap/core/utils/query/query_accelerator.h"
+#include "wavemap/core/utils/thread_pool.h"
+#include "wavemap/core/utils/time/time.h"
 
 namespace wavemap {
 struct ChildBitset {
@@ -51,6 +55,13 @@ class ClassifiedMap {
                 const OccupancyClassifier& classifier,
                 const HashedBlocks& esdf_map, FloatingPoint robot_radius);
 
+  ClassifiedMap(const HashedChunkedWaveletOctree& occupancy_map,
+                const OccupancyClassifier& classifier);
+
+  ClassifiedMap(const HashedChunkedWaveletOctree& occupancy_map,
+                const OccupancyClassifier& classifier,
+                const HashedBlocks& esdf_map, FloatingPoint robot_radius);
+
   bool empty() const { return block_map_.empty(); }
 
   FloatingPoint getMinCellWidth() const { return min_cell_width_; }
@@ -62,9 +73,34 @@ class ClassifiedMap {
   Index3D getMaxBlockIndex() const { return block_map_.getMaxBlockIndex(); }
   IndexElement getLastResultHeight() const { return query_cache_.height; }
 
-  void update(const HashedWaveletOctree& occupancy_map);
+  //! Reclassify all blocks, in parallel if a thread pool is provided
+  void update(const HashedWaveletOctree& occupancy_map,
+              ThreadPool* thread_pool = nullptr);
   void update(const HashedWaveletOctree& occupancy_map,
-              const HashedBlocks& esdf_map, FloatingPoint robot_radius);
+              const HashedBlocks& esdf_map, FloatingPoint robot_radius,
+              ThreadPool* thread_pool = nullptr);
+  void update(const HashedChunkedWaveletOctree& occupancy_map,
+              ThreadPool* thread_pool = nullptr);
+  void update(const HashedChunkedWaveletOctree& occupancy_map,
+              const HashedBlocks& esdf_map, FloatingPoint robot_radius,
+              ThreadPool* thread_pool = nullptr);
+
+  //! Only reclassify the blocks whose last updated stamp is newer than the
+  //! previous update, in parallel if a thread pool is provided
+  void updateChangedBlocks(const HashedWaveletOctree& occupancy_map,
+                           ThreadPool* thread_pool = nullptr);
+  void updateChangedBlocks(const HashedChunkedWaveletOctree& occupancy_map,
+                           ThreadPool* thread_pool = nullptr);
+  //! Only reclassify the blocks that changed since the previous update, and
+  //! the blocks within robot_radius of them whose ESDF values may have changed
+  void updateChangedBlocks(const HashedWaveletOctree& occupancy_map,
+                           const HashedBlocks& esdf_map,
+                           FloatingPoint robot_radius,
+                           ThreadPool* thread_pool = nullptr);
+  void updateChangedBlocks(const HashedChunkedWaveletOctree& occupancy_map,
+                           const HashedBlocks& esdf_map,
+                           FloatingPoint robot_radius,
+                           ThreadPool* thread_pool = nullptr);
 
   bool has(const Index3D& index, Occupancy::Id occupancy_type) const;
   bool has(const OctreeIndex& index, Occupancy::Id occupancy_type) const;
@@ -118,6 +154,24 @@ class ClassifiedMap {
   const OccupancyClassifier classifier_;
   BlockHashMap block_map_{tree_height_};
 
+  // Time at which the previous update started, used to find changed blocks
+  std::optional<Timestamp> last_update_stamp_;
+
+  // NOTE: These methods are templated on the occupancy map type, such that
+  //       hashed wavelet octrees and hashed chunked wavelet octrees can be
+  //       classified directly through their own node types.
+  template <typename HashedMapT>
+  void updateImpl(const HashedMapT& occupancy_map, bool only_changed_blocks,
+                  ThreadPool* thread_pool);
+  template <typename HashedMapT>
+  void updateImpl(const HashedMapT& occupancy_map, const HashedBlocks& esdf_map,
+                  FloatingPoint robot_radius, bool only_changed_blocks,
+                  ThreadPool* thread_pool);
+  template <typename HashedMapT, typename ClassifyBlockFn>
+  void updateBlocks(const HashedMapT& occupancy_map, bool only_changed_blocks,
+                    IndexElement changed_block_dilation,
+                    ThreadPool* thread_pool, ClassifyBlockFn classify_block_fn);
+
   // Cache previous queries
   struct QueryCache {
     explicit QueryCache(IndexElement tree_height) : tree_height(tree_height) {}
@@ -147,13 +201,14 @@ class ClassifiedMap {
   };
   mutable QueryCache query_cache_{tree_height_};
 
-  void recursiveClassifier(
-      const HashedWaveletOctreeBlock::NodeType& occupancy_node,
-      FloatingPoint average_occupancy, Node& classified_node);
+  template <typename OccupancyNodeT>
+  void recursiveClassifier(const OccupancyNodeT& occupancy_node,
+                           FloatingPoint average_occupancy,
+                           Node& classified_node);
 
+  template <typename OccupancyNodePtrT>
   void recursiveClassifier(
-      const OctreeIndex& node_index,
-      const HashedWaveletOctreeBlock::NodeType* occupancy_node,
+      const OctreeIndex& node_index, OccupancyNodePtrT occupancy_node,
       FloatingPoint occupancy_average,
       QueryAccelerator<HashedBlocks::DenseBlockHash>& esdf_map,
       FloatingPoint robot_radius, Node& classified_node);
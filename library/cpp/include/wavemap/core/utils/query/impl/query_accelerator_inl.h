@@ -5,15 +5,18 @@
 #include <utility>
 
 namespace wavemap {
-template <typename BlockDataT, int dim>
-void QueryAccelerator<SpatialHash<BlockDataT, dim>>::reset() {
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+void QueryAccelerator<SpatialHash<BlockDataT, dim, BlockHashMapT>>::reset() {
   last_block_index_ =
       Index3D::Constant(std::numeric_limits<IndexElement>::max());
   last_block_ = nullptr;
 }
 
-template <typename BlockDataT, int dim>
-BlockDataT* QueryAccelerator<SpatialHash<BlockDataT, dim>>::getBlock(
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+BlockDataT*
+QueryAccelerator<SpatialHash<BlockDataT, dim, BlockHashMapT>>::getBlock(
     const Index<dim>& block_index) {
   if (block_index != last_block_index_) {
     last_block_index_ = block_index;
@@ -22,10 +25,11 @@ BlockDataT* QueryAccelerator<SpatialHash<BlockDataT, dim>>::getBlock(
   return last_block_;
 }
 
-template <typename BlockDataT, int dim>
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
 template <typename... DefaultArgs>
-BlockDataT& QueryAccelerator<SpatialHash<BlockDataT, dim>>::getOrAllocateBlock(
-    const Index<dim>& block_index, DefaultArgs&&... args) {
+BlockDataT& QueryAccelerator<SpatialHash<BlockDataT, dim, BlockHashMapT>>::
+    getOrAllocateBlock(const Index<dim>& block_index, DefaultArgs&&... args) {
   if (block_index != last_block_index_ || !last_block_) {
     last_block_index_ = block_index;
     last_block_ = &spatial_hash_.getOrAllocateBlock(
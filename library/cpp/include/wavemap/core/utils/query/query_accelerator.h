@@ -7,6 +7,7 @@
 #include "wavemap/core/data_structure/ndtree_block_hash.h"
 #include "wavemap/core/data_structure/spatial_hash.h"
 #include "wavemap/core/indexing/index_hashes.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 
 namespace wavemap {
@@ -21,12 +22,14 @@ template <typename T>
 QueryAccelerator(const T& type) -> QueryAccelerator<T>;
 
 // Query accelerator for vanilla spatial hashes
-template <typename BlockDataT, int dim>
-class QueryAccelerator<SpatialHash<BlockDataT, dim>> {
+template <typename BlockDataT, int dim,
+          template <typename, int> typename BlockHashMapT>
+class QueryAccelerator<SpatialHash<BlockDataT, dim, BlockHashMapT>> {
  public:
   static constexpr int kDim = dim;
+  using SpatialHashType = SpatialHash<BlockDataT, dim, BlockHashMapT>;
 
-  explicit QueryAccelerator(SpatialHash<BlockDataT, dim>& spatial_hash)
+  explicit QueryAccelerator(SpatialHashType& spatial_hash)
       : spatial_hash_(spatial_hash) {}
 
   void reset();
@@ -37,7 +40,7 @@ class QueryAccelerator<SpatialHash<BlockDataT, dim>> {
                                  DefaultArgs&&... args);
 
  private:
-  SpatialHash<BlockDataT, dim>& spatial_hash_;
+  SpatialHashType& spatial_hash_;
 
   Index<dim> last_block_index_ =
       Index3D::Constant(std::numeric_limits<IndexElement>::max());
@@ -156,6 +159,66 @@ class QueryAccelerator<HashedWaveletOctree> {
   MortonIndex morton_code_ = std::numeric_limits<MortonIndex>::max();
   IndexElement height_ = tree_height_;
 };
+
+/**
+ * A class that accelerates queries by caching block and chunk addresses to
+ * speed up data structure traversals, and intermediate wavelet decompression
+ * results to reduce redundant computation.
+ * @note This class is safe to use in a multi-threaded environment. However,
+ *       concurrent calls to a single instance from multiple threads are not.
+ *       Since the accelerator is lightweight and cheap to construct, we
+ *       recommend using a separate instance per thread for the best performance
+ *       and simplicity.
+ */
+template <>
+class QueryAccelerator<HashedChunkedWaveletOctree> {
+ public:
+  static constexpr int kDim = HashedChunkedWaveletOctree::kDim;
+
+  explicit QueryAccelerator(const HashedChunkedWaveletOctree& map)
+      : map_(map) {}
+
+  //! Reset the cache
+  //! @note This method must be called whenever the map changes, not only to
+  //!       guarantee correct values (after node value changes) but also to
+  //!       avoid segmentation fault after map topology changes (e.g. after
+  //!       pruning).
+  void reset();
+
+  //! Query the value of the map at a given index
+  FloatingPoint getCellValue(const Index3D& index) {
+    return getCellValue(OctreeIndex{0, index});
+  }
+
+  //! Query the value of the map at a given octree node index
+  FloatingPoint getCellValue(const OctreeIndex& index);
+
+  //! Convenience function to get the map's minimum cell width
+  FloatingPoint getMinCellWidth() const { return map_.getMinCellWidth(); }
+
+ private:
+  using BlockIndex = HashedChunkedWaveletOctree::BlockIndex;
+  using BlockType = HashedChunkedWaveletOctree::Block;
+  using ChunkType = BlockType::ChunkedOctreeType::ChunkType;
+  static constexpr IndexElement kChunkHeight = BlockType::kChunkHeight;
+  static constexpr IndexElement kMaxChunkStackDepth =
+      BlockType::kMaxSupportedTreeHeight / kChunkHeight;
+
+  const HashedChunkedWaveletOctree& map_;
+  const IndexElement tree_height_ = map_.getTreeHeight();
+
+  const BlockType* block_ = nullptr;
+  std::array<const ChunkType*, kMaxChunkStackDepth> chunk_stack_{};
+  std::array<FloatingPoint, morton::kMaxTreeHeight<3>> value_stack_{};
+
+  BlockIndex block_index_ =
+      BlockIndex::Constant(std::numeric_limits<IndexElement>::max());
+  MortonIndex morton_code_ = std::numeric_limits<MortonIndex>::max();
+  IndexElement height_ = tree_height_;
+  //! Whether the node at height_ has no higher resolution details, meaning
+  //! that all of its descendants share its value
+  bool reached_leaf_ = false;
+};
 }  // namespace wavemap
 
 #include "wavemap/core/utils/query/impl/query_accelerator_inl.h"
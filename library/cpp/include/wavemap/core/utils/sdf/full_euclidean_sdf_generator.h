@@ -4,6 +4,7 @@
 #include "wavemap/core/common.h"
 #include "wavemap/core/data_structure/bucket_queue.h"
 #include "wavemap/core/map/hashed_blocks.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 #include "wavemap/core/utils/neighbors/grid_neighborhood.h"
 
@@ -32,6 +33,7 @@ class FullEuclideanSDFGenerator {
       : max_distance_(max_distance), classifier_(occupancy_threshold) {}
 
   HashedBlocks generate(const HashedWaveletOctree& occupancy_map) const;
+  HashedBlocks generate(const HashedChunkedWaveletOctree& occupancy_map) const;
 
   FloatingPoint getMaxDistance() const { return max_distance_; }
 
@@ -46,10 +48,16 @@ class FullEuclideanSDFGenerator {
                                      const Index3D& parent,
                                      FloatingPoint min_cell_width);
 
-  void seed(const HashedWaveletOctree& occupancy_map, VectorDistanceField& sdf,
+  // NOTE: These methods are templated on the occupancy map type, such that
+  //       both hashed wavelet octrees and hashed chunked wavelet octrees can
+  //       be processed natively.
+  template <typename HashedMapT>
+  HashedBlocks generateImpl(const HashedMapT& occupancy_map) const;
+  template <typename HashedMapT>
+  void seed(const HashedMapT& occupancy_map, VectorDistanceField& sdf,
             BucketQueue<Index3D>& open_queue) const;
-  void propagate(const HashedWaveletOctree& occupancy_map,
-                 VectorDistanceField& sdf,
+  template <typename HashedMapT>
+  void propagate(const HashedMapT& occupancy_map, VectorDistanceField& sdf,
                  BucketQueue<Index3D>& open_queue) const;
 };
 }  // namespace wavemap
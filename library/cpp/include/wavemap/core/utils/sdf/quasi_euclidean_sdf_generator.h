@@ -1,11 +1,19 @@
 #ifndef WAVEMAP_CORE_UTILS_SDF_QUASI_EUCLIDEAN_SDF_GENERATOR_H_
 #define WAVEMAP_CORE_UTILS_SDF_QUASI_EUCLIDEAN_SDF_GENERATOR_H_
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "wavemap/core/data_structure/bucket_queue.h"
+#include "wavemap/core/indexing/index_hashes.h"
 #include "wavemap/core/map/hashed_blocks.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 #include "wavemap/core/utils/neighbors/grid_neighborhood.h"
 #include "wavemap/core/utils/query/occupancy_classifier.h"
+#include "wavemap/core/utils/query/query_accelerator.h"
+#include "wavemap/core/utils/thread_pool.h"
 
 namespace wavemap {
 class QuasiEuclideanSDFGenerator {
@@ -17,7 +25,25 @@ class QuasiEuclideanSDFGenerator {
                                       FloatingPoint occupancy_threshold = 0.f)
       : max_distance_(max_distance), classifier_(occupancy_threshold) {}
 
-  HashedBlocks generate(const HashedWaveletOctree& occupancy_map) const;
+  //! Generate the SDF, in parallel if a thread pool is provided
+  HashedBlocks generate(const HashedWaveletOctree& occupancy_map,
+                        ThreadPool* thread_pool = nullptr) const;
+  HashedBlocks generate(const HashedChunkedWaveletOctree& occupancy_map,
+                        ThreadPool* thread_pool = nullptr) const;
+
+  //! Update an SDF previously generated from the same occupancy map, after
+  //! the map's blocks at changed_block_indices were modified. Only the SDF
+  //! within max_distance of these blocks is recomputed, so the cost scales
+  //! with the size of the change rather than with the size of the map. If the
+  //! affected region is larger than the SDF, it is regenerated instead.
+  //! @note Blocks that were erased from the occupancy map must also be
+  //!       included in changed_block_indices.
+  void update(const HashedWaveletOctree& occupancy_map,
+              const std::vector<Index3D>& changed_block_indices,
+              HashedBlocks& sdf) const;
+  void update(const HashedChunkedWaveletOctree& occupancy_map,
+              const std::vector<Index3D>& changed_block_indices,
+              HashedBlocks& sdf) const;
 
   FloatingPoint getMaxDistance() const { return max_distance_; }
 
@@ -28,10 +54,77 @@ class QuasiEuclideanSDFGenerator {
   const FloatingPoint max_distance_;
   const OccupancyClassifier classifier_;
 
-  void seed(const HashedWaveletOctree& occupancy_map, HashedBlocks& sdf,
-            BucketQueue<Index3D>& open_queue) const;
-  void propagate(const HashedWaveletOctree& occupancy_map, HashedBlocks& sdf,
-                 BucketQueue<Index3D>& open_queue) const;
+  using BlockIndexSet = std::unordered_set<Index3D, Index3DHash>;
+
+  // Set of SDF blocks that bounds the part of the SDF being updated
+  struct Region {
+    BlockIndexSet sdf_block_indices;
+
+    bool contains(const Index3D& index) const;
+  };
+
+  // NOTE: The methods below are templated on the occupancy map type, such
+  //       that both hashed wavelet octrees and hashed chunked wavelet octrees
+  //       can be processed natively.
+  template <typename HashedMapT>
+  HashedBlocks generateImpl(const HashedMapT& occupancy_map,
+                            ThreadPool* thread_pool) const;
+  template <typename HashedMapT>
+  void updateImpl(const HashedMapT& occupancy_map,
+                  const std::vector<Index3D>& changed_block_indices,
+                  HashedBlocks& sdf) const;
+  template <typename HashedMapT>
+  void regenerate(const HashedMapT& occupancy_map, HashedBlocks& sdf) const;
+
+  template <typename HashedMapT, typename SeedVisitor>
+  void forEachSeed(const OctreeIndex& obstacle_index,
+                   QueryAccelerator<HashedMapT>& occupancy_query_accelerator,
+                   FloatingPoint min_cell_width, SeedVisitor visitor) const;
+
+  // NOTE: If a region is provided, only the SDF cells inside it are written.
+  //       The seeds can also be restricted to the obstacles in a given set of
+  //       occupancy map blocks.
+  template <typename HashedMapT>
+  void seed(const HashedMapT& occupancy_map, HashedBlocks& sdf,
+            BucketQueue<Index3D>& open_queue, const Region* region = nullptr,
+            const BlockIndexSet* block_indices = nullptr) const;
+  template <typename HashedMapT>
+  void propagate(const HashedMapT& occupancy_map, HashedBlocks& sdf,
+                 BucketQueue<Index3D>& open_queue,
+                 const Region* region = nullptr) const;
+
+  // Distance propagated into a cell from its neighbor
+  struct Relaxation {
+    Index3D index;
+    FloatingPoint neighbor_sdf_value;
+    FloatingPoint neighbor_distance_offset;
+  };
+  // Cells of an SDF block that still need to be propagated
+  struct BlockUpdates {
+    std::vector<Index3D> seeds;
+    std::vector<Relaxation> relaxations;
+  };
+  using BlockUpdatesMap =
+      std::unordered_map<Index3D, BlockUpdates, Index3DHash>;
+
+  template <typename HashedMapT>
+  void seedInParallel(const HashedMapT& occupancy_map, HashedBlocks& sdf,
+                      ThreadPool& thread_pool,
+                      BlockUpdatesMap& block_updates) const;
+  template <typename HashedMapT>
+  void propagateInParallel(const HashedMapT& occupancy_map, HashedBlocks& sdf,
+                           ThreadPool& thread_pool,
+                           BlockUpdatesMap& block_updates) const;
+  template <typename HashedMapT>
+  void propagateBlock(const HashedMapT& occupancy_map,
+                      const Index3D& block_index, HashedBlocks::Block& block,
+                      const BlockUpdates& block_updates,
+                      std::vector<Relaxation>& outgoing_relaxations) const;
+  // Returns true if the neighbor's distance improved
+  template <typename HashedMapT>
+  bool relax(FloatingPoint sdf_value, FloatingPoint distance_offset,
+             const Index3D& neighbor_index, FloatingPoint& neighbor_sdf,
+             QueryAccelerator<HashedMapT>& occupancy_query_accelerator) const;
 };
 }  // namespace wavemap
 
@@ -4,12 +4,13 @@
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <cstddef>
+#include <deque>
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -17,7 +18,13 @@
 
 namespace wavemap {
 /**
- * \brief Implements a thread pool with a fixed number of threads.
+ * \brief Implements a work-stealing thread pool with a fixed number of threads.
+ *
+ * Each worker owns a task deque. Tasks submitted from within a worker are
+ * pushed onto, and popped from, the back of that worker's own deque. This
+ * keeps recursively spawned work on the same (cache-warm) core. Tasks
+ * submitted from other threads are distributed over the workers round-robin.
+ * Idle workers steal from the front of the other workers' deques.
  */
 class ThreadPool {
  public:
@@ -38,6 +45,11 @@ class ThreadPool {
    */
   ~ThreadPool();
 
+  /**
+   * \brief Returns the number of worker threads.
+   */
+  size_t num_workers() const { return num_workers_; }
+
   /**
    * \brief Waits for all work to be complete.
    */
@@ -54,22 +66,164 @@ class ThreadPool {
   std::future<std::result_of_t<Callable(Args...)>> add_task(Callable&& callable,
                                                             Args&&... args);
 
+  /**
+   * \brief Adds a fire-and-forget task to the task queue.
+   *
+   * \note Unlike add_task(), no future is created. Use wait_all() to wait for
+   *       the task's completion.
+   * \param callable the executable task, taking no arguments
+   */
+  template <typename Callable>
+  void add_detached_task(Callable&& callable);
+
+  /**
+   * \brief Calls body(idx) for every idx in [begin, end) on the pool.
+   *
+   * The range is split into contiguous chunks, which are added as detached
+   * tasks. The call returns as soon as all chunks are queued. Use wait_all()
+   * to wait for their completion.
+   *
+   * \param begin first index of the range
+   * \param end one past the last index of the range
+   * \param body the callable to run for each index
+   * \param grain_size minimum number of indices per chunk, or 0 to derive it
+   *                   from the number of workers
+   */
+  template <typename IndexT, typename Body>
+  void parallel_for(IndexT begin, IndexT end, Body&& body,
+                    size_t grain_size = 0);
+
+  /**
+   * \brief Set of tasks that can be waited for together.
+   *
+   * Unlike ThreadPool::wait_all(), TaskGroup::wait() can safely be called from
+   * within a task that runs on the pool itself. While waiting, the calling
+   * thread executes queued tasks, such that tasks can recursively fork and
+   * join subtasks without deadlocking the pool.
+   */
+  class TaskGroup {
+   public:
+    explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    // Prevent copying etc. of this class
+    TaskGroup(TaskGroup const& other) = delete;
+    TaskGroup& operator=(TaskGroup const& other) = delete;
+
+    /**
+     * \brief Adds a fire-and-forget task to the pool, as part of this group.
+     *
+     * \param callable the executable task, taking no arguments
+     */
+    template <typename Callable>
+    void add_task(Callable&& callable);
+
+    /**
+     * \brief Waits for all of the group's tasks to be complete.
+     */
+    void wait();
+
+   private:
+    ThreadPool& pool_;
+    std::atomic<size_t> pending_count_{0};
+  };
+
  private:
+  /**
+   * \brief Move-only, type-erased nullary callable.
+   *
+   * Callables that fit in the inline buffer (e.g. lambdas capturing a few
+   * pointers and indices) are stored without heap allocations.
+   */
+  class Task {
+   public:
+    Task() = default;
+    template <typename Callable,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<Callable>, Task>>>
+    explicit Task(Callable&& callable);
+    ~Task() { reset(); }
+
+    Task(Task&& other) noexcept { moveFrom(other); }
+    Task& operator=(Task&& other) noexcept;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    void operator()() { ops_->invoke(storage_); }
+
+   private:
+    static constexpr size_t kInlineSize = 8 * sizeof(void*);
+    template <typename CallableT>
+    static constexpr bool kStoredInline =
+        sizeof(CallableT) <= kInlineSize &&
+        alignof(CallableT) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<CallableT>;
+
+    struct Ops {
+      void (*invoke)(void*);
+      void (*relocate)(void* dst, void* src);
+      void (*destroy)(void*);
+    };
+    template <typename CallableT>
+    static const Ops* getOps();
+
+    alignas(std::max_align_t) std::byte storage_[kInlineSize];
+    const Ops* ops_ = nullptr;
+
+    void moveFrom(Task& other) noexcept;
+    void reset() noexcept;
+  };
+
+  //! Per-worker task queue
+  struct alignas(64) Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
   /**
    * \brief Loop executed by each of the workers.
    */
-  void worker_loop();
+  void worker_loop(size_t worker_idx);
+
+  /**
+   * \brief Queues the task on the current worker or, when called from outside
+   *        the pool, on the next worker in round-robin order.
+   */
+  void push_task(Task task);
+
+  /**
+   * \brief Pops a task from the worker's own deque or steals one from another
+   *        worker. Returns false if no task could be obtained.
+   */
+  bool pop_task(size_t worker_idx, Task& task);
+
+  /**
+   * \brief Runs the task and updates the bookkeeping.
+   */
+  void run_task(Task& task);
+
+  //! Index of the worker running on the calling thread, if it belongs to this
+  //! pool. Otherwise returns num_workers().
+  size_t current_worker_idx() const;
 
  private:
+  //! Number of worker threads
+  const size_t num_workers_;
+  //! Task queues, one per worker
+  std::unique_ptr<Worker[]> queues_;
   //! Worker threads of the pool
   std::vector<std::thread> workers_;
-  //! Queue of tasks to execute
-  std::queue<std::function<void()>> tasks_;
+  //! Round-robin counter used to distribute tasks added by external threads
+  std::atomic<size_t> next_queue_idx_;
+  //! Count of tasks currently queued (not yet picked up by a worker)
+  std::atomic<size_t> queued_count_;
   //! Count of tasks yet to be completed
-  std::atomic<int> task_count_;
+  std::atomic<size_t> task_count_;
+  //! Count of workers sleeping on the worker condition variable
+  std::atomic<size_t> sleeping_count_;
 
-  //! Task queue synchronization mutex
-  std::mutex tasks_mutex_;
+  //! Worker sleep/wake and wait_all synchronization mutex
+  std::mutex state_mutex_;
   //! Worker thread notification condition variable
   std::condition_variable worker_condition_;
   //! Waiting thread notification condition variable
@@ -77,27 +231,8 @@ class ThreadPool {
   //! Flag indicating the termination of all workers
   std::atomic<bool> terminate_;
 };
-
-template <typename Callable, typename... Args>
-std::future<std::result_of_t<Callable(Args...)>> ThreadPool::add_task(
-    Callable&& callable, Args&&... args) {
-  using ReturnType = std::result_of_t<Callable(Args...)>;
-
-  auto task = std::make_shared<std::packaged_task<ReturnType()>>(
-      std::bind(std::forward<Callable>(callable), std::forward<Args>(args)...));
-
-  {
-    auto lock = std::scoped_lock<std::mutex>(tasks_mutex_);
-    if (terminate_) {
-      LOG(FATAL) << "Adding tasks to an already stopped pool.";
-    }
-    tasks_.emplace([task]() { (*task)(); });
-    task_count_++;
-  }
-  worker_condition_.notify_one();
-
-  return task->get_future();
-}
 }  // namespace wavemap
 
+#include "wavemap/core/utils/impl/thread_pool_inl.h"
+
 #endif  // WAVEMAP_CORE_UTILS_THREAD_POOL_H_
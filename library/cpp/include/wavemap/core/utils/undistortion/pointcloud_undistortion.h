@@ -2,12 +2,20 @@
 #define WAVEMAP_CORE_UTILS_UNDISTORTION_POINTCLOUD_UNDISTORTION_H_
 
 #include "wavemap/core/data_structure/pointcloud.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/core/utils/undistortion/stamped_pointcloud.h"
 #include "wavemap/core/utils/undistortion/stamped_pose_buffer.h"
 
 namespace wavemap::undistortion {
+//! Minimum number of points processed per task when undistorting in parallel
+constexpr Eigen::Index kMinNumPointsPerTask = 16384;
+
+//! Undistort the pointcloud by transforming each point into the frame of the
+//! sensor's pose at the pointcloud's median timestamp. Large pointclouds are
+//! processed in parallel on the given thread pool, or serially if it is null.
 PosedPointcloud<> compensate_motion(const StampedPoseBuffer& pose_buffer,
-                                    StampedPointcloud& stamped_pointcloud);
+                                    StampedPointcloud& stamped_pointcloud,
+                                    ThreadPool* thread_pool = nullptr);
 }  // namespace wavemap::undistortion
 
 #endif  // WAVEMAP_CORE_UTILS_UNDISTORTION_POINTCLOUD_UNDISTORTION_H_
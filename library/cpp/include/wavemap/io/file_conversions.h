@@ -8,6 +8,10 @@
 
 namespace wavemap::io {
 bool mapToFile(const MapBase& map, const std::filesystem::path& file_path);
+//! Write the map to a file in the indexed format, whose blocks can be loaded
+//! lazily by io::MappedHashedWaveletOctree
+bool mapToIndexedFile(const MapBase& map,
+                      const std::filesystem::path& file_path);
 bool fileToMap(const std::filesystem::path& file_path, MapBase::Ptr& map);
 }  // namespace wavemap::io
 
@@ -139,6 +139,110 @@ HashedWaveletOctreeHeader HashedWaveletOctreeHeader::read(
   return instance;
 }
 
+template <size_t num_bits>
+void Bitset<num_bits>::write(std::ostream& ostream) const {
+  std::array<UInt8, kNumBytes> bytes{};
+  for (size_t bit_idx = 0; bit_idx < num_bits; ++bit_idx) {
+    if (bits[bit_idx]) {
+      bytes[bit_idx / 8] |= static_cast<UInt8>(1 << (bit_idx % 8));
+    }
+  }
+  ostream.write(reinterpret_cast<const char*>(bytes.data()), kNumBytes);
+}
+
+template <size_t num_bits>
+Bitset<num_bits> Bitset<num_bits>::read(std::istream& istream) {
+  Bitset instance;
+  std::array<UInt8, kNumBytes> bytes{};
+  istream.read(reinterpret_cast<char*>(bytes.data()), kNumBytes);
+  for (size_t bit_idx = 0; bit_idx < num_bits; ++bit_idx) {
+    instance.bits[bit_idx] = (bytes[bit_idx / 8] >> (bit_idx % 8)) & 1;
+  }
+  return instance;
+}
+
+void HashedChunkedWaveletOctreeBlockHeader::write(std::ostream& ostream) const {
+  root_node_offset.write(ostream);
+  ostream.write(reinterpret_cast<const char*>(&root_node_scale_coefficient),
+                sizeof(root_node_scale_coefficient));
+  ostream.write(reinterpret_cast<const char*>(&num_chunks), sizeof(num_chunks));
+}
+
+HashedChunkedWaveletOctreeBlockHeader
+HashedChunkedWaveletOctreeBlockHeader::read(std::istream& istream) {
+  HashedChunkedWaveletOctreeBlockHeader instance;
+  instance.root_node_offset = Index3D::read(istream);
+  istream.read(reinterpret_cast<char*>(&instance.root_node_scale_coefficient),
+               sizeof(root_node_scale_coefficient));
+  istream.read(reinterpret_cast<char*>(&instance.num_chunks),
+               sizeof(num_chunks));
+  return instance;
+}
+
+void HashedChunkedWaveletOctreeHeader::write(std::ostream& ostream) const {
+  ostream.write(reinterpret_cast<const char*>(&min_cell_width),
+                sizeof(min_cell_width));
+  ostream.write(reinterpret_cast<const char*>(&min_log_odds),
+                sizeof(min_log_odds));
+  ostream.write(reinterpret_cast<const char*>(&max_log_odds),
+                sizeof(max_log_odds));
+  ostream.write(reinterpret_cast<const char*>(&tree_height),
+                sizeof(tree_height));
+  ostream.write(reinterpret_cast<const char*>(&chunk_height),
+                sizeof(chunk_height));
+  ostream.write(reinterpret_cast<const char*>(&num_blocks), sizeof(num_blocks));
+}
+
+HashedChunkedWaveletOctreeHeader HashedChunkedWaveletOctreeHeader::read(
+    std::istream& istream) {
+  HashedChunkedWaveletOctreeHeader instance;
+  istream.read(reinterpret_cast<char*>(&instance.min_cell_width),
+               sizeof(min_cell_width));
+  istream.read(reinterpret_cast<char*>(&instance.min_log_odds),
+               sizeof(min_log_odds));
+  istream.read(reinterpret_cast<char*>(&instance.max_log_odds),
+               sizeof(max_log_odds));
+  istream.read(reinterpret_cast<char*>(&instance.tree_height),
+               sizeof(tree_height));
+  istream.read(reinterpret_cast<char*>(&instance.chunk_height),
+               sizeof(chunk_height));
+  istream.read(reinterpret_cast<char*>(&instance.num_blocks),
+               sizeof(num_blocks));
+  return instance;
+}
+
+void HashedBlockIndexEntry::write(std::ostream& ostream) const {
+  block_offset.write(ostream);
+  ostream.write(reinterpret_cast<const char*>(&stream_offset),
+                sizeof(stream_offset));
+  ostream.write(reinterpret_cast<const char*>(&num_bytes), sizeof(num_bytes));
+}
+
+HashedBlockIndexEntry HashedBlockIndexEntry::read(std::istream& istream) {
+  HashedBlockIndexEntry instance;
+  instance.block_offset = Index3D::read(istream);
+  istream.read(reinterpret_cast<char*>(&instance.stream_offset),
+               sizeof(stream_offset));
+  istream.read(reinterpret_cast<char*>(&instance.num_bytes),
+               sizeof(num_bytes));
+  return instance;
+}
+
+void HashedBlockIndexFooter::write(std::ostream& ostream) const {
+  ostream.write(reinterpret_cast<const char*>(&block_index_offset),
+                sizeof(block_index_offset));
+  ostream.write(reinterpret_cast<const char*>(&num_blocks), sizeof(num_blocks));
+}
+
+HashedBlockIndexFooter HashedBlockIndexFooter::read(std::istream& istream) {
+  HashedBlockIndexFooter instance;
+  istream.read(reinterpret_cast<char*>(&instance.block_index_offset),
+               sizeof(block_index_offset));
+  istream.read(reinterpret_cast<char*>(&instance.num_blocks),
+               sizeof(num_blocks));
+  return instance;
+}
+
 void StorageFormat::write(std::ostream& ostream) const {
   ostream.write(reinterpret_cast<const char*>(&id_), sizeof(id_));
 }
@@ -0,0 +1,118 @@
+#ifndef WAVEMAP_IO_MAPPED_HASHED_WAVELET_OCTREE_H_
+#define WAVEMAP_IO_MAPPED_HASHED_WAVELET_OCTREE_H_
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/data_structure/spatial_hash.h"
+#include "wavemap/core/map/hashed_wavelet_octree.h"
+#include "wavemap/core/map/map_base.h"
+#include "wavemap/io/memory_mapped_file.h"
+
+namespace wavemap::io {
+/**
+ * Hashed wavelet octree whose blocks are loaded from a memory mapped file, in
+ * the indexed format written by io::mapToIndexedStream(), on first access.
+ * Opening a map therefore only requires reading its block index, and queries
+ * in a local region only decode the blocks they touch.
+ *
+ * Blocks are loaded lazily by the const query methods as well. These methods
+ * can safely be called from multiple threads concurrently. Modifying the map
+ * is supported, but only affects the blocks in memory and not the file.
+ */
+class MappedHashedWaveletOctree : public MapBase {
+ public:
+  using Ptr = std::shared_ptr<MappedHashedWaveletOctree>;
+  using ConstPtr = std::shared_ptr<const MappedHashedWaveletOctree>;
+  using Config = HashedWaveletOctreeConfig;
+
+  using BlockIndex = Index3D;
+  using CellIndex = OctreeIndex;
+  using Block = HashedWaveletOctreeBlock;
+
+  //! Open the map stored in the given file, returning nullptr on failure
+  static Ptr open(const std::filesystem::path& file_path);
+
+  // Copy construction is not supported
+  MappedHashedWaveletOctree(const MappedHashedWaveletOctree&) = delete;
+
+  bool empty() const override { return block_map_.empty(); }
+  //! The number of nodes in the map
+  //! @note This loads all blocks.
+  size_t size() const override;
+  //! Threshold the blocks that have been loaded
+  void threshold() override;
+  //! Prune the blocks that have been loaded
+  void prune() override;
+  void clear() override {
+    block_map_.clear();
+    num_loaded_blocks_ = 0u;
+  }
+
+  //! The amount of memory used by the blocks that have been loaded, in bytes
+  size_t getMemoryUsage() const override;
+
+  Index3D getMinIndex() const override;
+  Index3D getMaxIndex() const override;
+  IndexElement getTreeHeight() const override { return config_.tree_height; }
+  const Config& getConfig() const { return config_; }
+
+  FloatingPoint getCellValue(const Index3D& index) const override;
+  FloatingPoint getCellValue(const OctreeIndex& index) const;
+  void setCellValue(const Index3D& index, FloatingPoint new_value) override;
+  void addToCellValue(const Index3D& index, FloatingPoint update) override;
+
+  bool hasBlock(const Index3D& block_index) const;
+  bool isBlockLoaded(const Index3D& block_index) const;
+  size_t getNumLoadedBlocks() const { return num_loaded_blocks_; }
+  void loadAllBlocks() const;
+
+  Block* getBlock(const Index3D& block_index);
+  const Block* getBlock(const Index3D& block_index) const;
+  Block& getOrAllocateBlock(const Index3D& block_index);
+
+  //! Visit the leaves of all blocks
+  //! @note This loads all blocks.
+  void forEachLeaf(
+      typename MapBase::IndexedLeafVisitorFunction visitor_fn) const override;
+
+  BlockIndex indexToBlockIndex(const OctreeIndex& node_index) const;
+  CellIndex indexToCellIndex(OctreeIndex index) const;
+
+ private:
+  struct BlockEntry {
+    // Position of the serialized block in the file, or zero bytes for blocks
+    // that were allocated after the file was opened
+    size_t stream_offset = 0u;
+    size_t num_bytes = 0u;
+    // The deserialized block, or null if it has not yet been loaded
+    mutable std::atomic<Block*> block{nullptr};
+
+    BlockEntry() = default;
+    BlockEntry(size_t stream_offset, size_t num_bytes)
+        : stream_offset(stream_offset), num_bytes(num_bytes) {}
+    ~BlockEntry() { delete block.load(); }
+
+    BlockEntry(const BlockEntry&) = delete;
+    BlockEntry& operator=(const BlockEntry&) = delete;
+  };
+
+  MappedHashedWaveletOctree(const Config& config,
+                            std::unique_ptr<MemoryMappedFile> file)
+      : MapBase(config), config_(config.checkValid()), file_(std::move(file)) {}
+
+  const Config config_;
+  const IndexElement cells_per_block_side_ =
+      int_math::exp2(config_.tree_height);
+
+  const std::unique_ptr<MemoryMappedFile> file_;
+  SpatialHash<BlockEntry, kDim> block_map_;
+  mutable std::atomic<size_t> num_loaded_blocks_ = 0u;
+
+  Block& loadBlock(const BlockEntry& block_entry) const;
+};
+}  // namespace wavemap::io
+
+#endif  // WAVEMAP_IO_MAPPED_HASHED_WAVELET_OCTREE_H_
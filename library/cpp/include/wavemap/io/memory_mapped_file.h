@@ -0,0 +1,69 @@
+#ifndef WAVEMAP_IO_MEMORY_MAPPED_FILE_H_
+#define WAVEMAP_IO_MEMORY_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <istream>
+#include <streambuf>
+
+namespace wavemap::io {
+/**
+ * Read-only view of a file that is mapped into memory. The operating system
+ * pages in the file's contents when they are first accessed, such that opening
+ * even very large files is cheap.
+ */
+class MemoryMappedFile {
+ public:
+  explicit MemoryMappedFile(const std::filesystem::path& file_path);
+  ~MemoryMappedFile();
+
+  // Prevent copying, since the mapping is owned by this object
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  //! Whether the file was opened and mapped successfully
+  bool isOpen() const { return is_open_; }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  bool is_open_ = false;
+  const char* data_ = nullptr;
+  size_t size_ = 0u;
+};
+
+/**
+ * Input stream that reads from a range of bytes in memory, without copying
+ * them. Can be used to deserialize parts of a MemoryMappedFile with the
+ * regular stream conversions.
+ */
+class MemoryInputStream : public std::istream {
+ public:
+  MemoryInputStream(const char* data, size_t size)
+      : std::istream(&buffer_), buffer_(data, size) {}
+
+ private:
+  class Buffer : public std::streambuf {
+   public:
+    Buffer(const char* data, size_t size) {
+      // NOTE: The buffer is only ever read from, so casting away the
+      //       constness is safe.
+      char* begin = const_cast<char*>(data);
+      setg(begin, begin, begin + size);
+    }
+
+   protected:
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                     std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type position,
+                     std::ios_base::openmode which) override {
+      return seekoff(position, std::ios_base::beg, which);
+    }
+  };
+
+  Buffer buffer_;
+};
+}  // namespace wavemap::io
+
+#endif  // WAVEMAP_IO_MEMORY_MAPPED_FILE_H_
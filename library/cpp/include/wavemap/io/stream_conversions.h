@@ -26,6 +26,23 @@ bool mapToStream(const HashedWaveletOctree& map, std::ostream& ostream);
 bool streamToMap(std::istream& istream, HashedWaveletOctree::Ptr& map);
 
 bool mapToStream(const HashedChunkedWaveletOctree& map, std::ostream& ostream);
+bool streamToMap(std::istream& istream, HashedChunkedWaveletOctree::Ptr& map);
+
+// Serialize hashed wavelet octrees in the indexed format, which appends an
+// index of the blocks' positions to the stream. This allows individual blocks
+// to be loaded without parsing the rest of the map, see
+// MappedHashedWaveletOctree. The regular streamToMap methods can also read
+// maps in this format.
+bool mapToIndexedStream(const MapBase& map, std::ostream& ostream);
+bool mapToIndexedStream(const HashedWaveletOctree& map, std::ostream& ostream);
+bool mapToIndexedStream(const HashedChunkedWaveletOctree& map,
+                        std::ostream& ostream);
+
+// Deserialize the octree of a single hashed wavelet octree block, given its
+// previously read header
+bool streamToBlock(std::istream& istream,
+                   const streamable::HashedWaveletOctreeBlockHeader& header,
+                   HashedWaveletOctreeBlock& block);
 }  // namespace wavemap::io
 
 #endif  // WAVEMAP_IO_STREAM_CONVERSIONS_H_
@@ -1,6 +1,7 @@
 #ifndef WAVEMAP_IO_STREAMABLE_TYPES_H_
 #define WAVEMAP_IO_STREAMABLE_TYPES_H_
 
+#include <bitset>
 #include <istream>
 #include <ostream>
 
@@ -85,13 +86,84 @@ struct HashedWaveletOctreeHeader {
   inline static HashedWaveletOctreeHeader read(std::istream& istream);
 };
 
+// Bitset, serialized as ceil(num_bits / 8) bytes with the first bit stored in
+// the least significant bit of the first byte
+template <size_t num_bits>
+struct Bitset {
+  std::bitset<num_bits> bits{};
+
+  static constexpr size_t kNumBytes = (num_bits + 7) / 8;
+
+  inline void write(std::ostream& ostream) const;
+  inline static Bitset read(std::istream& istream);
+};
+
+struct HashedChunkedWaveletOctreeBlockHeader {
+  Index3D root_node_offset{};
+  Float root_node_scale_coefficient{};
+  UInt64 num_chunks{};
+
+  inline void write(std::ostream& ostream) const;
+  inline static HashedChunkedWaveletOctreeBlockHeader read(
+      std::istream& istream);
+};
+
+struct HashedChunkedWaveletOctreeHeader {
+  Float min_cell_width{};
+  Float min_log_odds{};
+  Float max_log_odds{};
+
+  Int32 tree_height{};
+  Int32 chunk_height{};
+  UInt64 num_blocks{};
+
+  inline void write(std::ostream& ostream) const;
+  inline static HashedChunkedWaveletOctreeHeader read(std::istream& istream);
+};
+
+// Entry of the block index that is appended to indexed map streams, pointing
+// to the serialized block's position relative to the start of the map
+struct HashedBlockIndexEntry {
+  Index3D block_offset{};
+  UInt64 stream_offset{};
+  UInt64 num_bytes{};
+
+  static constexpr size_t kNumBytes =
+      3 * sizeof(Int32) + sizeof(stream_offset) + sizeof(num_bytes);
+
+  inline void write(std::ostream& ostream) const;
+  inline static HashedBlockIndexEntry read(std::istream& istream);
+};
+
+// Footer of indexed map streams, allowing the block index to be found by
+// seeking from the end of the stream
+struct HashedBlockIndexFooter {
+  UInt64 block_index_offset{};
+  UInt64 num_blocks{};
+
+  static constexpr size_t kNumBytes =
+      sizeof(block_index_offset) + sizeof(num_blocks);
+
+  inline void write(std::ostream& ostream) const;
+  inline static HashedBlockIndexFooter read(std::istream& istream);
+};
+
 struct StorageFormat : TypeSelector<StorageFormat> {
   using TypeSelector<StorageFormat>::TypeSelector;
 
-  enum Id : TypeId { kWaveletOctree, kHashedWaveletOctree, kHashedBlocks };
+  // NOTE: New formats must be appended, since the format's ID is what gets
+  //       serialized.
+  enum Id : TypeId {
+    kWaveletOctree,
+    kHashedWaveletOctree,
+    kHashedBlocks,
+    kIndexedHashedWaveletOctree,
+    kHashedChunkedWaveletOctree
+  };
 
   static constexpr std::array names = {
-      "wavelet_octree", "hashed_wavelet_octree", "hashed_blocks"};
+      "wavelet_octree", "hashed_wavelet_octree", "hashed_blocks",
+      "indexed_hashed_wavelet_octree", "hashed_chunked_wavelet_octree"};
 
   inline void write(std::ostream& ostream) const;
   inline static StorageFormat read(std::istream& istream);
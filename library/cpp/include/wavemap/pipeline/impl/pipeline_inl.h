@@ -1,30 +1,100 @@
 #ifndef WAVEMAP_PIPELINE_IMPL_PIPELINE_INL_H_
 #define WAVEMAP_PIPELINE_IMPL_PIPELINE_INL_H_
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace wavemap {
 template <typename MeasurementT>
 bool Pipeline::runIntegrators(const std::vector<std::string>& integrator_names,
                               const MeasurementT& measurement) {
-  for (const auto& integrator_name : integrator_names) {
-    if (auto* integrator = getIntegrator(integrator_name); integrator) {
-      integrator->integrate(measurement);
-    } else {
-      return false;
-    }
-  }
-  return true;
+  waitForAsync();
+  return integrate(integrator_names, measurement);
 }
 
 template <typename MeasurementT>
 bool Pipeline::runPipeline(const std::vector<std::string>& integrator_names,
                            const MeasurementT& measurement) {
-  const bool success = runIntegrators(integrator_names, measurement);
-  runOperations();
+  waitForAsync();
+  const bool success = integrate(integrator_names, measurement);
+  applyOperations(false);
+  return success;
+}
+
+template <typename MeasurementT>
+std::future<bool> Pipeline::runPipelineAsync(
+    const std::vector<std::string>& integrator_names, MeasurementT measurement,
+    AsyncCallback callback) {
+  // The map updates refer to the measurement, so it is kept on the heap until
+  // the job is finished
+  auto shared_measurement =
+      std::make_shared<const MeasurementT>(std::move(measurement));
+  return submitAsyncJob(
+      [this, integrator_names, shared_measurement = std::move(
+                                   shared_measurement)](MapUpdates& map_updates) {
+        return importMeasurement(integrator_names, *shared_measurement,
+                                 map_updates);
+      },
+      std::move(callback));
+}
+
+template <typename MeasurementT>
+bool Pipeline::integrate(const std::vector<std::string>& integrator_names,
+                         const MeasurementT& measurement) {
+  MapUpdates map_updates;
+  const bool success =
+      importMeasurement(integrator_names, measurement, map_updates);
+  updateMap(map_updates);
   return success;
 }
+
+template <typename MeasurementT>
+bool Pipeline::importMeasurement(
+    const std::vector<std::string>& integrator_names,
+    const MeasurementT& measurement, MapUpdates& map_updates) {
+  // Projective integrators that already imported the measurement. Compatible
+  // integrators reuse their range image, beam offsets and range bounds, such
+  // that only their map update runs.
+  std::vector<const ProjectiveIntegrator*> projective_integrators;
+  for (const auto& integrator_name : integrator_names) {
+    auto* integrator = findIntegrator(integrator_name);
+    if (!integrator) {
+      return false;
+    }
+
+    // Integrators that can not split their import from their map update
+    // process the whole measurement as part of the map update
+    auto* projective_integrator =
+        dynamic_cast<ProjectiveIntegrator*>(integrator);
+    if (!projective_integrator) {
+      map_updates.emplace_back(
+          [integrator, &measurement]() { integrator->integrate(measurement); });
+      continue;
+    }
+
+    // Prefer the most recent source, as it is the most likely to also provide
+    // range bounds
+    const auto source_it = std::find_if(
+        projective_integrators.rbegin(), projective_integrators.rend(),
+        [projective_integrator](const ProjectiveIntegrator* other) {
+          return projective_integrator->canReuseImportOf(*other);
+        });
+    const bool imported =
+        source_it != projective_integrators.rend()
+            ? projective_integrator->importMeasurement(measurement, **source_it)
+            : projective_integrator->importMeasurement(measurement);
+    if (imported) {
+      map_updates.emplace_back([projective_integrator]() {
+        projective_integrator->updateMapWithImport();
+      });
+    }
+    projective_integrators.emplace_back(projective_integrator);
+  }
+  return true;
+}
 }  // namespace wavemap
 
 #endif  // WAVEMAP_PIPELINE_IMPL_PIPELINE_INL_H_
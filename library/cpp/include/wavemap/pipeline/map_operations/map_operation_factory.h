@@ -11,12 +11,14 @@
 namespace wavemap {
 class MapOperationFactory {
  public:
-  static std::unique_ptr<MapOperationBase> create(const param::Value& params,
-                                                  MapBase::Ptr occupancy_map);
+  static std::unique_ptr<MapOperationBase> create(
+      const param::Value& params, MapBase::Ptr occupancy_map,
+      std::shared_ptr<ThreadPool> thread_pool = nullptr);
 
   static std::unique_ptr<MapOperationBase> create(
       MapOperationType operation_type, const param::Value& params,
-      MapBase::Ptr occupancy_map);
+      MapBase::Ptr occupancy_map,
+      std::shared_ptr<ThreadPool> thread_pool = nullptr);
 };
 }  // namespace wavemap
 
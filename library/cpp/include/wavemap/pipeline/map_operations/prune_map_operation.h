@@ -1,10 +1,12 @@
 #ifndef WAVEMAP_PIPELINE_MAP_OPERATIONS_PRUNE_MAP_OPERATION_H_
 #define WAVEMAP_PIPELINE_MAP_OPERATIONS_PRUNE_MAP_OPERATION_H_
 
+#include <memory>
 #include <utility>
 
 #include "wavemap/core/config/config_base.h"
 #include "wavemap/core/map/map_base.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/core/utils/time/time.h"
 #include "wavemap/pipeline/map_operations/map_operation_base.h"
 
@@ -24,9 +26,11 @@ struct PruneMapOperationConfig : public ConfigBase<PruneMapOperationConfig, 1> {
 class PruneMapOperation : public MapOperationBase {
  public:
   PruneMapOperation(const PruneMapOperationConfig& config,
-                    MapBase::Ptr occupancy_map)
+                    MapBase::Ptr occupancy_map,
+                    std::shared_ptr<ThreadPool> thread_pool = nullptr)
       : MapOperationBase(std::move(occupancy_map)),
-        config_(config.checkValid()) {}
+        config_(config.checkValid()),
+        thread_pool_(std::move(thread_pool)) {}
 
   bool shouldRun(const Timestamp& current_time);
 
@@ -34,6 +38,7 @@ class PruneMapOperation : public MapOperationBase {
 
  private:
   const PruneMapOperationConfig config_;
+  const std::shared_ptr<ThreadPool> thread_pool_;
   Timestamp last_run_timestamp_;
 };
 }  // namespace wavemap
@@ -1,10 +1,12 @@
 #ifndef WAVEMAP_PIPELINE_MAP_OPERATIONS_THRESHOLD_MAP_OPERATION_H_
 #define WAVEMAP_PIPELINE_MAP_OPERATIONS_THRESHOLD_MAP_OPERATION_H_
 
+#include <memory>
 #include <utility>
 
 #include "wavemap/core/config/config_base.h"
 #include "wavemap/core/map/map_base.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/core/utils/time/time.h"
 #include "wavemap/pipeline/map_operations/map_operation_base.h"
 
@@ -25,9 +27,11 @@ struct ThresholdMapOperationConfig
 class ThresholdMapOperation : public MapOperationBase {
  public:
   ThresholdMapOperation(const ThresholdMapOperationConfig& config,
-                        MapBase::Ptr occupancy_map)
+                        MapBase::Ptr occupancy_map,
+                        std::shared_ptr<ThreadPool> thread_pool = nullptr)
       : MapOperationBase(std::move(occupancy_map)),
-        config_(config.checkValid()) {}
+        config_(config.checkValid()),
+        thread_pool_(std::move(thread_pool)) {}
 
   bool shouldRun(const Timestamp& current_time = Time::now());
 
@@ -35,6 +39,7 @@ class ThresholdMapOperation : public MapOperationBase {
 
  private:
   const ThresholdMapOperationConfig config_;
+  const std::shared_ptr<ThreadPool> thread_pool_;
   Timestamp last_run_timestamp_;
 };
 }  // namespace wavemap
@@ -1,19 +1,80 @@
 #ifndef WAVEMAP_PIPELINE_PIPELINE_H_
 #define WAVEMAP_PIPELINE_PIPELINE_H_
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "wavemap/core/config/config_base.h"
+#include "wavemap/core/config/type_selector.h"
 #include "wavemap/core/integrator/integrator_base.h"
+#include "wavemap/core/integrator/projective/projective_integrator.h"
 #include "wavemap/core/map/map_base.h"
 #include "wavemap/core/utils/thread_pool.h"
+#include "wavemap/core/utils/time/time.h"
 #include "wavemap/pipeline/map_operations/map_operation_base.h"
 #include "wavemap/pipeline/map_operations/map_operation_factory.h"
 
 namespace wavemap {
+struct QueueDropPolicy : TypeSelector<QueueDropPolicy> {
+  using TypeSelector<QueueDropPolicy>::TypeSelector;
+
+  enum Id : TypeId { kBlock, kDropOldest, kDropNewest };
+
+  static constexpr std::array names = {"block", "drop_oldest", "drop_newest"};
+};
+
+/**
+ * Config struct for the pipeline's asynchronous mode.
+ */
+struct PipelineAsyncConfig
+    : ConfigBase<PipelineAsyncConfig, 2, QueueDropPolicy> {
+  //! Maximum number of measurements waiting to be integrated, not counting the
+  //! measurements that are currently being imported or integrated.
+  int max_queue_size = 4;
+  //! What to do when a measurement is added while the queue is full. Either
+  //! block the caller until space frees up, drop the oldest queued
+  //! measurement, or drop the new measurement.
+  QueueDropPolicy drop_policy = QueueDropPolicy::kDropOldest;
+
+  static MemberMap memberMap;
+
+  // Constructors
+  PipelineAsyncConfig() = default;
+  PipelineAsyncConfig(int max_queue_size, QueueDropPolicy drop_policy)
+      : max_queue_size(max_queue_size), drop_policy(drop_policy) {}
+
+  bool isValid(bool verbose) const override;
+};
+
+/**
+ * Statistics describing the pipeline's asynchronous mode.
+ */
+struct PipelineAsyncStats {
+  //! Number of measurements submitted, processed and dropped so far
+  uint64_t num_submitted = 0;
+  uint64_t num_processed = 0;
+  uint64_t num_dropped = 0;
+  //! Current and highest number of measurements waiting in the queue
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+  //! Time from submission until the map was updated and the map operations
+  //! ran, for the last processed measurement and over all measurements
+  FloatingPoint last_latency = 0.f;
+  FloatingPoint mean_latency = 0.f;
+  FloatingPoint max_latency = 0.f;
+};
+
 /*
  * A class to build pipelines of measurement integrators and map operations
  */
@@ -32,10 +93,16 @@ class Pipeline {
   // Copy construction is not supported
   Pipeline(const Pipeline&) = delete;
 
+  //! Finishes all queued measurements before destruction
+  ~Pipeline() { stopAsync(); }
+
   //! Deregister all measurement integrators and map operations
   void clear();
 
   //! Returns true if an integrator with the given name has been registered
+  //! NOTE: Like the other accessors below, this first waits for all queued
+  //!       measurements to be processed, since the async mode's workers use
+  //!       the integrators, operations and map while processing them.
   bool hasIntegrator(const std::string& integrator_name) const;
   //! Deregister the integrator with the given name. Returns true if it existed.
   bool removeIntegrator(const std::string& integrator_name);
@@ -47,22 +114,45 @@ class Pipeline {
                                 std::unique_ptr<IntegratorBase> integrator);
   //! Get a pointer to the given integrator, returns nullptr if it does not
   //! exist
+  //! NOTE: The integrator must not be used while measurements are being
+  //!       processed asynchronously, so call waitForAsync() before using it
+  //!       after submitting new measurements.
   IntegratorBase* getIntegrator(const std::string& integrator_name);
+  //! Access the thread pool shared by the pipeline's integrators and operations
+  const std::shared_ptr<ThreadPool>& getThreadPool() const {
+    return thread_pool_;
+  }
+
   //! Access all registered integrators (read-only)
-  const IntegratorMap& getIntegrators() { return integrators_; }
+  const IntegratorMap& getIntegrators() {
+    waitForAsync();
+    return integrators_;
+  }
   //! Deregister all integrators
-  void clearIntegrators() { integrators_.clear(); }
+  void clearIntegrators() {
+    waitForAsync();
+    integrators_.clear();
+  }
 
   //! Create and register a new map operation
   MapOperationBase* addOperation(const param::Value& operation_params);
   //! Register the given map operation, transferring ownership
   MapOperationBase* addOperation(std::unique_ptr<MapOperationBase> operation);
   //! Access all registered map operations (read-only)
-  const OperationsArray& getOperations() { return operations_; }
+  const OperationsArray& getOperations() {
+    waitForAsync();
+    return operations_;
+  }
   //! Deregister all map operations
-  void clearOperations() { operations_.clear(); }
+  void clearOperations() {
+    waitForAsync();
+    operations_.clear();
+  }
 
   //! Integrate a given measurement
+  //! NOTE: Projective integrators whose projection models and min ranges
+  //!       match reuse the range image and range bounds of the first one,
+  //!       such that the measurement is only preprocessed once.
   template <typename MeasurementT>
   bool runIntegrators(const std::vector<std::string>& integrator_names,
                       const MeasurementT& measurement);
@@ -74,6 +164,44 @@ class Pipeline {
   bool runPipeline(const std::vector<std::string>& integrator_names,
                    const MeasurementT& measurement);
 
+  //! Callback invoked once an asynchronously submitted measurement has been
+  //! processed, or dropped, with the same value as the returned future
+  using AsyncCallback = std::function<void(bool success)>;
+
+  //! Start the asynchronous mode, which processes the queued measurements in
+  //! pipelined stages on dedicated worker threads. The import worker
+  //! preprocesses the next measurement into the integrators, for example
+  //! projecting it into their range images, while the map worker updates the
+  //! map with the previous measurement and then runs the map operations.
+  //! Restarts the workers if they were already running.
+  void startAsync(const PipelineAsyncConfig& config = {});
+  //! Finish all queued measurements, then stop the worker threads
+  void stopAsync();
+  //! Returns true if the asynchronous mode's worker threads are running
+  bool isAsync() const;
+  //! Block until all queued measurements have been processed
+  void waitForAsync() const;
+  //! Statistics of the asynchronous mode
+  PipelineAsyncStats getAsyncStats() const;
+
+  //! Queue a measurement to be integrated, followed by the map operations, on
+  //! the asynchronous mode's worker threads. The workers are started with the
+  //! default config if they are not yet running. The returned future and the
+  //! optional callback receive false if an integrator does not exist or the
+  //! measurement was dropped.
+  //! NOTE: The measurement is copied such that the caller can prepare the
+  //!       next measurement while this one updates the map. The callback runs
+  //!       on the map worker thread, or on the submitting thread if the
+  //!       measurement is dropped, and must not call the pipeline's methods.
+  //! NOTE: The pipeline's other methods, except for the async mode's getters,
+  //!       first wait for all queued measurements to be processed. The map,
+  //!       and integrators or operations obtained from the pipeline earlier,
+  //!       must not be accessed until waitForAsync() returns.
+  template <typename MeasurementT>
+  std::future<bool> runPipelineAsync(
+      const std::vector<std::string>& integrator_names,
+      MeasurementT measurement, AsyncCallback callback = {});
+
  private:
   //! Map data structure
   const MapBase::Ptr occupancy_map_;
@@ -86,6 +214,64 @@ class Pipeline {
 
   //! Operations to perform after map updates
   OperationsArray operations_;
+
+  // Same as getIntegrator(), but without waiting for the async mode, such that
+  // its workers can also use it
+  IntegratorBase* findIntegrator(const std::string& integrator_name);
+
+  // Integration is split into an import step, which only modifies the
+  // integrators, and the map updates it returns, such that the async mode can
+  // import the next measurement while the map operations run
+  using MapUpdates = std::vector<std::function<void()>>;
+  template <typename MeasurementT>
+  bool integrate(const std::vector<std::string>& integrator_names,
+                 const MeasurementT& measurement);
+  template <typename MeasurementT>
+  bool importMeasurement(const std::vector<std::string>& integrator_names,
+                         const MeasurementT& measurement,
+                         MapUpdates& map_updates);
+  static void updateMap(const MapUpdates& map_updates);
+  void applyOperations(bool force_run_all);
+
+  // Asynchronous mode
+  // NOTE: Jobs wait in the bounded queue until the import worker picks them
+  //       up. The import worker hands each imported job over to the map
+  //       worker, and only imports the next job once the map was updated
+  //       with the previous one, since the map update reads the integrators'
+  //       imported measurements.
+  struct AsyncJob {
+    std::function<bool(MapUpdates&)> import;
+    MapUpdates map_updates;
+    bool import_succeeded = false;
+    std::promise<bool> promise;
+    AsyncCallback callback;
+    Timestamp submission_time;
+  };
+  PipelineAsyncConfig async_config_;
+  mutable std::mutex async_mutex_;
+  std::condition_variable async_job_queued_;
+  std::condition_variable async_job_imported_;
+  mutable std::condition_variable async_job_finished_;
+  std::deque<AsyncJob> async_queue_;
+  std::optional<AsyncJob> async_imported_job_;
+  std::thread async_import_worker_;
+  std::thread async_map_worker_;
+  // Jobs taken from the queue that have not yet been finished
+  size_t async_num_active_jobs_ = 0;
+  // Whether the integrators hold an import the map was not yet updated with
+  bool async_integrators_busy_ = false;
+  bool async_terminate_ = false;
+  PipelineAsyncStats async_stats_;
+  Duration async_total_latency_{};
+
+  std::future<bool> submitAsyncJob(std::function<bool(MapUpdates&)> import,
+                                   AsyncCallback callback);
+  // NOTE: These must be called while holding the async_mutex_
+  void startAsyncWorkers();
+  bool isAsyncWorkerThread() const;
+  void asyncImportWorkerLoop();
+  void asyncMapWorkerLoop();
+  static void finishAsyncJob(AsyncJob& job, bool success);
 };
 }  // namespace wavemap
 
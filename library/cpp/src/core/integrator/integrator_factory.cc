@@ -43,8 +43,8 @@ std::unique_ptr<IntegratorBase> IntegratorFactory::create(
     if (const auto config =
             RayTracingIntegratorConfig::from(params, "integration_method");
         config) {
-      return std::make_unique<RayTracingIntegrator>(config.value(),
-                                                    std::move(occupancy_map));
+      return std::make_unique<RayTracingIntegrator>(
+          config.value(), std::move(occupancy_map), std::move(thread_pool));
     } else {
       LOG(ERROR) << "Ray tracing integrator config could not be loaded.";
       return nullptr;
@@ -88,7 +88,8 @@ std::unique_ptr<IntegratorBase> IntegratorFactory::create(
     case IntegratorType::kFixedResolutionIntegrator: {
       return std::make_unique<FixedResolutionIntegrator>(
           integrator_config.value(), projection_model, posed_range_image,
-          beam_offset_image, measurement_model, std::move(occupancy_map));
+          beam_offset_image, measurement_model, std::move(occupancy_map),
+          std::move(thread_pool));
     }
     case IntegratorType::kCoarseToFineIntegrator: {
       auto octree_map =
@@ -18,6 +18,11 @@ OusterProjector::OusterProjector(const OusterProjector::Config& config)
           {config.elevation.max_angle, config.azimuth.max_angle}),
       config_(config.checkValid()) {}
 
+bool OusterProjector::isEquivalentTo(const ProjectorBase& other) const {
+  const auto* other_projector = dynamic_cast<const OusterProjector*>(&other);
+  return other_projector && other_projector->config_ == config_;
+}
+
 Eigen::Matrix<bool, 3, 1> OusterProjector::sensorAxisIsPeriodic() const {
   const FloatingPoint x_difference =
       angle_math::normalize_near(config_.elevation.max_angle +
@@ -33,6 +38,28 @@ Eigen::Matrix<bool, 3, 1> OusterProjector::sensorAxisIsPeriodic() const {
       false};
 }
 
+void OusterProjector::cartesianToSensor(
+    const Pointcloud<>& C_points, ImageCoordinatesBatch& image_coordinates,
+    SensorZBatch& sensor_z) const {
+  const auto& C_point_data = C_points.data();
+  const Eigen::Index num_points = C_point_data.cols();
+  image_coordinates.resize(2, num_points);
+  sensor_z.resize(num_points);
+  // NOTE: The loop body is branch free, such that it can be vectorized.
+  for (Eigen::Index point_idx = 0; point_idx < num_points; ++point_idx) {
+    const FloatingPoint x = C_point_data(0, point_idx);
+    const FloatingPoint y = C_point_data(1, point_idx);
+    const FloatingPoint z = C_point_data(2, point_idx);
+    // Project the point into the plane B, as in the single point version
+    const FloatingPoint B_x =
+        std::sqrt(x * x + y * y) - config_.lidar_origin_to_beam_origin;
+    const FloatingPoint B_y = z - config_.lidar_origin_to_sensor_origin_z_offset;
+    image_coordinates(0, point_idx) = approximate::atan2()(B_y, B_x);
+    image_coordinates(1, point_idx) = approximate::atan2()(y, x);
+    sensor_z[point_idx] = std::sqrt(B_x * B_x + B_y * B_y);
+  }
+}
+
 AABB<Vector3D> OusterProjector::cartesianToSensorAABB(
     const AABB<Point3D>& W_aabb,
     const kindr::minimal::QuatTransformationTemplate<
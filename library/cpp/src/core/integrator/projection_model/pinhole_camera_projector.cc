@@ -10,6 +10,31 @@ PinholeCameraProjector::PinholeCameraProjector(
                     indexToImage({config.width - 1, config.height - 1})),
       config_(config.checkValid()) {}
 
+bool PinholeCameraProjector::isEquivalentTo(const ProjectorBase& other) const {
+  const auto* other_projector =
+      dynamic_cast<const PinholeCameraProjector*>(&other);
+  return other_projector && other_projector->config_ == config_;
+}
+
+void PinholeCameraProjector::cartesianToSensor(
+    const Pointcloud<>& C_points, ImageCoordinatesBatch& image_coordinates,
+    SensorZBatch& sensor_z) const {
+  const auto& C_point_data = C_points.data();
+  const Eigen::Index num_points = C_point_data.cols();
+  image_coordinates.resize(2, num_points);
+  sensor_z.resize(num_points);
+  // NOTE: The loop body is branch free, such that it can be vectorized.
+  for (Eigen::Index point_idx = 0; point_idx < num_points; ++point_idx) {
+    const FloatingPoint x = C_point_data(0, point_idx);
+    const FloatingPoint y = C_point_data(1, point_idx);
+    const FloatingPoint z = C_point_data(2, point_idx);
+    const FloatingPoint w_clamped = std::max(z, kEpsilon);
+    image_coordinates(0, point_idx) = config_.fx * x / w_clamped + config_.cx;
+    image_coordinates(1, point_idx) = config_.fy * y / w_clamped + config_.cy;
+    sensor_z[point_idx] = z;
+  }
+}
+
 AABB<Vector3D> PinholeCameraProjector::cartesianToSensorAABB(
     const AABB<Point3D>& W_aabb,
     const kindr::minimal::QuatTransformationTemplate<
@@ -18,6 +18,11 @@ SphericalProjector::SphericalProjector(const SphericalProjector::Config& config)
           {config.elevation.max_angle, config.azimuth.max_angle}),
       config_(config.checkValid()) {}
 
+bool SphericalProjector::isEquivalentTo(const ProjectorBase& other) const {
+  const auto* other_projector = dynamic_cast<const SphericalProjector*>(&other);
+  return other_projector && other_projector->config_ == config_;
+}
+
 Eigen::Matrix<bool, 3, 1> SphericalProjector::sensorAxisIsPeriodic() const {
   const FloatingPoint x_difference =
       angle_math::normalize_near(config_.elevation.max_angle +
@@ -33,6 +38,26 @@ Eigen::Matrix<bool, 3, 1> SphericalProjector::sensorAxisIsPeriodic() const {
       false};
 }
 
+void SphericalProjector::cartesianToSensor(
+    const Pointcloud<>& C_points, ImageCoordinatesBatch& image_coordinates,
+    SensorZBatch& sensor_z) const {
+  const auto& C_point_data = C_points.data();
+  const Eigen::Index num_points = C_point_data.cols();
+  image_coordinates.resize(2, num_points);
+  sensor_z.resize(num_points);
+  // NOTE: The loop body is branch free, such that it can be vectorized.
+  for (Eigen::Index point_idx = 0; point_idx < num_points; ++point_idx) {
+    const FloatingPoint x = C_point_data(0, point_idx);
+    const FloatingPoint y = C_point_data(1, point_idx);
+    const FloatingPoint z = C_point_data(2, point_idx);
+    const FloatingPoint xy_norm_sq = x * x + y * y;
+    image_coordinates(0, point_idx) =
+        approximate::atan2()(z, std::sqrt(xy_norm_sq));
+    image_coordinates(1, point_idx) = approximate::atan2()(y, x);
+    sensor_z[point_idx] = std::sqrt(xy_norm_sq + z * z);
+  }
+}
+
 AABB<Vector3D> SphericalProjector::cartesianToSensorAABB(
     const AABB<Point3D>& W_aabb,
     const kindr::minimal::QuatTransformationTemplate<
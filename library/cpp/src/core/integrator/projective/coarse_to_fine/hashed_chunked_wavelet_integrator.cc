@@ -1,6 +1,7 @@
 #include "wavemap/core/integrator/projective/coarse_to_fine/hashed_chunked_wavelet_integrator.h"
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <stack>
 #include <utility>
@@ -11,12 +12,7 @@ namespace wavemap {
 void HashedChunkedWaveletIntegrator::updateMap() {
   ProfilerZoneScoped;
   // Update the range image intersector
-  {
-    ProfilerZoneScopedN("updateRangeImageIntersector");
-    range_image_intersector_ = std::make_shared<RangeImageIntersector>(
-        posed_range_image_, projection_model_, *measurement_model_,
-        config_.min_range, config_.max_range);
-  }
+  updateRangeImageIntersector(range_image_intersector_);
 
   // Find all the indices of blocks that need updating
   BlockList blocks_to_update;
@@ -37,13 +33,14 @@ void HashedChunkedWaveletIntegrator::updateMap() {
   }
 
   // Update it with the threadpool
-  for (const auto& block_index : blocks_to_update) {
-    thread_pool_->add_task([this, block_index]() {
-      if (auto* block = occupancy_map_->getBlock(block_index); block) {
-        updateBlock(*block, block_index);
-      }
-    });
-  }
+  thread_pool_->parallel_for(
+      size_t{0}, blocks_to_update.size(),
+      [this, &blocks_to_update](size_t job_idx) {
+        const auto& block_index = blocks_to_update[job_idx];
+        if (auto* block = occupancy_map_->getBlock(block_index); block) {
+          updateBlock(*block, block_index);
+        }
+      });
   thread_pool_->wait_all();
 }
 
@@ -95,6 +92,15 @@ void HashedChunkedWaveletIntegrator::updateNodeRecursive(  // NOLINT
   auto child_values = HashedChunkedWaveletOctreeBlock::Transform::backward(
       {parent_value, parent_details});
 
+  // Children that start a new chunk and are high enough are processed as
+  // separate tasks. Since their subtrees do not share any chunks with other
+  // tasks, this requires no further synchronization.
+  ThreadPool::TaskGroup child_subtree_tasks(*thread_pool_);
+  std::array<HashedChunkedWaveletOctreeBlock::ChunkedOctreeType::ChunkType*,
+             OctreeIndex::kNumChildren>
+      forked_child_chunks{};
+  std::array<bool, OctreeIndex::kNumChildren> child_needs_thresholding{};
+
   // Handle all the children
   for (NdtreeIndexRelativeChild relative_child_idx = 0;
        relative_child_idx < OctreeIndex::kNumChildren; ++relative_child_idx) {
@@ -177,8 +183,22 @@ void HashedChunkedWaveletIntegrator::updateNodeRecursive(  // NOLINT
     // If we're at the leaf level, directly compute the update
     if (child_height <= termination_height_ + 1) {
       updateLeavesBatch(child_index, child_value, child_details);
+    } else if (child_height % chunk_height_ == 0 &&
+               config_.min_parallel_subtree_height <= child_height) {
+      // Otherwise, recurse in a separate task if the subtree is large enough
+      forked_child_chunks[relative_child_idx] = chunk_containing_child;
+      child_subtree_tasks.add_task(
+          [this, chunk_containing_child, child_index, &child_value,
+           &child_subtree_needs_thresholding =
+               child_needs_thresholding[relative_child_idx]]() {
+            updateNodeRecursive(
+                *chunk_containing_child, child_index, 0u, child_value,
+                chunk_containing_child->nodeHasAtLeastOneChild(0u),
+                child_subtree_needs_thresholding);
+          });
+      continue;
     } else {
-      // Otherwise, recurse
+      // Or on the current thread
       DCHECK_GE(child_height, 0);
       updateNodeRecursive(*chunk_containing_child, child_index,
                           child_node_in_chunk_index, child_value,
@@ -190,6 +210,20 @@ void HashedChunkedWaveletIntegrator::updateNodeRecursive(  // NOLINT
     }
   }
 
+  // Wait for the forked subtrees and gather their results
+  child_subtree_tasks.wait();
+  for (NdtreeIndexRelativeChild relative_child_idx = 0;
+       relative_child_idx < OctreeIndex::kNumChildren; ++relative_child_idx) {
+    if (const auto* child_chunk = forked_child_chunks[relative_child_idx];
+        child_chunk) {
+      if (child_chunk->nodeHasAtLeastOneChild(0u) ||
+          data::is_nonzero(child_chunk->nodeData(0u))) {
+        parent_has_child = true;
+      }
+      block_needs_thresholding |= child_needs_thresholding[relative_child_idx];
+    }
+  }
+
   const auto [new_value, new_details] =
       HashedChunkedWaveletOctreeBlock::Transform::forward(child_values);
   parent_details = new_details;
@@ -1,6 +1,7 @@
 #include "wavemap/core/integrator/projective/coarse_to_fine/hashed_wavelet_integrator.h"
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <stack>
 #include <utility>
@@ -11,12 +12,7 @@ namespace wavemap {
 void HashedWaveletIntegrator::updateMap() {
   ProfilerZoneScoped;
   // Update the range image intersector
-  {
-    ProfilerZoneScopedN("updateRangeImageIntersector");
-    range_image_intersector_ = std::make_shared<RangeImageIntersector>(
-        posed_range_image_, projection_model_, *measurement_model_,
-        config_.min_range, config_.max_range);
-  }
+  updateRangeImageIntersector(range_image_intersector_);
 
   // Find all the indices of blocks that need updating
   BlockList blocks_to_update;
@@ -37,13 +33,14 @@ void HashedWaveletIntegrator::updateMap() {
   }
 
   // Update it with the threadpool
-  for (const auto& block_index : blocks_to_update) {
-    thread_pool_->add_task([this, block_index]() {
-      if (auto* block = occupancy_map_->getBlock(block_index.position)) {
-        updateBlock(*block, block_index);
-      }
-    });
-  }
+  thread_pool_->parallel_for(
+      size_t{0}, blocks_to_update.size(),
+      [this, &blocks_to_update](size_t job_idx) {
+        const auto& block_index = blocks_to_update[job_idx];
+        if (auto* block = occupancy_map_->getBlock(block_index.position)) {
+          updateBlock(*block, block_index);
+        }
+      });
   thread_pool_->wait_all();
 }
 
@@ -72,12 +69,61 @@ HashedWaveletIntegrator::getFovMinMaxIndices(
 void HashedWaveletIntegrator::updateBlock(HashedWaveletOctree::Block& block,
                                           const OctreeIndex& block_index) {
   ProfilerZoneScoped;
-  HashedWaveletOctreeBlock::NodeType& root_node = block.getRootNode();
-  HashedWaveletOctreeBlock::Coefficients::Scale& root_node_scale =
-      block.getRootScale();
   block.setNeedsPruning();
   block.setLastUpdatedStamp();
 
+  bool block_needs_thresholding = false;
+  updateSubtree(block.getRootNode(), block_index, block.getRootScale(),
+                block_needs_thresholding);
+  if (block_needs_thresholding) {
+    block.setNeedsThresholding();
+  }
+}
+
+void HashedWaveletIntegrator::updateSubtree(  // NOLINT
+    HashedWaveletOctreeBlock::NodeType& subtree_root_node,
+    const OctreeIndex& subtree_root_index, FloatingPoint& subtree_root_scale,
+    bool& needs_thresholding) {
+  // If the subtree is large enough, process its child subtrees in parallel
+  if (config_.min_parallel_subtree_height < subtree_root_index.height) {
+    auto child_scale_coefficients =
+        HashedWaveletOctreeBlock::Transform::backward(
+            {subtree_root_scale, subtree_root_node.data()});
+    std::array<bool, OctreeIndex::kNumChildren> child_needs_thresholding{};
+    ThreadPool::TaskGroup child_subtree_tasks(*thread_pool_);
+    for (NdtreeIndexRelativeChild child_idx = 0;
+         child_idx < OctreeIndex::kNumChildren; ++child_idx) {
+      const OctreeIndex child_index =
+          subtree_root_index.computeChildIndex(child_idx);
+      FloatingPoint& child_scale = child_scale_coefficients[child_idx];
+      bool& child_subtree_needs_thresholding =
+          child_needs_thresholding[child_idx];
+      if (auto* child_node =
+              updateOrAllocateNode(subtree_root_node, child_index, child_scale,
+                                   child_subtree_needs_thresholding);
+          child_node) {
+        child_subtree_tasks.add_task([this, child_node, child_index,
+                                      &child_scale,
+                                      &child_subtree_needs_thresholding]() {
+          updateSubtree(*child_node, child_index, child_scale,
+                        child_subtree_needs_thresholding);
+        });
+      }
+    }
+    child_subtree_tasks.wait();
+
+    for (const bool child_subtree_needs_thresholding :
+         child_needs_thresholding) {
+      needs_thresholding |= child_subtree_needs_thresholding;
+    }
+    const auto [scale, details] =
+        HashedWaveletOctreeBlock::Transform::forward(child_scale_coefficients);
+    subtree_root_node.data() = details;
+    subtree_root_scale = scale;
+    return;
+  }
+
+  // Otherwise, process it depth-first on the current thread
   struct StackElement {
     HashedWaveletOctreeBlock::NodeType& parent_node;
     const OctreeIndex parent_node_index;
@@ -86,9 +132,10 @@ void HashedWaveletIntegrator::updateBlock(HashedWaveletOctree::Block& block,
         child_scale_coefficients;
   };
   std::stack<StackElement> stack;
-  stack.emplace(StackElement{root_node, block_index, 0,
-                             HashedWaveletOctreeBlock::Transform::backward(
-                                 {root_node_scale, root_node.data()})});
+  stack.emplace(StackElement{
+      subtree_root_node, subtree_root_index, 0,
+      HashedWaveletOctreeBlock::Transform::backward(
+          {subtree_root_scale, subtree_root_node.data()})});
 
   while (!stack.empty()) {
     // If the current stack element has fully been processed, propagate upward
@@ -99,7 +146,7 @@ void HashedWaveletIntegrator::updateBlock(HashedWaveletOctree::Block& block,
       stack.top().parent_node.data() = details;
       stack.pop();
       if (stack.empty()) {
-        root_node_scale = scale;
+        subtree_root_scale = scale;
         return;
       } else {
         const NdtreeIndexRelativeChild current_child_idx =
@@ -123,78 +170,90 @@ void HashedWaveletIntegrator::updateBlock(HashedWaveletOctree::Block& block,
         stack.top().parent_node_index.computeChildIndex(current_child_idx);
     DCHECK_GE(node_index.height, 0);
 
-    // If we're at the leaf level, directly update the node
-    if (node_index.height <= termination_height_) {
-      const Point3D W_node_center =
-          convert::nodeIndexToCenterPoint(node_index, min_cell_width_);
-      const Point3D C_node_center =
-          posed_range_image_->getPoseInverse() * W_node_center;
-      const FloatingPoint sample = computeUpdate(C_node_center);
-      node_value =
-          std::clamp(sample + node_value, min_log_odds_ - kNoiseThreshold,
-                     max_log_odds_ + kNoiseThreshold);
-      continue;
-    }
-
-    // Otherwise, test whether the current node is fully occupied;
-    // free or unknown; or fully unknown
-    const AABB<Point3D> W_cell_aabb =
-        convert::nodeIndexToAABB(node_index, min_cell_width_);
-    const UpdateType update_type =
-        range_image_intersector_->determineUpdateType(
-            W_cell_aabb, posed_range_image_->getRotationMatrixInverse(),
-            posed_range_image_->getOrigin());
-
-    // If we're fully in unknown space,
-    // there's no need to evaluate this node or its children
-    if (update_type == UpdateType::kFullyUnobserved) {
-      continue;
-    }
-
-    // We can also stop here if the cell will result in a free space update
-    // (or zero) and the map is already saturated free
-    if (update_type != UpdateType::kPossiblyOccupied &&
-        node_value < min_log_odds_ + kNoiseThreshold / 10.f) {
-      continue;
+    // Update the node, or refine it if the current resolution is insufficient
+    if (auto* node = updateOrAllocateNode(parent_node, node_index, node_value,
+                                          needs_thresholding);
+        node) {
+      stack.emplace(StackElement{*node, node_index, 0,
+                                 HashedWaveletOctreeBlock::Transform::backward(
+                                     {node_value, node->data()})});
     }
+  }
+}
 
-    // Test if the worst-case error for the intersection type at the current
-    // resolution falls within the acceptable approximation error
-    const FloatingPoint node_width = W_cell_aabb.width<0>();
+HashedWaveletOctreeBlock::NodeType*
+HashedWaveletIntegrator::updateOrAllocateNode(
+    HashedWaveletOctreeBlock::NodeType& parent_node,
+    const OctreeIndex& node_index, FloatingPoint& node_value,
+    bool& needs_thresholding) {
+  // If we're at the leaf level, directly update the node
+  if (node_index.height <= termination_height_) {
     const Point3D W_node_center =
-        W_cell_aabb.min + Vector3D::Constant(node_width / 2.f);
+        convert::nodeIndexToCenterPoint(node_index, min_cell_width_);
     const Point3D C_node_center =
         posed_range_image_->getPoseInverse() * W_node_center;
-    const FloatingPoint d_C_cell =
-        projection_model_->cartesianToSensorZ(C_node_center);
-    const FloatingPoint bounding_sphere_radius =
-        kUnitCubeHalfDiagonal * node_width;
-    HashedWaveletOctreeBlock::NodeType* node =
-        parent_node.getChild(node_index.computeRelativeChildIndex());
-    if (measurement_model_->computeWorstCaseApproximationError(
-            update_type, d_C_cell, bounding_sphere_radius) <
-        config_.termination_update_error) {
-      const FloatingPoint sample = computeUpdate(C_node_center);
-      if (!node || !node->hasAtLeastOneChild()) {
-        node_value =
-            std::clamp(sample + node_value, min_log_odds_ - kNoiseThreshold,
-                       max_log_odds_ + kNoiseThreshold);
-      } else {
-        node_value += sample;
-        block.setNeedsThresholding();
-      }
-      continue;
-    }
+    const FloatingPoint sample = computeUpdate(C_node_center);
+    node_value =
+        std::clamp(sample + node_value, min_log_odds_ - kNoiseThreshold,
+                   max_log_odds_ + kNoiseThreshold);
+    return nullptr;
+  }
+
+  // Otherwise, test whether the current node is fully occupied;
+  // free or unknown; or fully unknown
+  const AABB<Point3D> W_cell_aabb =
+      convert::nodeIndexToAABB(node_index, min_cell_width_);
+  const UpdateType update_type = range_image_intersector_->determineUpdateType(
+      W_cell_aabb, posed_range_image_->getRotationMatrixInverse(),
+      posed_range_image_->getOrigin());
 
-    // Since the approximation error would still be too big, refine
-    if (!node) {
-      // Allocate the current node if it has not yet been allocated
-      node = &parent_node.getOrAllocateChild(
-          node_index.computeRelativeChildIndex());
+  // If we're fully in unknown space,
+  // there's no need to evaluate this node or its children
+  if (update_type == UpdateType::kFullyUnobserved) {
+    return nullptr;
+  }
+
+  // We can also stop here if the cell will result in a free space update
+  // (or zero) and the map is already saturated free
+  if (update_type != UpdateType::kPossiblyOccupied &&
+      node_value < min_log_odds_ + kNoiseThreshold / 10.f) {
+    return nullptr;
+  }
+
+  // Test if the worst-case error for the intersection type at the current
+  // resolution falls within the acceptable approximation error
+  const FloatingPoint node_width = W_cell_aabb.width<0>();
+  const Point3D W_node_center =
+      W_cell_aabb.min + Vector3D::Constant(node_width / 2.f);
+  const Point3D C_node_center =
+      posed_range_image_->getPoseInverse() * W_node_center;
+  const FloatingPoint d_C_cell =
+      projection_model_->cartesianToSensorZ(C_node_center);
+  const FloatingPoint bounding_sphere_radius =
+      kUnitCubeHalfDiagonal * node_width;
+  HashedWaveletOctreeBlock::NodeType* node =
+      parent_node.getChild(node_index.computeRelativeChildIndex());
+  if (measurement_model_->computeWorstCaseApproximationError(
+          update_type, d_C_cell, bounding_sphere_radius) <
+      config_.termination_update_error) {
+    const FloatingPoint sample = computeUpdate(C_node_center);
+    if (!node || !node->hasAtLeastOneChild()) {
+      node_value =
+          std::clamp(sample + node_value, min_log_odds_ - kNoiseThreshold,
+                     max_log_odds_ + kNoiseThreshold);
+    } else {
+      node_value += sample;
+      needs_thresholding = true;
     }
-    stack.emplace(StackElement{*node, node_index, 0,
-                               HashedWaveletOctreeBlock::Transform::backward(
-                                   {node_value, node->data()})});
+    return nullptr;
+  }
+
+  // Since the approximation error would still be too big, refine
+  if (!node) {
+    // Allocate the current node if it has not yet been allocated
+    node =
+        &parent_node.getOrAllocateChild(node_index.computeRelativeChildIndex());
   }
+  return node;
 }
 }  // namespace wavemap
@@ -5,9 +5,7 @@
 namespace wavemap {
 void WaveletIntegrator::updateMap() {
   // Update the range image intersector
-  range_image_intersector_ = std::make_shared<RangeImageIntersector>(
-      posed_range_image_, projection_model_, *measurement_model_,
-      config_.min_range, config_.max_range);
+  updateRangeImageIntersector(range_image_intersector_);
 
   // Recursively update all relevant cells
   const auto first_child_indices = occupancy_map_->getFirstChildIndices();
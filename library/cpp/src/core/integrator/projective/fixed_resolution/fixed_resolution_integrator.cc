@@ -1,52 +1,40 @@
 #include "wavemap/core/integrator/projective/fixed_resolution/fixed_resolution_integrator.h"
 
+#include <algorithm>
+#include <utility>
+
+#include <wavemap/core/utils/profile/profiler_interface.h>
+
 #include "wavemap/core/indexing/index_conversions.h"
 #include "wavemap/core/utils/iterate/grid_iterator.h"
+#include "wavemap/core/utils/math/int_math.h"
 
 namespace wavemap {
+bool FixedResolutionIntegrator::canReuseImportOf(
+    const ProjectiveIntegrator& other) const {
+  const auto* other_fixed_resolution =
+      dynamic_cast<const FixedResolutionIntegrator*>(&other);
+  return other_fixed_resolution &&
+         ProjectiveIntegrator::canReuseImportOf(other) &&
+         config_.max_range == other_fixed_resolution->config_.max_range &&
+         measurement_model_->getPaddingAngle() ==
+             other_fixed_resolution->measurement_model_->getPaddingAngle() &&
+         measurement_model_->getPaddingSurfaceBack() ==
+             other_fixed_resolution->measurement_model_
+                 ->getPaddingSurfaceBack();
+}
+
+void FixedResolutionIntegrator::importFrom(const ProjectiveIntegrator& source) {
+  ProjectiveIntegrator::importFrom(source);
+  aabb_ = static_cast<const FixedResolutionIntegrator&>(source).aabb_;
+}
+
 void FixedResolutionIntegrator::importPointcloud(
     const PosedPointcloud<>& pointcloud) {
-  // Reset the posed range image, beam offset image and aabb
-  posed_range_image_->resetToInitialValue();
-  posed_range_image_->setPose(pointcloud.getPose());
-  beam_offset_image_->resetToInitialValue();
-  aabb_ = AABB<Point3D>{};
-
   // Import all the points while updating the AABB
+  aabb_ = AABB<Point3D>{};
   aabb_.includePoint(pointcloud.getOrigin());  // sensor origin
-  for (const auto& C_point : pointcloud.getPointsLocal()) {
-    // Filter out noisy points and compute point's range
-    if (!isMeasurementValid(C_point)) {
-      continue;
-    }
-
-    // Add the point to the range image
-    const auto sensor_coordinates =
-        projection_model_->cartesianToSensor(C_point);
-    const auto [range_image_index, beam_to_pixel_offset] =
-        projection_model_->imageToNearestIndexAndOffset(
-            sensor_coordinates.image);
-    if (!posed_range_image_->isIndexWithinBounds(range_image_index)) {
-      // Prevent out-of-bounds access
-      continue;
-    }
-
-    // Add the point to the range image
-    // If multiple points hit the same image pixel, keep the closest point
-    const FloatingPoint range = sensor_coordinates.depth;
-    const FloatingPoint old_range_value =
-        posed_range_image_->at(range_image_index);
-    if (old_range_value < config_.min_range || range < old_range_value) {
-      posed_range_image_->at(range_image_index) = range;
-      beam_offset_image_->at(range_image_index) = beam_to_pixel_offset;
-    }
-
-    // Update the AABB (in world frame)
-    Point3D C_point_truncated = getEndPointOrMaxRange(Point3D::Zero(), C_point,
-                                                      range, config_.max_range);
-    const Point3D W_point_truncated = pointcloud.getPose() * C_point_truncated;
-    aabb_.includePoint(W_point_truncated);
-  }
+  importPointcloudIntoRangeImage(pointcloud, &aabb_);
 
   // Pad the aabb to account for the beam uncertainties
   const FloatingPoint max_lateral_component = std::max(
@@ -85,25 +73,165 @@ void FixedResolutionIntegrator::importRangeImage(
   aabb_.max += Vector3D::Constant(max_lateral_component);
 }
 
+template <typename UpdateFn>
+bool FixedResolutionIntegrator::forEachCellUpdate(
+    const Index3D& block_index, const Index3D& aabb_min_index,
+    const Index3D& aabb_max_index, UpdateFn update_fn) const {
+  const FloatingPoint min_cell_width = occupancy_map_->getMinCellWidth();
+  const Transformation3D T_C_W = posed_range_image_->getPoseInverse();
+
+  // Iterate over the block's cells that lie in the AABB
+  const IndexElement cells_per_block_side = int_math::exp2(kBlockHeight);
+  const Index3D block_min_index =
+      aabb_min_index.cwiseMax(block_index * cells_per_block_side);
+  const Index3D block_max_index = aabb_max_index.cwiseMin(
+      (block_index + Index3D::Ones()) * cells_per_block_side - Index3D::Ones());
+  for (const Index3D& index : Grid(block_min_index, block_max_index)) {
+    const Point3D W_cell_center =
+        convert::indexToCenterPoint(index, min_cell_width);
+    const Point3D C_cell_center = T_C_W * W_cell_center;
+    const FloatingPoint update = computeUpdate(C_cell_center);
+    if (kEpsilon < std::abs(update) && !update_fn(index, update)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void FixedResolutionIntegrator::updateMap() {
+  ProfilerZoneScoped;
+  // Update the range image intersector
+  updateRangeImageIntersector(range_image_intersector_);
+
   // Compute the min and max map indices that could be affected by the cloud
-  const FloatingPoint min_cell_width = occupancy_map_->getMinCellWidth();
-  const FloatingPoint min_cell_width_inv = 1.f / min_cell_width;
+  const FloatingPoint min_cell_width_inv =
+      1.f / occupancy_map_->getMinCellWidth();
   const Index3D aabb_min_index =
       convert::pointToFloorIndex(aabb_.min, min_cell_width_inv);
   const Index3D aabb_max_index =
       convert::pointToCeilIndex(aabb_.max, min_cell_width_inv);
 
-  // Iterate over all the cells in the AABB and update the map when needed
-  const Transformation3D T_C_W = posed_range_image_->getPoseInverse();
-  for (const Index3D& index : Grid(aabb_min_index, aabb_max_index)) {
-    const Point3D W_cell_center =
-        convert::indexToCenterPoint(index, min_cell_width);
-    const Point3D C_cell_center = T_C_W * W_cell_center;
-    const FloatingPoint update = computeUpdate(C_cell_center);
-    if (kEpsilon < std::abs(update)) {
-      occupancy_map_->addToCellValue(index, update);
+  // Split the AABB into blocks, skipping those that are fully unobserved
+  const std::vector<Index3D> blocks_to_update =
+      selectBlocksToUpdate(aabb_min_index, aabb_max_index);
+
+  // Update the blocks, directly accessing them if the map supports it
+  if (auto* hashed_blocks = dynamic_cast<HashedBlocks*>(occupancy_map_.get());
+      hashed_blocks) {
+    updateHashedBlocks(*hashed_blocks, blocks_to_update, aabb_min_index,
+                       aabb_max_index);
+    return;
+  }
+  for (const Index3D& block_index : blocks_to_update) {
+    forEachCellUpdate(block_index, aabb_min_index, aabb_max_index,
+                      [this](const Index3D& index, FloatingPoint update) {
+                        occupancy_map_->addToCellValue(index, update);
+                        return true;
+                      });
+  }
+}
+
+std::vector<Index3D> FixedResolutionIntegrator::selectBlocksToUpdate(
+    const Index3D& aabb_min_index, const Index3D& aabb_max_index) const {
+  ProfilerZoneScoped;
+  const FloatingPoint min_cell_width = occupancy_map_->getMinCellWidth();
+  const auto R_C_W = posed_range_image_->getRotationMatrixInverse();
+  const Point3D& t_W_C = posed_range_image_->getOrigin();
+
+  std::vector<Index3D> blocks_to_update;
+  for (const Index3D& block_index :
+       Grid(convert::indexToBlockIndex(aabb_min_index, kBlockHeight),
+            convert::indexToBlockIndex(aabb_max_index, kBlockHeight))) {
+    const AABB<Point3D> W_block_aabb = convert::nodeIndexToAABB(
+        OctreeIndex{kBlockHeight, block_index}, min_cell_width);
+    if (range_image_intersector_->determineUpdateType(W_block_aabb, R_C_W,
+                                                      t_W_C) !=
+        UpdateType::kFullyUnobserved) {
+      blocks_to_update.emplace_back(block_index);
     }
   }
+  return blocks_to_update;
+}
+
+void FixedResolutionIntegrator::updateHashedBlocks(
+    HashedBlocks& hashed_blocks, const std::vector<Index3D>& blocks_to_update,
+    const Index3D& aabb_min_index, const Index3D& aabb_max_index) {
+  ProfilerZoneScoped;
+  auto update_cell = [&hashed_blocks](HashedBlocks::Block& block,
+                                      const Index3D& index,
+                                      FloatingPoint update) {
+    FloatingPoint& cell_value = block.at(HashedBlocks::indexToCellIndex(index));
+    cell_value = hashed_blocks.clampedAdd(cell_value, update);
+  };
+
+  // Without a thread pool, update the blocks serially and only allocate the
+  // new blocks once they receive their first update
+  if (!thread_pool_) {
+    for (const Index3D& block_index : blocks_to_update) {
+      HashedBlocks::Block* block = hashed_blocks.getBlock(block_index);
+      forEachCellUpdate(
+          block_index, aabb_min_index, aabb_max_index,
+          [&hashed_blocks, &update_cell, &block_index, &block](
+              const Index3D& index, FloatingPoint update) {
+            if (!block) {
+              block = &hashed_blocks.getOrAllocateBlock(block_index);
+            }
+            update_cell(*block, index, update);
+            return true;
+          });
+    }
+    return;
+  }
+
+  auto update_block = [this, &aabb_min_index, &aabb_max_index, &update_cell](
+                          const Index3D& block_index,
+                          HashedBlocks::Block& block) {
+    forEachCellUpdate(block_index, aabb_min_index, aabb_max_index,
+                      [&block, &update_cell](const Index3D& index,
+                                             FloatingPoint update) {
+                        update_cell(block, index, update);
+                        return true;
+                      });
+  };
+
+  // Update the blocks that already exist. For the others, only check whether
+  // they receive any update, since allocating blocks modifies the map's hash
+  // table and therefore has to happen serially.
+  std::vector<char> needs_allocation(blocks_to_update.size(), false);
+  ThreadPool::TaskGroup task_group{*thread_pool_};
+  for (size_t job_idx = 0; job_idx < blocks_to_update.size(); ++job_idx) {
+    task_group.add_task([this, &hashed_blocks, &blocks_to_update,
+                         &aabb_min_index, &aabb_max_index, &needs_allocation,
+                         &update_block, job_idx]() {
+      const Index3D& block_index = blocks_to_update[job_idx];
+      if (auto* block = hashed_blocks.getBlock(block_index); block) {
+        update_block(block_index, *block);
+      } else {
+        needs_allocation[job_idx] = !forEachCellUpdate(
+            block_index, aabb_min_index, aabb_max_index,
+            [](const Index3D& /*index*/, FloatingPoint /*update*/) {
+              return false;
+            });
+      }
+    });
+  }
+  task_group.wait();
+
+  // Allocate the new blocks that receive updates, and update them
+  std::vector<std::pair<Index3D, HashedBlocks::Block*>> new_blocks;
+  for (size_t job_idx = 0; job_idx < blocks_to_update.size(); ++job_idx) {
+    if (needs_allocation[job_idx]) {
+      const Index3D& block_index = blocks_to_update[job_idx];
+      new_blocks.emplace_back(block_index,
+                              &hashed_blocks.getOrAllocateBlock(block_index));
+    }
+  }
+  for (const auto& [block_index, block] : new_blocks) {
+    task_group.add_task([&update_block, &block_index = block_index,
+                         block = block]() {
+      update_block(block_index, *block);
+    });
+  }
+  task_group.wait();
 }
 }  // namespace wavemap
@@ -1,5 +1,7 @@
 #include "wavemap/core/integrator/projective/projective_integrator.h"
 
+#include <algorithm>
+
 #include <wavemap/core/utils/data/eigen_checks.h>
 #include <wavemap/core/utils/profile/profiler_interface.h>
 
@@ -8,7 +10,8 @@ DECLARE_CONFIG_MEMBERS(ProjectiveIntegratorConfig,
                       (min_range)
                       (max_range)
                       (max_update_resolution)
-                      (termination_update_error));
+                      (termination_update_error)
+                      (min_parallel_subtree_height));
 
 bool ProjectiveIntegratorConfig::isValid(bool verbose) const {
   bool is_valid = true;
@@ -18,83 +21,307 @@ bool ProjectiveIntegratorConfig::isValid(bool verbose) const {
   is_valid &= IS_PARAM_LT(min_range, max_range, verbose);
   is_valid &= IS_PARAM_GE(max_update_resolution, 0.f, verbose);
   is_valid &= IS_PARAM_GT(termination_update_error, 0.f, verbose);
+  is_valid &= IS_PARAM_GE(min_parallel_subtree_height, 0, verbose);
 
   return is_valid;
 }
 
 void ProjectiveIntegrator::integrate(const PosedPointcloud<>& pointcloud) {
   ProfilerZoneScoped;
+  if (importMeasurement(pointcloud)) {
+    updateMapWithImport();
+  }
+}
+
+void ProjectiveIntegrator::integrate(const PosedImage<>& range_image) {
+  ProfilerZoneScoped;
+  if (importMeasurement(range_image)) {
+    updateMapWithImport();
+  }
+}
+
+void ProjectiveIntegrator::integrate(const PosedPointcloud<>& pointcloud,
+                                     const ProjectiveIntegrator& source) {
+  ProfilerZoneScoped;
+  if (importMeasurement(pointcloud, source)) {
+    updateMapWithImport();
+  }
+}
+
+void ProjectiveIntegrator::integrate(const PosedImage<>& range_image,
+                                     const ProjectiveIntegrator& source) {
+  ProfilerZoneScoped;
+  if (importMeasurement(range_image, source)) {
+    updateMapWithImport();
+  }
+}
+
+bool ProjectiveIntegrator::canReuseImportOf(
+    const ProjectiveIntegrator& other) const {
+  return &other != this && config_.min_range == other.config_.min_range &&
+         projection_model_->isEquivalentTo(*other.projection_model_);
+}
+
+bool ProjectiveIntegrator::importMeasurement(
+    const PosedPointcloud<>& pointcloud) {
   if (!isPoseValid(pointcloud.getPose())) {
-    return;
+    return false;
   }
+  import_source_ = nullptr;
   importPointcloud(pointcloud);
+  return true;
+}
+
+bool ProjectiveIntegrator::importMeasurement(const PosedImage<>& range_image) {
+  if (!isRangeImageValid(range_image)) {
+    return false;
+  }
+  import_source_ = nullptr;
+  importRangeImage(range_image);
+  return true;
+}
+
+bool ProjectiveIntegrator::importMeasurement(
+    const PosedPointcloud<>& pointcloud, const ProjectiveIntegrator& source) {
+  if (!isPoseValid(pointcloud.getPose())) {
+    return false;
+  }
+  importFromSource(source);
+  return true;
+}
+
+bool ProjectiveIntegrator::importMeasurement(
+    const PosedImage<>& range_image, const ProjectiveIntegrator& source) {
+  if (!isRangeImageValid(range_image)) {
+    return false;
+  }
+  importFromSource(source);
+  return true;
+}
+
+void ProjectiveIntegrator::updateMapWithImport() {
   updateMap();
+  import_source_ = nullptr;
 }
 
-void ProjectiveIntegrator::integrate(const PosedImage<>& range_image) {
-  ProfilerZoneScoped;
-  CHECK_NOTNULL(projection_model_);
+bool ProjectiveIntegrator::isRangeImageValid(
+    const PosedImage<>& range_image) const {
+  CHECK(projection_model_);
   if (range_image.getDimensions() != projection_model_->getDimensions()) {
     LOG(WARNING) << "Dimensions of range image"
                  << print::eigen::oneLine(range_image.getDimensions())
                  << " do not match projection model"
                  << print::eigen::oneLine(projection_model_->getDimensions())
                  << ". Ignoring integration request.";
-    return;
+    return false;
   }
-  if (!isPoseValid(range_image.getPose())) {
-    return;
+  return isPoseValid(range_image.getPose());
+}
+
+void ProjectiveIntegrator::importFromSource(
+    const ProjectiveIntegrator& source) {
+  CHECK(canReuseImportOf(source));
+  importFrom(source);
+  import_source_ = &source;
+}
+
+void ProjectiveIntegrator::importFrom(const ProjectiveIntegrator& source) {
+  ProfilerZoneScoped;
+  *posed_range_image_ = *source.posed_range_image_;
+  *beam_offset_image_ = *source.beam_offset_image_;
+}
+
+void ProjectiveIntegrator::updateRangeImageIntersector(
+    std::shared_ptr<RangeImageIntersector>& range_image_intersector) const {
+  ProfilerZoneScoped;
+  if (range_image_intersector) {
+    range_image_intersector->update(getReusableRangeBounds());
+  } else {
+    range_image_intersector = std::make_shared<RangeImageIntersector>(
+        posed_range_image_, projection_model_, *measurement_model_,
+        config_.min_range, config_.max_range);
   }
-  importRangeImage(range_image);
-  updateMap();
 }
 
 void ProjectiveIntegrator::importPointcloud(
     const PosedPointcloud<>& pointcloud) {
   ProfilerZoneScoped;
+  importPointcloudIntoRangeImage(pointcloud);
+}
+
+void ProjectiveIntegrator::importRangeImage(
+    const PosedImage<>& range_image_input) {
+  ProfilerZoneScoped;
+  CHECK_NOTNULL(posed_range_image_);
+  CHECK_EIGEN_EQ(range_image_input.getDimensions(),
+                 posed_range_image_->getDimensions());
+  *posed_range_image_ = range_image_input;
+  beam_offset_image_->resetToInitialValue();
+}
+
+void ProjectiveIntegrator::importPointcloudIntoRangeImage(
+    const PosedPointcloud<>& pointcloud, AABB<Point3D>* W_aabb) {
+  ProfilerZoneScoped;
   // Reset the posed range image and the beam offset image
   posed_range_image_->resetToInitialValue();
   posed_range_image_->setPose(pointcloud.getPose());
   beam_offset_image_->resetToInitialValue();
 
-  // Import all the points
-  for (const auto& C_point : pointcloud.getPointsLocal()) {
+  // Project all the points at once
+  projection_model_->cartesianToSensor(pointcloud.getPointsLocal(),
+                                       image_coordinates_batch_,
+                                       sensor_z_batch_);
+
+  // Import all the points, in parallel if the pointcloud is large enough
+  const Eigen::Index num_points = pointcloud.getPointsLocal().data().cols();
+  const size_t num_tasks =
+      thread_pool_ ? std::min(thread_pool_->num_workers(),
+                              static_cast<size_t>(num_points /
+                                                  kMinNumPointsPerImportTask))
+                   : 1u;
+  if (1u < num_tasks) {
+    importPointsInParallel(pointcloud, num_tasks, W_aabb);
+  } else {
+    importPoints(pointcloud, 0, num_points, *posed_range_image_,
+                 *beam_offset_image_, nullptr, W_aabb);
+  }
+}
+
+void ProjectiveIntegrator::importPoints(const PosedPointcloud<>& pointcloud,
+                                        Eigen::Index begin_point_idx,
+                                        Eigen::Index end_point_idx,
+                                        Image<>& range_image,
+                                        Image<Vector2D>& beam_offset_image,
+                                        Image<uint8_t>* pixel_states,
+                                        AABB<Point3D>* W_aabb) const {
+  const auto& C_points = pointcloud.getPointsLocal();
+  for (Eigen::Index point_idx = begin_point_idx; point_idx < end_point_idx;
+       ++point_idx) {
     // Filter out noisy points and compute point's range
+    const Point3D C_point = C_points[point_idx];
     if (!isMeasurementValid(C_point)) {
       continue;
     }
 
     // Calculate the range image index
-    const auto sensor_coordinates =
-        projection_model_->cartesianToSensor(C_point);
-
     const auto [range_image_index, beam_to_pixel_offset] =
         projection_model_->imageToNearestIndexAndOffset(
-            sensor_coordinates.image);
-    if (!posed_range_image_->isIndexWithinBounds(range_image_index)) {
+            image_coordinates_batch_.col(point_idx));
+    if (!range_image.isIndexWithinBounds(range_image_index)) {
       // Prevent out-of-bounds access
       continue;
     }
 
+    // Keep track of which pixels were hit, if requested
+    const FloatingPoint range = sensor_z_batch_[point_idx];
+    bool is_first_hit = false;
+    if (pixel_states) {
+      uint8_t& pixel_state = pixel_states->at(range_image_index);
+      is_first_hit = pixel_state == RangeImageTile::kNotHit;
+      if (range < config_.min_range) {
+        pixel_state = RangeImageTile::kHitBelowMinRange;
+      } else if (is_first_hit) {
+        pixel_state = RangeImageTile::kHit;
+      }
+    }
+
     // Add the point to the range image, if multiple points hit the same image
     // pixel, keep the closest point
-    const FloatingPoint range = sensor_coordinates.depth;
-    const FloatingPoint old_range_value =
-        posed_range_image_->at(range_image_index);
-    if (old_range_value < config_.min_range || range < old_range_value) {
-      posed_range_image_->at(range_image_index) = range;
-      beam_offset_image_->at(range_image_index) = beam_to_pixel_offset;
+    const FloatingPoint old_range_value = range_image.at(range_image_index);
+    if (is_first_hit || old_range_value < config_.min_range ||
+        range < old_range_value) {
+      range_image.at(range_image_index) = range;
+      beam_offset_image.at(range_image_index) = beam_to_pixel_offset;
+    }
+
+    // Update the AABB (in world frame), if requested
+    if (W_aabb) {
+      const Point3D C_point_truncated = getEndPointOrMaxRange(
+          Point3D::Zero(), C_point, range, config_.max_range);
+      W_aabb->includePoint(pointcloud.getPose() * C_point_truncated);
     }
   }
 }
 
-void ProjectiveIntegrator::importRangeImage(
-    const PosedImage<>& range_image_input) {
+void ProjectiveIntegrator::importPointsInParallel(
+    const PosedPointcloud<>& pointcloud, size_t num_tasks,
+    AABB<Point3D>* W_aabb) {
   ProfilerZoneScoped;
-  CHECK_NOTNULL(posed_range_image_);
-  CHECK_EIGEN_EQ(range_image_input.getDimensions(),
-                 posed_range_image_->getDimensions());
-  *posed_range_image_ = range_image_input;
-  beam_offset_image_->resetToInitialValue();
+  CHECK(thread_pool_);
+
+  // Import contiguous chunks of the pointcloud into separate tiles
+  const Index2D dimensions = posed_range_image_->getDimensions();
+  while (range_image_tiles_.size() < num_tasks) {
+    range_image_tiles_.emplace_back(dimensions);
+  }
+  const Eigen::Index num_points = pointcloud.getPointsLocal().data().cols();
+  ThreadPool::TaskGroup task_group{*thread_pool_};
+  for (size_t task_idx = 0; task_idx < num_tasks; ++task_idx) {
+    task_group.add_task([this, &pointcloud, W_aabb, num_points, num_tasks,
+                         task_idx]() {
+      RangeImageTile& tile = range_image_tiles_[task_idx];
+      tile.pixel_states.resetToInitialValue();
+      tile.W_aabb = AABB<Point3D>{};
+      const auto num_tasks_signed = static_cast<Eigen::Index>(num_tasks);
+      const auto task_idx_signed = static_cast<Eigen::Index>(task_idx);
+      importPoints(pointcloud, num_points * task_idx_signed / num_tasks_signed,
+                   num_points * (task_idx_signed + 1) / num_tasks_signed,
+                   tile.range_image, tile.beam_offset_image, &tile.pixel_states,
+                   W_aabb ? &tile.W_aabb : nullptr);
+    });
+  }
+  task_group.wait();
+
+  // Merge the tiles in the order of their chunks, splitting the image into
+  // column ranges that are merged in parallel
+  // NOTE: When importing serially, a point overwrites its pixel if the pixel's
+  //       current value is below min_range or if the point is closer. Points
+  //       below min_range thus always overwrite the pixel, after which it
+  //       evolves exactly as in the chunk's tile. If all of a chunk's points
+  //       are above min_range, the chunk's result is its tile's value if the
+  //       current value is below min_range, and otherwise the closer of the two
+  //       with ties keeping the current value. Merging the tiles in the order
+  //       of their chunks therefore reproduces the serial result exactly.
+  const IndexElement num_columns = dimensions.y();
+  const auto num_merge_tasks = static_cast<IndexElement>(num_tasks);
+  for (IndexElement task_idx = 0; task_idx < num_merge_tasks; ++task_idx) {
+    task_group.add_task([this, num_columns, num_merge_tasks, num_tasks,
+                         task_idx]() {
+      const IndexElement begin_column =
+          num_columns * task_idx / num_merge_tasks;
+      const IndexElement end_column =
+          num_columns * (task_idx + 1) / num_merge_tasks;
+      for (IndexElement column = begin_column; column < end_column; ++column) {
+        for (IndexElement row = 0; row < posed_range_image_->getNumRows();
+             ++row) {
+          const Index2D index{row, column};
+          FloatingPoint& range = posed_range_image_->at(index);
+          for (size_t tile_idx = 0; tile_idx < num_tasks; ++tile_idx) {
+            const RangeImageTile& tile = range_image_tiles_[tile_idx];
+            const uint8_t pixel_state = tile.pixel_states.at(index);
+            if (pixel_state == RangeImageTile::kNotHit) {
+              continue;
+            }
+            const FloatingPoint tile_range = tile.range_image.at(index);
+            if (pixel_state == RangeImageTile::kHitBelowMinRange ||
+                range < config_.min_range || tile_range < range) {
+              range = tile_range;
+              beam_offset_image_->at(index) = tile.beam_offset_image.at(index);
+            }
+          }
+        }
+      }
+    });
+  }
+  task_group.wait();
+
+  // Merge the AABBs
+  if (W_aabb) {
+    for (size_t tile_idx = 0; tile_idx < num_tasks; ++tile_idx) {
+      const AABB<Point3D>& tile_aabb = range_image_tiles_[tile_idx].W_aabb;
+      W_aabb->min = W_aabb->min.cwiseMin(tile_aabb.min);
+      W_aabb->max = W_aabb->max.cwiseMax(tile_aabb.max);
+    }
+  }
 }
 }  // namespace wavemap
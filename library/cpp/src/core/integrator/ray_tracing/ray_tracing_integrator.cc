@@ -1,9 +1,17 @@
 #include "wavemap/core/integrator/ray_tracing/ray_tracing_integrator.h"
 
+#include <algorithm>
+
+#include <wavemap/core/map/hashed_blocks.h>
+#include <wavemap/core/map/hashed_chunked_wavelet_octree.h>
+#include <wavemap/core/map/hashed_wavelet_octree.h>
+#include <wavemap/core/utils/profile/profiler_interface.h>
+
 namespace wavemap {
 DECLARE_CONFIG_MEMBERS(RayTracingIntegratorConfig,
                       (min_range)
-                      (max_range));
+                      (max_range)
+                      (merge_rays));
 
 bool RayTracingIntegratorConfig::isValid(bool verbose) const {
   bool is_valid = true;
@@ -15,18 +23,81 @@ bool RayTracingIntegratorConfig::isValid(bool verbose) const {
   return is_valid;
 }
 
-void RayTracingIntegrator::integrate(const PosedPointcloud<>& pointcloud) {
-  if (!isPoseValid(pointcloud.getPose())) {
-    return;
+namespace {
+// Height of the blocks into which the map is subdivided, in cells
+IndexElement getBlockHeight(const HashedBlocks& /*map*/) {
+  return HashedBlocks::kCellsPerSideLog2;
+}
+template <typename MapT>
+IndexElement getBlockHeight(const MapT& map) {
+  return map.getTreeHeight();
+}
+
+// Get a function that adds updates to cells of an already allocated block
+auto getBlockCellUpdater(HashedBlocks& map, const Index3D& block_index) {
+  HashedBlocks::Block& block = *CHECK_NOTNULL(map.getBlock(block_index));
+  return [&map, &block](const Index3D& index, FloatingPoint update) {
+    FloatingPoint& cell_value = block.at(HashedBlocks::indexToCellIndex(index));
+    cell_value = map.clampedAdd(cell_value, update);
+  };
+}
+template <typename MapT>
+auto getBlockCellUpdater(MapT& map, const Index3D& block_index) {
+  typename MapT::Block& block = *CHECK_NOTNULL(map.getBlock(block_index));
+  return [&map, &block](const Index3D& index, FloatingPoint update) {
+    block.addToCellValue(map.indexToCellIndex({0, index}), update);
+  };
+}
+}  // namespace
+
+void RayTracingIntegrator::mergeRays(
+    const Point3D& W_start_point, Pointcloud<>& W_end_points,
+    std::vector<FloatingPoint>& ray_weights) const {
+  ProfilerZoneScoped;
+  const FloatingPoint min_cell_width = occupancy_map_->getMinCellWidth();
+  const FloatingPoint min_cell_width_inv = 1.f / min_cell_width;
+
+  // Count the end points per cell, in the order in which the cells are first
+  // hit to keep the integration order deterministic
+  std::unordered_map<Index3D, size_t, IndexHash<3>> cell_to_ray_idx;
+  std::vector<Index3D> end_point_indices;
+  ray_weights.clear();
+  for (const auto& W_end_point : W_end_points) {
+    if (!isMeasurementValid(W_end_point - W_start_point)) {
+      continue;
+    }
+    const Index3D end_point_index =
+        convert::pointToNearestIndex<3>(W_end_point, min_cell_width_inv);
+    const auto [it, inserted] =
+        cell_to_ray_idx.try_emplace(end_point_index, end_point_indices.size());
+    if (inserted) {
+      end_point_indices.emplace_back(end_point_index);
+      ray_weights.emplace_back(0.f);
+    }
+    ray_weights[it->second] += 1.f;
   }
 
+  // Replace the end points with the centers of the cells they fell into
+  W_end_points.resize(end_point_indices.size());
+  for (size_t ray_idx = 0; ray_idx < end_point_indices.size(); ++ray_idx) {
+    W_end_points[static_cast<Eigen::Index>(ray_idx)] =
+        convert::indexToCenterPoint(end_point_indices[ray_idx], min_cell_width);
+  }
+}
+
+template <typename UpdateFn>
+void RayTracingIntegrator::traceRays(
+    const Point3D& W_start_point, const Pointcloud<>& W_end_points,
+    const std::vector<FloatingPoint>& ray_weights, Eigen::Index begin_ray_idx,
+    Eigen::Index end_ray_idx, UpdateFn update_fn) const {
   const FloatingPoint min_cell_width = occupancy_map_->getMinCellWidth();
-  const Point3D& W_start_point = pointcloud.getOrigin();
 
   MeasurementModelType measurement_model(min_cell_width);
   measurement_model.setStartPoint(W_start_point);
 
-  for (const auto& W_end_point : pointcloud.getPointsGlobal()) {
+  for (Eigen::Index ray_idx = begin_ray_idx; ray_idx < end_ray_idx;
+       ++ray_idx) {
+    const Point3D W_end_point = W_end_points[ray_idx];
     measurement_model.setEndPoint(W_end_point);
 
     if (!isMeasurementValid(W_end_point - W_start_point)) {
@@ -37,11 +108,134 @@ void RayTracingIntegrator::integrate(const PosedPointcloud<>& pointcloud) {
         (W_start_point - W_end_point).norm();
     const Point3D W_end_point_truncated = getEndPointOrMaxRange(
         W_start_point, W_end_point, measured_distance, config_.max_range);
+    const FloatingPoint ray_weight =
+        ray_weights.empty() ? 1.f : ray_weights[ray_idx];
     const Ray ray(W_start_point, W_end_point_truncated, min_cell_width);
     for (const auto& index : ray) {
-      const FloatingPoint update = measurement_model.computeUpdate(index);
-      occupancy_map_->addToCellValue(index, update);
+      const FloatingPoint update =
+          ray_weight * measurement_model.computeUpdate(index);
+      update_fn(index, update);
+    }
+  }
+}
+
+template <typename MapT>
+void RayTracingIntegrator::integrateInParallel(
+    const Point3D& W_start_point, const Pointcloud<>& W_end_points,
+    const std::vector<FloatingPoint>& ray_weights, MapT& map) {
+  ProfilerZoneScoped;
+  CHECK(thread_pool_);
+
+  const IndexElement block_height = getBlockHeight(map);
+  const auto num_rays = static_cast<Eigen::Index>(W_end_points.size());
+  std::vector<BlockUpdateMap> task_updates;
+  for (Eigen::Index batch_begin = 0; batch_begin < num_rays;
+       batch_begin += kMaxNumRaysPerBatch) {
+    const Eigen::Index batch_end =
+        std::min(batch_begin + kMaxNumRaysPerBatch, num_rays);
+
+    // Trace contiguous chunks of rays in parallel, bucketing their cell
+    // updates by block
+    const auto num_tasks = static_cast<Eigen::Index>(std::clamp(
+        static_cast<size_t>((batch_end - batch_begin) / kMinNumRaysPerTask),
+        size_t{1}, thread_pool_->num_workers()));
+    task_updates.resize(num_tasks);
+    ThreadPool::TaskGroup task_group{*thread_pool_};
+    for (Eigen::Index task_idx = 0; task_idx < num_tasks; ++task_idx) {
+      task_group.add_task([this, &W_start_point, &W_end_points, &ray_weights,
+                           &task_updates, block_height, batch_begin, batch_end,
+                           num_tasks, task_idx]() {
+        BlockUpdateMap& block_updates = task_updates[task_idx];
+        block_updates.clear();
+        const Eigen::Index num_batch_rays = batch_end - batch_begin;
+        traceRays(W_start_point, W_end_points, ray_weights,
+                  batch_begin + num_batch_rays * task_idx / num_tasks,
+                  batch_begin + num_batch_rays * (task_idx + 1) / num_tasks,
+                  [&block_updates, block_height](const Index3D& index,
+                                                 FloatingPoint update) {
+                    block_updates[convert::indexToBlockIndex(index,
+                                                             block_height)]
+                        .emplace_back(CellUpdate{index, update});
+                  });
+      });
+    }
+    task_group.wait();
+
+    // Gather the updates of each block in the order of the tasks, and make
+    // sure all the blocks are allocated
+    // NOTE: Allocating blocks modifies the map's hash table, so this has to
+    //       happen serially before the blocks are updated.
+    std::unordered_map<Index3D, size_t, IndexHash<3>> block_to_job_idx;
+    std::vector<Index3D> job_block_indices;
+    std::vector<std::vector<const CellUpdateList*>> job_update_lists;
+    for (const auto& block_updates : task_updates) {
+      for (const auto& [block_index, cell_updates] : block_updates) {
+        const auto [it, inserted] =
+            block_to_job_idx.try_emplace(block_index, job_block_indices.size());
+        if (inserted) {
+          map.getOrAllocateBlock(block_index);
+          job_block_indices.emplace_back(block_index);
+          job_update_lists.emplace_back();
+        }
+        job_update_lists[it->second].emplace_back(&cell_updates);
+      }
     }
+
+    // Apply the updates, with one task per block
+    for (size_t job_idx = 0; job_idx < job_block_indices.size(); ++job_idx) {
+      task_group.add_task(
+          [&map, &job_block_indices, &job_update_lists, job_idx]() {
+            auto cell_updater =
+                getBlockCellUpdater(map, job_block_indices[job_idx]);
+            for (const CellUpdateList* cell_updates :
+                 job_update_lists[job_idx]) {
+              for (const auto& [index, update] : *cell_updates) {
+                cell_updater(index, update);
+              }
+            }
+          });
+    }
+    task_group.wait();
   }
 }
+
+void RayTracingIntegrator::integrate(const PosedPointcloud<>& pointcloud) {
+  ProfilerZoneScoped;
+  if (!isPoseValid(pointcloud.getPose())) {
+    return;
+  }
+
+  const Point3D& W_start_point = pointcloud.getOrigin();
+  Pointcloud<> W_end_points = pointcloud.getPointsGlobal();
+  std::vector<FloatingPoint> ray_weights;
+  if (config_.merge_rays) {
+    mergeRays(W_start_point, W_end_points, ray_weights);
+  }
+  const auto num_rays = static_cast<Eigen::Index>(W_end_points.size());
+
+  // Integrate large pointclouds in parallel if the map consists of blocks that
+  // can be updated independently
+  if (thread_pool_ && 2 * kMinNumRaysPerTask <= num_rays) {
+    if (auto* map = dynamic_cast<HashedWaveletOctree*>(occupancy_map_.get());
+        map) {
+      integrateInParallel(W_start_point, W_end_points, ray_weights, *map);
+      return;
+    }
+    if (auto* map =
+            dynamic_cast<HashedChunkedWaveletOctree*>(occupancy_map_.get());
+        map) {
+      integrateInParallel(W_start_point, W_end_points, ray_weights, *map);
+      return;
+    }
+    if (auto* map = dynamic_cast<HashedBlocks*>(occupancy_map_.get()); map) {
+      integrateInParallel(W_start_point, W_end_points, ray_weights, *map);
+      return;
+    }
+  }
+
+  traceRays(W_start_point, W_end_points, ray_weights, 0, num_rays,
+            [this](const Index3D& index, FloatingPoint update) {
+              occupancy_map_->addToCellValue(index, update);
+            });
+}
 }  // namespace wavemap
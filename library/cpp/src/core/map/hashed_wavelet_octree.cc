@@ -1,7 +1,9 @@
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 
 #include <unordered_set>
+#include <vector>
 
+#include <wavemap/core/utils/iterate/for_each_in_parallel.h>
 #include <wavemap/core/utils/profile/profiler_interface.h>
 
 namespace wavemap {
@@ -22,31 +24,63 @@ bool HashedWaveletOctreeConfig::isValid(bool verbose) const {
   return is_valid;
 }
 
-void HashedWaveletOctree::threshold() {
+void HashedWaveletOctree::threshold(ThreadPool* thread_pool) {
   ProfilerZoneScoped;
-  forEachBlock([](const BlockIndex& /*block_index*/, Block& block) {
-    block.threshold();
+  std::vector<Block*> blocks;
+  forEachBlock([&blocks](const BlockIndex& /*block_index*/, Block& block) {
+    if (block.getNeedsThresholding()) {
+      blocks.emplace_back(&block);
+    }
   });
+  forEachInParallel(
+      blocks, [](Block& block) { block.threshold(); }, thread_pool);
 }
 
-void HashedWaveletOctree::prune() {
+void HashedWaveletOctree::prune(ThreadPool* thread_pool) {
   ProfilerZoneScoped;
-  block_map_.eraseBlockIf([](const BlockIndex& /*block_index*/, Block& block) {
-    block.prune();
-    return block.empty();
+  std::vector<BlockIndex> block_indices;
+  std::vector<Block*> blocks;
+  forEachBlock([&block_indices, &blocks](const BlockIndex& block_index,
+                                         Block& block) {
+    if (block.getNeedsPruning() || block.empty()) {
+      block_indices.emplace_back(block_index);
+      blocks.emplace_back(&block);
+    }
   });
+  forEachInParallel(
+      blocks, [](Block& block) { block.prune(); }, thread_pool);
+  eraseEmptyBlocks(block_indices, blocks);
 }
 
-void HashedWaveletOctree::pruneSmart() {
+void HashedWaveletOctree::pruneSmart(ThreadPool* thread_pool) {
   ProfilerZoneScoped;
-  block_map_.eraseBlockIf(
-      [&config = config_](const BlockIndex& /*block_index*/, Block& block) {
-        if (config.only_prune_blocks_if_unused_for <
-            block.getTimeSinceLastUpdated()) {
-          block.prune();
-        }
-        return block.empty();
-      });
+  std::vector<BlockIndex> block_indices;
+  std::vector<Block*> blocks;
+  forEachBlock([&block_indices, &blocks, &config = config_](
+                   const BlockIndex& block_index, Block& block) {
+    if ((block.getNeedsPruning() && config.only_prune_blocks_if_unused_for <
+                                        block.getTimeSinceLastUpdated()) ||
+        block.empty()) {
+      block_indices.emplace_back(block_index);
+      blocks.emplace_back(&block);
+    }
+  });
+  forEachInParallel(
+      blocks, [](Block& block) { block.prune(); }, thread_pool);
+  eraseEmptyBlocks(block_indices, blocks);
+}
+
+void HashedWaveletOctree::eraseEmptyBlocks(
+    const std::vector<BlockIndex>& block_indices,
+    const std::vector<Block*>& blocks) {
+  // NOTE: The blocks are only erased once all of them have been processed,
+  //       since erasing modifies the hash map that is shared by all tasks.
+  DCHECK_EQ(block_indices.size(), blocks.size());
+  for (size_t idx = 0; idx < blocks.size(); ++idx) {
+    if (blocks[idx]->empty()) {
+      block_map_.eraseBlock(block_indices[idx]);
+    }
+  }
 }
 
 size_t HashedWaveletOctree::getMemoryUsage() const {
@@ -0,0 +1,63 @@
+#include "wavemap/core/utils/memory/arena_allocator.h"
+
+#include <algorithm>
+#include <new>
+
+namespace wavemap {
+void* ArenaAllocator::allocate(size_t num_bytes) {
+  const size_t object_size = roundUpToAlignment(num_bytes);
+  std::lock_guard lock(mutex_);
+
+  // Reuse a previously freed object of the same size, if available
+  FreeList& free_list = getFreeList(object_size);
+  if (free_list.head) {
+    FreeListNode* node = free_list.head;
+    free_list.head = node->next;
+    return node;
+  }
+
+  // Otherwise, carve it out of the current slab, starting a new one if needed
+  if (static_cast<size_t>(slab_end_ - slab_cursor_) < object_size) {
+    const size_t slab_size = std::max(next_slab_size_, object_size);
+    slabs_.emplace_back(new std::byte[slab_size]);
+    slab_cursor_ = slabs_.back().get();
+    slab_end_ = slab_cursor_ + slab_size;
+    reserved_bytes_ += slab_size;
+    next_slab_size_ = std::min(2 * next_slab_size_, kMaxSlabSize);
+  }
+  void* ptr = slab_cursor_;
+  slab_cursor_ += object_size;
+  return ptr;
+}
+
+void ArenaAllocator::deallocate(void* ptr, size_t num_bytes) {
+  const size_t object_size = roundUpToAlignment(num_bytes);
+  std::lock_guard lock(mutex_);
+  FreeList& free_list = getFreeList(object_size);
+  free_list.head = new (ptr) FreeListNode{free_list.head};
+}
+
+void ArenaAllocator::clear() {
+  std::lock_guard lock(mutex_);
+  slabs_.clear();
+  slab_cursor_ = nullptr;
+  slab_end_ = nullptr;
+  next_slab_size_ = kMinSlabSize;
+  reserved_bytes_ = 0;
+  free_lists_.clear();
+}
+
+size_t ArenaAllocator::getMemoryUsage() const {
+  std::lock_guard lock(mutex_);
+  return reserved_bytes_;
+}
+
+ArenaAllocator::FreeList& ArenaAllocator::getFreeList(size_t object_size) {
+  for (FreeList& free_list : free_lists_) {
+    if (free_list.object_size == object_size) {
+      return free_list;
+    }
+  }
+  return free_lists_.emplace_back(FreeList{object_size, nullptr});
+}
+}  // namespace wavemap
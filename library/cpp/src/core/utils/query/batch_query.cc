@@ -0,0 +1,184 @@
+#include "wavemap/core/utils/query/batch_query.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "wavemap/core/indexing/index_conversions.h"
+#include "wavemap/core/utils/profile/profiler_interface.h"
+#include "wavemap/core/utils/query/query_accelerator.h"
+
+namespace wavemap::query {
+namespace {
+// Number of shards to create per worker, such that idle workers can still
+// steal work if the cost per block is unbalanced
+constexpr size_t kShardsPerWorker = 4;
+
+// Splits [0, num_queries) into contiguous shards that only start at indices
+// for which is_shard_start(idx) returns true, and calls process_shard(begin,
+// end) for each of them on the thread pool (if provided)
+template <typename IsShardStartFn, typename ProcessShardFn>
+void forEachShard(size_t num_queries, IsShardStartFn is_shard_start,
+                  ProcessShardFn process_shard, ThreadPool* thread_pool) {
+  if (!thread_pool) {
+    process_shard(size_t{0}, num_queries);
+    return;
+  }
+
+  const size_t min_shard_size = std::max(
+      size_t{1}, num_queries / (kShardsPerWorker * thread_pool->num_workers()));
+  ThreadPool::TaskGroup task_group{*thread_pool};
+  for (size_t shard_begin = 0; shard_begin < num_queries;) {
+    size_t shard_end = std::min(shard_begin + min_shard_size, num_queries);
+    while (shard_end < num_queries && !is_shard_start(shard_end)) {
+      ++shard_end;
+    }
+    task_group.add_task([&process_shard, shard_begin, shard_end]() {
+      process_shard(shard_begin, shard_end);
+    });
+    shard_begin = shard_end;
+  }
+  task_group.wait();
+}
+
+// Evaluates the queries in order of their block and Morton code, such that
+// consecutive queries share as much of their traversal as possible
+template <typename MapT, typename NodeIndexFn>
+void getSortedCellValues(const MapT& map, size_t num_queries,
+                         NodeIndexFn get_node_index,
+                         std::vector<FloatingPoint>& values,
+                         ThreadPool* thread_pool) {
+  ProfilerZoneScoped;
+  values.resize(num_queries);
+
+  // Sort the queries
+  struct SortedQuery {
+    Index3D block_index;
+    MortonIndex morton_code;
+    size_t query_idx;
+  };
+  std::vector<SortedQuery> sorted_queries(num_queries);
+  for (size_t query_idx = 0; query_idx < num_queries; ++query_idx) {
+    const OctreeIndex node_index = get_node_index(query_idx);
+    sorted_queries[query_idx] = {map.indexToBlockIndex(node_index),
+                                 convert::nodeIndexToMorton(node_index),
+                                 query_idx};
+  }
+  std::sort(sorted_queries.begin(), sorted_queries.end(),
+            [](const SortedQuery& lhs, const SortedQuery& rhs) {
+              return std::make_tuple(lhs.block_index.x(), lhs.block_index.y(),
+                                     lhs.block_index.z(), lhs.morton_code) <
+                     std::make_tuple(rhs.block_index.x(), rhs.block_index.y(),
+                                     rhs.block_index.z(), rhs.morton_code);
+            });
+
+  // Evaluate them, splitting the work into shards of whole blocks
+  forEachShard(
+      num_queries,
+      [&sorted_queries](size_t sorted_idx) {
+        return sorted_queries[sorted_idx].block_index !=
+               sorted_queries[sorted_idx - 1].block_index;
+      },
+      [&map, &get_node_index, &sorted_queries, &values](size_t begin,
+                                                        size_t end) {
+        QueryAccelerator<MapT> query_accelerator{map};
+        for (size_t sorted_idx = begin; sorted_idx < end; ++sorted_idx) {
+          const size_t query_idx = sorted_queries[sorted_idx].query_idx;
+          values[query_idx] =
+              query_accelerator.getCellValue(get_node_index(query_idx));
+        }
+      },
+      thread_pool);
+}
+
+// Evaluates the queries one by one, through the generic map interface
+template <typename IndexFn>
+void getUnsortedCellValues(const MapBase& map, size_t num_queries,
+                           IndexFn get_index,
+                           std::vector<FloatingPoint>& values,
+                           ThreadPool* thread_pool) {
+  ProfilerZoneScoped;
+  values.resize(num_queries);
+  forEachShard(
+      num_queries, [](size_t /*query_idx*/) { return true; },
+      [&map, &get_index, &values](size_t begin, size_t end) {
+        for (size_t query_idx = begin; query_idx < end; ++query_idx) {
+          values[query_idx] = map.getCellValue(get_index(query_idx));
+        }
+      },
+      thread_pool);
+}
+
+// Selects the most efficient implementation for the given map type
+template <typename IndexFn>
+void getCellValuesImpl(const MapBase& map, size_t num_queries,
+                       IndexFn get_index, std::vector<FloatingPoint>& values,
+                       ThreadPool* thread_pool) {
+  const auto get_node_index = [&get_index](size_t query_idx) {
+    return OctreeIndex{0, get_index(query_idx)};
+  };
+  if (const auto* hashed_wavelet_octree =
+          dynamic_cast<const HashedWaveletOctree*>(&map);
+      hashed_wavelet_octree) {
+    getSortedCellValues(*hashed_wavelet_octree, num_queries, get_node_index,
+                        values, thread_pool);
+    return;
+  }
+  if (const auto* hashed_chunked_wavelet_octree =
+          dynamic_cast<const HashedChunkedWaveletOctree*>(&map);
+      hashed_chunked_wavelet_octree) {
+    getSortedCellValues(*hashed_chunked_wavelet_octree, num_queries,
+                        get_node_index, values, thread_pool);
+    return;
+  }
+  getUnsortedCellValues(map, num_queries, get_index, values, thread_pool);
+}
+}  // namespace
+
+void getCellValues(const MapBase& map, const std::vector<Index3D>& indices,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool) {
+  getCellValuesImpl(
+      map, indices.size(),
+      [&indices](size_t query_idx) -> const Index3D& {
+        return indices[query_idx];
+      },
+      values, thread_pool);
+}
+
+void getCellValues(const MapBase& map, const std::vector<Point3D>& positions,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool) {
+  const FloatingPoint cell_width_inv = 1.f / map.getMinCellWidth();
+  getCellValuesImpl(
+      map, positions.size(),
+      [&positions, cell_width_inv](size_t query_idx) {
+        return convert::pointToNearestIndex(positions[query_idx],
+                                            cell_width_inv);
+      },
+      values, thread_pool);
+}
+
+void getCellValues(const HashedWaveletOctree& map,
+                   const std::vector<OctreeIndex>& node_indices,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool) {
+  getSortedCellValues(
+      map, node_indices.size(),
+      [&node_indices](size_t query_idx) -> const OctreeIndex& {
+        return node_indices[query_idx];
+      },
+      values, thread_pool);
+}
+
+void getCellValues(const HashedChunkedWaveletOctree& map,
+                   const std::vector<OctreeIndex>& node_indices,
+                   std::vector<FloatingPoint>& values,
+                   ThreadPool* thread_pool) {
+  getSortedCellValues(
+      map, node_indices.size(),
+      [&node_indices](size_t query_idx) -> const OctreeIndex& {
+        return node_indices[query_idx];
+      },
+      values, thread_pool);
+}
+}  // namespace wavemap::query
@@ -1,12 +1,17 @@
 #include "wavemap/core/utils/query/classified_map.h"
 
+#include <cmath>
 #include <limits>
 #include <stack>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <wavemap/core/utils/profile/profiler_interface.h>
 
+#include "wavemap/core/indexing/index_hashes.h"
+#include "wavemap/core/utils/iterate/grid_iterator.h"
+
 namespace wavemap {
 ClassifiedMap::ClassifiedMap(FloatingPoint min_cell_width,
                              IndexElement tree_height,
@@ -31,6 +36,22 @@ ClassifiedMap::ClassifiedMap(const HashedWaveletOctree& occupancy_map,
   update(occupancy_map, esdf_map, robot_radius);
 }
 
+ClassifiedMap::ClassifiedMap(const HashedChunkedWaveletOctree& occupancy_map,
+                             const OccupancyClassifier& classifier)
+    : ClassifiedMap(occupancy_map.getMinCellWidth(),
+                    occupancy_map.getTreeHeight(), classifier) {
+  update(occupancy_map);
+}
+
+ClassifiedMap::ClassifiedMap(const HashedChunkedWaveletOctree& occupancy_map,
+                             const OccupancyClassifier& classifier,
+                             const HashedBlocks& esdf_map,
+                             FloatingPoint robot_radius)
+    : ClassifiedMap(occupancy_map.getMinCellWidth(),
+                    occupancy_map.getTreeHeight(), classifier) {
+  update(occupancy_map, esdf_map, robot_radius);
+}
+
 Index3D ClassifiedMap::getMinIndex() const {
   return cells_per_block_side_ * getMinBlockIndex();
 }
@@ -42,58 +63,208 @@ Index3D ClassifiedMap::getMaxIndex() const {
   return cells_per_block_side_ * (getMaxBlockIndex().array() + 1) - 1;
 }
 
-void ClassifiedMap::update(const HashedWaveletOctree& occupancy_map) {
-  ProfilerZoneScoped;
-  // Reset the query cache
-  query_cache_.reset();
+void ClassifiedMap::update(const HashedWaveletOctree& occupancy_map,
+                           ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, /*only_changed_blocks=*/false, thread_pool);
+}
 
-  // Erase blocks that no longer exist
-  block_map_.eraseBlockIf(
-      [&occupancy_map](const Index3D& block_index, const auto& /*block*/) {
-        return !occupancy_map.hasBlock(block_index);
-      });
+void ClassifiedMap::update(const HashedWaveletOctree& occupancy_map,
+                           const HashedBlocks& esdf_map,
+                           FloatingPoint robot_radius,
+                           ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, esdf_map, robot_radius,
+             /*only_changed_blocks=*/false, thread_pool);
+}
 
-  // Update all existing blocks
-  occupancy_map.forEachBlock(
-      [this](const Index3D& block_index, const auto& occupancy_block) {
-        auto& classified_block = block_map_.getOrAllocateBlock(block_index);
-        recursiveClassifier(occupancy_block.getRootNode(),
-                            occupancy_block.getRootScale(),
-                            classified_block.getRootNode());
-      });
+void ClassifiedMap::update(const HashedChunkedWaveletOctree& occupancy_map,
+                           ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, /*only_changed_blocks=*/false, thread_pool);
 }
 
-void ClassifiedMap::update(const HashedWaveletOctree& occupancy_map,
+void ClassifiedMap::update(const HashedChunkedWaveletOctree& occupancy_map,
                            const HashedBlocks& esdf_map,
-                           FloatingPoint robot_radius) {
+                           FloatingPoint robot_radius,
+                           ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, esdf_map, robot_radius,
+             /*only_changed_blocks=*/false, thread_pool);
+}
+
+void ClassifiedMap::updateChangedBlocks(
+    const HashedWaveletOctree& occupancy_map, ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, /*only_changed_blocks=*/true, thread_pool);
+}
+
+void ClassifiedMap::updateChangedBlocks(
+    const HashedChunkedWaveletOctree& occupancy_map, ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, /*only_changed_blocks=*/true, thread_pool);
+}
+
+void ClassifiedMap::updateChangedBlocks(
+    const HashedWaveletOctree& occupancy_map, const HashedBlocks& esdf_map,
+    FloatingPoint robot_radius, ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, esdf_map, robot_radius,
+             /*only_changed_blocks=*/true, thread_pool);
+}
+
+void ClassifiedMap::updateChangedBlocks(
+    const HashedChunkedWaveletOctree& occupancy_map,
+    const HashedBlocks& esdf_map, FloatingPoint robot_radius,
+    ThreadPool* thread_pool) {
+  updateImpl(occupancy_map, esdf_map, robot_radius,
+             /*only_changed_blocks=*/true, thread_pool);
+}
+
+template <typename HashedMapT>
+void ClassifiedMap::updateImpl(const HashedMapT& occupancy_map,
+                               bool only_changed_blocks,
+                               ThreadPool* thread_pool) {
   ProfilerZoneScoped;
-  // Reset the query cache
-  query_cache_.reset();
+  updateBlocks(occupancy_map, only_changed_blocks, 0, thread_pool,
+               [this](const Index3D& /*block_index*/,
+                      const typename HashedMapT::Block& occupancy_block,
+                      Block& classified_block) {
+                 recursiveClassifier(occupancy_block.getRootNode(),
+                                     occupancy_block.getRootScale(),
+                                     classified_block.getRootNode());
+               });
+}
 
+template <typename HashedMapT>
+void ClassifiedMap::updateImpl(const HashedMapT& occupancy_map,
+                               const HashedBlocks& esdf_map,
+                               FloatingPoint robot_radius,
+                               bool only_changed_blocks,
+                               ThreadPool* thread_pool) {
+  ProfilerZoneScoped;
   // Check that the ESDF is valid for our query and compatible with the occ map
   CHECK_GE(esdf_map.getDefaultValue(), robot_radius);
   CHECK_GE(esdf_map.getMaxLogOdds(), robot_radius);
   CHECK_NEAR(esdf_map.getMinCellWidth(), occupancy_map.getMinCellWidth(),
              kEpsilon);
 
+  // Whether a cell is closer than robot_radius to an obstacle can only change
+  // if the occupancy changed within robot_radius of it. When only updating the
+  // changed blocks, the blocks around them therefore also need to be
+  // reclassified.
+  const FloatingPoint block_width =
+      occupancy_map.getMinCellWidth() * static_cast<FloatingPoint>(
+                                            occupancy_map.getBlockSize().x());
+  const auto changed_block_dilation =
+      static_cast<IndexElement>(std::ceil(robot_radius / block_width));
+
+  updateBlocks(occupancy_map, only_changed_blocks, changed_block_dilation,
+               thread_pool,
+               [this, &esdf_map, block_height = occupancy_map.getTreeHeight(),
+                robot_radius](const Index3D& block_index,
+                              const typename HashedMapT::Block& occupancy_block,
+                              Block& classified_block) {
+                 const OctreeIndex block_node_index{block_height, block_index};
+                 QueryAccelerator esdf_accelerator{
+                     dynamic_cast<const HashedBlocks::DenseBlockHash&>(
+                         esdf_map)};
+                 recursiveClassifier(
+                     block_node_index, &occupancy_block.getRootNode(),
+                     occupancy_block.getRootScale(), esdf_accelerator,
+                     robot_radius, classified_block.getRootNode());
+               });
+}
+
+template <typename HashedMapT, typename ClassifyBlockFn>
+void ClassifiedMap::updateBlocks(const HashedMapT& occupancy_map,
+                                 bool only_changed_blocks,
+                                 IndexElement changed_block_dilation,
+                                 ThreadPool* thread_pool,
+                                 ClassifyBlockFn classify_block_fn) {
+  // Reset the query cache
+  query_cache_.reset();
+
+  // NOTE: Blocks that get updated while this method runs are reclassified
+  //       again on the next update, since their stamps will be newer.
+  const Timestamp update_stamp = Time::now();
+
   // Erase blocks that no longer exist
-  block_map_.eraseBlockIf(
-      [&occupancy_map](const Index3D& block_index, const auto& /*block*/) {
-        return !occupancy_map.hasBlock(block_index);
-      });
+  std::vector<Index3D> erased_block_indices;
+  block_map_.eraseBlockIf([&occupancy_map, &erased_block_indices](
+                              const Index3D& block_index,
+                              const auto& /*block*/) {
+    if (occupancy_map.hasBlock(block_index)) {
+      return false;
+    }
+    erased_block_indices.emplace_back(block_index);
+    return true;
+  });
+
+  // Find the blocks that need to be reclassified
+  std::vector<Index3D> block_indices;
+  if (!only_changed_blocks || !last_update_stamp_) {
+    block_indices.reserve(occupancy_map.getHashMap().size());
+    occupancy_map.forEachBlock(
+        [&block_indices](const Index3D& block_index, const auto& /*block*/) {
+          block_indices.emplace_back(block_index);
+        });
+  } else {
+    std::unordered_set<Index3D, Index3DHash> changed_block_indices;
+    const Index3D dilation = Index3D::Constant(changed_block_dilation);
+    auto add_dilated_block = [&occupancy_map, &changed_block_indices,
+                              &dilation](const Index3D& block_index) {
+      for (const Index3D& neighbor_index :
+           Grid<3>(block_index - dilation, block_index + dilation)) {
+        if (occupancy_map.hasBlock(neighbor_index)) {
+          changed_block_indices.emplace(neighbor_index);
+        }
+      }
+    };
+    occupancy_map.forEachBlock([this, &add_dilated_block](
+                                   const Index3D& block_index,
+                                   const auto& occupancy_block) {
+      if (occupancy_block.getLastUpdatedStamp() < *last_update_stamp_ &&
+          block_map_.hasBlock(block_index)) {
+        return;
+      }
+      add_dilated_block(block_index);
+    });
+    // NOTE: Erased blocks can also change the classification of their
+    //       neighbors, if it depends on the distance to obstacles.
+    for (const Index3D& block_index : erased_block_indices) {
+      add_dilated_block(block_index);
+    }
+    block_indices.assign(changed_block_indices.begin(),
+                         changed_block_indices.end());
+  }
 
-  // Update all existing blocks
-  QueryAccelerator esdf_accelerator{
-      dynamic_cast<const HashedBlocks::DenseBlockHash&>(esdf_map)};
-  occupancy_map.forEachBlock(
-      [this, &esdf_accelerator, block_height = occupancy_map.getTreeHeight(),
-       robot_radius](const Index3D& block_index, const auto& occupancy_block) {
-        const OctreeIndex block_node_index{block_height, block_index};
-        auto& classified_block = block_map_.getOrAllocateBlock(block_index);
-        recursiveClassifier(block_node_index, &occupancy_block.getRootNode(),
-                            occupancy_block.getRootScale(), esdf_accelerator,
-                            robot_radius, classified_block.getRootNode());
+  // Allocate the classified blocks up front, since the block map itself is not
+  // thread-safe
+  struct BlockPair {
+    Index3D block_index;
+    const typename HashedMapT::Block* occupancy_block;
+    Block* classified_block;
+  };
+  std::vector<BlockPair> blocks;
+  blocks.reserve(block_indices.size());
+  for (const Index3D& block_index : block_indices) {
+    blocks.emplace_back(BlockPair{block_index,
+                                  occupancy_map.getBlock(block_index),
+                                  &block_map_.getOrAllocateBlock(block_index)});
+  }
+
+  // Classify the blocks, in parallel if possible
+  if (!thread_pool || blocks.size() <= 1) {
+    for (const BlockPair& block : blocks) {
+      classify_block_fn(block.block_index, *block.occupancy_block,
+                        *block.classified_block);
+    }
+  } else {
+    ThreadPool::TaskGroup task_group{*thread_pool};
+    for (const BlockPair& block : blocks) {
+      task_group.add_task([&classify_block_fn, &block]() {
+        classify_block_fn(block.block_index, *block.occupancy_block,
+                          *block.classified_block);
       });
+    }
+    task_group.wait();
+  }
+
+  last_update_stamp_ = update_stamp;
 }
 
 std::pair<std::optional<Occupancy::Mask>, ClassifiedMap::HeightType>
@@ -333,16 +504,17 @@ void ClassifiedMap::QueryCache::reset() {
   node_stack = std::array<const Node*, morton::kMaxTreeHeight<3>>{};
 }
 
+template <typename OccupancyNodeT>
 void ClassifiedMap::recursiveClassifier(  // NOLINT
-    const HashedWaveletOctreeBlock::NodeType& occupancy_node,
-    FloatingPoint average_occupancy, ClassifiedMap::Node& classified_node) {
+    const OccupancyNodeT& occupancy_node, FloatingPoint average_occupancy,
+    ClassifiedMap::Node& classified_node) {
   const auto child_occupancies =
       HaarTransform::backward({average_occupancy, occupancy_node.data()});
   for (int child_idx = 0; child_idx < OctreeIndex::kNumChildren; ++child_idx) {
     const FloatingPoint child_occupancy = child_occupancies[child_idx];
     // If the node has children, recurse
     if (occupancy_node.hasChild(child_idx)) {
-      const auto* occupancy_child_node = occupancy_node.getChild(child_idx);
+      const auto occupancy_child_node = occupancy_node.getChild(child_idx);
       auto& classified_child_node =
           classified_node.getOrAllocateChild(child_idx);
       recursiveClassifier(*occupancy_child_node, child_occupancy,
@@ -360,6 +532,9 @@ void ClassifiedMap::recursiveClassifier(  // NOLINT
         classified_node.eraseChild(child_idx);
       }
     } else {  // Otherwise, the node is a leaf
+      // NOTE: When reclassifying a block, the occupancy node's child might
+      //       have been pruned since the previous classification.
+      classified_node.eraseChild(child_idx);
       const bool is_free = classifier_.is(child_occupancy, Occupancy::kFree);
       const bool is_occupied =
           classifier_.is(child_occupancy, Occupancy::kOccupied);
@@ -372,9 +547,9 @@ void ClassifiedMap::recursiveClassifier(  // NOLINT
   }
 }
 
+template <typename OccupancyNodePtrT>
 void ClassifiedMap::recursiveClassifier(  // NOLINT
-    const OctreeIndex& node_index,
-    const HashedWaveletOctreeBlock::NodeType* occupancy_node,
+    const OctreeIndex& node_index, OccupancyNodePtrT occupancy_node,
     FloatingPoint occupancy_average,
     QueryAccelerator<HashedBlocks::DenseBlockHash>& esdf_map,
     FloatingPoint robot_radius, ClassifiedMap::Node& classified_node) {
@@ -389,8 +564,9 @@ void ClassifiedMap::recursiveClassifier(  // NOLINT
   for (int child_idx = 0; child_idx < OctreeIndex::kNumChildren; ++child_idx) {
     // Get the child's index, occupancy node pointer and occupancy
     const OctreeIndex child_index = node_index.computeChildIndex(child_idx);
-    const auto* child_occupancy_node =
-        occupancy_node ? occupancy_node->getChild(child_idx) : nullptr;
+    const OccupancyNodePtrT child_occupancy_node =
+        occupancy_node ? occupancy_node->getChild(child_idx)
+                       : OccupancyNodePtrT{};
     const FloatingPoint child_occupancy =
         occupancy_node ? child_occupancies[child_idx] : occupancy_average;
 
@@ -400,6 +576,7 @@ void ClassifiedMap::recursiveClassifier(  // NOLINT
     const bool is_free = classifier_.is(child_occupancy, Occupancy::kFree);
     const bool is_non_free_leaf = !is_free && !child_occupancy_node;
     if (esdf_resolution_reached || is_non_free_leaf) {
+      classified_node.eraseChild(child_idx);
       // If the child's occupancy is free, check if it's also free in the ESDF
       if (is_free) {
         DCHECK_EQ(child_index.height, 0);
@@ -85,4 +85,100 @@ FloatingPoint QueryAccelerator<HashedWaveletOctree>::getCellValue(
 
   return value_stack_[height_];
 }
+
+void QueryAccelerator<HashedChunkedWaveletOctree>::reset() {
+  block_ = nullptr;
+  chunk_stack_ = std::array<const ChunkType*, kMaxChunkStackDepth>{};
+  value_stack_ = std::array<FloatingPoint, morton::kMaxTreeHeight<3>>{};
+
+  block_index_ = BlockIndex::Constant(std::numeric_limits<IndexElement>::max());
+  morton_code_ = std::numeric_limits<MortonIndex>::max();
+  height_ = tree_height_;
+  reached_leaf_ = false;
+}
+
+FloatingPoint QueryAccelerator<HashedChunkedWaveletOctree>::getCellValue(
+    const OctreeIndex& index) {
+  // Remember previous query indices and compute new ones
+  const BlockIndex previous_block_index = block_index_;
+  const MortonIndex previous_morton_code = morton_code_;
+  const IndexElement previous_height = height_;
+  block_index_ = map_.indexToBlockIndex(index);
+  morton_code_ = convert::nodeIndexToMorton(index);
+
+  // Check whether we're in the same block as last time
+  if (block_index_ == previous_block_index) {
+    // If the block is the same, but it doesn't exist, return 'unknown'
+    if (!block_) {
+      return 0.f;
+    }
+    // Compute the last ancestor the current and previous query had in common
+    const IndexElement last_common_ancestor =
+        OctreeIndex::computeLastCommonAncestorHeight(
+            morton_code_, index.height, previous_morton_code, previous_height);
+    DCHECK_LE(last_common_ancestor, tree_height_);
+    // If the query lies within a node that has no higher resolution details,
+    // its value was already decompressed in the last query
+    if (reached_leaf_ && last_common_ancestor == previous_height) {
+      height_ = previous_height;
+      return value_stack_[height_];
+    }
+    height_ = last_common_ancestor;
+  } else {
+    // Test if the queried block exists
+    block_ = map_.getBlock(block_index_);
+    height_ = tree_height_;
+    if (!block_) {
+      // Otherwise remember that it doesn't exist and return 'unknown'
+      reached_leaf_ = false;
+      return 0.f;
+    }
+    // If yes, load it
+    chunk_stack_[0] = &block_->getRootChunk();
+    value_stack_[tree_height_] = block_->getRootScale();
+  }
+
+  // Walk down the tree from height_ to index.height
+  // NOTE: The values down to height_ and the chunks containing the ancestors
+  //       above height_ are shared with the previous query and can be reused.
+  reached_leaf_ = false;
+  while (index.height < height_) {
+    // Get the chunk containing the current node, loading it if needed
+    const int chunk_depth = (tree_height_ - height_) / kChunkHeight;
+    const IndexElement chunk_top_height =
+        tree_height_ - chunk_depth * kChunkHeight;
+    if (height_ == chunk_top_height && 0 < chunk_depth) {
+      const ChunkType* parent_chunk = chunk_stack_[chunk_depth - 1];
+      const LinearIndex linear_child_index =
+          OctreeIndex::computeLevelTraversalDistance(
+              morton_code_, chunk_top_height + kChunkHeight, chunk_top_height);
+      // If there are no remaining higher resolution details, stop
+      if (!parent_chunk->hasChild(linear_child_index)) {
+        reached_leaf_ = true;
+        break;
+      }
+      chunk_stack_[chunk_depth] = parent_chunk->getChild(linear_child_index);
+    }
+    const ChunkType* current_chunk = chunk_stack_[chunk_depth];
+
+    // Perform one decompression stage
+    const LinearIndex relative_node_index =
+        OctreeIndex::computeTreeTraversalDistance(morton_code_,
+                                                  chunk_top_height, height_);
+    const NdtreeIndexRelativeChild relative_child_index =
+        OctreeIndex::computeRelativeChildIndex(morton_code_, height_);
+    value_stack_[height_ - 1] = BlockType::Transform::backwardSingleChild(
+        {value_stack_[height_], current_chunk->nodeData(relative_node_index)},
+        relative_child_index);
+    --height_;
+
+    // If there are no remaining higher resolution details, stop
+    if (!current_chunk->nodeHasAtLeastOneChild(relative_node_index)) {
+      reached_leaf_ = true;
+      break;
+    }
+  }
+
+  return value_stack_[height_];
+}
 }  // namespace wavemap
@@ -8,6 +8,17 @@
 namespace wavemap {
 HashedBlocks FullEuclideanSDFGenerator::generate(
     const HashedWaveletOctree& occupancy_map) const {
+  return generateImpl(occupancy_map);
+}
+
+HashedBlocks FullEuclideanSDFGenerator::generate(
+    const HashedChunkedWaveletOctree& occupancy_map) const {
+  return generateImpl(occupancy_map);
+}
+
+template <typename HashedMapT>
+HashedBlocks FullEuclideanSDFGenerator::generateImpl(
+    const HashedMapT& occupancy_map) const {
   ProfilerZoneScoped;
   // Initialize the SDF data structure
   const FloatingPoint min_cell_width = occupancy_map.getMinCellWidth();
@@ -36,7 +47,8 @@ HashedBlocks FullEuclideanSDFGenerator::generate(
   return sdf;
 }
 
-void FullEuclideanSDFGenerator::seed(const HashedWaveletOctree& occupancy_map,
+template <typename HashedMapT>
+void FullEuclideanSDFGenerator::seed(const HashedMapT& occupancy_map,
                                      VectorDistanceField& sdf,
                                      BucketQueue<Index3D>& open_queue) const {
   ProfilerZoneScoped;
@@ -102,8 +114,9 @@ void FullEuclideanSDFGenerator::seed(const HashedWaveletOctree& occupancy_map,
   });
 }
 
+template <typename HashedMapT>
 void FullEuclideanSDFGenerator::propagate(
-    const HashedWaveletOctree& occupancy_map, VectorDistanceField& sdf,
+    const HashedMapT& occupancy_map, VectorDistanceField& sdf,
     BucketQueue<Index3D>& open_queue) const {
   ProfilerZoneScoped;
   // Create an occupancy query accelerator
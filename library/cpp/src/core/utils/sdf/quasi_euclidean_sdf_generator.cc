@@ -1,6 +1,8 @@
 #include "wavemap/core/utils/sdf/quasi_euclidean_sdf_generator.h"
 
 #include <algorithm>
+#include <unordered_set>
+#include <utility>
 
 #include <wavemap/core/utils/profile/profiler_interface.h>
 
@@ -9,28 +11,210 @@
 
 namespace wavemap {
 HashedBlocks QuasiEuclideanSDFGenerator::generate(
-    const HashedWaveletOctree& occupancy_map) const {
+    const HashedWaveletOctree& occupancy_map, ThreadPool* thread_pool) const {
+  return generateImpl(occupancy_map, thread_pool);
+}
+
+HashedBlocks QuasiEuclideanSDFGenerator::generate(
+    const HashedChunkedWaveletOctree& occupancy_map,
+    ThreadPool* thread_pool) const {
+  return generateImpl(occupancy_map, thread_pool);
+}
+
+void QuasiEuclideanSDFGenerator::update(
+    const HashedWaveletOctree& occupancy_map,
+    const std::vector<Index3D>& changed_block_indices,
+    HashedBlocks& sdf) const {
+  updateImpl(occupancy_map, changed_block_indices, sdf);
+}
+
+void QuasiEuclideanSDFGenerator::update(
+    const HashedChunkedWaveletOctree& occupancy_map,
+    const std::vector<Index3D>& changed_block_indices,
+    HashedBlocks& sdf) const {
+  updateImpl(occupancy_map, changed_block_indices, sdf);
+}
+
+template <typename HashedMapT>
+HashedBlocks QuasiEuclideanSDFGenerator::generateImpl(
+    const HashedMapT& occupancy_map, ThreadPool* thread_pool) const {
   ProfilerZoneScoped;
   // Initialize the SDF data structure
   const FloatingPoint min_cell_width = occupancy_map.getMinCellWidth();
   const MapBaseConfig config{min_cell_width, 0.f, max_distance_};
   HashedBlocks sdf(config, max_distance_);
 
+  // Seed and propagate the SDF
+  if (thread_pool) {
+    BlockUpdatesMap block_updates;
+    seedInParallel(occupancy_map, sdf, *thread_pool, block_updates);
+    propagateInParallel(occupancy_map, sdf, *thread_pool, block_updates);
+  } else {
+    regenerate(occupancy_map, sdf);
+  }
+
+  return sdf;
+}
+
+template <typename HashedMapT>
+void QuasiEuclideanSDFGenerator::updateImpl(
+    const HashedMapT& occupancy_map,
+    const std::vector<Index3D>& changed_block_indices,
+    HashedBlocks& sdf) const {
+  ProfilerZoneScoped;
+  const FloatingPoint min_cell_width = occupancy_map.getMinCellWidth();
+  CHECK_NEAR(sdf.getMinCellWidth(), min_cell_width, kEpsilon);
+  CHECK_EQ(sdf.getDefaultValue(), max_distance_);
+
+  // Find the SDF blocks whose values can be affected by the changes, which
+  // are all blocks within max_distance (plus one cell, for the seeds' padding)
+  const IndexElement tree_height = occupancy_map.getTreeHeight();
+  const IndexElement cells_per_block = occupancy_map.getBlockSize().x();
+  const Index3D dilation = Index3D::Constant(
+      static_cast<IndexElement>(std::ceil(max_distance_ / min_cell_width)) + 1);
+  const size_t max_region_size = sdf.getHashMap().size();
+  Region region;
+  for (const Index3D& changed_block_index : changed_block_indices) {
+    const Index3D min_cell_index = cells_per_block * changed_block_index;
+    const Index3D max_cell_index =
+        min_cell_index + Index3D::Constant(cells_per_block - 1);
+    const Index3D min_sdf_block_index =
+        HashedBlocks::indexToBlockIndex(min_cell_index - dilation);
+    const Index3D max_sdf_block_index =
+        HashedBlocks::indexToBlockIndex(max_cell_index + dilation);
+    // If the region gets larger than the SDF itself, regenerating the SDF
+    // from scratch is cheaper
+    const Index3D range_size =
+        max_sdf_block_index - min_sdf_block_index + Index3D::Ones();
+    if (max_region_size <= range_size.cast<size_t>().prod()) {
+      regenerate(occupancy_map, sdf);
+      return;
+    }
+    for (const Index3D& sdf_block_index :
+         Grid<3>(min_sdf_block_index, max_sdf_block_index)) {
+      region.sdf_block_indices.emplace(sdf_block_index);
+    }
+    if (max_region_size <= region.sdf_block_indices.size()) {
+      regenerate(occupancy_map, sdf);
+      return;
+    }
+  }
+
+  // Reset the SDF inside the region
+  for (const Index3D& sdf_block_index : region.sdf_block_indices) {
+    if (auto* sdf_block = sdf.getBlock(sdf_block_index); sdf_block) {
+      sdf_block->data().fill(sdf.getDefaultValue());
+    }
+  }
+
   // Initialize the bucketed priority queue
   const int num_bins =
       static_cast<int>(std::ceil(max_distance_ / min_cell_width));
   BucketQueue<Index3D> open{num_bins, max_distance_};
 
+  // Seed the region from the obstacles that are in or directly next to it
+  BlockIndexSet seed_block_indices;
+  for (const Index3D& sdf_block_index : region.sdf_block_indices) {
+    const Index3D min_cell_index =
+        HashedBlocks::kCellsPerSide * sdf_block_index - Index3D::Ones();
+    const Index3D max_cell_index =
+        min_cell_index + Index3D::Constant(HashedBlocks::kCellsPerSide + 1);
+    for (const Index3D& block_index :
+         Grid<3>(convert::indexToBlockIndex(min_cell_index, tree_height),
+                 convert::indexToBlockIndex(max_cell_index, tree_height))) {
+      seed_block_indices.emplace(block_index);
+    }
+  }
+  seed(occupancy_map, sdf, open, &region, &seed_block_indices);
+
+  // Also propagate the distances of the cells that surround the region, which
+  // are not affected by the changes, into it
+  for (const Index3D& sdf_block_index : region.sdf_block_indices) {
+    const Index3D min_cell_index =
+        HashedBlocks::kCellsPerSide * sdf_block_index;
+    const Index3D max_cell_index =
+        min_cell_index + Index3D::Constant(HashedBlocks::kCellsPerSide - 1);
+    for (const Index3D& index : Grid<3>(min_cell_index - Index3D::Ones(),
+                                        max_cell_index + Index3D::Ones())) {
+      // Only consider cells just outside the region
+      const bool is_in_block =
+          (min_cell_index.array() <= index.array()).all() &&
+          (index.array() <= max_cell_index.array()).all();
+      if (is_in_block || region.contains(index)) {
+        continue;
+      }
+      const FloatingPoint sdf_value = sdf.getCellValue(index);
+      if (std::abs(sdf_value) != sdf.getDefaultValue()) {
+        open.push(std::abs(sdf_value), index);
+      }
+    }
+  }
+
+  // Propagate the SDF inside the region
+  propagate(occupancy_map, sdf, open, &region);
+}
+
+template <typename HashedMapT>
+void QuasiEuclideanSDFGenerator::regenerate(const HashedMapT& occupancy_map,
+                                            HashedBlocks& sdf) const {
+  // Initialize the bucketed priority queue
+  const int num_bins = static_cast<int>(
+      std::ceil(max_distance_ / occupancy_map.getMinCellWidth()));
+  BucketQueue<Index3D> open{num_bins, max_distance_};
+
   // Seed and propagate the SDF
+  sdf.clear();
   seed(occupancy_map, sdf, open);
   propagate(occupancy_map, sdf, open);
+}
 
-  return sdf;
+bool QuasiEuclideanSDFGenerator::Region::contains(const Index3D& index) const {
+  return sdf_block_indices.count(HashedBlocks::indexToBlockIndex(index));
+}
+
+template <typename HashedMapT, typename SeedVisitor>
+void QuasiEuclideanSDFGenerator::forEachSeed(
+    const OctreeIndex& obstacle_index,
+    QueryAccelerator<HashedMapT>& occupancy_query_accelerator,
+    FloatingPoint min_cell_width, SeedVisitor visitor) const {
+  // Span a grid at the highest resolution (=SDF resolution) that pads the
+  // multi-resolution obstacle cell with 1 voxel in all directions
+  const Index3D min_corner = convert::nodeIndexToMinCornerIndex(obstacle_index);
+  const Index3D max_corner = convert::nodeIndexToMaxCornerIndex(obstacle_index);
+  const Grid<3> grid{
+      Grid<3>(min_corner - Index3D::Ones(), max_corner + Index3D::Ones())};
+
+  // Iterate over the grid
+  for (const Index3D& index : grid) {
+    // Skip cells that are inside the occupied node (obstacle)
+    // NOTE: Occupied cells (negative distances) are handled in the
+    //       propagation stage.
+    const Index3D nearest_inner_index =
+        index.cwiseMax(min_corner).cwiseMin(max_corner);
+    const bool voxel_is_inside = (index == nearest_inner_index);
+    if (voxel_is_inside) {
+      continue;
+    }
+
+    // Skip the cell if it is not free
+    const FloatingPoint occupancy =
+        occupancy_query_accelerator.getCellValue(index);
+    if (!classifier_.is(occupancy, Occupancy::kFree)) {
+      continue;
+    }
+
+    const FloatingPoint distance_to_surface =
+        0.5f * min_cell_width *
+        (index - nearest_inner_index).cast<FloatingPoint>().norm();
+    visitor(index, distance_to_surface);
+  }
 }
 
-void QuasiEuclideanSDFGenerator::seed(const HashedWaveletOctree& occupancy_map,
-                                      HashedBlocks& sdf,
-                                      BucketQueue<Index3D>& open_queue) const {
+template <typename HashedMapT>
+void QuasiEuclideanSDFGenerator::seed(
+    const HashedMapT& occupancy_map, HashedBlocks& sdf,
+    BucketQueue<Index3D>& open_queue, const Region* region,
+    const BlockIndexSet* block_indices) const {
   ProfilerZoneScoped;
   // Create an occupancy query accelerator
   QueryAccelerator occupancy_query_accelerator{occupancy_map};
@@ -38,63 +222,54 @@ void QuasiEuclideanSDFGenerator::seed(const HashedWaveletOctree& occupancy_map,
   // For all free cells that border an obstacle:
   // - initialize their SDF value, and
   // - add them to the open queue
-  occupancy_map.forEachLeaf([this, &occupancy_query_accelerator, &sdf,
-                             &open_queue,
-                             min_cell_width = occupancy_map.getMinCellWidth()](
-                                const OctreeIndex& node_index,
-                                FloatingPoint node_occupancy) {
+  auto seed_from_leaf = [this, &occupancy_query_accelerator, &sdf, &open_queue,
+                         region,
+                         min_cell_width = occupancy_map.getMinCellWidth()](
+                            const OctreeIndex& node_index,
+                            FloatingPoint node_occupancy) {
     // Only process obstacles
     if (!classifier_.is(node_occupancy, Occupancy::kOccupied)) {
       return;
     }
 
-    // Span a grid at the highest resolution (=SDF resolution) that pads the
-    // multi-resolution obstacle cell with 1 voxel in all directions
-    const Index3D min_corner = convert::nodeIndexToMinCornerIndex(node_index);
-    const Index3D max_corner = convert::nodeIndexToMaxCornerIndex(node_index);
-    const Grid<3> grid{
-        Grid<3>(min_corner - Index3D::Ones(), max_corner + Index3D::Ones())};
-
-    // Iterate over the grid
-    for (const Index3D& index : grid) {
-      // Skip cells that are inside the occupied node (obstacle)
-      // NOTE: Occupied cells (negative distances) are handled in the
-      //       propagation stage.
-      const Index3D nearest_inner_index =
-          index.cwiseMax(min_corner).cwiseMin(max_corner);
-      const bool voxel_is_inside = (index == nearest_inner_index);
-      if (voxel_is_inside) {
-        continue;
-      }
+    forEachSeed(node_index, occupancy_query_accelerator, min_cell_width,
+                [&sdf, &open_queue, region](
+                    const Index3D& index, FloatingPoint distance_to_surface) {
+                  // Skip the cell if it is outside the region being updated
+                  if (region && !region->contains(index)) {
+                    return;
+                  }
 
-      // Skip the cell if it is not free
-      const FloatingPoint occupancy =
-          occupancy_query_accelerator.getCellValue(index);
-      if (!classifier_.is(occupancy, Occupancy::kFree)) {
-        continue;
-      }
+                  // Get the voxel's SDF value
+                  FloatingPoint& sdf_value = sdf.getOrAllocateValue(index);
+                  const bool sdf_uninitialized =
+                      sdf.getDefaultValue() == sdf_value;
 
-      // Get the voxel's SDF value
-      FloatingPoint& sdf_value = sdf.getOrAllocateValue(index);
-      const bool sdf_uninitialized = sdf.getDefaultValue() == sdf_value;
+                  // Update the voxel's SDF value
+                  sdf_value = std::min(sdf_value, distance_to_surface);
 
-      // Update the voxel's SDF value
-      const FloatingPoint distance_to_surface =
-          0.5f * min_cell_width *
-          (index - nearest_inner_index).cast<FloatingPoint>().norm();
-      sdf_value = std::min(sdf_value, distance_to_surface);
+                  // If the voxel is not yet in the open queue, add it
+                  if (sdf_uninitialized) {
+                    open_queue.push(distance_to_surface, index);
+                  }
+                });
+  };
 
-      // If the voxel is not yet in the open queue, add it
-      if (sdf_uninitialized) {
-        open_queue.push(distance_to_surface, index);
-      }
+  if (!block_indices) {
+    occupancy_map.forEachLeaf(seed_from_leaf);
+    return;
+  }
+  for (const Index3D& block_index : *block_indices) {
+    if (const auto* block = occupancy_map.getBlock(block_index); block) {
+      block->forEachLeaf(block_index, seed_from_leaf);
     }
-  });
+  }
 }
 
+template <typename HashedMapT>
 void QuasiEuclideanSDFGenerator::propagate(
-    const HashedWaveletOctree& occupancy_map, HashedBlocks& sdf,
-    BucketQueue<Index3D>& open_queue) const {
+    const HashedMapT& occupancy_map, HashedBlocks& sdf,
+    BucketQueue<Index3D>& open_queue, const Region* region) const {
   ProfilerZoneScoped;
   // Create an occupancy query accelerator
   QueryAccelerator occupancy_query_accelerator{occupancy_map};
@@ -128,6 +303,9 @@ void QuasiEuclideanSDFGenerator::propagate(
       // Get the neighbor's SDF value
       const Index3D neighbor_index =
           index + kNeighborIndexOffsets[neighbor_idx];
+      if (region && !region->contains(neighbor_index)) {
+        continue;
+      }
       FloatingPoint& neighbor_sdf = sdf.getOrAllocateValue(neighbor_index);
 
       // If the neighbor is uninitialized, get its sign from the occupancy map
@@ -175,4 +353,226 @@ void QuasiEuclideanSDFGenerator::propagate(
     }
   }
 }
+
+template <typename HashedMapT>
+void QuasiEuclideanSDFGenerator::seedInParallel(
+    const HashedMapT& occupancy_map, HashedBlocks& sdf,
+    ThreadPool& thread_pool, BlockUpdatesMap& block_updates) const {
+  ProfilerZoneScoped;
+  // Find the seeds of each occupancy block in parallel
+  using Seed = std::pair<Index3D, FloatingPoint>;
+  std::vector<std::pair<Index3D, std::vector<Seed>>> block_seeds;
+  block_seeds.reserve(occupancy_map.getHashMap().size());
+  occupancy_map.forEachBlock(
+      [&block_seeds](const Index3D& block_index, const auto& /*block*/) {
+        block_seeds.emplace_back(block_index, std::vector<Seed>{});
+      });
+  ThreadPool::TaskGroup task_group{thread_pool};
+  for (auto& [block_index, seeds] : block_seeds) {
+    task_group.add_task([this, &occupancy_map, &block_index = block_index,
+                         &seeds = seeds]() {
+      QueryAccelerator occupancy_query_accelerator{occupancy_map};
+      const auto* block = occupancy_map.getBlock(block_index);
+      block->forEachLeaf(
+          block_index,
+          [this, &occupancy_query_accelerator, &seeds,
+           min_cell_width = occupancy_map.getMinCellWidth()](
+              const OctreeIndex& node_index, FloatingPoint node_occupancy) {
+            if (classifier_.is(node_occupancy, Occupancy::kOccupied)) {
+              forEachSeed(node_index, occupancy_query_accelerator,
+                          min_cell_width,
+                          [&seeds](const Index3D& index,
+                                   FloatingPoint distance_to_surface) {
+                            seeds.emplace_back(index, distance_to_surface);
+                          });
+            }
+          });
+    });
+  }
+  task_group.wait();
+
+  // Write them into the SDF, and mark the seeded cells for propagation
+  for (const auto& [block_index, seeds] : block_seeds) {
+    for (const auto& [index, distance_to_surface] : seeds) {
+      FloatingPoint& sdf_value = sdf.getOrAllocateValue(index);
+      if (sdf_value == sdf.getDefaultValue()) {
+        const Index3D sdf_block_index = HashedBlocks::indexToBlockIndex(index);
+        block_updates[sdf_block_index].seeds.emplace_back(index);
+      }
+      sdf_value = std::min(sdf_value, distance_to_surface);
+    }
+  }
+}
+
+template <typename HashedMapT>
+void QuasiEuclideanSDFGenerator::propagateInParallel(
+    const HashedMapT& occupancy_map, HashedBlocks& sdf,
+    ThreadPool& thread_pool, BlockUpdatesMap& block_updates) const {
+  ProfilerZoneScoped;
+  // Propagate the distances inside each SDF block in parallel, and exchange
+  // the distances that cross block boundaries between rounds until no more
+  // values change
+  while (!block_updates.empty()) {
+    ProfilerPlot("NumUpdatedBlocks",
+                 static_cast<int64_t>(block_updates.size()));
+    // Allocate all blocks before taking references to them, since allocating
+    // blocks can move the existing ones
+    for (const auto& [block_index, updates] : block_updates) {
+      sdf.getOrAllocateBlock(block_index);
+    }
+
+    // Propagate each block
+    struct BlockTask {
+      Index3D block_index;
+      HashedBlocks::Block* block;
+      BlockUpdates updates;
+      std::vector<Relaxation> outgoing_relaxations;
+    };
+    std::vector<BlockTask> block_tasks;
+    block_tasks.reserve(block_updates.size());
+    for (auto& [block_index, updates] : block_updates) {
+      block_tasks.emplace_back(BlockTask{block_index,
+                                         sdf.getBlock(block_index),
+                                         std::move(updates),
+                                         {}});
+    }
+    block_updates.clear();
+    ThreadPool::TaskGroup task_group{thread_pool};
+    for (BlockTask& block_task : block_tasks) {
+      task_group.add_task([this, &occupancy_map, &block_task]() {
+        propagateBlock(occupancy_map, block_task.block_index,
+                       *block_task.block, block_task.updates,
+                       block_task.outgoing_relaxations);
+      });
+    }
+    task_group.wait();
+
+    // Forward the relaxations that crossed block boundaries
+    for (const BlockTask& block_task : block_tasks) {
+      for (const Relaxation& relaxation : block_task.outgoing_relaxations) {
+        block_updates[HashedBlocks::indexToBlockIndex(relaxation.index)]
+            .relaxations.emplace_back(relaxation);
+      }
+    }
+  }
+}
+
+template <typename HashedMapT>
+void QuasiEuclideanSDFGenerator::propagateBlock(
+    const HashedMapT& occupancy_map, const Index3D& block_index,
+    HashedBlocks::Block& block, const BlockUpdates& block_updates,
+    std::vector<Relaxation>& outgoing_relaxations) const {
+  // Create an occupancy query accelerator
+  QueryAccelerator occupancy_query_accelerator{occupancy_map};
+
+  // Precompute the neighbor distance offsets
+  const FloatingPoint min_cell_width = occupancy_map.getMinCellWidth();
+  const auto neighbor_distance_offsets =
+      GridNeighborhood<3>::computeOffsetLengths(kNeighborIndexOffsets,
+                                                min_cell_width);
+
+  // Helpers to access the block's cells
+  const Index3D min_index = HashedBlocks::kCellsPerSide * block_index;
+  const Index3D max_index =
+      min_index + Index3D::Constant(HashedBlocks::kCellsPerSide - 1);
+  auto is_in_block = [&min_index, &max_index](const Index3D& index) {
+    return (min_index.array() <= index.array()).all() &&
+           (index.array() <= max_index.array()).all();
+  };
+  auto cell_value = [&block, &min_index](const Index3D& index) -> auto& {
+    return block.at(index - min_index);
+  };
+
+  // Open the cells that were seeded or improved by neighboring blocks
+  const int num_bins =
+      static_cast<int>(std::ceil(max_distance_ / min_cell_width));
+  BucketQueue<Index3D> open_queue{num_bins, max_distance_};
+  for (const Index3D& index : block_updates.seeds) {
+    open_queue.push(std::abs(cell_value(index)), index);
+  }
+  for (const auto& [index, sdf_value, distance_offset] :
+       block_updates.relaxations) {
+    FloatingPoint& neighbor_sdf = cell_value(index);
+    if (relax(sdf_value, distance_offset, index, neighbor_sdf,
+              occupancy_query_accelerator)) {
+      open_queue.push(std::abs(neighbor_sdf), index);
+    }
+  }
+
+  // Propagate the distance
+  // NOTE: Unlike the serial propagation, cells are reopened whenever their
+  //       distance improves. This makes the result independent of the order
+  //       in which the blocks exchange their boundary values.
+  while (!open_queue.empty()) {
+    const Index3D index = open_queue.front();
+    const FloatingPoint sdf_value = cell_value(index);
+    open_queue.pop();
+
+    for (size_t neighbor_idx = 0; neighbor_idx < kNeighborIndexOffsets.size();
+         ++neighbor_idx) {
+      const FloatingPoint distance_offset =
+          neighbor_distance_offsets[neighbor_idx];
+      if (max_distance_ <= std::abs(sdf_value) + distance_offset) {
+        continue;
+      }
+      const Index3D neighbor_index =
+          index + kNeighborIndexOffsets[neighbor_idx];
+      if (!is_in_block(neighbor_index)) {
+        outgoing_relaxations.emplace_back(
+            Relaxation{neighbor_index, sdf_value, distance_offset});
+        continue;
+      }
+      FloatingPoint& neighbor_sdf = cell_value(neighbor_index);
+      if (relax(sdf_value, distance_offset, neighbor_index, neighbor_sdf,
+                occupancy_query_accelerator)) {
+        open_queue.push(std::abs(neighbor_sdf), neighbor_index);
+      }
+    }
+  }
+}
+
+template <typename HashedMapT>
+bool QuasiEuclideanSDFGenerator::relax(
+    FloatingPoint sdf_value, FloatingPoint distance_offset,
+    const Index3D& neighbor_index, FloatingPoint& neighbor_sdf,
+    QueryAccelerator<HashedMapT>& occupancy_query_accelerator) const {
+  // Compute the neighbor's distance if reached from the current voxel
+  const FloatingPoint df_value = std::abs(sdf_value);
+  FloatingPoint neighbor_df_candidate = df_value + distance_offset;
+  if (max_distance_ <= neighbor_df_candidate) {
+    return false;
+  }
+
+  // If the neighbor is uninitialized, get its sign from the occupancy map
+  if (neighbor_sdf == max_distance_) {
+    const FloatingPoint neighbor_occupancy =
+        occupancy_query_accelerator.getCellValue(neighbor_index);
+    // Never initialize or update unknown cells
+    if (classifier_.is(neighbor_occupancy, Occupancy::kUnobserved)) {
+      return false;
+    }
+    // Set the sign
+    if (classifier_.is(neighbor_occupancy, Occupancy::kOccupied)) {
+      neighbor_sdf = -max_distance_;
+    }
+  }
+
+  // Handle sign changes when propagating across the surface
+  const bool crossed_surface =
+      std::signbit(neighbor_sdf) != std::signbit(sdf_value);
+  if (crossed_surface) {
+    if (neighbor_sdf < 0.f) {
+      neighbor_df_candidate = distance_offset - df_value;
+    } else {
+      return false;
+    }
+  }
+
+  // Update the neighbor's SDF value if the new distance is shorter
+  if (neighbor_df_candidate < std::abs(neighbor_sdf)) {
+    neighbor_sdf = std::copysign(neighbor_df_candidate, neighbor_sdf);
+    return true;
+  }
+  return false;
+}
 }  // namespace wavemap
@@ -6,16 +6,29 @@
 #include <wavemap/core/utils/profile/profiler_interface.h>
 
 namespace wavemap {
+namespace {
+// The pool and worker index the current thread belongs to, if any
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_pool_worker_idx = 0;
+}  // namespace
+
 ThreadPool::ThreadPool(size_t thread_count)
-    : task_count_(0), terminate_(false) {
+    : num_workers_(std::max(size_t{1}, thread_count)),
+      queues_(std::make_unique<Worker[]>(num_workers_)),
+      next_queue_idx_(0),
+      queued_count_(0),
+      task_count_(0),
+      sleeping_count_(0),
+      terminate_(false) {
   // Create the worker threads
   static int pool_id = 0;
-  for (size_t i = 0; i < thread_count; ++i) {
+  workers_.reserve(num_workers_);
+  for (size_t i = 0; i < num_workers_; ++i) {
     const std::string thread_name =
         "pool_" + std::to_string(pool_id) + "_worker_" + std::to_string(i);
-    workers_.emplace_back([this, thread_name] {
+    workers_.emplace_back([this, thread_name, i] {
       ProfilerSetThreadName(thread_name.c_str());
-      worker_loop();
+      worker_loop(i);
     });
   }
   ++pool_id;
@@ -23,7 +36,7 @@ ThreadPool::ThreadPool(size_t thread_count)
 
 ThreadPool::~ThreadPool() {
   {
-    auto lock = std::scoped_lock<std::mutex>(tasks_mutex_);
+    auto lock = std::scoped_lock<std::mutex>(state_mutex_);
     terminate_ = true;
   }
   worker_condition_.notify_all();
@@ -34,39 +47,126 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::wait_all() {
-  auto lock = std::unique_lock<std::mutex>(tasks_mutex_);
+  auto lock = std::unique_lock<std::mutex>(state_mutex_);
   wait_all_condition_.wait(lock,
                            [this] { return terminate_ || task_count_ == 0; });
 }
 
-void ThreadPool::worker_loop() {
+void ThreadPool::worker_loop(size_t worker_idx) {
+  current_pool = this;
+  current_pool_worker_idx = worker_idx;
+
+  Task task;
   while (true) {
-    // Obtain the next task
-    auto task = std::function<void()>();
-    {
-      auto lock = std::unique_lock<std::mutex>(tasks_mutex_);
+    // Execute tasks for as long as we can find any
+    if (pop_task(worker_idx, task)) {
+      run_task(task);
+      continue;
+    }
+
+    // Otherwise, wait for something to do
+    auto lock = std::unique_lock<std::mutex>(state_mutex_);
+    ++sleeping_count_;
+    worker_condition_.wait(
+        lock, [this] { return terminate_ || 0 < queued_count_; });
+    --sleeping_count_;
+
+    if (terminate_ && queued_count_ == 0) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::push_task(Task task) {
+  size_t queue_idx = current_worker_idx();
+  const bool called_from_worker = queue_idx < num_workers_;
+  if (terminate_ && !called_from_worker) {
+    LOG(FATAL) << "Adding tasks to an already stopped pool.";
+  }
+  if (!called_from_worker) {
+    queue_idx = next_queue_idx_.fetch_add(1, std::memory_order_relaxed) %
+                num_workers_;
+  }
+
+  // NOTE: The counters are incremented before the task is queued, such that
+  //       they never underestimate the number of queued or pending tasks.
+  ++task_count_;
+  ++queued_count_;
+  {
+    auto& queue = queues_[queue_idx];
+    auto lock = std::scoped_lock<std::mutex>(queue.mutex);
+    queue.tasks.emplace_back(std::move(task));
+  }
 
-      // Wait for something to do
-      worker_condition_.wait(lock,
-                             [this] { return terminate_ || !tasks_.empty(); });
+  // Wake up a sleeping worker, if there is one
+  if (0 < sleeping_count_) {
+    { auto lock = std::scoped_lock<std::mutex>(state_mutex_); }
+    worker_condition_.notify_one();
+  }
+}
 
-      if (terminate_ && tasks_.empty()) {
-        return;
-      }
+bool ThreadPool::pop_task(size_t worker_idx, Task& task) {
+  // Try to take the most recently added task from our own queue
+  const bool is_worker = worker_idx < num_workers_;
+  if (is_worker) {
+    auto& own_queue = queues_[worker_idx];
+    auto lock = std::scoped_lock<std::mutex>(own_queue.mutex);
+    if (!own_queue.tasks.empty()) {
+      task = std::move(own_queue.tasks.back());
+      own_queue.tasks.pop_back();
+      --queued_count_;
+      return true;
+    }
+  }
 
-      task = std::move(tasks_.front());
-      tasks_.pop();
+  // Otherwise, steal the oldest task from another worker
+  // NOTE: Threads that do not belong to the pool, which can only end up here
+  //       when helping out in TaskGroup::wait(), may steal from all workers.
+  const size_t num_victims = is_worker ? num_workers_ - 1 : num_workers_;
+  for (size_t offset = 1; offset <= num_victims; ++offset) {
+    auto& victim_queue = queues_[(worker_idx + offset) % num_workers_];
+    auto lock = std::scoped_lock<std::mutex>(victim_queue.mutex);
+    if (!victim_queue.tasks.empty()) {
+      task = std::move(victim_queue.tasks.front());
+      victim_queue.tasks.pop_front();
+      --queued_count_;
+      return true;
     }
+  }
+
+  return false;
+}
 
-    // Execute the task
-    task();
-    task_count_--;
+void ThreadPool::run_task(Task& task) {
+  // Execute the task and release the resources it holds
+  task();
+  task = Task{};
 
-    // Notify the waiting threads if we're done
-    if (task_count_ == 0) {
-      auto lock = std::unique_lock<std::mutex>(tasks_mutex_);
-      wait_all_condition_.notify_all();
+  // Notify the waiting threads if we're done
+  if (--task_count_ == 0) {
+    auto lock = std::scoped_lock<std::mutex>(state_mutex_);
+    wait_all_condition_.notify_all();
+  }
+}
+
+void ThreadPool::TaskGroup::wait() {
+  if (pending_count_.load(std::memory_order_acquire) == 0) {
+    return;
+  }
+
+  // Help out by running queued tasks until all tasks in the group are done
+  const size_t worker_idx = pool_.current_worker_idx();
+  Task task;
+  while (0 < pending_count_.load(std::memory_order_acquire)) {
+    if (pool_.pop_task(worker_idx, task)) {
+      pool_.run_task(task);
+    } else {
+      std::this_thread::yield();
     }
   }
 }
+
+size_t ThreadPool::current_worker_idx() const {
+  return current_pool == this ? current_pool_worker_idx : num_workers_;
+}
 }  // namespace wavemap
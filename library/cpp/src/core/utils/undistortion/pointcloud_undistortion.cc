@@ -1,70 +1,125 @@
 #include "wavemap/core/utils/undistortion/pointcloud_undistortion.h"
 
+#include <algorithm>
 #include <utility>
 
-namespace wavemap {
-PosedPointcloud<> undistortion::compensate_motion(
-    const StampedPoseBuffer& pose_buffer,
-    undistortion::StampedPointcloud& stamped_pointcloud) {
+#include "wavemap/core/utils/profile/profiler_interface.h"
+
+namespace wavemap::undistortion {
+namespace {
+// Find the index of the pose right before the given time, such that the pose
+// can be interpolated between pose_left_idx and pose_left_idx + 1
+size_t findLeftPoseIdx(const StampedPoseBuffer& pose_buffer,
+                       TimeAbsolute time) {
+  const auto right_it = std::lower_bound(
+      std::next(pose_buffer.begin()), pose_buffer.end(), time,
+      [](const auto& stamped_pose, TimeAbsolute time) {
+        return stamped_pose.stamp < time;
+      });
+  const auto right_idx =
+      static_cast<size_t>(std::distance(pose_buffer.begin(), right_it));
+  return std::min(right_idx, pose_buffer.size() - 1u) - 1u;
+}
+
+// Interpolate the sensor's pose at the given time, using the poses at
+// pose_left_idx and pose_left_idx + 1
+Transformation3D interpolatePose(
+    const StampedPoseBuffer& pose_buffer, size_t pose_left_idx,
+    TimeAbsolute time) {
+  CHECK_LT(pose_left_idx + 1, pose_buffer.size());
+  const TimeAbsolute time_left = pose_buffer[pose_left_idx].stamp;
+  const TimeAbsolute time_right = pose_buffer[pose_left_idx + 1].stamp;
+  const Transformation3D& T_WCleft = pose_buffer[pose_left_idx].pose;
+  const Transformation3D& T_WCright = pose_buffer[pose_left_idx + 1].pose;
+  FloatingPoint a = static_cast<FloatingPoint>((time - time_left)) /
+                    static_cast<FloatingPoint>((time_right - time_left));
+  DCHECK_GE(a, 0.f);
+  DCHECK_LE(a, 1.f);
+  return interpolateComponentwise(T_WCleft, T_WCright, a);
+}
+}  // namespace
+
+PosedPointcloud<> compensate_motion(const StampedPoseBuffer& pose_buffer,
+                                    StampedPointcloud& stamped_pointcloud,
+                                    ThreadPool* thread_pool) {
+  ProfilerZoneScoped;
   // Check that timestamps of all points fall within range of pose buffer
   {
+    CHECK_GE(pose_buffer.size(), 2u);
     const auto& buffer_start_time = pose_buffer.front().stamp;
     const auto& buffer_end_time = pose_buffer.back().stamp;
     CHECK_GE(stamped_pointcloud.getStartTime(), buffer_start_time);
     CHECK_LE(stamped_pointcloud.getEndTime(), buffer_end_time);
   }
 
-  // Motion undistort
-  // NOTE: The undistortion is done by transforming the points into a fixed
-  //       (inertial) frame using the sensor's pose at each point's timestamp.
+  // Get the sensor's pose at the median timestamp, whose frame the undistorted
+  // pointcloud will be expressed in
   const auto& points = stamped_pointcloud.getPoints();
-  const auto num_points = static_cast<int>(points.size());
-  const auto num_time_steps = static_cast<int>(pose_buffer.size());
-  Eigen::Matrix<FloatingPoint, 3, Eigen::Dynamic> t_W_points;
-  t_W_points.setZero(3, num_points);
-  TimeAbsolute previous_point_time = -1u;
-  int pose_left_idx = 0u;
-  Transformation3D T_WCi;
-  Transformation3D T_WCmedian;
-  for (int idx = 0u; idx < num_points; ++idx) {
-    const auto& point = points[idx];
-    const Point3D& Ci_p = point.position;
+  const auto num_points = static_cast<Eigen::Index>(points.size());
+  const TimeAbsolute time_base = stamped_pointcloud.getTimeBase();
+  const TimeAbsolute median_time = stamped_pointcloud.getMedianTime();
+  const Transformation3D T_WCmedian = interpolatePose(
+      pose_buffer, findLeftPoseIdx(pose_buffer, median_time), median_time);
+  const Transformation3D T_CmedianW = T_WCmedian.inverse();
 
-    // Get the sensor pose at the current point's time stamp
-    const TimeAbsolute time =
-        stamped_pointcloud.getTimeBase() + point.time_offset;
-    if (time != previous_point_time) {
-      previous_point_time = time;
+  // Motion undistort
+  // NOTE: The undistortion is done by transforming each point into the frame
+  //       of the median pose, using the sensor's pose at the point's timestamp.
+  //       Since the points are sorted by time, all points that share a
+  //       timestamp form a contiguous column block. The pose for each block is
+  //       interpolated once and applied to the whole block at once.
+  Pointcloud<>::Data t_C_points(3, num_points);
+  auto undistort_points = [&](Eigen::Index begin_idx, Eigen::Index end_idx) {
+    // Copy the points of this range into the output matrix
+    for (Eigen::Index idx = begin_idx; idx < end_idx; ++idx) {
+      t_C_points.col(idx) = points[idx].position;
+    }
+    // Transform each block of points with the same timestamp in place
+    size_t pose_left_idx =
+        findLeftPoseIdx(pose_buffer, time_base + points[begin_idx].time_offset);
+    Eigen::Index block_begin_idx = begin_idx;
+    while (block_begin_idx < end_idx) {
+      const TimeOffset time_offset = points[block_begin_idx].time_offset;
+      Eigen::Index block_end_idx = block_begin_idx + 1;
+      while (block_end_idx < end_idx &&
+             points[block_end_idx].time_offset == time_offset) {
+        ++block_end_idx;
+      }
+      const TimeAbsolute time = time_base + time_offset;
       while (pose_buffer[pose_left_idx + 1].stamp < time &&
-             pose_left_idx + 2 < num_time_steps) {
+             pose_left_idx + 2 < pose_buffer.size()) {
         ++pose_left_idx;
       }
-      CHECK_LT(pose_left_idx + 1, pose_buffer.size());
-      const TimeAbsolute time_left = pose_buffer[pose_left_idx].stamp;
-      const TimeAbsolute time_right = pose_buffer[pose_left_idx + 1].stamp;
-      const Transformation3D& T_WCleft = pose_buffer[pose_left_idx].pose;
-      const Transformation3D& T_WCright = pose_buffer[pose_left_idx + 1].pose;
-      FloatingPoint a = static_cast<FloatingPoint>((time - time_left)) /
-                        static_cast<FloatingPoint>((time_right - time_left));
-      DCHECK_GE(a, 0.f);
-      DCHECK_LE(a, 1.f);
-      T_WCi = interpolateComponentwise(T_WCleft, T_WCright, a);
+      const Transformation3D T_CmedianCi =
+          T_CmedianW * interpolatePose(pose_buffer, pose_left_idx, time);
+      const auto R_CmedianCi = T_CmedianCi.getRotationMatrix();
+      auto block = t_C_points.middleCols(block_begin_idx,
+                                         block_end_idx - block_begin_idx);
+      block = (R_CmedianCi * block).colwise() + T_CmedianCi.getPosition();
+      block_begin_idx = block_end_idx;
     }
+  };
 
-    // Transform the current point into the fixed frame
-    t_W_points.col(idx) = T_WCi * Ci_p;
-
-    // Store the sensor's pose at the median timestamp
-    if (idx == num_points / 2) {
-      T_WCmedian = T_WCi;
+  // Process large pointclouds in parallel, splitting them into contiguous
+  // ranges of points
+  if (thread_pool && 2 * kMinNumPointsPerTask <= num_points) {
+    const auto num_tasks = static_cast<Eigen::Index>(
+        std::min(static_cast<size_t>(num_points / kMinNumPointsPerTask),
+                 thread_pool->num_workers()));
+    ThreadPool::TaskGroup task_group{*thread_pool};
+    for (Eigen::Index task_idx = 0; task_idx < num_tasks; ++task_idx) {
+      task_group.add_task([&undistort_points, num_points, num_tasks,
+                           task_idx]() {
+        undistort_points(num_points * task_idx / num_tasks,
+                         num_points * (task_idx + 1) / num_tasks);
+      });
     }
+    task_group.wait();
+  } else if (0 < num_points) {
+    undistort_points(0, num_points);
   }
 
-  // Transform the undistorted pointcloud back into sensor frame,
-  // as needed by the integrators
-  auto t_C_points = T_WCmedian.inverse().transformVectorized(t_W_points);
-
   // Return the result
   return PosedPointcloud<>{T_WCmedian, std::move(t_C_points)};
 }
-}  // namespace wavemap
+}  // namespace wavemap::undistortion
@@ -3,7 +3,10 @@
 #include <fstream>
 
 namespace wavemap::io {
-bool mapToFile(const MapBase& map, const std::filesystem::path& file_path) {
+namespace {
+template <typename SerializerFn>
+bool writeToFile(const std::filesystem::path& file_path,
+                 SerializerFn serializer_fn) {
   if (file_path.empty()) {
     LOG(WARNING)
         << "Could open file for writing. Specified file path is empty.";
@@ -20,7 +23,7 @@ bool mapToFile(const MapBase& map, const std::filesystem::path& file_path) {
   }
 
   // Serialize to bytestream
-  if (!mapToStream(map, file_ostream)) {
+  if (!serializer_fn(file_ostream)) {
     return false;
   }
 
@@ -28,6 +31,20 @@ bool mapToFile(const MapBase& map, const std::filesystem::path& file_path) {
   file_ostream.close();
   return static_cast<bool>(file_ostream);
 }
+}  // namespace
+
+bool mapToFile(const MapBase& map, const std::filesystem::path& file_path) {
+  return writeToFile(file_path, [&map](std::ostream& ostream) {
+    return mapToStream(map, ostream);
+  });
+}
+
+bool mapToIndexedFile(const MapBase& map,
+                      const std::filesystem::path& file_path) {
+  return writeToFile(file_path, [&map](std::ostream& ostream) {
+    return mapToIndexedStream(map, ostream);
+  });
+}
 
 bool fileToMap(const std::filesystem::path& file_path, MapBase::Ptr& map) {
   if (file_path.empty()) {
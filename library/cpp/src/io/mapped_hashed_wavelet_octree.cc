@@ -0,0 +1,252 @@
+#include "wavemap/io/mapped_hashed_wavelet_octree.h"
+
+#include <utility>
+
+#include "wavemap/core/indexing/index_conversions.h"
+#include "wavemap/io/stream_conversions.h"
+#include "wavemap/io/streamable_types.h"
+
+namespace wavemap::io {
+MappedHashedWaveletOctree::Ptr MappedHashedWaveletOctree::open(
+    const std::filesystem::path& file_path) {
+  auto file = std::make_unique<MemoryMappedFile>(file_path);
+  if (!file->isOpen()) {
+    return nullptr;
+  }
+
+  // Make sure the file contains an indexed map and read its metadata
+  MemoryInputStream header_istream(file->data(), file->size());
+  if (streamable::StorageFormat::read(header_istream) !=
+      streamable::StorageFormat::kIndexedHashedWaveletOctree) {
+    LOG(WARNING) << "File " << file_path
+                 << " does not contain a map in the indexed hashed wavelet "
+                    "octree format.";
+    return nullptr;
+  }
+  const auto header =
+      streamable::HashedWaveletOctreeHeader::read(header_istream);
+  HashedWaveletOctreeConfig config;
+  config.min_cell_width = header.min_cell_width;
+  config.min_log_odds = header.min_log_odds;
+  config.max_log_odds = header.max_log_odds;
+  config.tree_height = header.tree_height;
+  if (!header_istream.good() || !config.isValid(false)) {
+    LOG(WARNING) << "Could not read the header of map file " << file_path
+                 << ".";
+    return nullptr;
+  }
+
+  // Locate the block index through the footer at the end of the file
+  constexpr size_t kFooterNumBytes =
+      streamable::HashedBlockIndexFooter::kNumBytes;
+  constexpr size_t kEntryNumBytes =
+      streamable::HashedBlockIndexEntry::kNumBytes;
+  const size_t header_num_bytes = header_istream.tellg();
+  if (file->size() < header_num_bytes + kFooterNumBytes) {
+    LOG(WARNING) << "Map file " << file_path << " is truncated.";
+    return nullptr;
+  }
+  const size_t footer_offset = file->size() - kFooterNumBytes;
+  MemoryInputStream footer_istream(file->data() + footer_offset,
+                                   kFooterNumBytes);
+  const auto footer = streamable::HashedBlockIndexFooter::read(footer_istream);
+  if (footer.num_blocks != header.num_blocks ||
+      footer.block_index_offset < header_num_bytes ||
+      footer_offset - footer.block_index_offset !=
+          footer.num_blocks * kEntryNumBytes) {
+    LOG(WARNING) << "The block index of map file " << file_path
+                 << " is corrupted.";
+    return nullptr;
+  }
+
+  // Read the block index
+  Ptr map(new MappedHashedWaveletOctree(config, std::move(file)));
+  MemoryInputStream index_istream(
+      map->file_->data() + footer.block_index_offset,
+      footer.num_blocks * kEntryNumBytes);
+  for (size_t block_idx = 0; block_idx < footer.num_blocks; ++block_idx) {
+    const auto entry = streamable::HashedBlockIndexEntry::read(index_istream);
+    if (footer.block_index_offset < entry.stream_offset + entry.num_bytes) {
+      LOG(WARNING) << "The block index of map file " << file_path
+                   << " is corrupted.";
+      return nullptr;
+    }
+    const Index3D block_index{entry.block_offset.x, entry.block_offset.y,
+                              entry.block_offset.z};
+    map->block_map_.getOrAllocateBlock(block_index, entry.stream_offset,
+                                       entry.num_bytes);
+  }
+
+  return map;
+}
+
+size_t MappedHashedWaveletOctree::size() const {
+  size_t size = 0u;
+  block_map_.forEachBlock([this, &size](const BlockIndex& /*block_index*/,
+                                         const BlockEntry& entry) {
+    size += loadBlock(entry).size();
+  });
+  return size;
+}
+
+void MappedHashedWaveletOctree::threshold() {
+  block_map_.forEachBlock(
+      [](const BlockIndex& /*block_index*/, BlockEntry& entry) {
+        if (Block* block = entry.block.load(); block) {
+          block->threshold();
+        }
+      });
+}
+
+void MappedHashedWaveletOctree::prune() {
+  // NOTE: Blocks that become empty are kept, since erasing them would cause
+  //       them to be reloaded from the file on their next access.
+  block_map_.forEachBlock(
+      [](const BlockIndex& /*block_index*/, BlockEntry& entry) {
+        if (Block* block = entry.block.load(); block) {
+          block->prune();
+        }
+      });
+}
+
+size_t MappedHashedWaveletOctree::getMemoryUsage() const {
+  size_t memory_usage = 0u;
+  block_map_.forEachBlock([&memory_usage](const BlockIndex& /*block_index*/,
+                                          const BlockEntry& entry) {
+    if (const Block* block = entry.block.load(); block) {
+      memory_usage += block->getMemoryUsage();
+    }
+  });
+  return memory_usage;
+}
+
+Index3D MappedHashedWaveletOctree::getMinIndex() const {
+  return cells_per_block_side_ * block_map_.getMinBlockIndex();
+}
+
+Index3D MappedHashedWaveletOctree::getMaxIndex() const {
+  if (empty()) {
+    return Index3D::Zero();
+  }
+  return cells_per_block_side_ * (block_map_.getMaxBlockIndex().array() + 1) -
+         1;
+}
+
+FloatingPoint MappedHashedWaveletOctree::getCellValue(
+    const Index3D& index) const {
+  return getCellValue(OctreeIndex{0, index});
+}
+
+FloatingPoint MappedHashedWaveletOctree::getCellValue(
+    const OctreeIndex& index) const {
+  const Block* block = getBlock(indexToBlockIndex(index));
+  if (!block) {
+    return 0.f;
+  }
+  return block->getCellValue(indexToCellIndex(index));
+}
+
+void MappedHashedWaveletOctree::setCellValue(const Index3D& index,
+                                             FloatingPoint new_value) {
+  const OctreeIndex node_index{0, index};
+  Block& block = getOrAllocateBlock(indexToBlockIndex(node_index));
+  block.setCellValue(indexToCellIndex(node_index), new_value);
+}
+
+void MappedHashedWaveletOctree::addToCellValue(const Index3D& index,
+                                               FloatingPoint update) {
+  const OctreeIndex node_index{0, index};
+  Block& block = getOrAllocateBlock(indexToBlockIndex(node_index));
+  block.addToCellValue(indexToCellIndex(node_index), update);
+}
+
+bool MappedHashedWaveletOctree::hasBlock(const Index3D& block_index) const {
+  return block_map_.hasBlock(block_index);
+}
+
+bool MappedHashedWaveletOctree::isBlockLoaded(
+    const Index3D& block_index) const {
+  const BlockEntry* entry = block_map_.getBlock(block_index);
+  return entry && entry->block.load();
+}
+
+void MappedHashedWaveletOctree::loadAllBlocks() const {
+  block_map_.forEachBlock(
+      [this](const BlockIndex& /*block_index*/, const BlockEntry& entry) {
+        loadBlock(entry);
+      });
+}
+
+MappedHashedWaveletOctree::Block* MappedHashedWaveletOctree::getBlock(
+    const Index3D& block_index) {
+  const BlockEntry* entry = block_map_.getBlock(block_index);
+  return entry ? &loadBlock(*entry) : nullptr;
+}
+
+const MappedHashedWaveletOctree::Block* MappedHashedWaveletOctree::getBlock(
+    const Index3D& block_index) const {
+  const BlockEntry* entry = block_map_.getBlock(block_index);
+  return entry ? &loadBlock(*entry) : nullptr;
+}
+
+MappedHashedWaveletOctree::Block& MappedHashedWaveletOctree::getOrAllocateBlock(
+    const Index3D& block_index) {
+  return loadBlock(block_map_.getOrAllocateBlock(block_index));
+}
+
+void MappedHashedWaveletOctree::forEachLeaf(
+    MapBase::IndexedLeafVisitorFunction visitor_fn) const {
+  block_map_.forEachBlock([this, &visitor_fn](const BlockIndex& block_index,
+                                              const BlockEntry& entry) {
+    loadBlock(entry).forEachLeaf(block_index, visitor_fn);
+  });
+}
+
+MappedHashedWaveletOctree::BlockIndex
+MappedHashedWaveletOctree::indexToBlockIndex(
+    const OctreeIndex& node_index) const {
+  const Index3D index = convert::nodeIndexToMinCornerIndex(node_index);
+  return convert::indexToBlockIndex(index, config_.tree_height);
+}
+
+MappedHashedWaveletOctree::CellIndex
+MappedHashedWaveletOctree::indexToCellIndex(OctreeIndex index) const {
+  DCHECK_LE(index.height, config_.tree_height);
+  const IndexElement height_difference = config_.tree_height - index.height;
+  index.position =
+      int_math::div_exp2_floor_remainder(index.position, height_difference);
+  return index;
+}
+
+MappedHashedWaveletOctree::Block& MappedHashedWaveletOctree::loadBlock(
+    const BlockEntry& block_entry) const {
+  if (Block* block = block_entry.block.load(std::memory_order_acquire);
+      block) {
+    return *block;
+  }
+
+  // Deserialize the block
+  auto new_block = std::make_unique<Block>(
+      config_.tree_height, config_.min_log_odds, config_.max_log_odds);
+  if (0u < block_entry.num_bytes) {
+    MemoryInputStream block_istream(file_->data() + block_entry.stream_offset,
+                                    block_entry.num_bytes);
+    const auto block_header =
+        streamable::HashedWaveletOctreeBlockHeader::read(block_istream);
+    if (!streamToBlock(block_istream, block_header, *new_block)) {
+      LOG(WARNING) << "Could not deserialize block at offset "
+                   << block_entry.stream_offset << ". Leaving it empty.";
+      new_block->clear();
+    }
+  }
+
+  // Publish it, unless another thread loaded the same block concurrently
+  Block* expected = nullptr;
+  if (block_entry.block.compare_exchange_strong(expected, new_block.get(),
+                                                std::memory_order_acq_rel)) {
+    ++num_loaded_blocks_;
+    return *new_block.release();
+  }
+  return *expected;
+}
+}  // namespace wavemap::io
@@ -0,0 +1,77 @@
+#include "wavemap/io/memory_mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wavemap::io {
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& file_path) {
+  const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+  if (file_descriptor == -1) {
+    LOG(WARNING) << "Could not open file " << file_path
+                 << " for reading. Error: " << strerror(errno);
+    return;
+  }
+
+  struct stat file_status {};
+  if (::fstat(file_descriptor, &file_status) == -1) {
+    LOG(WARNING) << "Could not determine the size of file " << file_path
+                 << ". Error: " << strerror(errno);
+    ::close(file_descriptor);
+    return;
+  }
+  size_ = static_cast<size_t>(file_status.st_size);
+
+  // Empty files cannot be mapped, but are valid nonetheless
+  if (size_ == 0u) {
+    is_open_ = true;
+    ::close(file_descriptor);
+    return;
+  }
+
+  void* mapping =
+      ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  // NOTE: The mapping remains valid after the file descriptor is closed.
+  ::close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    LOG(WARNING) << "Could not map file " << file_path
+                 << " into memory. Error: " << strerror(errno);
+    size_ = 0u;
+    return;
+  }
+  data_ = static_cast<const char*>(mapping);
+  is_open_ = true;
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  if (data_) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+MemoryInputStream::Buffer::pos_type MemoryInputStream::Buffer::seekoff(
+    off_type offset, std::ios_base::seekdir direction,
+    std::ios_base::openmode which) {
+  if (!(which & std::ios_base::in)) {
+    return pos_type(off_type(-1));
+  }
+
+  off_type new_position = offset;
+  if (direction == std::ios_base::cur) {
+    new_position += gptr() - eback();
+  } else if (direction == std::ios_base::end) {
+    new_position += egptr() - eback();
+  }
+  if (new_position < 0 || egptr() - eback() < new_position) {
+    return pos_type(off_type(-1));
+  }
+
+  setg(eback(), eback() + new_position, egptr());
+  return pos_type(new_position);
+}
+}  // namespace wavemap::io
@@ -1,10 +1,156 @@
 #include "wavemap/io/stream_conversions.h"
 
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <stack>
+#include <type_traits>
+#include <vector>
 
 namespace wavemap::io {
+namespace {
+// Serializes the octree of a hashed wavelet octree block, skipping the
+// descendants of saturated nodes
+template <typename BlockT, typename NodeRefT>
+void blockToStream(const Index3D& block_index, const BlockT& block,
+                   FloatingPoint min_log_odds, FloatingPoint max_log_odds,
+                   std::ostream& ostream) {
+  // Define convenience types
+  struct StackElement {
+    const FloatingPoint scale;
+    NodeRefT node;
+  };
+
+  // Serialize the block's metadata
+  streamable::HashedWaveletOctreeBlockHeader block_header;
+  block_header.root_node_offset = {block_index.x(), block_index.y(),
+                                   block_index.z()};
+  // Wavelet scale coefficient of the block's root node
+  block_header.root_node_scale_coefficient = block.getRootScale();
+  block_header.write(ostream);
+
+  // Serialize the block's data (all nodes of its octree)
+  std::stack<StackElement> stack;
+  stack.emplace(StackElement{block.getRootScale(), block.getRootNode()});
+  while (!stack.empty()) {
+    const FloatingPoint scale = stack.top().scale;
+    NodeRefT node = stack.top().node;
+    stack.pop();
+
+    // Serialize the node's data
+    streamable::WaveletOctreeNode streamable_node;
+    std::copy(node.data().begin(), node.data().end(),
+              streamable_node.detail_coefficients.begin());
+
+    // Evaluate which of its children should be serialized
+    const auto child_scales =
+        HashedWaveletOctreeBlock::Transform::backward({scale, node.data()});
+    // NOTE: We iterate and add nodes to the stack in decreasing order s.t.
+    //       the nodes are popped from the stack in increasing order.
+    for (int relative_child_idx = OctreeIndex::kNumChildren - 1;
+         0 <= relative_child_idx; --relative_child_idx) {
+      // If the child is saturated, we don't need to store its descendants
+      const auto child_scale = child_scales[relative_child_idx];
+      if (child_scale < min_log_odds || max_log_odds < child_scale) {
+        continue;
+      }
+      // Otherwise, indicate that the child will be serialized
+      // and add it to the stack
+      if (auto child = node.getChild(relative_child_idx); child) {
+        stack.emplace(StackElement{child_scale, *child});
+        streamable_node.allocated_children_bitset += (1 << relative_child_idx);
+      }
+    }
+    streamable_node.write(ostream);
+  }
+}
+
+// Serializes hashed wavelet octrees and, optionally, appends an index that
+// maps each block to its position in the stream
+template <typename MapT>
+bool hashedWaveletOctreeToStream(const MapT& map, std::ostream& ostream,
+                                 bool with_block_index) {
+  // Check if the output stream can be written to
+  if (!ostream.good()) {
+    return false;
+  }
+
+  // Positions in the block index are stored relative to the start of the map
+  const std::streampos map_begin = ostream.tellp();
+  if (with_block_index && map_begin == std::streampos(-1)) {
+    LOG(WARNING) << "Could not write indexed map to stream. "
+                    "The stream does not report its write position.";
+    return false;
+  }
+
+  // Define convenience constants
+  constexpr FloatingPoint kNumericalNoise = 1e-3f;
+  const auto min_log_odds = map.getMinLogOdds() + kNumericalNoise;
+  const auto max_log_odds = map.getMaxLogOdds() - kNumericalNoise;
+
+  // Indicate the map's data structure type
+  streamable::StorageFormat storage_format =
+      with_block_index ? streamable::StorageFormat::kIndexedHashedWaveletOctree
+                       : streamable::StorageFormat::kHashedWaveletOctree;
+  storage_format.write(ostream);
+
+  // Serialize the map and data structure's metadata
+  streamable::HashedWaveletOctreeHeader hashed_wavelet_octree_header;
+  hashed_wavelet_octree_header.min_cell_width = map.getMinCellWidth();
+  hashed_wavelet_octree_header.min_log_odds = map.getMinLogOdds();
+  hashed_wavelet_octree_header.max_log_odds = map.getMaxLogOdds();
+  hashed_wavelet_octree_header.tree_height = map.getTreeHeight();
+  hashed_wavelet_octree_header.num_blocks = map.getHashMap().size();
+  hashed_wavelet_octree_header.write(ostream);
+
+  // Iterate over all the map's blocks
+  std::vector<streamable::HashedBlockIndexEntry> block_index;
+  if (with_block_index) {
+    block_index.reserve(map.getHashMap().size());
+  }
+  map.forEachBlock([&ostream, &block_index, with_block_index, map_begin,
+                    min_log_odds, max_log_odds](const Index3D& block_index_3d,
+                                                const auto& block) {
+    // Stop if any writing errors occurred
+    if (!ostream.good()) {
+      return;
+    }
+    using BlockT = std::decay_t<decltype(block)>;
+    using NodeRefT = std::conditional_t<
+        std::is_same_v<BlockT, HashedWaveletOctreeBlock>,
+        const HashedWaveletOctreeBlock::NodeType&,
+        HashedChunkedWaveletOctreeBlock::ChunkedOctreeType::NodeConstRefType>;
+    if (!with_block_index) {
+      blockToStream<BlockT, NodeRefT>(block_index_3d, block, min_log_odds,
+                                      max_log_odds, ostream);
+      return;
+    }
+    const std::streampos block_begin = ostream.tellp();
+    blockToStream<BlockT, NodeRefT>(block_index_3d, block, min_log_odds,
+                                    max_log_odds, ostream);
+    auto& entry = block_index.emplace_back();
+    entry.block_offset = {block_index_3d.x(), block_index_3d.y(),
+                          block_index_3d.z()};
+    entry.stream_offset = block_begin - map_begin;
+    entry.num_bytes = ostream.tellp() - block_begin;
+  });
+
+  // Append the block index, followed by the footer pointing to it
+  if (with_block_index && ostream.good()) {
+    streamable::HashedBlockIndexFooter footer;
+    footer.block_index_offset = ostream.tellp() - map_begin;
+    footer.num_blocks = block_index.size();
+    for (const auto& entry : block_index) {
+      entry.write(ostream);
+    }
+    footer.write(ostream);
+  }
+
+  // Return true if no write errors occurred
+  return ostream.good();
+}
+}  // namespace
+
 bool mapToStream(const MapBase& map, std::ostream& ostream) {
   // Call the appropriate mapToStream converter based on the map's derived type
   if (const auto* hashed_blocks = dynamic_cast<const HashedBlocks*>(&map);
@@ -56,7 +202,8 @@ bool streamToMap(std::istream& istream, MapBase::Ptr& map) {
       map = wavelet_octree;
       return true;
     }
-    case streamable::StorageFormat::kHashedWaveletOctree: {
+    case streamable::StorageFormat::kHashedWaveletOctree:
+    case streamable::StorageFormat::kIndexedHashedWaveletOctree: {
       auto hashed_wavelet_octree =
           std::dynamic_pointer_cast<HashedWaveletOctree>(map);
       if (!streamToMap(istream, hashed_wavelet_octree)) {
@@ -65,6 +212,15 @@ bool streamToMap(std::istream& istream, MapBase::Ptr& map) {
       map = hashed_wavelet_octree;
       return true;
     }
+    case streamable::StorageFormat::kHashedChunkedWaveletOctree: {
+      auto hashed_chunked_wavelet_octree =
+          std::dynamic_pointer_cast<HashedChunkedWaveletOctree>(map);
+      if (!streamToMap(istream, hashed_chunked_wavelet_octree)) {
+        return false;
+      }
+      map = hashed_chunked_wavelet_octree;
+      return true;
+    }
     default:
       LOG(WARNING) << "Could not deserialize map stream to a wavemap map. "
                       "Unsupported map type.";
@@ -267,85 +423,144 @@ bool streamToMap(std::istream& istream, WaveletOctree::Ptr& map) {
 }
 
 bool mapToStream(const HashedWaveletOctree& map, std::ostream& ostream) {
-  // Check if the output stream can be written to
-  if (!ostream.good()) {
+  return hashedWaveletOctreeToStream(map, ostream, /*with_block_index=*/false);
+}
+
+bool streamToMap(std::istream& istream, HashedWaveletOctree::Ptr& map) {
+  // Check if the input stream can be read from
+  if (!istream.good()) {
+    return false;
+  }
+
+  // Make sure the map in the input stream is of the correct type
+  const auto storage_format = streamable::StorageFormat::read(istream);
+  if (storage_format != streamable::StorageFormat::kHashedWaveletOctree &&
+      storage_format !=
+          streamable::StorageFormat::kIndexedHashedWaveletOctree) {
     return false;
   }
 
+  // Deserialize the map's config and initialize the data structure
+  const auto hashed_wavelet_octree_header =
+      streamable::HashedWaveletOctreeHeader::read(istream);
+  HashedWaveletOctreeConfig config;
+  config.min_cell_width = hashed_wavelet_octree_header.min_cell_width;
+  config.min_log_odds = hashed_wavelet_octree_header.min_log_odds;
+  config.max_log_odds = hashed_wavelet_octree_header.max_log_odds;
+  config.tree_height = hashed_wavelet_octree_header.tree_height;
+  map = std::make_shared<HashedWaveletOctree>(config);
+
+  // Deserialize all the blocks
+  for (size_t block_idx = 0;
+       block_idx < hashed_wavelet_octree_header.num_blocks; ++block_idx) {
+    // Stop if any reading errors occurred
+    if (!istream.good()) {
+      return false;
+    }
+
+    // Deserialize the block header, containing its position and scale coeff.
+    const auto block_header =
+        streamable::HashedWaveletOctreeBlockHeader::read(istream);
+    const Index3D block_index{block_header.root_node_offset.x,
+                              block_header.root_node_offset.y,
+                              block_header.root_node_offset.z};
+    auto& block = map->getOrAllocateBlock(block_index);
+    if (!streamToBlock(istream, block_header, block)) {
+      return false;
+    }
+  }
+
+  // Skip the block index, since the blocks are read sequentially
+  if (storage_format ==
+      streamable::StorageFormat::kIndexedHashedWaveletOctree) {
+    istream.ignore(hashed_wavelet_octree_header.num_blocks *
+                       streamable::HashedBlockIndexEntry::kNumBytes +
+                   streamable::HashedBlockIndexFooter::kNumBytes);
+  }
+
+  // Return true if no read errors occurred
+  return istream.good();
+}
+
+bool mapToStream(const HashedChunkedWaveletOctree& map, std::ostream& ostream) {
   // Define convenience types and constants
-  struct StackElement {
-    const FloatingPoint scale;
-    const HashedWaveletOctreeBlock::NodeType& node;
-  };
-  constexpr FloatingPoint kNumericalNoise = 1e-3f;
-  const auto min_log_odds = map.getMinLogOdds() + kNumericalNoise;
-  const auto max_log_odds = map.getMaxLogOdds() - kNumericalNoise;
+  using Block = HashedChunkedWaveletOctreeBlock;
+  using ChunkType = Block::ChunkedOctreeType::ChunkType;
+  using ChildChunkBitset = streamable::Bitset<ChunkType::kNumChildren>;
+  using NodeChildBitset = streamable::Bitset<ChunkType::kNumInnerNodes>;
+  // NOTE: The chunks' node data is written and read in bulk, which requires
+  //       it to be laid out exactly as in the serialization format.
+  static_assert(std::is_same_v<FloatingPoint, streamable::Float>);
+  static_assert(sizeof(ChunkType::NodeDataArray) ==
+                ChunkType::kNumInnerNodes *
+                    Block::Coefficients::kNumDetailCoefficients *
+                    sizeof(streamable::Float));
+
+  // Check if the output stream can be written to
+  if (!ostream.good()) {
+    return false;
+  }
 
   // Indicate the map's data structure type
   streamable::StorageFormat storage_format =
-      streamable::StorageFormat::kHashedWaveletOctree;
+      streamable::StorageFormat::kHashedChunkedWaveletOctree;
   storage_format.write(ostream);
 
   // Serialize the map and data structure's metadata
-  streamable::HashedWaveletOctreeHeader hashed_wavelet_octree_header;
-  hashed_wavelet_octree_header.min_cell_width = map.getMinCellWidth();
-  hashed_wavelet_octree_header.min_log_odds = map.getMinLogOdds();
-  hashed_wavelet_octree_header.max_log_odds = map.getMaxLogOdds();
-  hashed_wavelet_octree_header.tree_height = map.getTreeHeight();
-  hashed_wavelet_octree_header.num_blocks = map.getHashMap().size();
-  hashed_wavelet_octree_header.write(ostream);
+  streamable::HashedChunkedWaveletOctreeHeader header;
+  header.min_cell_width = map.getMinCellWidth();
+  header.min_log_odds = map.getMinLogOdds();
+  header.max_log_odds = map.getMaxLogOdds();
+  header.tree_height = map.getTreeHeight();
+  header.chunk_height = map.getChunkHeight();
+  header.num_blocks = map.getHashMap().size();
+  header.write(ostream);
 
   // Iterate over all the map's blocks
-  map.forEachBlock([&ostream, min_log_odds, max_log_odds](
-                       const Index3D& block_index, const auto& block) {
+  map.forEachBlock([&ostream](const Index3D& block_index, const Block& block) {
     // Stop if any writing errors occurred
     if (!ostream.good()) {
       return;
     }
 
     // Serialize the block's metadata
-    streamable::HashedWaveletOctreeBlockHeader block_header;
+    streamable::HashedChunkedWaveletOctreeBlockHeader block_header;
     block_header.root_node_offset = {block_index.x(), block_index.y(),
                                      block_index.z()};
-    // Wavelet scale coefficient of the block's root node
     block_header.root_node_scale_coefficient = block.getRootScale();
+    auto chunk_iterator =
+        block.getChunkIterator<TraversalOrder::kDepthFirstPreorder>();
+    block_header.num_chunks =
+        std::distance(chunk_iterator.begin(), chunk_iterator.end());
     block_header.write(ostream);
 
-    // Serialize the block's data (all nodes of its octree)
-    std::stack<StackElement> stack;
-    stack.emplace(StackElement{block.getRootScale(), block.getRootNode()});
+    // Serialize the block's chunks in depth-first preorder. Each chunk is
+    // stored as the contiguous array of its nodes' detail coefficients,
+    // followed by the bitsets indicating which nodes and chunks have children.
+    std::stack<const ChunkType*> stack;
+    stack.emplace(&block.getRootChunk());
     while (!stack.empty()) {
-      const FloatingPoint scale = stack.top().scale;
-      const auto& node = stack.top().node;
+      const ChunkType* chunk = stack.top();
       stack.pop();
 
-      // Serialize the node's data
-      streamable::WaveletOctreeNode streamable_node;
-      std::copy(node.data().begin(), node.data().end(),
-                streamable_node.detail_coefficients.begin());
-
-      // Evaluate which of its children should be serialized
-      const auto child_scales =
-          HashedWaveletOctreeBlock::Transform::backward({scale, node.data()});
-      // NOTE: We iterate and add nodes to the stack in decreasing order s.t.
-      //       the nodes are popped from the stack in increasing order.
-      for (int relative_child_idx = OctreeIndex::kNumChildren - 1;
-           0 <= relative_child_idx; --relative_child_idx) {
-        // If the child is saturated, we don't need to store its descendants
-        const auto child_scale = child_scales[relative_child_idx];
-        if (child_scale < min_log_odds || max_log_odds < child_scale) {
-          continue;
-        }
-        // Otherwise, indicate that the child will be serialized
-        // and add it to the stack
-        const auto* child = node.getChild(relative_child_idx);
-        if (child) {
-          stack.emplace(StackElement{child_scale, *child});
-          streamable_node.allocated_children_bitset +=
-              (1 << relative_child_idx);
+      ostream.write(
+          reinterpret_cast<const char*>(chunk->getNodeDataArray().data()),
+          sizeof(ChunkType::NodeDataArray));
+      NodeChildBitset{chunk->getNodeChildBitset()}.write(ostream);
+
+      // NOTE: We iterate and add chunks to the stack in decreasing order s.t.
+      //       the chunks are popped from the stack in increasing order.
+      ChildChunkBitset child_chunk_bitset;
+      if (chunk->hasChildrenArray()) {
+        for (int child_idx = ChunkType::kNumChildren - 1; 0 <= child_idx;
+             --child_idx) {
+          if (const ChunkType* child = chunk->getChild(child_idx); child) {
+            child_chunk_bitset.bits.set(child_idx);
+            stack.emplace(child);
+          }
         }
       }
-      streamable_node.write(ostream);
+      child_chunk_bitset.write(ostream);
     }
   });
 
@@ -353,7 +568,13 @@ bool mapToStream(const HashedWaveletOctree& map, std::ostream& ostream) {
   return ostream.good();
 }
 
-bool streamToMap(std::istream& istream, HashedWaveletOctree::Ptr& map) {
+bool streamToMap(std::istream& istream, HashedChunkedWaveletOctree::Ptr& map) {
+  // Define convenience types
+  using Block = HashedChunkedWaveletOctreeBlock;
+  using ChunkType = Block::ChunkedOctreeType::ChunkType;
+  using ChildChunkBitset = streamable::Bitset<ChunkType::kNumChildren>;
+  using NodeChildBitset = streamable::Bitset<ChunkType::kNumInnerNodes>;
+
   // Check if the input stream can be read from
   if (!istream.good()) {
     return false;
@@ -361,23 +582,29 @@ bool streamToMap(std::istream& istream, HashedWaveletOctree::Ptr& map) {
 
   // Make sure the map in the input stream is of the correct type
   if (streamable::StorageFormat::read(istream) !=
-      streamable::StorageFormat::kHashedWaveletOctree) {
+      streamable::StorageFormat::kHashedChunkedWaveletOctree) {
     return false;
   }
 
   // Deserialize the map's config and initialize the data structure
-  const auto hashed_wavelet_octree_header =
-      streamable::HashedWaveletOctreeHeader::read(istream);
-  HashedWaveletOctreeConfig config;
-  config.min_cell_width = hashed_wavelet_octree_header.min_cell_width;
-  config.min_log_odds = hashed_wavelet_octree_header.min_log_odds;
-  config.max_log_odds = hashed_wavelet_octree_header.max_log_odds;
-  config.tree_height = hashed_wavelet_octree_header.tree_height;
-  map = std::make_shared<HashedWaveletOctree>(config);
+  const auto header =
+      streamable::HashedChunkedWaveletOctreeHeader::read(istream);
+  if (header.chunk_height != Block::kChunkHeight) {
+    LOG(WARNING) << "Could not deserialize hashed chunked wavelet octree with "
+                    "chunk height "
+                 << header.chunk_height << ". Only chunk height "
+                 << Block::kChunkHeight << " is supported.";
+    return false;
+  }
+  HashedChunkedWaveletOctreeConfig config;
+  config.min_cell_width = header.min_cell_width;
+  config.min_log_odds = header.min_log_odds;
+  config.max_log_odds = header.max_log_odds;
+  config.tree_height = header.tree_height;
+  map = std::make_shared<HashedChunkedWaveletOctree>(config);
 
   // Deserialize all the blocks
-  for (size_t block_idx = 0;
-       block_idx < hashed_wavelet_octree_header.num_blocks; ++block_idx) {
+  for (size_t block_idx = 0; block_idx < header.num_blocks; ++block_idx) {
     // Stop if any reading errors occurred
     if (!istream.good()) {
       return false;
@@ -385,127 +612,109 @@ bool streamToMap(std::istream& istream, HashedWaveletOctree::Ptr& map) {
 
     // Deserialize the block header, containing its position and scale coeff.
     const auto block_header =
-        streamable::HashedWaveletOctreeBlockHeader::read(istream);
+        streamable::HashedChunkedWaveletOctreeBlockHeader::read(istream);
     const Index3D block_index{block_header.root_node_offset.x,
                               block_header.root_node_offset.y,
                               block_header.root_node_offset.z};
-    auto& block = map->getOrAllocateBlock(block_index);
-    // Wavelet scale coefficient of the block's root node
+    Block& block = map->getOrAllocateBlock(block_index);
     block.getRootScale() = block_header.root_node_scale_coefficient;
 
-    // Deserialize the block's remaining data into octree nodes
-    std::stack<WaveletOctree::NodeType*> stack;
-    stack.emplace(&block.getRootNode());
+    // Deserialize the block's chunks, which are stored in depth-first preorder
+    size_t num_chunks_read = 0u;
+    std::stack<ChunkType*> stack;
+    stack.emplace(&block.getRootChunk());
     while (!stack.empty()) {
-      WaveletOctree::NodeType* node = stack.top();
+      // Stop if the chunks do not match the block's header or reading failed
+      if (block_header.num_chunks <= num_chunks_read || !istream.good()) {
+        return false;
+      }
+      ChunkType* chunk = stack.top();
       stack.pop();
-
-      // Deserialize the node's (wavelet) detail coefficients
-      const auto read_node = streamable::WaveletOctreeNode::read(istream);
-      std::copy(read_node.detail_coefficients.begin(),
-                read_node.detail_coefficients.end(), node->data().begin());
-
-      // Evaluate which of the node's children are coming next
-      // NOTE: We iterate and add nodes to the stack in decreasing order s.t.
-      //       the nodes are popped from the stack in increasing order.
-      for (int relative_child_idx = wavemap::OctreeIndex::kNumChildren - 1;
-           0 <= relative_child_idx; --relative_child_idx) {
-        const bool child_exists = bit_ops::is_bit_set(
-            read_node.allocated_children_bitset, relative_child_idx);
-        if (child_exists) {
-          stack.emplace(&node->getOrAllocateChild(relative_child_idx));
+      ++num_chunks_read;
+
+      istream.read(reinterpret_cast<char*>(chunk->getNodeDataArray().data()),
+                   sizeof(ChunkType::NodeDataArray));
+      chunk->getNodeChildBitset() = NodeChildBitset::read(istream).bits;
+
+      // NOTE: We iterate and add chunks to the stack in decreasing order s.t.
+      //       the chunks are popped from the stack in increasing order.
+      const auto child_chunk_bitset = ChildChunkBitset::read(istream);
+      for (int child_idx = ChunkType::kNumChildren - 1; 0 <= child_idx;
+           --child_idx) {
+        if (child_chunk_bitset.bits.test(child_idx)) {
+          stack.emplace(&chunk->getOrAllocateChild(child_idx));
         }
       }
     }
+    if (num_chunks_read != block_header.num_chunks) {
+      return false;
+    }
   }
 
   // Return true if no read errors occurred
   return istream.good();
 }
 
-bool mapToStream(const HashedChunkedWaveletOctree& map, std::ostream& ostream) {
-  // Check if the output stream can be written to
-  if (!ostream.good()) {
-    return false;
+bool mapToIndexedStream(const MapBase& map, std::ostream& ostream) {
+  // Call the appropriate converter based on the map's derived type
+  if (const auto* hashed_wavelet_octree =
+          dynamic_cast<const HashedWaveletOctree*>(&map);
+      hashed_wavelet_octree) {
+    return io::mapToIndexedStream(*hashed_wavelet_octree, ostream);
+  }
+  if (const auto* hashed_chunked_wavelet_octree =
+          dynamic_cast<const HashedChunkedWaveletOctree*>(&map);
+      hashed_chunked_wavelet_octree) {
+    return io::mapToIndexedStream(*hashed_chunked_wavelet_octree, ostream);
   }
 
-  // Define convenience types and constants
-  struct StackElement {
-    const FloatingPoint scale;
-    HashedChunkedWaveletOctreeBlock::ChunkedOctreeType::NodeConstRefType node;
-  };
-  constexpr FloatingPoint kNumericalNoise = 1e-3f;
-  const auto min_log_odds = map.getMinLogOdds() + kNumericalNoise;
-  const auto max_log_odds = map.getMaxLogOdds() - kNumericalNoise;
+  LOG(WARNING) << "Could not serialize requested map to indexed stream. "
+                  "Map type not yet supported.";
+  return false;
+}
 
-  // Indicate the map's data structure type
-  streamable::StorageFormat storage_format =
-      streamable::StorageFormat::kHashedWaveletOctree;
-  storage_format.write(ostream);
+bool mapToIndexedStream(const HashedWaveletOctree& map,
+                        std::ostream& ostream) {
+  return hashedWaveletOctreeToStream(map, ostream, /*with_block_index=*/true);
+}
 
-  // Serialize the map and data structure's metadata
-  streamable::HashedWaveletOctreeHeader hashed_wavelet_octree_header;
-  hashed_wavelet_octree_header.min_cell_width = map.getMinCellWidth();
-  hashed_wavelet_octree_header.min_log_odds = map.getMinLogOdds();
-  hashed_wavelet_octree_header.max_log_odds = map.getMaxLogOdds();
-  hashed_wavelet_octree_header.tree_height = map.getTreeHeight();
-  hashed_wavelet_octree_header.num_blocks = map.getHashMap().size();
-  hashed_wavelet_octree_header.write(ostream);
+bool mapToIndexedStream(const HashedChunkedWaveletOctree& map,
+                        std::ostream& ostream) {
+  return hashedWaveletOctreeToStream(map, ostream, /*with_block_index=*/true);
+}
 
-  // Iterate over all the map's blocks
-  map.forEachBlock([&ostream, min_log_odds, max_log_odds](
-                       const Index3D& block_index, const auto& block) {
-    // Stop if any writing errors occurred
-    if (!ostream.good()) {
-      return;
-    }
+bool streamToBlock(std::istream& istream,
+                   const streamable::HashedWaveletOctreeBlockHeader& header,
+                   HashedWaveletOctreeBlock& block) {
+  // Wavelet scale coefficient of the block's root node
+  block.getRootScale() = header.root_node_scale_coefficient;
 
-    // Serialize the block's metadata
-    streamable::HashedWaveletOctreeBlockHeader block_header;
-    block_header.root_node_offset = {block_index.x(), block_index.y(),
-                                     block_index.z()};
-    // Wavelet scale coefficient of the block's root node
-    block_header.root_node_scale_coefficient = block.getRootScale();
-    block_header.write(ostream);
+  // Deserialize the block's remaining data into octree nodes
+  std::stack<HashedWaveletOctreeBlock::NodeType*> stack;
+  stack.emplace(&block.getRootNode());
+  while (!stack.empty()) {
+    HashedWaveletOctreeBlock::NodeType* node = stack.top();
+    stack.pop();
 
-    // Serialize the block's data (all nodes of its octree)
-    std::stack<StackElement> stack;
-    stack.emplace(StackElement{block.getRootScale(), block.getRootNode()});
-    while (!stack.empty()) {
-      const FloatingPoint scale = stack.top().scale;
-      auto node = stack.top().node;
-      stack.pop();
+    // Deserialize the node's (wavelet) detail coefficients
+    const auto read_node = streamable::WaveletOctreeNode::read(istream);
+    std::copy(read_node.detail_coefficients.begin(),
+              read_node.detail_coefficients.end(), node->data().begin());
 
-      // Serialize the node's data
-      streamable::WaveletOctreeNode streamable_node;
-      std::copy(node.data().begin(), node.data().end(),
-                streamable_node.detail_coefficients.begin());
-
-      // Evaluate which of its children should be serialized
-      const auto child_scales =
-          HashedWaveletOctreeBlock::Transform::backward({scale, node.data()});
-      // NOTE: We iterate and add nodes to the stack in decreasing order s.t.
-      //       the nodes are popped from the stack in increasing order.
-      for (int relative_child_idx = OctreeIndex::kNumChildren - 1;
-           0 <= relative_child_idx; --relative_child_idx) {
-        // If the child is saturated, we don't need to store its descendants
-        const auto child_scale = child_scales[relative_child_idx];
-        if (child_scale < min_log_odds || max_log_odds < child_scale) {
-          continue;
-        }
-        // Otherwise, indicate that the child will be serialized
-        // and add it to the stack
-        if (auto child = node.getChild(relative_child_idx); child) {
-          stack.emplace(StackElement{child_scale, *child});
-          streamable_node.allocated_children_bitset +=
-              (1 << relative_child_idx);
-        }
+    // Evaluate which of the node's children are coming next
+    // NOTE: We iterate and add nodes to the stack in decreasing order s.t.
+    //       the nodes are popped from the stack in increasing order.
+    for (int relative_child_idx = wavemap::OctreeIndex::kNumChildren - 1;
+         0 <= relative_child_idx; --relative_child_idx) {
+      const bool child_exists = bit_ops::is_bit_set(
+          read_node.allocated_children_bitset, relative_child_idx);
+      if (child_exists) {
+        stack.emplace(&node->getOrAllocateChild(relative_child_idx));
       }
-      streamable_node.write(ostream);
     }
-  });
+  }
 
-  // Return true if no write errors occurred
-  return ostream.good();
+  // Return true if no read errors occurred
+  return istream.good();
 }
 }  // namespace wavemap::io
@@ -8,9 +8,11 @@
 
 namespace wavemap {
 std::unique_ptr<MapOperationBase> MapOperationFactory::create(
-    const param::Value& params, MapBase::Ptr occupancy_map) {
+    const param::Value& params, MapBase::Ptr occupancy_map,
+    std::shared_ptr<ThreadPool> thread_pool) {
   if (const auto type = MapOperationType::from(params); type) {
-    return create(type.value(), params, std::move(occupancy_map));
+    return create(type.value(), params, std::move(occupancy_map),
+                  std::move(thread_pool));
   }
 
   LOG(ERROR) << "Could not create map operation. Returning nullptr.";
@@ -19,7 +21,7 @@ std::unique_ptr<MapOperationBase> MapOperationFactory::create(
 
 std::unique_ptr<MapOperationBase> MapOperationFactory::create(
     MapOperationType operation_type, const param::Value& params,
-    MapBase::Ptr occupancy_map) {
+    MapBase::Ptr occupancy_map, std::shared_ptr<ThreadPool> thread_pool) {
   if (!operation_type.isValid()) {
     LOG(ERROR) << "Received request to create map operation with invalid type.";
     return nullptr;
@@ -31,15 +33,15 @@ std::unique_ptr<MapOperationBase> MapOperationFactory::create(
       if (const auto config = ThresholdMapOperationConfig::from(params);
           config) {
         return std::make_unique<ThresholdMapOperation>(
-            config.value(), std::move(occupancy_map));
+            config.value(), std::move(occupancy_map), std::move(thread_pool));
       } else {
         LOG(ERROR) << "Threshold map operation config could not be loaded.";
         return nullptr;
       }
     case MapOperationType::kPruneMap:
       if (const auto config = PruneMapOperationConfig::from(params); config) {
-        return std::make_unique<PruneMapOperation>(config.value(),
-                                                   std::move(occupancy_map));
+        return std::make_unique<PruneMapOperation>(
+            config.value(), std::move(occupancy_map), std::move(thread_pool));
       } else {
         LOG(ERROR) << "Prune map operation config could not be loaded.";
         return nullptr;
@@ -1,5 +1,8 @@
 #include "wavemap/pipeline/map_operations/prune_map_operation.h"
 
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
+#include "wavemap/core/map/hashed_wavelet_octree.h"
+
 namespace wavemap {
 DECLARE_CONFIG_MEMBERS(PruneMapOperationConfig,
                       (once_every));
@@ -16,7 +19,19 @@ bool PruneMapOperation::shouldRun(const Timestamp& current_time) {
 void PruneMapOperation::run(bool force_run) {
   const Timestamp current_time = Time::now();
   if (force_run || shouldRun(current_time)) {
-    occupancy_map_->pruneSmart();
+    // Process the blocks of hashed maps in parallel
+    if (auto* hashed_wavelet_octree =
+            dynamic_cast<HashedWaveletOctree*>(occupancy_map_.get());
+        hashed_wavelet_octree) {
+      hashed_wavelet_octree->pruneSmart(thread_pool_.get());
+    } else if (auto* hashed_chunked_wavelet_octree =
+                   dynamic_cast<HashedChunkedWaveletOctree*>(
+                       occupancy_map_.get());
+               hashed_chunked_wavelet_octree) {
+      hashed_chunked_wavelet_octree->pruneSmart(thread_pool_.get());
+    } else {
+      occupancy_map_->pruneSmart();
+    }
     last_run_timestamp_ = current_time;
   }
 }
@@ -1,26 +1,48 @@
 #include "wavemap/pipeline/pipeline.h"
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "wavemap/core/integrator/integrator_factory.h"
 
 namespace wavemap {
+DECLARE_CONFIG_MEMBERS(PipelineAsyncConfig,
+                      (max_queue_size)
+                      (drop_policy));
+
+bool PipelineAsyncConfig::isValid(bool verbose) const {
+  bool all_valid = true;
+
+  all_valid &= IS_PARAM_GT(max_queue_size, 0, verbose);
+  all_valid &= IS_PARAM_TRUE(drop_policy.isValid(), verbose);
+
+  return all_valid;
+}
+
 void Pipeline::clear() {
   clearIntegrators();
   clearOperations();
 }
 
 bool Pipeline::hasIntegrator(const std::string& integrator_name) const {
+  waitForAsync();
   return integrators_.count(integrator_name);
 }
 
 bool Pipeline::removeIntegrator(const std::string& integrator_name) {
+  waitForAsync();
   return integrators_.erase(integrator_name);
 }
 
 IntegratorBase* Pipeline::getIntegrator(const std::string& integrator_name) {
+  waitForAsync();
+  return findIntegrator(integrator_name);
+}
+
+IntegratorBase* Pipeline::findIntegrator(const std::string& integrator_name) {
   if (auto it = integrators_.find(integrator_name); it != integrators_.end()) {
     return it->second.get();
   }
@@ -37,6 +59,7 @@ IntegratorBase* Pipeline::addIntegrator(const std::string& integrator_name,
 IntegratorBase* Pipeline::addIntegrator(
     const std::string& integrator_name,
     std::unique_ptr<IntegratorBase> integrator) {
+  waitForAsync();
   if (integrator) {
     auto [it, success] =
         integrators_.try_emplace(integrator_name, std::move(integrator));
@@ -54,20 +77,235 @@ IntegratorBase* Pipeline::addIntegrator(
 }
 
 MapOperationBase* Pipeline::addOperation(const param::Value& operation_params) {
-  auto operation_handler =
-      MapOperationFactory::create(operation_params, occupancy_map_);
+  auto operation_handler = MapOperationFactory::create(
+      operation_params, occupancy_map_, thread_pool_);
   return addOperation(std::move(operation_handler));
 }
 
 MapOperationBase* Pipeline::addOperation(
     std::unique_ptr<MapOperationBase> operation) {
+  waitForAsync();
   return operation ? operations_.emplace_back(std::move(operation)).get()
                    : nullptr;
 }
 
 void Pipeline::runOperations(bool force_run_all) {
+  waitForAsync();
+  applyOperations(force_run_all);
+}
+
+void Pipeline::startAsync(const PipelineAsyncConfig& config) {
+  CHECK(config.isValid(true));
+  stopAsync();
+  std::lock_guard lock(async_mutex_);
+  async_config_ = config;
+  startAsyncWorkers();
+}
+
+void Pipeline::stopAsync() {
+  std::thread import_worker;
+  std::thread map_worker;
+  {
+    std::lock_guard lock(async_mutex_);
+    if (!async_map_worker_.joinable()) {
+      return;
+    }
+    CHECK(!isAsyncWorkerThread())
+        << "The async pipeline can not be stopped from its own callbacks.";
+    async_terminate_ = true;
+    import_worker = std::move(async_import_worker_);
+    map_worker = std::move(async_map_worker_);
+  }
+  // The workers process all remaining measurements before they exit
+  async_job_queued_.notify_all();
+  async_job_imported_.notify_all();
+  async_job_finished_.notify_all();
+  import_worker.join();
+  map_worker.join();
+  std::lock_guard lock(async_mutex_);
+  async_terminate_ = false;
+}
+
+bool Pipeline::isAsync() const {
+  std::lock_guard lock(async_mutex_);
+  return async_map_worker_.joinable();
+}
+
+void Pipeline::waitForAsync() const {
+  std::unique_lock lock(async_mutex_);
+  CHECK(!isAsyncWorkerThread())
+      << "The pipeline can not be used from its own async callbacks.";
+  async_job_finished_.wait(lock, [this]() {
+    return async_queue_.empty() && async_num_active_jobs_ == 0;
+  });
+}
+
+PipelineAsyncStats Pipeline::getAsyncStats() const {
+  std::lock_guard lock(async_mutex_);
+  PipelineAsyncStats stats = async_stats_;
+  stats.queue_depth = async_queue_.size();
+  return stats;
+}
+
+void Pipeline::updateMap(const MapUpdates& map_updates) {
+  for (const auto& map_update : map_updates) {
+    map_update();
+  }
+}
+
+void Pipeline::applyOperations(bool force_run_all) {
   for (auto& operation : operations_) {
     operation->run(force_run_all);
   }
 }
+
+std::future<bool> Pipeline::submitAsyncJob(
+    std::function<bool(MapUpdates&)> import, AsyncCallback callback) {
+  AsyncJob new_job{std::move(import), {}, false, {}, std::move(callback),
+                   Time::now()};
+  std::future<bool> future = new_job.promise.get_future();
+
+  std::optional<AsyncJob> dropped_job;
+  {
+    std::unique_lock lock(async_mutex_);
+    ++async_stats_.num_submitted;
+
+    // Start the workers on first use, unless they are currently being stopped
+    if (!async_terminate_) {
+      startAsyncWorkers();
+    }
+
+    // Make space in the queue, if needed
+    const size_t max_queue_size = async_config_.max_queue_size;
+    bool drop_new_job = async_terminate_;
+    if (!drop_new_job && max_queue_size <= async_queue_.size()) {
+      switch (async_config_.drop_policy) {
+        case QueueDropPolicy::kBlock:
+          CHECK(!isAsyncWorkerThread())
+              << "The pipeline can not be used from its own async callbacks.";
+          async_job_finished_.wait(lock, [this, max_queue_size]() {
+            return async_queue_.size() < max_queue_size || async_terminate_;
+          });
+          drop_new_job = async_terminate_;
+          break;
+        case QueueDropPolicy::kDropOldest:
+          dropped_job = std::move(async_queue_.front());
+          async_queue_.pop_front();
+          break;
+        case QueueDropPolicy::kDropNewest:
+        default:
+          drop_new_job = true;
+          break;
+      }
+    }
+
+    if (drop_new_job) {
+      dropped_job = std::move(new_job);
+    } else {
+      async_queue_.emplace_back(std::move(new_job));
+      async_stats_.max_queue_depth =
+          std::max(async_stats_.max_queue_depth, async_queue_.size());
+    }
+    if (dropped_job) {
+      ++async_stats_.num_dropped;
+    }
+  }
+  async_job_queued_.notify_one();
+
+  if (dropped_job) {
+    finishAsyncJob(dropped_job.value(), false);
+  }
+  return future;
+}
+
+void Pipeline::startAsyncWorkers() {
+  if (!async_map_worker_.joinable()) {
+    async_import_worker_ = std::thread(&Pipeline::asyncImportWorkerLoop, this);
+    async_map_worker_ = std::thread(&Pipeline::asyncMapWorkerLoop, this);
+  }
+}
+
+bool Pipeline::isAsyncWorkerThread() const {
+  const auto this_thread_id = std::this_thread::get_id();
+  return async_import_worker_.get_id() == this_thread_id ||
+         async_map_worker_.get_id() == this_thread_id;
+}
+
+void Pipeline::asyncImportWorkerLoop() {
+  std::unique_lock lock(async_mutex_);
+  while (true) {
+    // Only import the next measurement once the map was updated with the
+    // previous one, as importing overwrites the integrators' range images
+    async_job_queued_.wait(lock, [this]() {
+      return (!async_queue_.empty() && !async_integrators_busy_) ||
+             (async_queue_.empty() && async_terminate_);
+    });
+    if (async_queue_.empty()) {
+      // Only exit once all queued measurements have been imported
+      break;
+    }
+    AsyncJob job = std::move(async_queue_.front());
+    async_queue_.pop_front();
+    ++async_num_active_jobs_;
+    async_integrators_busy_ = true;
+    lock.unlock();
+    // Wake up producers waiting for space in the queue
+    async_job_finished_.notify_all();
+
+    job.import_succeeded = job.import(job.map_updates);
+
+    lock.lock();
+    async_imported_job_ = std::move(job);
+    async_job_imported_.notify_one();
+  }
+}
+
+void Pipeline::asyncMapWorkerLoop() {
+  std::unique_lock lock(async_mutex_);
+  while (true) {
+    async_job_imported_.wait(lock, [this]() {
+      return async_imported_job_.has_value() ||
+             (async_terminate_ && async_queue_.empty() &&
+              async_num_active_jobs_ == 0);
+    });
+    if (!async_imported_job_) {
+      // Only exit once all queued measurements have been processed
+      break;
+    }
+    AsyncJob job = std::move(async_imported_job_.value());
+    async_imported_job_.reset();
+    lock.unlock();
+
+    // Update the map, then release the integrators such that the next
+    // measurement can be imported while the map operations run
+    updateMap(job.map_updates);
+    job.map_updates.clear();
+    lock.lock();
+    async_integrators_busy_ = false;
+    lock.unlock();
+    async_job_queued_.notify_all();
+
+    applyOperations(false);
+    const Duration latency = Time::now() - job.submission_time;
+    finishAsyncJob(job, job.import_succeeded);
+
+    lock.lock();
+    --async_num_active_jobs_;
+    auto& stats = async_stats_;
+    ++stats.num_processed;
+    async_total_latency_ += latency;
+    stats.last_latency = time::to_seconds<FloatingPoint>(latency);
+    stats.mean_latency = time::to_seconds<FloatingPoint>(async_total_latency_) /
+                         static_cast<FloatingPoint>(stats.num_processed);
+    stats.max_latency = std::max(stats.max_latency, stats.last_latency);
+    async_job_finished_.notify_all();
+  }
+}
+
+void Pipeline::finishAsyncJob(AsyncJob& job, bool success) {
+  if (job.callback) {
+    job.callback(success);
+  }
+  job.promise.set_value(success);
+}
 }  // namespace wavemap
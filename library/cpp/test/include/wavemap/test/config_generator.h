@@ -127,6 +127,7 @@ inline ProjectiveIntegratorConfig getRandomConfig<ProjectiveIntegratorConfig>(
   config.min_range = rng.getRandomRealNumber(0.2f, 3.f);
   config.max_range = rng.getRandomRealNumber(
       static_cast<FloatingPoint>(config.min_range), 20.f);
+  config.min_parallel_subtree_height = rng.getRandomInteger(0, 7);
   return config;
 }
 }  // namespace detail
@@ -0,0 +1,155 @@
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/data_structure/flat_hash_map.h"
+#include "wavemap/core/indexing/index_hashes.h"
+#include "wavemap/core/utils/random_number_generator.h"
+
+namespace wavemap {
+class FlatHashMapTest : public ::testing::Test {
+ protected:
+  using FlatMap = FlatHashMap<Index3D, int, MortonIndexHash<3>>;
+  using ReferenceMap = std::unordered_map<Index3D, int, Index3DHash>;
+
+  static constexpr IndexElement kMaxCoordinate = 12;
+
+  Index3D getRandomIndex() {
+    return {random_number_generator_.getRandomInteger(-kMaxCoordinate,
+                                                      kMaxCoordinate),
+            random_number_generator_.getRandomInteger(-kMaxCoordinate,
+                                                      kMaxCoordinate),
+            random_number_generator_.getRandomInteger(-kMaxCoordinate,
+                                                      kMaxCoordinate)};
+  }
+
+  static void expectEqual(const FlatMap& flat_map,
+                          const ReferenceMap& reference_map) {
+    EXPECT_EQ(flat_map.size(), reference_map.size());
+    EXPECT_EQ(flat_map.empty(), reference_map.empty());
+    for (const auto& [key, value] : reference_map) {
+      ASSERT_EQ(flat_map.count(key), 1u);
+      EXPECT_EQ(flat_map.find(key)->second, value);
+    }
+    size_t num_visited_entries = 0u;
+    for (const auto& [key, value] : flat_map) {
+      ++num_visited_entries;
+      ASSERT_EQ(reference_map.count(key), 1u);
+      EXPECT_EQ(reference_map.at(key), value);
+    }
+    EXPECT_EQ(num_visited_entries, reference_map.size());
+  }
+
+ private:
+  RandomNumberGenerator random_number_generator_;
+};
+
+TEST_F(FlatHashMapTest, InsertAndErase) {
+  constexpr int kNumOperations = 20000;
+  RandomNumberGenerator random_number_generator;
+
+  FlatMap flat_map;
+  ReferenceMap reference_map;
+  expectEqual(flat_map, reference_map);
+
+  for (int operation_idx = 0; operation_idx < kNumOperations;
+       ++operation_idx) {
+    const Index3D key = getRandomIndex();
+    if (random_number_generator.getRandomBool(0.6f)) {
+      const auto [flat_it, flat_inserted] =
+          flat_map.try_emplace(key, operation_idx);
+      const auto [reference_it, reference_inserted] =
+          reference_map.try_emplace(key, operation_idx);
+      EXPECT_EQ(flat_inserted, reference_inserted);
+      EXPECT_EQ(flat_it->first, key);
+      EXPECT_EQ(flat_it->second, reference_it->second);
+    } else {
+      EXPECT_EQ(flat_map.erase(key), reference_map.erase(key));
+    }
+  }
+  expectEqual(flat_map, reference_map);
+
+  flat_map.clear();
+  reference_map.clear();
+  expectEqual(flat_map, reference_map);
+}
+
+TEST_F(FlatHashMapTest, EraseWhileIterating) {
+  constexpr int kNumInsertions = 5000;
+  FlatMap flat_map;
+  ReferenceMap reference_map;
+  for (int insertion_idx = 0; insertion_idx < kNumInsertions;
+       ++insertion_idx) {
+    const Index3D key = getRandomIndex();
+    flat_map.try_emplace(key, insertion_idx);
+    reference_map.try_emplace(key, insertion_idx);
+  }
+
+  // Erase all entries with odd values, checking that each entry is visited
+  // exactly once
+  size_t num_visited_entries = 0u;
+  for (auto it = flat_map.begin(); it != flat_map.end();) {
+    ++num_visited_entries;
+    if (it->second % 2) {
+      it = flat_map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  EXPECT_EQ(num_visited_entries, reference_map.size());
+  for (auto it = reference_map.begin(); it != reference_map.end();) {
+    if (it->second % 2) {
+      it = reference_map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  expectEqual(flat_map, reference_map);
+}
+
+TEST_F(FlatHashMapTest, PointerStability) {
+  constexpr int kNumInsertions = 5000;
+  FlatMap flat_map;
+  std::vector<std::pair<Index3D, const int*>> value_pointers;
+  for (int insertion_idx = 0; insertion_idx < kNumInsertions;
+       ++insertion_idx) {
+    const Index3D key = getRandomIndex();
+    if (auto [it, inserted] = flat_map.try_emplace(key, insertion_idx);
+        inserted) {
+      value_pointers.emplace_back(key, &it->second);
+    }
+  }
+
+  // Pointers to the entries must remain valid while the table grows
+  for (const auto& [key, value_ptr] : value_pointers) {
+    EXPECT_EQ(&flat_map.find(key)->second, value_ptr);
+  }
+}
+
+TEST_F(FlatHashMapTest, CopyAndMove) {
+  constexpr int kNumInsertions = 1000;
+  FlatMap flat_map;
+  ReferenceMap reference_map;
+  for (int insertion_idx = 0; insertion_idx < kNumInsertions;
+       ++insertion_idx) {
+    const Index3D key = getRandomIndex();
+    flat_map.try_emplace(key, insertion_idx);
+    reference_map.try_emplace(key, insertion_idx);
+  }
+
+  FlatMap copied_map(flat_map);
+  expectEqual(copied_map, reference_map);
+  expectEqual(flat_map, reference_map);
+
+  FlatMap moved_map(std::move(flat_map));
+  expectEqual(moved_map, reference_map);
+
+  FlatMap assigned_map;
+  assigned_map = moved_map;
+  expectEqual(assigned_map, reference_map);
+  assigned_map = std::move(copied_map);
+  expectEqual(assigned_map, reference_map);
+}
+}  // namespace wavemap
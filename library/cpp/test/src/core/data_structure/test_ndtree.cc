@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -7,6 +8,7 @@
 #include "wavemap/core/data_structure/chunked_ndtree/chunked_ndtree.h"
 #include "wavemap/core/data_structure/ndtree/ndtree.h"
 #include "wavemap/core/indexing/index_hashes.h"
+#include "wavemap/core/utils/memory/arena_allocator.h"
 #include "wavemap/test/fixture_base.h"
 #include "wavemap/test/geometry_generator.h"
 
@@ -16,8 +18,9 @@ class NdtreeTest : public FixtureBase, public GeometryGenerator {};
 
 using NdtreeTypes =
     ::testing::Types<Ndtree<int, 1>, Ndtree<int, 2>, Ndtree<int, 3>,
-                     ChunkedNdtree<int, 1, 3>, ChunkedNdtree<int, 2, 3>,
-                     ChunkedNdtree<int, 3, 3>>;
+                     Ndtree<int, 3, ArenaAllocator>, ChunkedNdtree<int, 1, 3>,
+                     ChunkedNdtree<int, 2, 3>, ChunkedNdtree<int, 3, 3>,
+                     ChunkedNdtree<int, 3, 3, ArenaAllocator>>;
 TYPED_TEST_SUITE(NdtreeTest, NdtreeTypes, );
 
 TYPED_TEST(NdtreeTest, AllocatingAndClearing) {
@@ -58,6 +61,46 @@ TYPED_TEST(NdtreeTest, AllocatingAndClearing) {
   }
 }
 
+TYPED_TEST(NdtreeTest, MovingAndReusing) {
+  using IndexType = typename TypeParam::IndexType;
+  using PositionType = typename IndexType::Position;
+  constexpr int kNumRepetitions = 100;
+
+  for (int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    const int tree_height = TestFixture::getRandomNdtreeIndexHeight(4, 14);
+    TypeParam ndtree(tree_height);
+    const size_t empty_memory_usage = ndtree.getMemoryUsage();
+
+    // Allocate a random leaf node
+    const PositionType min_child_pos = convert::nodeIndexToMinCornerIndex(
+        IndexType{ndtree.getMaxHeight(), PositionType::Zero()});
+    const PositionType max_child_pos = convert::nodeIndexToMaxCornerIndex(
+        IndexType{ndtree.getMaxHeight(), PositionType::Zero()});
+    const auto random_index = GeometryGenerator::getRandomNdtreeIndex<IndexType>(
+        min_child_pos, max_child_pos, 0, 0);
+    const int random_value = TestFixture::getRandomInteger(1, 100000);
+    ndtree.getOrAllocateNode(random_index).data() = random_value;
+    EXPECT_LT(empty_memory_usage, ndtree.getMemoryUsage());
+
+    // Move the tree, then clear and reuse the moved-from tree
+    TypeParam moved_ndtree(std::move(ndtree));
+    ndtree.clear();  // NOLINT(bugprone-use-after-move)
+    EXPECT_TRUE(ndtree.empty());
+    EXPECT_EQ(ndtree.getMemoryUsage(), empty_memory_usage);
+    ndtree.getOrAllocateNode(random_index).data() = random_value + 1;
+
+    // Both trees should remain valid and independent
+    auto moved_node = moved_ndtree.getNode(random_index);
+    ASSERT_TRUE(moved_node) << "At index " << random_index.toString();
+    EXPECT_EQ(moved_node->data(), random_value);
+    auto reused_node = ndtree.getNode(random_index);
+    ASSERT_TRUE(reused_node) << "At index " << random_index.toString();
+    EXPECT_EQ(reused_node->data(), random_value + 1);
+    moved_ndtree.clear();
+    EXPECT_EQ(ndtree.getNode(random_index)->data(), random_value + 1);
+  }
+}
+
 TYPED_TEST(NdtreeTest, GettingAndSetting) {
   using IndexType = typename TypeParam::IndexType;
   using PositionType = typename IndexType::Position;
@@ -232,6 +232,47 @@ TYPED_TEST(Image2DProjectorTypedTest, Conversions) {
   }
 }
 
+TYPED_TEST(Image2DProjectorTypedTest, BatchedConversions) {
+  constexpr int kNumRepetitions = 10;
+  for (int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    // Create a projector with random params
+    typename TypeParam::Config projector_config;
+    TestFixture::getRandomProjectorConfig(projector_config);
+    const TypeParam projector(projector_config);
+
+    // Project a random pointcloud with the projector's batched kernel and
+    // with the base class' default implementation
+    const Pointcloud<> C_points(GeometryGenerator::getRandomPointVector<3>());
+    ProjectorBase::ImageCoordinatesBatch image_coordinates;
+    ProjectorBase::SensorZBatch sensor_z;
+    projector.cartesianToSensor(C_points, image_coordinates, sensor_z);
+    ProjectorBase::ImageCoordinatesBatch image_coordinates_default;
+    ProjectorBase::SensorZBatch sensor_z_default;
+    projector.ProjectorBase::cartesianToSensor(
+        C_points, image_coordinates_default, sensor_z_default);
+    ASSERT_EQ(image_coordinates.cols(), C_points.data().cols());
+    ASSERT_EQ(sensor_z.cols(), C_points.data().cols());
+
+    // Check that both match the single point conversions
+    for (Eigen::Index point_idx = 0; point_idx < C_points.data().cols();
+         ++point_idx) {
+      const auto expected =
+          projector.cartesianToSensor(Point3D{C_points[point_idx]});
+      for (const auto* image_batch :
+           {&image_coordinates, &image_coordinates_default}) {
+        for (int axis : {0, 1}) {
+          EXPECT_NEAR((*image_batch)(axis, point_idx), expected.image[axis],
+                      kEpsilon * (1.f + std::abs(expected.image[axis])));
+        }
+      }
+      for (const auto* sensor_z_batch : {&sensor_z, &sensor_z_default}) {
+        EXPECT_NEAR((*sensor_z_batch)[point_idx], expected.depth,
+                    kEpsilon * (1.f + std::abs(expected.depth)));
+      }
+    }
+  }
+}
+
 TYPED_TEST(Image2DProjectorTypedTest, SensorCoordinateAABBs) {
   constexpr int kNumRandomProjectorConfigs = 10;
   for (int config_idx = 0; config_idx < kNumRandomProjectorConfigs;
@@ -173,6 +173,48 @@ TEST_F(HierarchicalRangeImage2DTest, PyramidConstruction) {
   }
 }
 
+TEST_F(HierarchicalRangeImage2DTest, PyramidUpdate) {
+  for (int repetition = 0; repetition < 3; ++repetition) {
+    // Generate a random hierarchical range image
+    const bool azimuth_wraps = repetition % 2;
+    constexpr FloatingPoint kPointcloudIntegratorMinRange = 0.5f;
+    auto range_image = std::make_shared<Image<>>(getRandomRangeImage());
+    HierarchicalRangeBounds hierarchical_range_image(
+        range_image, azimuth_wraps, kPointcloudIntegratorMinRange);
+
+    // Change the range image and update the pyramids in place
+    *range_image = getRandomRangeImage();
+    hierarchical_range_image.update();
+
+    // The updated pyramids should match pyramids that were built from scratch
+    const HierarchicalRangeBounds hierarchical_range_image_reference(
+        range_image, azimuth_wraps, kPointcloudIntegratorMinRange);
+    ASSERT_EQ(hierarchical_range_image.getMaxHeight(),
+              hierarchical_range_image_reference.getMaxHeight());
+    const Index2D range_image_dims_scaled =
+        range_image->getDimensions().cwiseProduct(
+            hierarchical_range_image.getImageToPyramidScaleFactor());
+    for (IndexElement height = 1;
+         height <= hierarchical_range_image.getMaxHeight(); ++height) {
+      const Index2D current_level_dims =
+          int_math::div_exp2_ceil(range_image_dims_scaled, height);
+      for (const Index2D& position :
+           Grid<2>(Index2D::Zero(), current_level_dims - Index2D::Ones())) {
+        const QuadtreeIndex index{height, position};
+        EXPECT_EQ(hierarchical_range_image.getLowerBound(index),
+                  hierarchical_range_image_reference.getLowerBound(index))
+            << "For index " << index.toString();
+        EXPECT_EQ(hierarchical_range_image.getUpperBound(index),
+                  hierarchical_range_image_reference.getUpperBound(index))
+            << "For index " << index.toString();
+        EXPECT_EQ(hierarchical_range_image.hasUnobserved(index),
+                  hierarchical_range_image_reference.hasUnobserved(index))
+            << "For index " << index.toString();
+      }
+    }
+  }
+}
+
 TEST_F(HierarchicalRangeImage2DTest, RangeBoundQueries) {
   for (int repetition = 0; repetition < 3; ++repetition) {
     // Generate a random hierarchical range image
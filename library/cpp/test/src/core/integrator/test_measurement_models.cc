@@ -1,9 +1,12 @@
+#include <memory>
+
 #include <gtest/gtest.h>
 
 #include "wavemap/core/common.h"
 #include "wavemap/core/integrator/measurement_model/constant_ray.h"
 #include "wavemap/core/integrator/measurement_model/continuous_beam.h"
 #include "wavemap/core/integrator/measurement_model/continuous_ray.h"
+#include "wavemap/core/integrator/projection_model/spherical_projector.h"
 #include "wavemap/core/utils/iterate/grid_iterator.h"
 #include "wavemap/core/utils/iterate/ray_iterator.h"
 #include "wavemap/test/fixture_base.h"
@@ -31,4 +34,84 @@ TEST_F(MeasurementModelTest, DISABLED_ContinuousBeam) {
   for (int i = 0; i < kNumRepetitions; ++i) {
   }
 }
+
+TEST_F(MeasurementModelTest, BatchedUpdates) {
+  constexpr int kNumRepetitions = 100;
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    // Create a random range image and beam offset image
+    const auto projection_model =
+        std::make_shared<SphericalProjector>(SphericalProjectorConfig{
+            {-kQuarterPi, kQuarterPi, 32}, {-kPi, kPi, 128}});
+    const Index2D dimensions = projection_model->getDimensions();
+    const Vector2D pixel_size =
+        projection_model->indexToImage(Index2D::Ones()) -
+        projection_model->indexToImage(Index2D::Zero());
+    auto range_image = std::make_shared<Image<>>(dimensions);
+    auto beam_offset_image = std::make_shared<Image<Vector2D>>(dimensions);
+    for (const Index2D& index :
+         Grid<2>(Index2D::Zero(), dimensions - Index2D::Ones())) {
+      range_image->at(index) = getRandomFloat(0.5f, 10.f);
+      beam_offset_image->at(index) =
+          0.5f * pixel_size.cwiseProduct(Vector2D{getRandomFloat(-1.f, 1.f),
+                                                  getRandomFloat(-1.f, 1.f)});
+    }
+
+    // Sample cells all around the sensor, half of them close to the surface
+    const FloatingPoint range_sigma = getRandomFloat(0.01f, 0.5f);
+    MeasurementModelBase::SensorCoordinatesBatch sensor_coordinates;
+    for (size_t cell_idx = 0; cell_idx < sensor_coordinates.size();
+         ++cell_idx) {
+      SensorCoordinates& cell_coordinates = sensor_coordinates[cell_idx];
+      cell_coordinates.image = {getRandomFloat(-kHalfPi, kHalfPi),
+                                getRandomFloat(-kPi, kPi)};
+      const Index2D nearest_index =
+          projection_model->imageToNearestIndex(cell_coordinates.image)
+              .cwiseMax(Index2D::Zero())
+              .cwiseMin(dimensions - Index2D::Ones());
+      cell_coordinates.depth =
+          cell_idx % 2 == 0
+              ? getRandomFloat(0.f, 12.f)
+              : range_image->at(nearest_index) +
+                    getRandomFloat(-6.f * range_sigma, 9.f * range_sigma);
+    }
+
+    // Check that the batched updates match the regular updates
+    constexpr FloatingPoint kTolerance = 1e-4f;
+    for (const auto beam_selector_type :
+         {BeamSelectorType::kNearestNeighbor, BeamSelectorType::kAllNeighbors}) {
+      ContinuousRayConfig continuous_ray_config{
+          range_sigma, getRandomFloat(0.1f, 0.9f), getRandomFloat(0.1f, 0.9f)};
+      continuous_ray_config.beam_selector_type = beam_selector_type;
+      const ContinuousRay continuous_ray(continuous_ray_config,
+                                         projection_model, range_image);
+      const auto ray_updates = continuous_ray.computeUpdates(sensor_coordinates);
+      for (size_t cell_idx = 0; cell_idx < sensor_coordinates.size();
+           ++cell_idx) {
+        EXPECT_NEAR(ray_updates[cell_idx],
+                    continuous_ray.computeUpdate(sensor_coordinates[cell_idx]),
+                    kTolerance)
+            << "For beam selector "
+            << BeamSelectorType::toStr(beam_selector_type);
+      }
+
+      ContinuousBeamConfig continuous_beam_config{
+          getRandomFloat(0.1f, 1.f) * pixel_size.minCoeff() / 12.f,
+          range_sigma, getRandomFloat(0.1f, 0.9f), getRandomFloat(0.1f, 0.9f)};
+      continuous_beam_config.beam_selector_type = beam_selector_type;
+      const ContinuousBeam continuous_beam(continuous_beam_config,
+                                           projection_model, range_image,
+                                           beam_offset_image);
+      const auto beam_updates =
+          continuous_beam.computeUpdates(sensor_coordinates);
+      for (size_t cell_idx = 0; cell_idx < sensor_coordinates.size();
+           ++cell_idx) {
+        EXPECT_NEAR(beam_updates[cell_idx],
+                    continuous_beam.computeUpdate(sensor_coordinates[cell_idx]),
+                    kTolerance)
+            << "For beam selector "
+            << BeamSelectorType::toStr(beam_selector_type);
+      }
+    }
+  }
+}
 }  // namespace wavemap
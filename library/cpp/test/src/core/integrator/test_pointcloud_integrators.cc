@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <unordered_set>
 
@@ -21,6 +23,7 @@
 #include "wavemap/core/map/wavelet_octree.h"
 #include "wavemap/core/utils/iterate/grid_iterator.h"
 #include "wavemap/core/utils/print/eigen.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/test/config_generator.h"
 #include "wavemap/test/fixture_base.h"
 #include "wavemap/test/geometry_generator.h"
@@ -146,6 +149,344 @@ TYPED_TEST(PointcloudIntegratorTypedTest,
   }
 }
 
+TEST_F(PointcloudIntegratorTest, ParallelFixedResolutionIntegrator) {
+  constexpr int kNumRepetitions = 3;
+  constexpr int kNumPointclouds = 3;
+  for (int idx = 0; idx < kNumRepetitions; ++idx) {
+    const auto projective_integrator_config =
+        getRandomConfig<ProjectiveIntegratorConfig>();
+    const auto data_structure_config = getRandomConfig<MapBaseConfig>();
+    const auto projection_model = std::make_shared<SphericalProjector>(
+        getRandomConfig<SphericalProjectorConfig>());
+    const auto measurement_model_config =
+        getRandomConfig<ContinuousBeamConfig>(*projection_model);
+
+    auto create_integrator = [&](MapBase::Ptr occupancy_map,
+                                 std::shared_ptr<ThreadPool> thread_pool) {
+      auto posed_range_image =
+          std::make_shared<PosedImage<>>(projection_model->getDimensions());
+      auto beam_offset_image =
+          std::make_shared<Image<Vector2D>>(projection_model->getDimensions());
+      auto measurement_model = std::make_shared<ContinuousBeam>(
+          measurement_model_config, projection_model, posed_range_image,
+          beam_offset_image);
+      return std::make_unique<FixedResolutionIntegrator>(
+          projective_integrator_config, projection_model, posed_range_image,
+          beam_offset_image, measurement_model, std::move(occupancy_map),
+          std::move(thread_pool));
+    };
+    auto serial_map = std::make_shared<HashedBlocks>(data_structure_config);
+    auto serial_integrator = create_integrator(serial_map, nullptr);
+    auto parallel_map = std::make_shared<HashedBlocks>(data_structure_config);
+    auto parallel_integrator =
+        create_integrator(parallel_map, std::make_shared<ThreadPool>(4));
+
+    // Updating the blocks in parallel should yield identical maps
+    // NOTE: The pointclouds are integrated consecutively, such that both the
+    //       updates of existing and newly allocated blocks are covered.
+    for (int pointcloud_idx = 0; pointcloud_idx < kNumPointclouds;
+         ++pointcloud_idx) {
+      const PosedPointcloud<> random_pointcloud =
+          getRandomPointcloud(*projection_model);
+      serial_integrator->integrate(random_pointcloud);
+      parallel_integrator->integrate(random_pointcloud);
+    }
+    EXPECT_EQ(serial_map->size(), parallel_map->size());
+    serial_map->forEachLeaf(
+        [&parallel_map](const OctreeIndex& node_index, FloatingPoint value) {
+          EXPECT_EQ(parallel_map->getCellValue(node_index.position), value);
+        });
+  }
+}
+
+TEST_F(PointcloudIntegratorTest, FixedResolutionIntegratorBlockCulling) {
+  constexpr int kNumRepetitions = 3;
+  constexpr int kNumPointclouds = 3;
+  for (int idx = 0; idx < kNumRepetitions; ++idx) {
+    // Bound the max range and resolution, such that the reference update of
+    // the full AABB stays cheap
+    const ProjectiveIntegratorConfig projective_integrator_config{
+        getRandomSignedDistance(0.2f, 1.f), getRandomSignedDistance(2.f, 8.f)};
+    auto data_structure_config = getRandomConfig<MapBaseConfig>();
+    data_structure_config.min_cell_width = getRandomSignedDistance(0.2f, 0.5f);
+    const FloatingPoint min_cell_width = data_structure_config.min_cell_width;
+    const auto projection_model = std::make_shared<SphericalProjector>(
+        getRandomConfig<SphericalProjectorConfig>());
+    const auto measurement_model_config =
+        getRandomConfig<ContinuousBeamConfig>(*projection_model);
+
+    // Set up the serial integrator, whose range image and measurement model
+    // are also used to compute the reference updates
+    const auto posed_range_image =
+        std::make_shared<PosedImage<>>(projection_model->getDimensions());
+    const auto beam_offset_image =
+        std::make_shared<Image<Vector2D>>(projection_model->getDimensions());
+    const auto measurement_model = std::make_shared<ContinuousBeam>(
+        measurement_model_config, projection_model, posed_range_image,
+        beam_offset_image);
+    auto serial_map = std::make_shared<HashedBlocks>(data_structure_config);
+    FixedResolutionIntegrator serial_integrator(
+        projective_integrator_config, projection_model, posed_range_image,
+        beam_offset_image, measurement_model, serial_map);
+
+    // Set up the parallel integrator
+    const auto parallel_range_image =
+        std::make_shared<PosedImage<>>(projection_model->getDimensions());
+    const auto parallel_beam_offset_image =
+        std::make_shared<Image<Vector2D>>(projection_model->getDimensions());
+    auto parallel_map = std::make_shared<HashedBlocks>(data_structure_config);
+    FixedResolutionIntegrator parallel_integrator(
+        projective_integrator_config, projection_model, parallel_range_image,
+        parallel_beam_offset_image,
+        std::make_shared<ContinuousBeam>(measurement_model_config,
+                                         projection_model, parallel_range_image,
+                                         parallel_beam_offset_image),
+        parallel_map, std::make_shared<ThreadPool>(4));
+
+    // Update every cell of the measurement's padded AABB, without skipping
+    // the blocks that the range image intersector classifies as unobserved
+    auto reference_map = std::make_shared<HashedBlocks>(data_structure_config);
+    auto update_reference_map = [&](const PosedPointcloud<>& pointcloud) {
+      const FloatingPoint max_range = projective_integrator_config.max_range;
+      AABB<Point3D> W_aabb;
+      W_aabb.includePoint(pointcloud.getOrigin());
+      for (const Point3D& C_point : pointcloud.getPointsLocal()) {
+        const FloatingPoint range = C_point.norm();
+        if (range < 1e-3f) {
+          continue;
+        }
+        const Point3D C_point_truncated =
+            max_range < range ? Point3D(max_range / range * C_point) : C_point;
+        W_aabb.includePoint(pointcloud.getPose() * C_point_truncated);
+      }
+      const FloatingPoint max_lateral_component = std::max(
+          std::sin(measurement_model->getPaddingAngle()) * max_range,
+          measurement_model->getPaddingSurfaceBack());
+      W_aabb.min -= Vector3D::Constant(max_lateral_component);
+      W_aabb.max += Vector3D::Constant(max_lateral_component);
+
+      const FloatingPoint min_cell_width_inv = 1.f / min_cell_width;
+      const Transformation3D T_C_W = posed_range_image->getPoseInverse();
+      for (const Index3D& index :
+           Grid(convert::pointToFloorIndex(W_aabb.min, min_cell_width_inv),
+                convert::pointToCeilIndex(W_aabb.max, min_cell_width_inv))) {
+        const Point3D C_cell_center =
+            T_C_W * convert::indexToCenterPoint(index, min_cell_width);
+        const auto sensor_coordinates =
+            projection_model->cartesianToSensor(C_cell_center);
+        if (sensor_coordinates.depth < projective_integrator_config.min_range ||
+            max_range < sensor_coordinates.depth) {
+          continue;
+        }
+        const FloatingPoint update =
+            measurement_model->computeUpdate(sensor_coordinates);
+        if (kEpsilon < std::abs(update)) {
+          reference_map->addToCellValue(index, update);
+        }
+      }
+    };
+
+    // Skipping the unobserved blocks should not change the result, neither
+    // when updating the blocks serially nor in parallel
+    for (int pointcloud_idx = 0; pointcloud_idx < kNumPointclouds;
+         ++pointcloud_idx) {
+      const PosedPointcloud<> random_pointcloud =
+          getRandomPointcloud(*projection_model);
+      serial_integrator.integrate(random_pointcloud);
+      parallel_integrator.integrate(random_pointcloud);
+      update_reference_map(random_pointcloud);
+    }
+    // NOTE: The reference updates are computed in a different translation
+    //       unit, where the compiler can contract the measurement model's
+    //       arithmetic differently. The values are therefore compared up to a
+    //       small tolerance, while the maps must allocate the same blocks.
+    constexpr FloatingPoint kTolerance = 1e-3f;
+    ASSERT_LT(0u, reference_map->size());
+    EXPECT_EQ(serial_map->size(), reference_map->size());
+    EXPECT_EQ(parallel_map->size(), reference_map->size());
+    reference_map->forEachLeaf([&serial_map, &parallel_map](
+                                   const OctreeIndex& node_index,
+                                   FloatingPoint value) {
+      EXPECT_NEAR(serial_map->getCellValue(node_index.position), value,
+                  kTolerance);
+      EXPECT_EQ(parallel_map->getCellValue(node_index.position),
+                serial_map->getCellValue(node_index.position));
+    });
+  }
+}
+
+TEST_F(PointcloudIntegratorTest, ParallelRangeImageImport) {
+  constexpr int kNumRepetitions = 3;
+  constexpr int kNumPoints = 100000;
+  for (int idx = 0; idx < kNumRepetitions; ++idx) {
+    // Use a small range image, such that many points fall into each pixel
+    const ProjectiveIntegratorConfig projective_integrator_config{
+        getRandomSignedDistance(0.2f, 1.f), getRandomSignedDistance(1.f, 3.f)};
+    auto data_structure_config = getRandomConfig<MapBaseConfig>();
+    data_structure_config.min_cell_width = 0.2f;
+    const auto projection_model =
+        std::make_shared<SphericalProjector>(SphericalProjectorConfig{
+            {-kQuarterPi, kQuarterPi, 16}, {-kPi, kPi, 64}});
+    const auto measurement_model_config =
+        getRandomConfig<ContinuousBeamConfig>(*projection_model);
+
+    // Generate points with ranges around min_range and max_range, including
+    // points at exactly the same range
+    Pointcloud<> pointcloud;
+    pointcloud.resize(kNumPoints);
+    for (int point_idx = 0; point_idx < kNumPoints; ++point_idx) {
+      if (0 < point_idx && getRandomIndexElement(0, 9) == 0) {
+        pointcloud[point_idx] = pointcloud[point_idx - 1];
+        continue;
+      }
+      const Index2D image_index = getRandomIndex<2>(
+          Index2D::Zero(), projection_model->getDimensions());
+      const Vector2D image_coordinates =
+          projection_model->indexToImage(image_index) +
+          Vector2D{getRandomSignedDistance(-0.01f, 0.01f),
+                   getRandomSignedDistance(-0.01f, 0.01f)};
+      const FloatingPoint range = getRandomSignedDistance(
+          0.5f * projective_integrator_config.min_range,
+          1.2f * projective_integrator_config.max_range);
+      pointcloud[point_idx] =
+          projection_model->sensorToCartesian({image_coordinates, range});
+    }
+    const PosedPointcloud<> posed_pointcloud(getRandomTransformation(),
+                                             pointcloud);
+
+    // Integrate it serially and in parallel
+    auto integrate_pointcloud =
+        [&](std::shared_ptr<ThreadPool> thread_pool,
+            PosedImage<>::Ptr& posed_range_image,
+            Image<Vector2D>::Ptr& beam_offset_image) -> MapBase::Ptr {
+      posed_range_image =
+          std::make_shared<PosedImage<>>(projection_model->getDimensions());
+      beam_offset_image =
+          std::make_shared<Image<Vector2D>>(projection_model->getDimensions());
+      const auto measurement_model = std::make_shared<ContinuousBeam>(
+          measurement_model_config, projection_model, posed_range_image,
+          beam_offset_image);
+      MapBase::Ptr occupancy_map =
+          std::make_shared<HashedBlocks>(data_structure_config);
+      FixedResolutionIntegrator integrator(
+          projective_integrator_config, projection_model, posed_range_image,
+          beam_offset_image, measurement_model, occupancy_map,
+          std::move(thread_pool));
+      integrator.integrate(posed_pointcloud);
+      return occupancy_map;
+    };
+    PosedImage<>::Ptr serial_range_image;
+    Image<Vector2D>::Ptr serial_beam_offset_image;
+    const MapBase::Ptr serial_map =
+        integrate_pointcloud(nullptr, serial_range_image,
+                             serial_beam_offset_image);
+    PosedImage<>::Ptr parallel_range_image;
+    Image<Vector2D>::Ptr parallel_beam_offset_image;
+    const MapBase::Ptr parallel_map =
+        integrate_pointcloud(std::make_shared<ThreadPool>(4),
+                             parallel_range_image, parallel_beam_offset_image);
+
+    // The results should be bit-identical
+    EXPECT_EQ(parallel_range_image->getData(), serial_range_image->getData());
+    for (IndexElement row = 0; row < serial_range_image->getNumRows(); ++row) {
+      for (IndexElement col = 0; col < serial_range_image->getNumColumns();
+           ++col) {
+        EXPECT_EQ(parallel_beam_offset_image->at({row, col}),
+                  serial_beam_offset_image->at({row, col}));
+      }
+    }
+    EXPECT_EQ(parallel_map->getMinIndex(), serial_map->getMinIndex());
+    EXPECT_EQ(parallel_map->getMaxIndex(), serial_map->getMaxIndex());
+    serial_map->forEachLeaf(
+        [&parallel_map](const OctreeIndex& node_index, FloatingPoint value) {
+          EXPECT_EQ(parallel_map->getCellValue(node_index.position), value);
+        });
+  }
+}
+
+TEST_F(PointcloudIntegratorTest, ReusedImport) {
+  constexpr int kNumRepetitions = 3;
+  constexpr int kNumPointclouds = 3;
+  for (int idx = 0; idx < kNumRepetitions; ++idx) {
+    // Set up a near and a far range integrator with the same min_range
+    const auto projection_config = getRandomConfig<SphericalProjectorConfig>();
+    const auto data_structure_config =
+        getRandomConfig<HashedWaveletOctreeConfig>();
+    const FloatingPoint min_range = getRandomSignedDistance(0.2f, 1.f);
+    const ProjectiveIntegratorConfig near_config{
+        min_range, getRandomSignedDistance(2.f, 5.f)};
+    const ProjectiveIntegratorConfig far_config{
+        min_range, getRandomSignedDistance(5.f, 15.f)};
+    const auto measurement_model_config = getRandomConfig<ContinuousBeamConfig>(
+        SphericalProjector(projection_config));
+
+    auto create_integrator = [&](const ProjectiveIntegratorConfig& config,
+                                 HashedWaveletOctree::Ptr occupancy_map) {
+      auto projection_model =
+          std::make_shared<SphericalProjector>(projection_config);
+      auto posed_range_image =
+          std::make_shared<PosedImage<>>(projection_model->getDimensions());
+      auto beam_offset_image =
+          std::make_shared<Image<Vector2D>>(projection_model->getDimensions());
+      auto measurement_model = std::make_shared<ContinuousBeam>(
+          measurement_model_config, projection_model, posed_range_image,
+          beam_offset_image);
+      return std::make_unique<HashedWaveletIntegrator>(
+          config, projection_model, posed_range_image, beam_offset_image,
+          measurement_model, std::move(occupancy_map),
+          std::make_shared<ThreadPool>(1));
+    };
+
+    auto reference_map =
+        std::make_shared<HashedWaveletOctree>(data_structure_config);
+    auto reference_near_integrator =
+        create_integrator(near_config, reference_map);
+    auto reference_far_integrator =
+        create_integrator(far_config, reference_map);
+
+    auto shared_map =
+        std::make_shared<HashedWaveletOctree>(data_structure_config);
+    auto shared_near_integrator = create_integrator(near_config, shared_map);
+    auto shared_far_integrator = create_integrator(far_config, shared_map);
+    ASSERT_TRUE(
+        shared_far_integrator->canReuseImportOf(*shared_near_integrator));
+    ASSERT_FALSE(
+        shared_far_integrator->canReuseImportOf(*shared_far_integrator));
+
+    // Integrators with a different min_range can not reuse each other's import
+    const ProjectiveIntegratorConfig other_min_range_config{
+        0.5f * min_range, far_config.max_range};
+    EXPECT_FALSE(create_integrator(other_min_range_config, shared_map)
+                     ->canReuseImportOf(*shared_near_integrator));
+
+    // Integrating with and without reuse should yield bit-identical maps
+    const SphericalProjector projection_model(projection_config);
+    for (int pointcloud_idx = 0; pointcloud_idx < kNumPointclouds;
+         ++pointcloud_idx) {
+      const auto posed_pointcloud =
+          getRandomPointcloud(projection_model, 0.f, far_config.max_range);
+      reference_near_integrator->integrate(posed_pointcloud);
+      reference_far_integrator->integrate(posed_pointcloud);
+      shared_near_integrator->integrate(posed_pointcloud);
+      shared_far_integrator->integrate(posed_pointcloud,
+                                       *shared_near_integrator);
+      EXPECT_EQ(shared_far_integrator->getPosedRangeImage()->getData(),
+                reference_far_integrator->getPosedRangeImage()->getData());
+    }
+    // NOTE: We compare the maps through the same accessor, since
+    //       forEachLeaf(...) and getCellValue(...) reconstruct the values with
+    //       different floating point rounding.
+    auto compare_maps = [&reference_map, &shared_map](
+                            const OctreeIndex& node_index,
+                            FloatingPoint /*value*/) {
+      EXPECT_EQ(shared_map->getCellValue(node_index),
+                reference_map->getCellValue(node_index));
+    };
+    reference_map->forEachLeaf(compare_maps);
+    shared_map->forEachLeaf(compare_maps);
+  }
+}
+
 TEST_F(PointcloudIntegratorTest, RayTracingIntegrator) {
   for (int idx = 0; idx < 3; ++idx) {
     const auto ray_tracing_integrator_config =
@@ -207,4 +548,114 @@ TEST_F(PointcloudIntegratorTest, RayTracingIntegrator) {
     }
   }
 }
+
+TEST_F(PointcloudIntegratorTest, ParallelRayTracingIntegrator) {
+  constexpr int kNumRepetitions = 3;
+  constexpr int kNumPoints = 20000;
+  for (int idx = 0; idx < kNumRepetitions; ++idx) {
+    const RayTracingIntegratorConfig ray_tracing_integrator_config{
+        getRandomSignedDistance(0.2f, 1.f), getRandomSignedDistance(2.f, 4.f)};
+    auto data_structure_config =
+        getRandomConfig<HashedWaveletOctreeConfig>();
+    data_structure_config.min_cell_width = getRandomMinCellWidth(0.05f, 0.2f);
+
+    // Generate a pointcloud with many rays that cross the same cells
+    Pointcloud<> pointcloud;
+    pointcloud.resize(kNumPoints);
+    for (int point_idx = 0; point_idx < kNumPoints; ++point_idx) {
+      pointcloud[point_idx] = getRandomPoint<3>(
+          0.f, 1.2f * ray_tracing_integrator_config.max_range);
+    }
+    const PosedPointcloud<> posed_pointcloud(getRandomTransformation(),
+                                             pointcloud);
+
+    // Integrating it serially and in parallel should yield identical maps
+    auto integrate_pointcloud = [&](MapBase::Ptr occupancy_map,
+                                    std::shared_ptr<ThreadPool> thread_pool) {
+      RayTracingIntegrator integrator(ray_tracing_integrator_config,
+                                      occupancy_map, std::move(thread_pool));
+      integrator.integrate(posed_pointcloud);
+      return occupancy_map;
+    };
+    const std::vector<std::pair<MapBase::Ptr, MapBase::Ptr>> map_pairs{
+        {integrate_pointcloud(
+             std::make_shared<HashedBlocks>(data_structure_config), nullptr),
+         integrate_pointcloud(
+             std::make_shared<HashedBlocks>(data_structure_config),
+             std::make_shared<ThreadPool>(4))},
+        {integrate_pointcloud(
+             std::make_shared<HashedWaveletOctree>(data_structure_config),
+             nullptr),
+         integrate_pointcloud(
+             std::make_shared<HashedWaveletOctree>(data_structure_config),
+             std::make_shared<ThreadPool>(4))}};
+    for (const auto& [serial_map, parallel_map] : map_pairs) {
+      EXPECT_EQ(serial_map->size(), parallel_map->size());
+      serial_map->forEachLeaf([&serial_map = serial_map,
+                               &parallel_map = parallel_map](
+                                  const OctreeIndex& node_index,
+                                  FloatingPoint /*value*/) {
+        const Index3D index = convert::nodeIndexToMinCornerIndex(node_index);
+        EXPECT_EQ(parallel_map->getCellValue(index),
+                  serial_map->getCellValue(index));
+      });
+    }
+  }
+}
+
+TEST_F(PointcloudIntegratorTest, MergedRayTracingIntegrator) {
+  constexpr int kNumRepetitions = 3;
+  constexpr int kNumCells = 10000;
+  constexpr int kMaxNumPointsPerCell = 8;
+  for (int idx = 0; idx < kNumRepetitions; ++idx) {
+    RayTracingIntegratorConfig ray_tracing_integrator_config{
+        getRandomSignedDistance(0.2f, 1.f), getRandomSignedDistance(2.f, 4.f)};
+    // NOTE: We use wide log-odds bounds, such that merging the updates does
+    //       not change where they get clamped.
+    const MapBaseConfig data_structure_config{
+        getRandomMinCellWidth(0.05f, 0.2f), -1e4f, 1e4f};
+    const FloatingPoint min_cell_width = data_structure_config.min_cell_width;
+
+    // Generate a pointcloud whose points lie at the centers of random cells,
+    // with several points per cell
+    std::vector<Point3D> points;
+    for (int cell_idx = 0; cell_idx < kNumCells; ++cell_idx) {
+      const Index3D index = convert::pointToNearestIndex<3>(
+          getRandomPoint<3>(0.f, 1.2f * ray_tracing_integrator_config.max_range),
+          1.f / min_cell_width);
+      const int num_points = getRandomIndexElement(1, kMaxNumPointsPerCell);
+      for (int point_idx = 0; point_idx < num_points; ++point_idx) {
+        points.emplace_back(convert::indexToCenterPoint(index, min_cell_width));
+      }
+    }
+    const PosedPointcloud<> posed_pointcloud(Transformation3D{},
+                                             Pointcloud<>(points));
+
+    // Integrate it with and without merging the rays
+    auto integrate_pointcloud = [&](bool merge_rays,
+                                    std::shared_ptr<ThreadPool> thread_pool) {
+      ray_tracing_integrator_config.merge_rays = merge_rays;
+      auto occupancy_map = std::make_shared<HashedBlocks>(data_structure_config);
+      RayTracingIntegrator integrator(ray_tracing_integrator_config,
+                                      occupancy_map, std::move(thread_pool));
+      integrator.integrate(posed_pointcloud);
+      return occupancy_map;
+    };
+    const auto reference_map = integrate_pointcloud(false, nullptr);
+    const auto merged_map = integrate_pointcloud(true, nullptr);
+    const auto parallel_merged_map =
+        integrate_pointcloud(true, std::make_shared<ThreadPool>(4));
+
+    // Merging the rays should only change the results up to rounding errors
+    EXPECT_EQ(reference_map->size(), merged_map->size());
+    reference_map->forEachLeaf(
+        [&merged_map, &parallel_merged_map](const OctreeIndex& node_index,
+                                            FloatingPoint value) {
+          const Index3D index = convert::nodeIndexToMinCornerIndex(node_index);
+          const FloatingPoint merged_value = merged_map->getCellValue(index);
+          EXPECT_NEAR(merged_value, value, 1e-3f * (1.f + std::abs(value)));
+          EXPECT_EQ(parallel_merged_map->getCellValue(index), merged_value);
+        });
+  }
+}
 }  // namespace wavemap
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "wavemap/core/common.h"
@@ -139,6 +141,88 @@ TYPED_TEST(HaarCellTest, ParallelAndLiftedBackwardTransformEquivalence) {
   }
 }
 
+TYPED_TEST(HaarCellTest, VectorizedAndLiftedTransformEquivalence) {
+  constexpr int kNumRepetitions = 1000;
+  using ValueType = typename TypeParam::ValueType;
+  using Coefficients = HaarCoefficients<ValueType, TypeParam::kDim>;
+
+  for (int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    // The vectorized transforms perform the same operations as the lifted
+    // transforms, so their results should be exactly identical
+    const typename Coefficients::CoefficientsArray child_scale_coefficients =
+        TestFixture::getRandomWaveletCoefficientArray();
+    const typename Coefficients::Parent vectorized_parent =
+        ForwardVectorized<ValueType, TypeParam::kDim>(child_scale_coefficients);
+    const typename Coefficients::Parent lifted_parent =
+        ForwardLifted<ValueType, TypeParam::kDim>(child_scale_coefficients);
+    EXPECT_EQ(vectorized_parent, lifted_parent)
+        << "The vectorized parent coefficients are\n"
+        << vectorized_parent.toString() << " and the lifted ones are\n"
+        << lifted_parent.toString();
+
+    const typename Coefficients::Parent parent_coefficients =
+        TestFixture::getRandomWaveletCoefficientArray();
+    const typename Coefficients::CoefficientsArray vectorized_child_scales =
+        BackwardVectorized<ValueType, TypeParam::kDim>(parent_coefficients);
+    const typename Coefficients::CoefficientsArray lifted_child_scales =
+        BackwardLifted<ValueType, TypeParam::kDim>(parent_coefficients);
+    EXPECT_EQ(vectorized_child_scales, lifted_child_scales)
+        << "The vectorized child scales are\n["
+        << print::sequence(vectorized_child_scales)
+        << "] and the lifted ones are\n["
+        << print::sequence(lifted_child_scales) << "]";
+  }
+}
+
+TYPED_TEST(HaarCellTest, BatchedAndLiftedTransformEquivalence) {
+  // Use a number of nodes that is not a multiple of the SIMD width, such that
+  // the loops' remainders are covered too
+  constexpr size_t kNumNodes = 101;
+  using ValueType = typename TypeParam::ValueType;
+  using Coefficients = HaarCoefficients<ValueType, TypeParam::kDim>;
+  constexpr auto kNumCoefficients = Coefficients::kNumCoefficients;
+
+  // Generate random nodes and store them in a structure-of-arrays layout
+  std::vector<typename Coefficients::CoefficientsArray> child_scales(
+      kNumNodes);
+  std::vector<typename Coefficients::CoefficientsArray> parents(kNumNodes);
+  std::vector<ValueType> batched_child_scales(kNumCoefficients * kNumNodes);
+  std::vector<ValueType> batched_parents(kNumCoefficients * kNumNodes);
+  for (size_t node_idx = 0; node_idx < kNumNodes; ++node_idx) {
+    child_scales[node_idx] = TestFixture::getRandomWaveletCoefficientArray();
+    parents[node_idx] = TestFixture::getRandomWaveletCoefficientArray();
+    for (int coeff_idx = 0; coeff_idx < kNumCoefficients; ++coeff_idx) {
+      batched_child_scales[coeff_idx * kNumNodes + node_idx] =
+          child_scales[node_idx][coeff_idx];
+      batched_parents[coeff_idx * kNumNodes + node_idx] =
+          parents[node_idx][coeff_idx];
+    }
+  }
+
+  // The batched transforms perform the same operations as the lifted
+  // transforms, so their results should be exactly identical
+  std::vector<ValueType> batched_forward_result(kNumCoefficients * kNumNodes);
+  ForwardLiftedBatch<ValueType, TypeParam::kDim>(
+      batched_child_scales.data(), batched_forward_result.data(), kNumNodes);
+  std::vector<ValueType> batched_backward_result(kNumCoefficients * kNumNodes);
+  BackwardLiftedBatch<ValueType, TypeParam::kDim>(
+      batched_parents.data(), batched_backward_result.data(), kNumNodes);
+  for (size_t node_idx = 0; node_idx < kNumNodes; ++node_idx) {
+    const typename Coefficients::CoefficientsArray lifted_parent =
+        ForwardLifted<ValueType, TypeParam::kDim>(child_scales[node_idx]);
+    const typename Coefficients::CoefficientsArray lifted_child_scales =
+        BackwardLifted<ValueType, TypeParam::kDim>(parents[node_idx]);
+    for (int coeff_idx = 0; coeff_idx < kNumCoefficients; ++coeff_idx) {
+      EXPECT_EQ(batched_forward_result[coeff_idx * kNumNodes + node_idx],
+                lifted_parent[coeff_idx])
+          << "For node " << node_idx << " and coefficient " << coeff_idx;
+      EXPECT_EQ(batched_backward_result[coeff_idx * kNumNodes + node_idx],
+                lifted_child_scales[coeff_idx])
+          << "For node " << node_idx << " and coefficient " << coeff_idx;
+    }
+  }
+}
+
 TYPED_TEST(HaarCellTest, ParentScaleEqualsAverageChildScale) {
   constexpr int kNumRepetitions = 1000;
   using Coefficients =
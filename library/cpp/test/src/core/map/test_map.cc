@@ -14,6 +14,7 @@
 #include "wavemap/core/map/map_base.h"
 #include "wavemap/core/map/volumetric_octree.h"
 #include "wavemap/core/map/wavelet_octree.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/test/config_generator.h"
 #include "wavemap/test/eigen_utils.h"
 #include "wavemap/test/fixture_base.h"
@@ -205,6 +206,69 @@ TYPED_TEST(MapTest, InsertionAndLeafVisitor) {
   }
 }
 
+template <typename MapType>
+class HashedWaveletMapTest : public FixtureBase,
+                             public GeometryGenerator,
+                             public ConfigGenerator {};
+
+using HashedWaveletMapTypes =
+    ::testing::Types<HashedWaveletOctree, HashedChunkedWaveletOctree>;
+TYPED_TEST_SUITE(HashedWaveletMapTest, HashedWaveletMapTypes, );
+
+TYPED_TEST(HashedWaveletMapTest, ParallelThresholdingAndPruning) {
+  constexpr int kNumRepetitions = 3;
+  ThreadPool thread_pool(4);
+  for (int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    const auto config =
+        ConfigGenerator::getRandomConfig<typename TypeParam::Config>();
+    TypeParam serial_map(config);
+    TypeParam parallel_map(config);
+
+    // Fill both maps with the same values, including zeros and values that
+    // exceed the map's log odds bounds
+    const auto random_indices = GeometryGenerator::getRandomIndexVector<3>();
+    for (const Index3D& index : random_indices) {
+      const FloatingPoint value =
+          TestFixture::getRandomInteger(0, 2) == 0
+              ? 0.f
+              : TestFixture::getRandomFloat(2.f * config.min_log_odds,
+                                            2.f * config.max_log_odds);
+      serial_map.setCellValue(index, value);
+      parallel_map.setCellValue(index, value);
+    }
+
+    // Thresholding and pruning in parallel should yield identical maps
+    serial_map.threshold();
+    parallel_map.threshold(&thread_pool);
+    serial_map.prune();
+    parallel_map.prune(&thread_pool);
+    EXPECT_EQ(parallel_map.getHashMap().size(),
+              serial_map.getHashMap().size());
+    EXPECT_EQ(parallel_map.size(), serial_map.size());
+    for (const Index3D& index : random_indices) {
+      EXPECT_EQ(parallel_map.getCellValue(index),
+                serial_map.getCellValue(index));
+    }
+
+    // The same should hold for smart pruning, after zeroing some cells
+    for (const Index3D& index : random_indices) {
+      if (TestFixture::getRandomInteger(0, 1) == 0) {
+        serial_map.setCellValue(index, 0.f);
+        parallel_map.setCellValue(index, 0.f);
+      }
+    }
+    serial_map.pruneSmart();
+    parallel_map.pruneSmart(&thread_pool);
+    EXPECT_EQ(parallel_map.getHashMap().size(),
+              serial_map.getHashMap().size());
+    EXPECT_EQ(parallel_map.size(), serial_map.size());
+    for (const Index3D& index : random_indices) {
+      EXPECT_EQ(parallel_map.getCellValue(index),
+                serial_map.getCellValue(index));
+    }
+  }
+}
+
 // TODO(victorr): For classes derived from VolumetricOctreeInterface, test
 //                NodeIndex based setters and getters (incl. whether values of
 //                all children are updated but nothing spills to the
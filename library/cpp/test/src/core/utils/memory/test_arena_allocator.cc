@@ -0,0 +1,98 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wavemap/core/utils/memory/arena_allocator.h"
+#include "wavemap/core/utils/thread_pool.h"
+#include "wavemap/test/fixture_base.h"
+
+namespace wavemap {
+class ArenaAllocatorTest : public FixtureBase {};
+
+TEST_F(ArenaAllocatorTest, CreateAndDestroy) {
+  ArenaAllocator allocator;
+  EXPECT_EQ(allocator.getMemoryUsage(), 0u);
+
+  // Check that the objects are constructed, aligned and do not overlap
+  using SmallObject = std::array<int, 3>;
+  using LargeObject = std::array<double, 1000>;
+  std::vector<SmallObject*> small_objects;
+  std::vector<LargeObject*> large_objects;
+  for (int idx = 0; idx < 1000; ++idx) {
+    small_objects.emplace_back(
+        allocator.create<SmallObject>(SmallObject{idx, idx, idx}));
+    if (idx % 100 == 0) {
+      large_objects.emplace_back(allocator.create<LargeObject>());
+    }
+  }
+  std::set<const void*> addresses;
+  for (int idx = 0; idx < 1000; ++idx) {
+    const SmallObject* object = small_objects[idx];
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(object) %
+                  alignof(std::max_align_t),
+              0u);
+    EXPECT_EQ(*object, (SmallObject{idx, idx, idx}));
+    addresses.emplace(object);
+  }
+  for (const LargeObject* object : large_objects) {
+    EXPECT_EQ(*object, LargeObject{});
+    addresses.emplace(object);
+  }
+  EXPECT_EQ(addresses.size(), small_objects.size() + large_objects.size());
+  EXPECT_GE(allocator.getMemoryUsage(),
+            small_objects.size() * sizeof(SmallObject) +
+                large_objects.size() * sizeof(LargeObject));
+
+  // Check that destroyed objects are reused, without reserving more memory
+  const size_t memory_usage = allocator.getMemoryUsage();
+  for (SmallObject* object : small_objects) {
+    allocator.destroy(object);
+  }
+  std::set<const void*> reused_addresses;
+  for (size_t idx = 0; idx < small_objects.size(); ++idx) {
+    reused_addresses.emplace(allocator.create<SmallObject>());
+  }
+  for (const void* address : reused_addresses) {
+    EXPECT_EQ(addresses.count(address), 1u);
+  }
+  EXPECT_EQ(allocator.getMemoryUsage(), memory_usage);
+
+  // Check that clearing frees all memory at once
+  allocator.clear();
+  EXPECT_EQ(allocator.getMemoryUsage(), 0u);
+}
+
+TEST_F(ArenaAllocatorTest, ConcurrentAllocations) {
+  ArenaAllocator allocator;
+  ThreadPool thread_pool(4);
+  constexpr int kNumTasks = 16;
+  constexpr int kNumObjectsPerTask = 1000;
+  std::array<std::vector<int*>, kNumTasks> objects;
+  for (int task_idx = 0; task_idx < kNumTasks; ++task_idx) {
+    thread_pool.add_detached_task([&allocator, &objects, task_idx]() {
+      for (int idx = 0; idx < kNumObjectsPerTask; ++idx) {
+        objects[task_idx].emplace_back(allocator.create<int>(task_idx));
+        if (idx % 3 == 0) {
+          allocator.destroy(objects[task_idx].back());
+          objects[task_idx].pop_back();
+        }
+      }
+    });
+  }
+  thread_pool.wait_all();
+
+  std::set<const int*> addresses;
+  for (int task_idx = 0; task_idx < kNumTasks; ++task_idx) {
+    for (const int* object : objects[task_idx]) {
+      EXPECT_EQ(*object, task_idx);
+      addresses.emplace(object);
+    }
+  }
+  EXPECT_EQ(addresses.size(),
+            kNumTasks * (kNumObjectsPerTask - (kNumObjectsPerTask + 2) / 3));
+}
+}  // namespace wavemap
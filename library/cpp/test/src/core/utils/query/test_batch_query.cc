@@ -0,0 +1,99 @@
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wavemap/core/common.h>
+#include <wavemap/core/indexing/index_conversions.h>
+#include <wavemap/core/map/hashed_blocks.h>
+#include <wavemap/core/map/hashed_chunked_wavelet_octree.h>
+#include <wavemap/core/map/hashed_wavelet_octree.h>
+#include <wavemap/core/map/wavelet_octree.h>
+#include <wavemap/core/utils/thread_pool.h>
+#include <wavemap/test/config_generator.h>
+#include <wavemap/test/fixture_base.h>
+#include <wavemap/test/geometry_generator.h>
+
+#include "wavemap/core/utils/query/batch_query.h"
+
+namespace wavemap {
+template <typename MapType>
+class BatchQueryTest : public FixtureBase,
+                       public GeometryGenerator,
+                       public ConfigGenerator {};
+
+using MapTypes =
+    ::testing::Types<HashedBlocks, WaveletOctree, HashedWaveletOctree,
+                     HashedChunkedWaveletOctree>;
+TYPED_TEST_SUITE(BatchQueryTest, MapTypes, );
+
+TYPED_TEST(BatchQueryTest, Equivalence) {
+  ThreadPool thread_pool(3);
+  constexpr int kNumRepetitions = 3;
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    // Create a random map
+    const auto config =
+        ConfigGenerator::getRandomConfig<typename TypeParam::Config>();
+    TypeParam map(config);
+    const std::vector<Index3D> random_indices =
+        GeometryGenerator::getRandomIndexVector<3>(
+            1000u, 2000u, Index3D::Constant(-500), Index3D::Constant(500));
+    for (const Index3D& index : random_indices) {
+      const FloatingPoint update = TestFixture::getRandomUpdate();
+      map.addToCellValue(index, update);
+    }
+    map.prune();
+
+    // Generate unordered queries around the updated cells, and their positions
+    const auto random_offsets = GeometryGenerator::getRandomIndexVector<3>(
+        Index3D::Constant(-10), Index3D::Constant(10), 2, 10);
+    std::vector<Index3D> query_indices;
+    for (const Index3D& offset : random_offsets) {
+      for (const Index3D& index : random_indices) {
+        query_indices.emplace_back(index + offset);
+      }
+    }
+    std::vector<Point3D> query_positions;
+    for (const Index3D& index : query_indices) {
+      query_positions.emplace_back(
+          convert::indexToCenterPoint(index, map.getMinCellWidth()));
+    }
+
+    // Run the queries with and without thread pool
+    for (ThreadPool* pool : {static_cast<ThreadPool*>(nullptr), &thread_pool}) {
+      std::vector<FloatingPoint> values;
+      query::getCellValues(map, query_indices, values, pool);
+      ASSERT_EQ(values.size(), query_indices.size());
+      for (size_t query_idx = 0; query_idx < query_indices.size();
+           ++query_idx) {
+        EXPECT_NEAR(values[query_idx],
+                    map.getCellValue(query_indices[query_idx]), kEpsilon);
+      }
+
+      std::vector<FloatingPoint> position_values;
+      query::getCellValues(map, query_positions, position_values, pool);
+      EXPECT_EQ(position_values, values);
+    }
+
+    // Test queries at random heights for the multi-resolution hashed maps
+    if constexpr (std::is_same_v<TypeParam, HashedWaveletOctree> ||
+                  std::is_same_v<TypeParam, HashedChunkedWaveletOctree>) {
+      std::vector<OctreeIndex> query_node_indices;
+      for (const Index3D& index : query_indices) {
+        const IndexElement height =
+            TestFixture::getRandomInteger(0, map.getTreeHeight());
+        query_node_indices.emplace_back(
+            OctreeIndex{0, index}.computeParentIndex(height));
+      }
+      std::vector<FloatingPoint> values;
+      query::getCellValues(map, query_node_indices, values, &thread_pool);
+      ASSERT_EQ(values.size(), query_node_indices.size());
+      for (size_t query_idx = 0; query_idx < query_node_indices.size();
+           ++query_idx) {
+        const OctreeIndex& node_index = query_node_indices[query_idx];
+        EXPECT_NEAR(values[query_idx], map.getCellValue(node_index), kEpsilon)
+            << "For node_index " << node_index.toString();
+      }
+    }
+  }
+}
+}  // namespace wavemap
@@ -3,9 +3,12 @@
 #include <gtest/gtest.h>
 
 #include "wavemap/core/common.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 #include "wavemap/core/utils/iterate/grid_iterator.h"
 #include "wavemap/core/utils/query/classified_map.h"
+#include "wavemap/core/utils/sdf/quasi_euclidean_sdf_generator.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/test/config_generator.h"
 #include "wavemap/test/fixture_base.h"
 #include "wavemap/test/geometry_generator.h"
@@ -84,4 +87,150 @@ TEST_F(ClassifiedMapTest, ClassificationResults) {
     }
   }
 }
+
+TEST_F(ClassifiedMapTest, IncrementalUpdates) {
+  constexpr int kNumRepetitions = 3;
+  ThreadPool thread_pool(4);
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    // Create a random map and classify it
+    const auto config =
+        ConfigGenerator::getRandomConfig<HashedWaveletOctree::Config>();
+    HashedWaveletOctree map{config};
+    for (const Index3D& index : GeometryGenerator::getRandomIndexVector<3>(
+             1000u, 2000u, Index3D::Constant(-5000), Index3D::Constant(5000))) {
+      map.addToCellValue(index, getRandomUpdate());
+    }
+    map.prune();
+    const OccupancyClassifier classifier;
+    ClassifiedMap classified_map{map, classifier};
+
+    // Update a subset of the map
+    for (const Index3D& index : GeometryGenerator::getRandomIndexVector<3>(
+             10u, 100u, Index3D::Constant(-5000), Index3D::Constant(5000))) {
+      map.addToCellValue(index, getRandomUpdate());
+    }
+    map.prune();
+    classified_map.updateChangedBlocks(map, &thread_pool);
+
+    // Check that the result matches classifying the whole map from scratch
+    const ClassifiedMap reference_map{map, classifier};
+    EXPECT_EQ(classified_map.getHashMap().size(),
+              reference_map.getHashMap().size());
+    reference_map.forEachLeaf(
+        [&classified_map](const OctreeIndex& index, Occupancy::Mask occupancy) {
+          EXPECT_EQ(classified_map.getValue(index), occupancy)
+              << "For index: " << index.toString();
+        });
+    classified_map.forEachLeaf(
+        [&reference_map](const OctreeIndex& index, Occupancy::Mask occupancy) {
+          EXPECT_EQ(reference_map.getValue(index), occupancy)
+              << "For index: " << index.toString();
+        });
+  }
+}
+
+TEST_F(ClassifiedMapTest, IncrementalEsdfUpdates) {
+  constexpr int kNumRepetitions = 3;
+  ThreadPool thread_pool(4);
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    // Params
+    const Index3D min_index = Index3D::Constant(-20);
+    const Index3D max_index = Index3D::Constant(80);
+    const Index3D min_change_index = Index3D::Constant(-20);
+    const Index3D max_change_index = Index3D::Constant(0);
+    const Index3D erased_cell_index = Index3D::Constant(50);
+
+    // Create a map with random obstacles in free space
+    auto config = getRandomConfig<HashedWaveletOctree::Config>();
+    config.tree_height = getRandomInteger(2, 4);
+    HashedWaveletOctree map{config};
+    const IndexElement tree_height = map.getTreeHeight();
+    for (const auto& block_index :
+         Grid<3>(convert::indexToBlockIndex(min_index, tree_height),
+                 convert::indexToBlockIndex(max_index, tree_height))) {
+      map.getOrAllocateBlock(block_index).getRootScale() = config.min_log_odds;
+    }
+    for (const Index3D& index :
+         getRandomIndexVector<3>(100u, 200u, min_index, max_index)) {
+      map.addToCellValue(index, config.max_log_odds);
+    }
+    // NOTE: We place an obstacle on the corner of the block that will be
+    //       erased, such that erasing it changes the classification of the
+    //       cells in its neighboring blocks.
+    const OctreeIndex erased_block_node_index{
+        tree_height,
+        convert::indexToBlockIndex(erased_cell_index, tree_height)};
+    map.addToCellValue(
+        convert::nodeIndexToMinCornerIndex(erased_block_node_index),
+        config.max_log_odds);
+
+    // Classify the map, accounting for the robot's radius
+    const FloatingPoint robot_radius =
+        getRandomFloat(1.f, 3.f) * config.min_cell_width;
+    const QuasiEuclideanSDFGenerator sdf_generator{2.f * robot_radius};
+    const auto esdf = sdf_generator.generate(map);
+    const OccupancyClassifier classifier;
+    ClassifiedMap classified_map{map, classifier, esdf, robot_radius};
+
+    // Update a small part of the map and erase a block far away from it
+    for (const Index3D& index : getRandomIndexVector<3>(
+             10u, 20u, min_change_index, max_change_index)) {
+      map.addToCellValue(index, getRandomUpdate());
+    }
+    map.eraseBlock(erased_block_node_index.position);
+    const auto updated_esdf = sdf_generator.generate(map);
+    classified_map.updateChangedBlocks(map, updated_esdf, robot_radius,
+                                       &thread_pool);
+
+    // Check that the result matches a full update
+    ClassifiedMap reference_map{map.getMinCellWidth(), tree_height,
+                                classifier};
+    reference_map.update(map, updated_esdf, robot_radius);
+    EXPECT_EQ(classified_map.getHashMap().size(),
+              reference_map.getHashMap().size());
+    reference_map.forEachLeaf(
+        [&classified_map](const OctreeIndex& index, Occupancy::Mask occupancy) {
+          EXPECT_EQ(classified_map.getValue(index), occupancy)
+              << "For index: " << index.toString();
+        });
+    classified_map.forEachLeaf(
+        [&reference_map](const OctreeIndex& index, Occupancy::Mask occupancy) {
+          EXPECT_EQ(reference_map.getValue(index), occupancy)
+              << "For index: " << index.toString();
+        });
+  }
+}
+
+TEST_F(ClassifiedMapTest, ChunkedOctreeClassification) {
+  constexpr int kNumRepetitions = 3;
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    // Create a random chunked map and classify it directly
+    const auto config = ConfigGenerator::getRandomConfig<
+        HashedChunkedWaveletOctree::Config>();
+    HashedChunkedWaveletOctree map{config};
+    for (const Index3D& index : GeometryGenerator::getRandomIndexVector<3>(
+             1000u, 2000u, Index3D::Constant(-5000), Index3D::Constant(5000))) {
+      map.addToCellValue(index, getRandomUpdate());
+    }
+    map.prune();
+    const OccupancyClassifier classifier;
+    const ClassifiedMap classified_map{map, classifier};
+
+    // Test all leaves
+    map.forEachLeaf([&map, &classifier, &classified_map](
+                        const OctreeIndex& cell_index,
+                        FloatingPoint cell_log_odds) {
+      const auto cell_occupancy_type = classifier.classify(cell_log_odds);
+      EXPECT_TRUE(classified_map.isFully(cell_index, cell_occupancy_type))
+          << "For cell_index: " << cell_index.toString();
+      for (IndexElement height = cell_index.height;
+           height < map.getTreeHeight(); ++height) {
+        EXPECT_TRUE(classified_map.has(cell_index.computeParentIndex(height),
+                                       cell_occupancy_type))
+            << "For cell_index.computeParentIndex(height): "
+            << cell_index.computeParentIndex(height).toString();
+      }
+    });
+  }
+}
 }  // namespace wavemap
@@ -1,7 +1,10 @@
+#include <cmath>
+#include <type_traits>
 #include <vector>
 
 #include <gtest/gtest.h>
 #include <wavemap/core/common.h>
+#include <wavemap/core/map/hashed_chunked_wavelet_octree.h>
 #include <wavemap/core/map/hashed_wavelet_octree.h>
 #include <wavemap/core/map/wavelet_octree.h>
 #include <wavemap/test/config_generator.h>
@@ -11,22 +14,27 @@
 #include "wavemap/core/utils/query/query_accelerator.h"
 
 namespace wavemap {
+template <typename MapType>
 class QueryAcceleratorTest : public FixtureBase,
                              public GeometryGenerator,
                              public ConfigGenerator {};
 
-TEST_F(QueryAcceleratorTest, Equivalence) {
+using MapTypes =
+    ::testing::Types<HashedWaveletOctree, HashedChunkedWaveletOctree>;
+TYPED_TEST_SUITE(QueryAcceleratorTest, MapTypes, );
+
+TYPED_TEST(QueryAcceleratorTest, Equivalence) {
   constexpr int kNumRepetitions = 3;
   for (int i = 0; i < kNumRepetitions; ++i) {
     // Create a random map
     const auto config =
-        ConfigGenerator::getRandomConfig<HashedWaveletOctree::Config>();
-    HashedWaveletOctree map(config);
+        ConfigGenerator::getRandomConfig<typename TypeParam::Config>();
+    TypeParam map(config);
     const std::vector<Index3D> random_indices =
         GeometryGenerator::getRandomIndexVector<3>(
             10000u, 20000u, Index3D::Constant(-5000), Index3D::Constant(5000));
     for (const Index3D& index : random_indices) {
-      const FloatingPoint update = getRandomUpdate();
+      const FloatingPoint update = TestFixture::getRandomUpdate();
       map.addToCellValue(index, update);
     }
     map.prune();
@@ -37,18 +45,29 @@ TEST_F(QueryAcceleratorTest, Equivalence) {
     // Test all leaves
     map.forEachLeaf(
         [&query_accelerator](const OctreeIndex& index, FloatingPoint value) {
-          EXPECT_NEAR(query_accelerator.getCellValue(index), value, kEpsilon);
+          if constexpr (std::is_same_v<TypeParam, HashedChunkedWaveletOctree>) {
+            // NOTE: The chunked map's leaf visitor decompresses all children
+            //       at once, whereas the accelerator decompresses one child at
+            //       a time. We therefore allow for rounding errors
+            //       proportional to the value's magnitude.
+            EXPECT_NEAR(query_accelerator.getCellValue(index), value,
+                        kEpsilon * (1.f + std::abs(value)));
+          } else {
+            EXPECT_NEAR(query_accelerator.getCellValue(index), value,
+                        kEpsilon);
+          }
         });
 
     // Test random indices
     const IndexElement tree_height = map.getTreeHeight();
-    auto random_offsets = getRandomIndexVector<3>(Index3D::Constant(-10),
-                                                  Index3D::Constant(10), 2, 10);
+    auto random_offsets = GeometryGenerator::getRandomIndexVector<3>(
+        Index3D::Constant(-10), Index3D::Constant(10), 2, 10);
     random_offsets.emplace_back(Index3D::Zero());
     OctreeIndex previous_index{};
     for (const Index3D& index : random_indices) {
       for (const Index3D& offset : random_offsets) {
-        const IndexElement height = getRandomInteger(0, tree_height);
+        const IndexElement height =
+            TestFixture::getRandomInteger(0, tree_height);
         const auto node_index =
             OctreeIndex{0, index + offset}.computeParentIndex(height);
         EXPECT_NEAR(query_accelerator.getCellValue(node_index),
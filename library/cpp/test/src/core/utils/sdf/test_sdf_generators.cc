@@ -1,22 +1,48 @@
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "wavemap/core/common.h"
+#include "wavemap/core/indexing/index_hashes.h"
 #include "wavemap/core/map/hashed_blocks.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
 #include "wavemap/core/map/hashed_wavelet_octree.h"
 #include "wavemap/core/utils/sdf/full_euclidean_sdf_generator.h"
 #include "wavemap/core/utils/sdf/quasi_euclidean_sdf_generator.h"
+#include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/test/config_generator.h"
 #include "wavemap/test/fixture_base.h"
 #include "wavemap/test/geometry_generator.h"
 
 namespace wavemap {
+// Quasi-Euclidean SDF generator that always runs in parallel, such that the
+// typed tests also cover its parallel implementation
+class ParallelQuasiEuclideanSDFGenerator : public QuasiEuclideanSDFGenerator {
+ public:
+  using QuasiEuclideanSDFGenerator::QuasiEuclideanSDFGenerator;
+
+  template <typename HashedMapT>
+  HashedBlocks generate(const HashedMapT& occupancy_map) const {
+    return QuasiEuclideanSDFGenerator::generate(occupancy_map,
+                                                thread_pool_.get());
+  }
+
+ private:
+  const std::shared_ptr<ThreadPool> thread_pool_ =
+      std::make_shared<ThreadPool>(4);
+};
+
 template <typename T>
 class SdfGeneratorTest : public FixtureBase,
                          public GeometryGenerator,
                          public ConfigGenerator {};
 
 using SdfGeneratorTypes =
-    ::testing::Types<QuasiEuclideanSDFGenerator, FullEuclideanSDFGenerator>;
+    ::testing::Types<QuasiEuclideanSDFGenerator,
+                     ParallelQuasiEuclideanSDFGenerator,
+                     FullEuclideanSDFGenerator>;
 TYPED_TEST_SUITE(SdfGeneratorTest, SdfGeneratorTypes, );
 
 TYPED_TEST(SdfGeneratorTest, BruteForceEquivalence) {
@@ -179,4 +205,225 @@ TYPED_TEST(SdfGeneratorTest, BruteForceEquivalence) {
         });
   }
 }
+
+TYPED_TEST(SdfGeneratorTest, ChunkedOctreeEquivalence) {
+  constexpr int kNumIterations = 2;
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    // Params
+    const Index3D min_index = Index3D::Constant(-20);
+    const Index3D max_index = Index3D::Constant(60);
+    const FloatingPoint kMaxSdfDistance =
+        FixtureBase::getRandomFloat(0.2f, 2.f);
+
+    // Create the same map as a regular and as a chunked octree
+    auto config =
+        ConfigGenerator::getRandomConfig<HashedChunkedWaveletOctree::Config>();
+    config.tree_height = HashedChunkedWaveletOctreeBlock::kChunkHeight;
+    HashedWaveletOctree::Config regular_config;
+    regular_config.min_cell_width = config.min_cell_width;
+    regular_config.min_log_odds = config.min_log_odds;
+    regular_config.max_log_odds = config.max_log_odds;
+    regular_config.tree_height = config.tree_height;
+    HashedWaveletOctree map{regular_config};
+    HashedChunkedWaveletOctree chunked_map{config};
+    for (const auto& block_index :
+         Grid<3>(convert::indexToBlockIndex(min_index, config.tree_height),
+                 convert::indexToBlockIndex(max_index, config.tree_height))) {
+      map.getOrAllocateBlock(block_index).getRootScale() = config.min_log_odds;
+      chunked_map.getOrAllocateBlock(block_index).getRootScale() =
+          config.min_log_odds;
+    }
+    for (const Index3D& index : GeometryGenerator::getRandomIndexVector<3>(
+             50, 100, min_index, max_index)) {
+      map.addToCellValue(index, config.max_log_odds);
+      chunked_map.addToCellValue(index, config.max_log_odds);
+    }
+
+    // Generating the SDF from the chunked octree directly should give the same
+    // result as generating it from the regular octree
+    const TypeParam sdf_generator{kMaxSdfDistance};
+    const auto sdf = sdf_generator.generate(map);
+    const auto chunked_sdf = sdf_generator.generate(chunked_map);
+    sdf.forEachLeaf([&chunked_sdf](const OctreeIndex& node_index,
+                                   FloatingPoint value) {
+      EXPECT_NEAR(chunked_sdf.getCellValue(node_index.position), value,
+                  kEpsilon)
+          << "At index " << print::eigen::oneLine(node_index.position);
+    });
+    chunked_sdf.forEachLeaf(
+        [&sdf](const OctreeIndex& node_index, FloatingPoint chunked_value) {
+          EXPECT_NEAR(chunked_value, sdf.getCellValue(node_index.position),
+                      kEpsilon)
+              << "At index " << print::eigen::oneLine(node_index.position);
+        });
+  }
+}
+
+class QuasiEuclideanSdfGeneratorTest : public SdfGeneratorTest<void> {
+ protected:
+  // Updating the SDF incrementally should yield the same result as
+  // regenerating it from scratch, up to differences caused by the order in
+  // which the cells are propagated
+  static void expectEquivalent(const HashedBlocks& sdf,
+                               const HashedBlocks& sdf_reference) {
+    auto expect_equivalent = [](const Index3D& index, FloatingPoint value,
+                                FloatingPoint reference_value) {
+      EXPECT_EQ(std::signbit(value), std::signbit(reference_value))
+          << "At index " << print::eigen::oneLine(index);
+      EXPECT_NEAR(value, reference_value,
+                  QuasiEuclideanSDFGenerator::kMaxRelativeOverEstimate *
+                          std::abs(reference_value) +
+                      kEpsilon)
+          << "At index " << print::eigen::oneLine(index);
+    };
+    sdf_reference.forEachLeaf([&sdf, &expect_equivalent](
+                                  const OctreeIndex& node_index,
+                                  FloatingPoint reference_value) {
+      expect_equivalent(node_index.position,
+                        sdf.getCellValue(node_index.position), reference_value);
+    });
+    sdf.forEachLeaf([&sdf_reference, &expect_equivalent](
+                        const OctreeIndex& node_index, FloatingPoint value) {
+      expect_equivalent(node_index.position, value,
+                        sdf_reference.getCellValue(node_index.position));
+    });
+  }
+};
+
+TEST_F(QuasiEuclideanSdfGeneratorTest, IncrementalUpdates) {
+  constexpr int kNumIterations = 5;
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    // Params
+    const Index3D min_index = Index3D::Constant(-50);
+    const Index3D max_index = Index3D::Constant(150);
+    const FloatingPoint kMaxSdfDistance = getRandomFloat(0.2f, 1.f);
+
+    // Create a map with random obstacles in free space
+    // NOTE: The block size is limited such that the changes usually only
+    //       affect part of the SDF, instead of triggering a full regeneration.
+    auto config = getRandomConfig<HashedWaveletOctree::Config>();
+    config.tree_height = getRandomInteger(2, 4);
+    HashedWaveletOctree map{config};
+    const IndexElement tree_height = map.getTreeHeight();
+    for (const auto& block_index :
+         Grid<3>(convert::indexToBlockIndex(min_index, tree_height),
+                 convert::indexToBlockIndex(max_index, tree_height))) {
+      map.getOrAllocateBlock(block_index).getRootScale() = config.min_log_odds;
+    }
+    for (const Index3D& index :
+         getRandomIndexVector<3>(200, 400, min_index, max_index)) {
+      map.addToCellValue(index, config.max_log_odds);
+    }
+
+    // Generate the initial SDF
+    const QuasiEuclideanSDFGenerator sdf_generator{kMaxSdfDistance};
+    auto sdf = sdf_generator.generate(map);
+
+    // Add and remove obstacles in a small part of the map, and erase a block
+    std::unordered_set<Index3D, Index3DHash> changed_blocks;
+    const Index3D min_change_index = Index3D::Constant(0);
+    const Index3D max_change_index = Index3D::Constant(10);
+    for (const Index3D& index : getRandomIndexVector<3>(
+             10, 20, min_change_index, max_change_index)) {
+      map.addToCellValue(index, config.max_log_odds);
+      changed_blocks.emplace(convert::indexToBlockIndex(index, tree_height));
+    }
+    for (const Index3D& index : getRandomIndexVector<3>(
+             10, 20, min_change_index, max_change_index)) {
+      map.addToCellValue(index, 2.f * config.min_log_odds);
+      changed_blocks.emplace(convert::indexToBlockIndex(index, tree_height));
+    }
+    const Index3D erased_block_index =
+        convert::indexToBlockIndex(max_index, tree_height);
+    map.eraseBlock(erased_block_index);
+    changed_blocks.emplace(erased_block_index);
+
+    // Update the SDF incrementally and compare it to a regenerated SDF
+    sdf_generator.update(map, {changed_blocks.begin(), changed_blocks.end()},
+                         sdf);
+    const auto sdf_reference = sdf_generator.generate(map);
+    expectEquivalent(sdf, sdf_reference);
+  }
+}
+
+TEST_F(QuasiEuclideanSdfGeneratorTest, IncrementalUpdatesFreedObstacle) {
+  constexpr int kNumIterations = 5;
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    // Params
+    const Index3D min_index = Index3D::Constant(-50);
+    const Index3D max_index = Index3D::Constant(150);
+    const Index3D min_box_index = Index3D::Constant(0);
+    const Index3D max_box_index = Index3D::Constant(15);
+    const FloatingPoint kMaxSdfDistance = getRandomFloat(0.2f, 1.f);
+
+    // Create a map with a solid box and random obstacles in free space
+    auto config = getRandomConfig<HashedWaveletOctree::Config>();
+    config.tree_height = getRandomInteger(2, 4);
+    config.min_log_odds = getRandomFloat(-10.f, -1.f);
+    config.max_log_odds = getRandomFloat(1.f, 10.f);
+    HashedWaveletOctree map{config};
+    const IndexElement tree_height = map.getTreeHeight();
+    for (const auto& block_index :
+         Grid<3>(convert::indexToBlockIndex(min_index, tree_height),
+                 convert::indexToBlockIndex(max_index, tree_height))) {
+      map.getOrAllocateBlock(block_index).getRootScale() = config.min_log_odds;
+    }
+    for (const Index3D& index : Grid<3>(min_box_index, max_box_index)) {
+      map.setCellValue(index, config.max_log_odds);
+    }
+    for (const Index3D& index :
+         getRandomIndexVector<3>(200, 400, min_index, max_index)) {
+      map.setCellValue(index, config.max_log_odds);
+    }
+
+    // Generate the initial SDF
+    const QuasiEuclideanSDFGenerator sdf_generator{kMaxSdfDistance};
+    auto sdf = sdf_generator.generate(map);
+    const HashedBlocks sdf_before_change = sdf;
+
+    // Free the lower half of the box, such that the cells that were inside it
+    // become free and the remaining half's interior gets exposed
+    const Index3D min_freed_index = min_box_index;
+    const Index3D max_freed_index{max_box_index.x(), max_box_index.y(),
+                                  max_box_index.z() / 2};
+    std::unordered_set<Index3D, Index3DHash> changed_blocks;
+    for (const Index3D& index : Grid<3>(min_freed_index, max_freed_index)) {
+      map.setCellValue(index, config.min_log_odds);
+      changed_blocks.emplace(convert::indexToBlockIndex(index, tree_height));
+    }
+    sdf_generator.update(map, {changed_blocks.begin(), changed_blocks.end()},
+                         sdf);
+    const auto sdf_reference = sdf_generator.generate(map);
+    expectEquivalent(sdf, sdf_reference);
+
+    // Make sure the change affected the SDF and that the comparison also
+    // covered free cells further away from the changed cells than the margin
+    // the update uses to bound the region it recomputes
+    const IndexElement margin =
+        static_cast<IndexElement>(
+            std::ceil(kMaxSdfDistance / config.min_cell_width)) +
+        1;
+    size_t num_changed_cells = 0u;
+    size_t num_free_cells_beyond_margin = 0u;
+    sdf_reference.forEachLeaf([&](const OctreeIndex& node_index,
+                                  FloatingPoint reference_value) {
+      const Index3D& index = node_index.position;
+      if (kEpsilon < std::abs(sdf_before_change.getCellValue(index) -
+                              reference_value)) {
+        ++num_changed_cells;
+      }
+      const IndexElement distance_to_change =
+          (min_freed_index - index)
+              .cwiseMax(index - max_freed_index)
+              .maxCoeff();
+      if (margin < distance_to_change && 0.f < reference_value) {
+        ++num_free_cells_beyond_margin;
+        EXPECT_NEAR(sdf.getCellValue(index), reference_value, kEpsilon)
+            << "At index " << print::eigen::oneLine(index);
+      }
+    });
+    EXPECT_GT(num_changed_cells, 0u);
+    EXPECT_GT(num_free_cells_beyond_margin, 0u);
+  }
+}
 }  // namespace wavemap
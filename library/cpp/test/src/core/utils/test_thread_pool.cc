@@ -1,10 +1,14 @@
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <numeric>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+#include "wavemap/core/utils/math/int_math.h"
 #include "wavemap/core/utils/thread_pool.h"
 #include "wavemap/core/utils/time/stopwatch.h"
 
@@ -68,4 +72,110 @@ TEST(ThreadPoolTest, FutureResults) {
     EXPECT_EQ(future.get(), task_idx);
   }
 }
+
+TEST(ThreadPoolTest, DetachedTasks) {
+  constexpr int kNumThreads = 4;
+  ThreadPool pool(kNumThreads);
+
+  // Add the tasks to the pool
+  constexpr int kNumTasks = 1000;
+  std::atomic<int> num_tasks_run{0};
+  for (int task_idx = 0; task_idx < kNumTasks; ++task_idx) {
+    pool.add_detached_task([&num_tasks_run]() { ++num_tasks_run; });
+  }
+  pool.wait_all();
+
+  // Check that all tasks ran exactly once
+  EXPECT_EQ(num_tasks_run, kNumTasks);
+}
+
+TEST(ThreadPoolTest, NestedTasks) {
+  constexpr int kNumThreads = 4;
+  ThreadPool pool(kNumThreads);
+
+  // Add tasks that in turn spawn tasks, including large (heap-stored) ones
+  constexpr int kNumParentTasks = 16;
+  constexpr int kNumChildTasks = 64;
+  std::atomic<int> num_children_run{0};
+  for (int parent_idx = 0; parent_idx < kNumParentTasks; ++parent_idx) {
+    pool.add_detached_task([&pool, &num_children_run]() {
+      for (int child_idx = 0; child_idx < kNumChildTasks; ++child_idx) {
+        std::array<int, 32> payload{};
+        payload.fill(1);
+        pool.add_detached_task([&num_children_run, payload]() {
+          num_children_run += payload.front();
+        });
+      }
+    });
+  }
+  pool.wait_all();
+
+  // Check that waiting also covered the tasks spawned by other tasks
+  EXPECT_EQ(num_children_run, kNumParentTasks * kNumChildTasks);
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+  constexpr int kNumThreads = 3;
+  ThreadPool pool(kNumThreads);
+
+  for (const size_t grain_size : {0, 1, 7, 1000}) {
+    // Run the body for a range that does not start at zero
+    constexpr int kBegin = 5;
+    constexpr int kEnd = 517;
+    std::vector<std::atomic<int>> visit_counts(kEnd);
+    pool.parallel_for(
+        kBegin, kEnd, [&visit_counts](int idx) { ++visit_counts[idx]; },
+        grain_size);
+    pool.wait_all();
+
+    // Check that each index in the range was visited exactly once
+    for (int idx = 0; idx < kEnd; ++idx) {
+      EXPECT_EQ(visit_counts[idx], kBegin <= idx ? 1 : 0)
+          << "For index " << idx << " and grain size " << grain_size;
+    }
+  }
+
+  // Empty ranges should not result in any calls
+  bool called = false;
+  pool.parallel_for(10, 10, [&called](int) { called = true; });
+  pool.parallel_for(10, 0, [&called](int) { called = true; });
+  pool.wait_all();
+  EXPECT_FALSE(called);
+}
+
+// Recursively count the leaves of a full tree, forking one task per child
+int countLeavesRecursive(ThreadPool& pool, int height, int num_children) {
+  if (height == 0) {
+    return 1;
+  }
+  std::vector<int> child_leaf_counts(num_children, 0);
+  ThreadPool::TaskGroup child_tasks(pool);
+  for (int child_idx = 0; child_idx < num_children; ++child_idx) {
+    child_tasks.add_task([&pool, height, num_children,
+                          &child_leaf_count = child_leaf_counts[child_idx]]() {
+      child_leaf_count = countLeavesRecursive(pool, height - 1, num_children);
+    });
+  }
+  child_tasks.wait();
+  return std::accumulate(child_leaf_counts.begin(), child_leaf_counts.end(),
+                         0);
+}
+
+TEST(ThreadPoolTest, NestedTaskGroups) {
+  // NOTE: Use fewer threads than the recursion depth, such that the test would
+  //       deadlock if waiting tasks did not help to execute other tasks.
+  for (const int num_threads : {1, 2, 4}) {
+    ThreadPool pool(num_threads);
+    constexpr int kHeight = 5;
+    constexpr int kNumChildren = 4;
+    EXPECT_EQ(countLeavesRecursive(pool, kHeight, kNumChildren),
+              int_math::exp2(2 * kHeight));
+
+    // Task groups can also be waited for from within another pool task
+    auto future = pool.add_task(
+        [&pool]() { return countLeavesRecursive(pool, kHeight, 2); });
+    EXPECT_EQ(future.get(), int_math::exp2(kHeight));
+    pool.wait_all();
+  }
+}
 }  // namespace wavemap
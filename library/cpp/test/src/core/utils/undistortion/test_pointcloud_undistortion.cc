@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/utils/thread_pool.h"
+#include "wavemap/core/utils/undistortion/pointcloud_undistortion.h"
+#include "wavemap/test/eigen_utils.h"
+#include "wavemap/test/fixture_base.h"
+#include "wavemap/test/geometry_generator.h"
+
+namespace wavemap {
+class PointcloudUndistortionTest : public FixtureBase,
+                                   public GeometryGenerator {
+ protected:
+  static constexpr undistortion::TimeAbsolute kTimeBase = 1000000000u;
+  static constexpr undistortion::TimeOffset kPoseInterval = 20000000u;
+
+  undistortion::StampedPoseBuffer getRandomPoseBuffer(size_t num_poses) {
+    undistortion::StampedPoseBuffer pose_buffer;
+    for (size_t pose_idx = 0; pose_idx < num_poses; ++pose_idx) {
+      pose_buffer.push_back({kTimeBase + pose_idx * kPoseInterval,
+                             getRandomTransformation()});
+    }
+    return pose_buffer;
+  }
+
+  undistortion::StampedPointcloud getRandomStampedPointcloud(
+      size_t num_points, size_t num_time_steps,
+      undistortion::TimeOffset max_time_offset) {
+    undistortion::StampedPointcloud stamped_pointcloud(kTimeBase, "sensor",
+                                                       num_points);
+    for (size_t point_idx = 0; point_idx < num_points; ++point_idx) {
+      const Point3D point = getRandomPoint<3>(0.5f, 20.f);
+      const auto time_step = getRandomInteger<size_t>(0u, num_time_steps - 1u);
+      const auto time_offset = static_cast<undistortion::TimeOffset>(
+          time_step * max_time_offset / (num_time_steps - 1u));
+      stamped_pointcloud.emplace(point.x(), point.y(), point.z(), time_offset);
+    }
+    return stamped_pointcloud;
+  }
+
+  // Reference implementation that interpolates and applies the pose of each
+  // point individually
+  static Pointcloud<> undistortPointwise(
+      const undistortion::StampedPoseBuffer& pose_buffer,
+      undistortion::StampedPointcloud& stamped_pointcloud,
+      const Transformation3D& T_WCmedian) {
+    const auto& points = stamped_pointcloud.getPoints();
+    Pointcloud<> C_points;
+    C_points.resize(points.size());
+    for (size_t idx = 0; idx < points.size(); ++idx) {
+      const undistortion::TimeAbsolute time =
+          stamped_pointcloud.getTimeBase() + points[idx].time_offset;
+      size_t pose_left_idx = 0u;
+      while (pose_buffer[pose_left_idx + 1].stamp < time &&
+             pose_left_idx + 2 < pose_buffer.size()) {
+        ++pose_left_idx;
+      }
+      const auto& [time_left, T_WCleft] = pose_buffer[pose_left_idx];
+      const auto& [time_right, T_WCright] = pose_buffer[pose_left_idx + 1];
+      const FloatingPoint a =
+          static_cast<FloatingPoint>(time - time_left) /
+          static_cast<FloatingPoint>(time_right - time_left);
+      const Transformation3D T_WCi =
+          interpolateComponentwise(T_WCleft, T_WCright, a);
+      C_points[static_cast<Eigen::Index>(idx)] =
+          T_WCmedian.inverse() * (T_WCi * points[idx].position);
+    }
+    return C_points;
+  }
+};
+
+TEST_F(PointcloudUndistortionTest, SerialAndParallel) {
+  constexpr int kNumRepetitions = 3;
+  constexpr FloatingPoint kTolerance = 1e-4f;
+  ThreadPool thread_pool;
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    const auto num_poses = getRandomInteger<size_t>(2u, 10u);
+    const auto pose_buffer = getRandomPoseBuffer(num_poses);
+    const auto max_time_offset =
+        static_cast<undistortion::TimeOffset>((num_poses - 1u) * kPoseInterval);
+    const size_t num_points = getRandomInteger<size_t>(
+        4 * undistortion::kMinNumPointsPerTask,
+        8 * undistortion::kMinNumPointsPerTask);
+    const size_t num_time_steps = getRandomInteger<size_t>(2u, 2048u);
+    auto stamped_pointcloud = getRandomStampedPointcloud(
+        num_points, num_time_steps, max_time_offset);
+
+    const auto serial_result =
+        undistortion::compensate_motion(pose_buffer, stamped_pointcloud);
+    const auto parallel_result = undistortion::compensate_motion(
+        pose_buffer, stamped_pointcloud, &thread_pool);
+    ASSERT_EQ(serial_result.size(), num_points);
+    ASSERT_EQ(parallel_result.size(), num_points);
+
+    // The parallel implementation should match the serial one exactly
+    EXPECT_TRUE(parallel_result.getPose().getTransformationMatrix() ==
+                serial_result.getPose().getTransformationMatrix());
+    EXPECT_TRUE(parallel_result.getPointsLocal().data() ==
+                serial_result.getPointsLocal().data());
+
+    // The undistorted points should match the pointwise reference
+    const Transformation3D& T_WCmedian = serial_result.getPose();
+    const Pointcloud<> reference_points =
+        undistortPointwise(pose_buffer, stamped_pointcloud, T_WCmedian);
+    for (Eigen::Index idx = 0; idx < static_cast<Eigen::Index>(num_points);
+         ++idx) {
+      EXPECT_EIGEN_NEAR(serial_result.getPointsLocal()[idx],
+                        reference_points[idx], kTolerance);
+    }
+  }
+}
+}  // namespace wavemap
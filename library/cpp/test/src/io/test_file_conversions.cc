@@ -54,31 +54,16 @@ TYPED_TEST(FileConversionsTest, MetadataPreservation) {
       io::fileToMap(TestFixture::kTemporaryFilePath, map_base_round_trip));
   ASSERT_TRUE(map_base_round_trip);
 
-  // TODO(victorr): Add option to deserialize into hashed chunked wavelet
-  //                octrees, instead of implicitly converting them to regular
-  //                hashed wavelet octrees.
-  if constexpr (std::is_same_v<TypeParam, HashedChunkedWaveletOctree>) {
-    HashedWaveletOctree::ConstPtr map_round_trip =
-        std::dynamic_pointer_cast<HashedWaveletOctree>(map_base_round_trip);
-    ASSERT_TRUE(map_round_trip);
-
-    // Check that the metadata still matches the original config
-    EXPECT_EQ(map_round_trip->getMinCellWidth(), config.min_cell_width);
-    EXPECT_EQ(map_round_trip->getMinLogOdds(), config.min_log_odds);
-    EXPECT_EQ(map_round_trip->getMaxLogOdds(), config.max_log_odds);
+  typename TypeParam::ConstPtr map_round_trip =
+      std::dynamic_pointer_cast<TypeParam>(map_base_round_trip);
+  ASSERT_TRUE(map_round_trip);
+
+  // Check that the metadata still matches the original config
+  EXPECT_EQ(map_round_trip->getMinCellWidth(), config.min_cell_width);
+  EXPECT_EQ(map_round_trip->getMinLogOdds(), config.min_log_odds);
+  EXPECT_EQ(map_round_trip->getMaxLogOdds(), config.max_log_odds);
+  if constexpr (!std::is_same_v<TypeParam, HashedBlocks>) {
     EXPECT_EQ(map_round_trip->getTreeHeight(), config.tree_height);
-  } else {
-    typename TypeParam::ConstPtr map_round_trip =
-        std::dynamic_pointer_cast<TypeParam>(map_base_round_trip);
-    ASSERT_TRUE(map_round_trip);
-
-    // Check that the metadata still matches the original config
-    EXPECT_EQ(map_round_trip->getMinCellWidth(), config.min_cell_width);
-    EXPECT_EQ(map_round_trip->getMinLogOdds(), config.min_log_odds);
-    EXPECT_EQ(map_round_trip->getMaxLogOdds(), config.max_log_odds);
-    if constexpr (!std::is_same_v<TypeParam, HashedBlocks>) {
-      EXPECT_EQ(map_round_trip->getTreeHeight(), config.tree_height);
-    }
   }
 }
 
@@ -120,36 +105,54 @@ TYPED_TEST(FileConversionsTest, InsertionAndLeafVisitor) {
           }
         });
 
-    // TODO(victorr): Remove this special case once deserializing directly
-    //                into HashedChunkedWaveletOctrees is supported
-    if (std::is_same_v<TypeParam, HashedChunkedWaveletOctree>) {
-      HashedWaveletOctree::ConstPtr map_round_trip =
-          std::dynamic_pointer_cast<HashedWaveletOctree>(map_base_round_trip);
-      ASSERT_TRUE(map_round_trip);
+    typename TypeParam::ConstPtr map_round_trip =
+        std::dynamic_pointer_cast<TypeParam>(map_base_round_trip);
+    ASSERT_TRUE(map_round_trip);
 
-      map_original.forEachLeaf([&map_round_trip](const OctreeIndex& node_index,
-                                                 FloatingPoint original_value) {
+    map_original.forEachLeaf([&map_round_trip](const OctreeIndex& node_index,
+                                               FloatingPoint original_value) {
+      if constexpr (std::is_same_v<TypeParam, HashedBlocks>) {
+        EXPECT_EQ(node_index.height, 0);
+        EXPECT_NEAR(original_value,
+                    map_round_trip->getValueOrDefault(node_index.position),
+                    TestFixture::kAcceptableReconstructionError);
+      } else {
         EXPECT_NEAR(original_value, map_round_trip->getCellValue(node_index),
                     TestFixture::kAcceptableReconstructionError);
-      });
-    } else {
-      typename TypeParam::ConstPtr map_round_trip =
-          std::dynamic_pointer_cast<TypeParam>(map_base_round_trip);
-      ASSERT_TRUE(map_round_trip);
-
-      map_original.forEachLeaf([&map_round_trip](const OctreeIndex& node_index,
-                                                 FloatingPoint original_value) {
-        if constexpr (std::is_same_v<TypeParam, HashedBlocks>) {
-          EXPECT_EQ(node_index.height, 0);
-          EXPECT_NEAR(original_value,
-                      map_round_trip->getValueOrDefault(node_index.position),
-                      TestFixture::kAcceptableReconstructionError);
-        } else {
-          EXPECT_NEAR(original_value, map_round_trip->getCellValue(node_index),
-                      TestFixture::kAcceptableReconstructionError);
-        }
-      });
-    }
+      }
+    });
   }
 }
+
+using HashedChunkedWaveletOctreeFileTest = FileConversionsTest<void>;
+TEST_F(HashedChunkedWaveletOctreeFileTest, LosslessRoundTrip) {
+  // Create a random map
+  HashedChunkedWaveletOctree map_original(
+      getRandomConfig<HashedChunkedWaveletOctree::Config>());
+  for (const Index3D& index : getRandomIndexVector<3>(
+           1000u, 2000u, Index3D::Constant(-5000), Index3D::Constant(5000))) {
+    map_original.addToCellValue(index, getRandomUpdate());
+  }
+
+  // Serialize and deserialize
+  ASSERT_TRUE(io::mapToFile(map_original, kTemporaryFilePath));
+  MapBase::Ptr map_base_round_trip;
+  ASSERT_TRUE(io::fileToMap(kTemporaryFilePath, map_base_round_trip));
+  HashedChunkedWaveletOctree::ConstPtr map_round_trip =
+      std::dynamic_pointer_cast<HashedChunkedWaveletOctree>(
+          map_base_round_trip);
+  ASSERT_TRUE(map_round_trip);
+
+  // The chunked format stores the chunks as they are, so the maps should match
+  // exactly
+  EXPECT_EQ(map_round_trip->size(), map_original.size());
+  EXPECT_EQ(map_round_trip->getHashMap().size(),
+            map_original.getHashMap().size());
+  map_original.forEachLeaf(
+      [&map_original, &map_round_trip](const OctreeIndex& node_index,
+                                       FloatingPoint /*original_value*/) {
+        EXPECT_EQ(map_original.getCellValue(node_index),
+                  map_round_trip->getCellValue(node_index));
+      });
+}
 }  // namespace wavemap
@@ -0,0 +1,133 @@
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/map/hashed_chunked_wavelet_octree.h"
+#include "wavemap/core/map/hashed_wavelet_octree.h"
+#include "wavemap/core/map/map_base.h"
+#include "wavemap/io/file_conversions.h"
+#include "wavemap/io/mapped_hashed_wavelet_octree.h"
+#include "wavemap/io/stream_conversions.h"
+#include "wavemap/test/config_generator.h"
+#include "wavemap/test/fixture_base.h"
+#include "wavemap/test/geometry_generator.h"
+
+namespace wavemap {
+template <typename MapType>
+class MappedHashedWaveletOctreeTest : public FixtureBase,
+                                      public GeometryGenerator,
+                                      public ConfigGenerator {
+ protected:
+  static constexpr FloatingPoint kAcceptableReconstructionError = 5e-2f;
+  static constexpr auto kTemporaryFilePath = "/tmp/tmp_indexed.wvmp";
+
+  typename MapType::Ptr getRandomMap() {
+    auto map = std::make_shared<MapType>(
+        getRandomConfig<typename MapType::Config>());
+    const std::vector<Index3D> random_indices = getRandomIndexVector<3>(
+        1000u, 2000u, Index3D::Constant(-5000), Index3D::Constant(5000));
+    for (const Index3D& index : random_indices) {
+      map->addToCellValue(index, getRandomUpdate());
+    }
+    map->prune();
+    return map;
+  }
+};
+
+using MapTypes =
+    ::testing::Types<HashedWaveletOctree, HashedChunkedWaveletOctree>;
+TYPED_TEST_SUITE(MappedHashedWaveletOctreeTest, MapTypes, );
+
+TYPED_TEST(MappedHashedWaveletOctreeTest, RegularLoaderCompatibility) {
+  constexpr int kNumRepetitions = 3;
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    const auto map_original = TestFixture::getRandomMap();
+
+    // Write the map in the indexed format and read it with the regular loader
+    ASSERT_TRUE(
+        io::mapToIndexedFile(*map_original, TestFixture::kTemporaryFilePath));
+    MapBase::Ptr map_base_round_trip;
+    ASSERT_TRUE(
+        io::fileToMap(TestFixture::kTemporaryFilePath, map_base_round_trip));
+    HashedWaveletOctree::ConstPtr map_round_trip =
+        std::dynamic_pointer_cast<HashedWaveletOctree>(map_base_round_trip);
+    ASSERT_TRUE(map_round_trip);
+
+    map_original->forEachLeaf([&map_round_trip](const OctreeIndex& node_index,
+                                               FloatingPoint original_value) {
+      EXPECT_NEAR(original_value, map_round_trip->getCellValue(node_index),
+                  TestFixture::kAcceptableReconstructionError);
+    });
+  }
+}
+
+TYPED_TEST(MappedHashedWaveletOctreeTest, StreamPositioning) {
+  const auto map_original = TestFixture::getRandomMap();
+
+  // Embed the indexed map in a larger stream
+  constexpr int kSentinel = 42;
+  std::stringstream stream;
+  ASSERT_TRUE(io::mapToIndexedStream(*map_original, stream));
+  stream << kSentinel;
+
+  // Make sure the regular loader stops reading at the end of the map
+  MapBase::Ptr map_round_trip;
+  ASSERT_TRUE(io::streamToMap(stream, map_round_trip));
+  int sentinel = 0;
+  stream >> sentinel;
+  EXPECT_EQ(sentinel, kSentinel);
+}
+
+TYPED_TEST(MappedHashedWaveletOctreeTest, LazyLoading) {
+  constexpr int kNumRepetitions = 3;
+  for (int i = 0; i < kNumRepetitions; ++i) {
+    const auto map_original = TestFixture::getRandomMap();
+    ASSERT_TRUE(
+        io::mapToIndexedFile(*map_original, TestFixture::kTemporaryFilePath));
+
+    // Opening the map should not load any blocks
+    auto map_mapped =
+        io::MappedHashedWaveletOctree::open(TestFixture::kTemporaryFilePath);
+    ASSERT_TRUE(map_mapped);
+    EXPECT_EQ(map_mapped->getNumLoadedBlocks(), 0u);
+    EXPECT_EQ(map_mapped->getMinCellWidth(), map_original->getMinCellWidth());
+    EXPECT_EQ(map_mapped->getTreeHeight(), map_original->getTreeHeight());
+    EXPECT_EQ(map_mapped->getMinIndex(), map_original->getMinIndex());
+    EXPECT_EQ(map_mapped->getMaxIndex(), map_original->getMaxIndex());
+
+    // Querying a cell should only load the block that contains it
+    const Index3D query_index = TestFixture::getRandomIndex(
+        map_original->getMinIndex(), map_original->getMaxIndex());
+    const auto block_index =
+        map_mapped->indexToBlockIndex(OctreeIndex{0, query_index});
+    EXPECT_NEAR(map_mapped->getCellValue(query_index),
+                map_original->getCellValue(query_index),
+                TestFixture::kAcceptableReconstructionError);
+    const size_t expected_num_loaded_blocks =
+        map_mapped->hasBlock(block_index) ? 1u : 0u;
+    EXPECT_EQ(map_mapped->getNumLoadedBlocks(), expected_num_loaded_blocks);
+    EXPECT_EQ(map_mapped->isBlockLoaded(block_index),
+              map_mapped->hasBlock(block_index));
+
+    // Check that all leaves match
+    map_original->forEachLeaf([&map_mapped](const OctreeIndex& node_index,
+                                           FloatingPoint original_value) {
+      EXPECT_NEAR(original_value, map_mapped->getCellValue(node_index),
+                  TestFixture::kAcceptableReconstructionError);
+    });
+    map_mapped->loadAllBlocks();
+    EXPECT_EQ(map_mapped->getNumLoadedBlocks(),
+              map_original->getHashMap().size());
+  }
+}
+
+TYPED_TEST(MappedHashedWaveletOctreeTest, RejectsRegularFormat) {
+  const auto map_original = TestFixture::getRandomMap();
+  ASSERT_TRUE(io::mapToFile(*map_original, TestFixture::kTemporaryFilePath));
+  EXPECT_FALSE(
+      io::MappedHashedWaveletOctree::open(TestFixture::kTemporaryFilePath));
+}
+}  // namespace wavemap
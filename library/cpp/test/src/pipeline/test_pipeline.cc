@@ -0,0 +1,344 @@
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wavemap/core/common.h"
+#include "wavemap/core/data_structure/image.h"
+#include "wavemap/core/data_structure/pointcloud.h"
+#include "wavemap/core/integrator/integrator_base.h"
+#include "wavemap/core/map/hashed_wavelet_octree.h"
+#include "wavemap/pipeline/map_operations/map_operation_base.h"
+#include "wavemap/pipeline/pipeline.h"
+#include "wavemap/test/fixture_base.h"
+
+namespace wavemap {
+// Integrator that blocks until it is opened, such that tests can control how
+// many measurements pile up in the async pipeline's queue
+class GatedIntegrator : public IntegratorBase {
+ public:
+  struct Gate {
+    std::mutex mutex;
+    std::condition_variable opened_or_started;
+    bool is_open = false;
+    int num_started = 0;
+    int num_finished = 0;
+
+    void open() {
+      {
+        std::lock_guard lock(mutex);
+        is_open = true;
+      }
+      opened_or_started.notify_all();
+    }
+    void waitUntilStarted(int num_measurements) {
+      std::unique_lock lock(mutex);
+      opened_or_started.wait(lock, [this, num_measurements]() {
+        return num_measurements <= num_started;
+      });
+    }
+    int getNumFinished() {
+      std::lock_guard lock(mutex);
+      return num_finished;
+    }
+  };
+
+  explicit GatedIntegrator(std::shared_ptr<Gate> gate)
+      : gate_(std::move(gate)) {}
+
+  void integrate(const PosedPointcloud<>& /*pointcloud*/) override { pass(); }
+  void integrate(const PosedImage<>& /*range_image*/) override { pass(); }
+
+ private:
+  const std::shared_ptr<Gate> gate_;
+
+  void pass() {
+    std::unique_lock lock(gate_->mutex);
+    ++gate_->num_started;
+    gate_->opened_or_started.notify_all();
+    gate_->opened_or_started.wait(lock, [this]() { return gate_->is_open; });
+    ++gate_->num_finished;
+  }
+};
+
+// Map operation that blocks until its gate is opened, such that tests can
+// control when the async pipeline's map worker finishes a measurement
+class GatedOperation : public MapOperationBase {
+ public:
+  GatedOperation(MapBase::Ptr occupancy_map,
+                 std::shared_ptr<GatedIntegrator::Gate> gate)
+      : MapOperationBase(std::move(occupancy_map)), gate_(std::move(gate)) {}
+
+  void run(bool /*force_run*/) override {
+    std::unique_lock lock(gate_->mutex);
+    ++gate_->num_started;
+    gate_->opened_or_started.notify_all();
+    gate_->opened_or_started.wait(lock, [this]() { return gate_->is_open; });
+    ++gate_->num_finished;
+  }
+
+ private:
+  const std::shared_ptr<GatedIntegrator::Gate> gate_;
+};
+
+class PipelineTest : public FixtureBase {
+ protected:
+  static constexpr auto kIntegratorName = "gated_integrator";
+  static constexpr size_t kMaxQueueSize = 2;
+
+  std::shared_ptr<GatedIntegrator::Gate> gate_ =
+      std::make_shared<GatedIntegrator::Gate>();
+  const PosedPointcloud<> measurement_{Transformation3D{}};
+
+  // Measurements submitted to the async pipeline and their outcomes
+  std::vector<std::future<bool>> futures_;
+  std::mutex callback_mutex_;
+  std::vector<std::optional<bool>> callback_results_;
+
+  std::unique_ptr<Pipeline> createPipeline() {
+    auto pipeline = std::make_unique<Pipeline>(
+        std::make_shared<HashedWaveletOctree>(HashedWaveletOctreeConfig{}));
+    pipeline->addIntegrator(kIntegratorName,
+                            std::make_unique<GatedIntegrator>(gate_));
+    return pipeline;
+  }
+
+  void submit(Pipeline& pipeline,
+              const std::string& integrator_name = kIntegratorName) {
+    size_t measurement_idx;
+    {
+      std::lock_guard lock(callback_mutex_);
+      measurement_idx = callback_results_.size();
+      callback_results_.emplace_back();
+    }
+    futures_.emplace_back(pipeline.runPipelineAsync(
+        {integrator_name}, measurement_, [this, measurement_idx](bool success) {
+          std::lock_guard lock(callback_mutex_);
+          callback_results_[measurement_idx] = success;
+        }));
+  }
+
+  bool isReady(size_t measurement_idx) {
+    return futures_[measurement_idx].wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
+  // Fill the queue while the first measurement is being integrated
+  void fillQueue(Pipeline& pipeline) {
+    submit(pipeline);
+    gate_->waitUntilStarted(1);
+    for (size_t queue_idx = 0; queue_idx < kMaxQueueSize; ++queue_idx) {
+      submit(pipeline);
+    }
+    EXPECT_EQ(pipeline.getAsyncStats().queue_depth, kMaxQueueSize);
+  }
+
+  // Check that the futures and callbacks report the expected outcomes
+  void expectResults(const std::vector<bool>& expected_results) {
+    ASSERT_EQ(futures_.size(), expected_results.size());
+    for (size_t measurement_idx = 0; measurement_idx < futures_.size();
+         ++measurement_idx) {
+      const bool expected_result = expected_results[measurement_idx];
+      EXPECT_EQ(futures_[measurement_idx].get(), expected_result)
+          << "For measurement " << measurement_idx;
+      std::lock_guard lock(callback_mutex_);
+      ASSERT_TRUE(callback_results_[measurement_idx].has_value())
+          << "For measurement " << measurement_idx;
+      EXPECT_EQ(callback_results_[measurement_idx].value(), expected_result)
+          << "For measurement " << measurement_idx;
+    }
+  }
+};
+
+TEST_F(PipelineTest, AsyncDropOldest) {
+  auto pipeline = createPipeline();
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kDropOldest});
+  fillQueue(*pipeline);
+
+  // Adding a measurement to the full queue drops the oldest queued one
+  submit(*pipeline);
+  EXPECT_TRUE(isReady(1));
+  EXPECT_FALSE(isReady(3));
+  EXPECT_EQ(pipeline->getAsyncStats().num_dropped, 1u);
+
+  gate_->open();
+  pipeline->waitForAsync();
+  expectResults({true, false, true, true});
+  const PipelineAsyncStats stats = pipeline->getAsyncStats();
+  EXPECT_EQ(stats.num_submitted, 4u);
+  EXPECT_EQ(stats.num_processed, 3u);
+  EXPECT_EQ(stats.num_dropped, 1u);
+  EXPECT_EQ(stats.queue_depth, 0u);
+  EXPECT_EQ(stats.max_queue_depth, kMaxQueueSize);
+  EXPECT_EQ(gate_->getNumFinished(), 3);
+}
+
+TEST_F(PipelineTest, AsyncDropNewest) {
+  auto pipeline = createPipeline();
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kDropNewest});
+  fillQueue(*pipeline);
+
+  // Adding a measurement to the full queue drops the new measurement
+  submit(*pipeline);
+  EXPECT_TRUE(isReady(3));
+  EXPECT_FALSE(isReady(1));
+  EXPECT_EQ(pipeline->getAsyncStats().num_dropped, 1u);
+
+  gate_->open();
+  pipeline->waitForAsync();
+  expectResults({true, true, true, false});
+  const PipelineAsyncStats stats = pipeline->getAsyncStats();
+  EXPECT_EQ(stats.num_submitted, 4u);
+  EXPECT_EQ(stats.num_processed, 3u);
+  EXPECT_EQ(stats.num_dropped, 1u);
+  EXPECT_EQ(stats.queue_depth, 0u);
+  EXPECT_EQ(stats.max_queue_depth, kMaxQueueSize);
+  EXPECT_EQ(gate_->getNumFinished(), 3);
+}
+
+TEST_F(PipelineTest, AsyncBlock) {
+  auto pipeline = createPipeline();
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kBlock});
+  fillQueue(*pipeline);
+
+  // Adding a measurement to the full queue blocks until space frees up
+  auto blocked_submission =
+      std::async(std::launch::async, [this, &pipeline]() { submit(*pipeline); });
+  EXPECT_EQ(blocked_submission.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  gate_->open();
+  blocked_submission.get();
+
+  pipeline->waitForAsync();
+  expectResults({true, true, true, true});
+  const PipelineAsyncStats stats = pipeline->getAsyncStats();
+  EXPECT_EQ(stats.num_submitted, 4u);
+  EXPECT_EQ(stats.num_processed, 4u);
+  EXPECT_EQ(stats.num_dropped, 0u);
+  EXPECT_EQ(stats.queue_depth, 0u);
+  EXPECT_LE(stats.max_queue_depth, kMaxQueueSize);
+  EXPECT_LT(0.f, stats.last_latency);
+  EXPECT_LE(stats.mean_latency, stats.max_latency);
+  EXPECT_EQ(gate_->getNumFinished(), 4);
+}
+
+TEST_F(PipelineTest, AsyncMissingIntegrator) {
+  auto pipeline = createPipeline();
+  gate_->open();
+  submit(*pipeline, "missing_integrator");
+  pipeline->waitForAsync();
+  expectResults({false});
+  EXPECT_EQ(pipeline->getAsyncStats().num_processed, 1u);
+  EXPECT_EQ(pipeline->getAsyncStats().num_dropped, 0u);
+  EXPECT_EQ(gate_->getNumFinished(), 0);
+}
+
+TEST_F(PipelineTest, SyncCallsWaitForAsync) {
+  auto pipeline = createPipeline();
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kBlock});
+  fillQueue(*pipeline);
+
+  // Synchronous calls first finish all queued measurements
+  auto sync_call = std::async(std::launch::async, [this, &pipeline]() {
+    return pipeline->runPipeline({kIntegratorName}, measurement_);
+  });
+  EXPECT_EQ(sync_call.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  gate_->open();
+  EXPECT_TRUE(sync_call.get());
+  EXPECT_EQ(pipeline->getAsyncStats().num_processed, 3u);
+  EXPECT_EQ(gate_->getNumFinished(), 4);
+  expectResults({true, true, true});
+}
+
+TEST_F(PipelineTest, AsyncAccessorsWaitForAsync) {
+  auto pipeline = createPipeline();
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kBlock});
+  fillQueue(*pipeline);
+
+  // Accessing the integrators first finishes all queued measurements
+  auto access = std::async(std::launch::async, [&pipeline]() {
+    return pipeline->hasIntegrator(kIntegratorName) &&
+           pipeline->getIntegrator(kIntegratorName) != nullptr;
+  });
+  EXPECT_EQ(access.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  gate_->open();
+  EXPECT_TRUE(access.get());
+  EXPECT_EQ(pipeline->getAsyncStats().num_processed, 3u);
+  expectResults({true, true, true});
+}
+
+TEST_F(PipelineTest, AsyncImportOverlapsOperations) {
+  auto pipeline = createPipeline();
+  auto operation_gate = std::make_shared<GatedIntegrator::Gate>();
+  pipeline->addOperation(std::make_unique<GatedOperation>(
+      std::make_shared<HashedWaveletOctree>(HashedWaveletOctreeConfig{}),
+      operation_gate));
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kBlock});
+  gate_->open();
+
+  // While the map operations run for the first measurement, the second one
+  // is taken from the queue and imported, while the third one waits until the
+  // map was updated with the second one
+  submit(*pipeline);
+  operation_gate->waitUntilStarted(1);
+  submit(*pipeline);
+  submit(*pipeline);
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (1u < pipeline->getAsyncStats().queue_depth &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(pipeline->getAsyncStats().queue_depth, 1u);
+  EXPECT_EQ(pipeline->getAsyncStats().num_processed, 0u);
+  EXPECT_EQ(gate_->getNumFinished(), 1);
+
+  operation_gate->open();
+  pipeline->waitForAsync();
+  expectResults({true, true, true});
+  EXPECT_EQ(gate_->getNumFinished(), 3);
+  EXPECT_EQ(operation_gate->getNumFinished(), 3);
+}
+
+TEST_F(PipelineTest, AsyncShutdown) {
+  auto pipeline = createPipeline();
+  pipeline->startAsync({kMaxQueueSize, QueueDropPolicy::kBlock});
+  fillQueue(*pipeline);
+  EXPECT_TRUE(pipeline->isAsync());
+
+  // Destroying the pipeline finishes all queued measurements, then stops
+  auto destruction =
+      std::async(std::launch::async, [&pipeline]() { pipeline.reset(); });
+  gate_->open();
+  destruction.get();
+  expectResults({true, true, true});
+  EXPECT_EQ(gate_->getNumFinished(), 3);
+}
+
+TEST_F(PipelineTest, AsyncRestart) {
+  auto pipeline = createPipeline();
+  gate_->open();
+
+  // The worker starts on first use and can be stopped and restarted
+  EXPECT_FALSE(pipeline->isAsync());
+  submit(*pipeline);
+  EXPECT_TRUE(pipeline->isAsync());
+  pipeline->stopAsync();
+  EXPECT_FALSE(pipeline->isAsync());
+  submit(*pipeline);
+  EXPECT_TRUE(pipeline->isAsync());
+  pipeline->waitForAsync();
+  expectResults({true, true});
+  EXPECT_EQ(pipeline->getAsyncStats().num_processed, 2u);
+}
+}  // namespace wavemap
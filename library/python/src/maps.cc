@@ -1,6 +1,7 @@
 #include "pywavemap/maps.h"
 
 #include <memory>
+#include <vector>
 
 #include <nanobind/eigen/dense.h>
 #include <nanobind/stl/filesystem.h>
@@ -9,6 +10,7 @@
 #include <wavemap/core/map/hashed_wavelet_octree.h>
 #include <wavemap/core/map/map_base.h>
 #include <wavemap/core/map/map_factory.h>
+#include <wavemap/core/utils/query/batch_query.h>
 #include <wavemap/core/utils/query/map_interpolator.h>
 #include <wavemap/core/utils/query/query_accelerator.h>
 #include <wavemap/io/file_conversions.h>
@@ -123,26 +125,26 @@ void add_map_bindings(nb::module_& m) {
           [](const HashedWaveletOctree& self,
              const nb::ndarray<IndexElement, nb::shape<-1, 3>, nb::device::cpu>&
                  indices) {
-            // Create a query accelerator
-            QueryAccelerator<HashedWaveletOctree> query_accelerator{self};
             // Create nb::ndarray view for efficient access to the query indices
             const auto index_view = indices.view();
             const auto num_queries = index_view.shape(0);
-            // Create the raw results array and wrap it in a Python capsule that
+            std::vector<Index3D> query_indices(num_queries);
+            for (size_t query_idx = 0; query_idx < num_queries; ++query_idx) {
+              query_indices[query_idx] = {index_view(query_idx, 0),
+                                          index_view(query_idx, 1),
+                                          index_view(query_idx, 2)};
+            }
+            // Create the results vector and wrap it in a Python capsule that
             // deallocates it when all references to it expire
-            auto* results = new float[num_queries];
+            auto* results = new std::vector<FloatingPoint>();
             nb::capsule owner(results, [](void* p) noexcept {
-              delete[] reinterpret_cast<float*>(p);
+              delete reinterpret_cast<std::vector<FloatingPoint>*>(p);
             });
-            // Compute the interpolated values
-            for (size_t query_idx = 0; query_idx < num_queries; ++query_idx) {
-              results[query_idx] = query_accelerator.getCellValue(
-                  {index_view(query_idx, 0), index_view(query_idx, 1),
-                   index_view(query_idx, 2)});
-            }
+            // Compute the values, processing the queries block by block
+            query::getCellValues(self, query_indices, *results);
             // Return results as numpy array
             return nb::ndarray<nb::numpy, float>{
-                results, {num_queries, 1u}, owner};
+                results->data(), {num_queries, 1u}, owner};
           },
           "index_list"_a,
           "Query the map at the given indices, provided as a matrix with one "
@@ -152,28 +154,27 @@ void add_map_bindings(nb::module_& m) {
           [](const HashedWaveletOctree& self,
              const nb::ndarray<IndexElement, nb::shape<-1, 4>, nb::device::cpu>&
                  indices) {
-            // Create a query accelerator
-            QueryAccelerator<HashedWaveletOctree> query_accelerator{self};
             // Create nb::ndarray view for efficient access to the query indices
             auto index_view = indices.view();
             const auto num_queries = index_view.shape(0);
-            // Create the raw results array and wrap it in a Python capsule that
-            // deallocates it when all references to it expire
-            auto* results = new float[num_queries];
-            nb::capsule owner(results, [](void* p) noexcept {
-              delete[] reinterpret_cast<float*>(p);
-            });
-            // Compute the interpolated values
+            std::vector<OctreeIndex> query_node_indices(num_queries);
             for (size_t query_idx = 0; query_idx < num_queries; ++query_idx) {
-              const OctreeIndex node_index{
+              query_node_indices[query_idx] = {
                   index_view(query_idx, 0),
                   {index_view(query_idx, 1), index_view(query_idx, 2),
                    index_view(query_idx, 3)}};
-              results[query_idx] = query_accelerator.getCellValue(node_index);
             }
+            // Create the results vector and wrap it in a Python capsule that
+            // deallocates it when all references to it expire
+            auto* results = new std::vector<FloatingPoint>();
+            nb::capsule owner(results, [](void* p) noexcept {
+              delete reinterpret_cast<std::vector<FloatingPoint>*>(p);
+            });
+            // Compute the values, processing the queries block by block
+            query::getCellValues(self, query_node_indices, *results);
             // Return results as numpy array
             return nb::ndarray<nb::numpy, float>{
-                results, {num_queries, 1u}, owner};
+                results->data(), {num_queries, 1u}, owner};
           },
           "node_index_list"_a,
           "Query the map at the given node indices, provided as a matrix with "
@@ -252,6 +253,65 @@ void add_map_bindings(nb::module_& m) {
                &HashedChunkedWaveletOctree::getCellValue, nb::const_),
            "node_index"_a,
            "Query the value of the map at a given octree node index.")
+      .def(
+          "get_cell_values",
+          [](const HashedChunkedWaveletOctree& self,
+             const nb::ndarray<IndexElement, nb::shape<-1, 3>, nb::device::cpu>&
+                 indices) {
+            // Create nb::ndarray view for efficient access to the query indices
+            const auto index_view = indices.view();
+            const auto num_queries = index_view.shape(0);
+            std::vector<Index3D> query_indices(num_queries);
+            for (size_t query_idx = 0; query_idx < num_queries; ++query_idx) {
+              query_indices[query_idx] = {index_view(query_idx, 0),
+                                          index_view(query_idx, 1),
+                                          index_view(query_idx, 2)};
+            }
+            // Create the results vector and wrap it in a Python capsule that
+            // deallocates it when all references to it expire
+            auto* results = new std::vector<FloatingPoint>();
+            nb::capsule owner(results, [](void* p) noexcept {
+              delete reinterpret_cast<std::vector<FloatingPoint>*>(p);
+            });
+            // Compute the values, processing the queries block by block
+            query::getCellValues(self, query_indices, *results);
+            // Return results as numpy array
+            return nb::ndarray<nb::numpy, float>{
+                results->data(), {num_queries, 1u}, owner};
+          },
+          "index_list"_a,
+          "Query the map at the given indices, provided as a matrix with one "
+          "(x, y, z) index per row.")
+      .def(
+          "get_cell_values",
+          [](const HashedChunkedWaveletOctree& self,
+             const nb::ndarray<IndexElement, nb::shape<-1, 4>, nb::device::cpu>&
+                 indices) {
+            // Create nb::ndarray view for efficient access to the query indices
+            auto index_view = indices.view();
+            const auto num_queries = index_view.shape(0);
+            std::vector<OctreeIndex> query_node_indices(num_queries);
+            for (size_t query_idx = 0; query_idx < num_queries; ++query_idx) {
+              query_node_indices[query_idx] = {
+                  index_view(query_idx, 0),
+                  {index_view(query_idx, 1), index_view(query_idx, 2),
+                   index_view(query_idx, 3)}};
+            }
+            // Create the results vector and wrap it in a Python capsule that
+            // deallocates it when all references to it expire
+            auto* results = new std::vector<FloatingPoint>();
+            nb::capsule owner(results, [](void* p) noexcept {
+              delete reinterpret_cast<std::vector<FloatingPoint>*>(p);
+            });
+            // Compute the values, processing the queries block by block
+            query::getCellValues(self, query_node_indices, *results);
+            // Return results as numpy array
+            return nb::ndarray<nb::numpy, float>{
+                results->data(), {num_queries, 1u}, owner};
+          },
+          "node_index_list"_a,
+          "Query the map at the given node indices, provided as a matrix with "
+          "one (height, x, y, z) node index per row.")
       .def(
           "interpolate",
           [](const MapBase& self, const Point3D& position,
@@ -267,6 +327,54 @@ void add_map_bindings(nb::module_& m) {
           },
           "position"_a, "mode"_a = InterpolationMode::kTrilinear,
           "Query the map's value at a point, using the specified interpolation "
-          "mode.");
+          "mode.")
+      .def(
+          "interpolate",
+          [](const HashedChunkedWaveletOctree& self,
+             const nb::ndarray<FloatingPoint, nb::shape<-1, 3>,
+                               nb::device::cpu>& positions,
+             InterpolationMode mode) {
+            // Create a query accelerator
+            QueryAccelerator<HashedChunkedWaveletOctree> query_accelerator{
+                self};
+            // Create nb::ndarray view for efficient access to the query points
+            const auto positions_view = positions.view();
+            const auto num_queries = positions_view.shape(0);
+            // Create the raw results array and wrap it in a Python capsule that
+            // deallocates it when all references to it expire
+            auto* results = new float[num_queries];
+            nb::capsule owner(results, [](void* p) noexcept {
+              delete[] reinterpret_cast<float*>(p);
+            });
+            // Compute the interpolated values
+            switch (mode) {
+              case InterpolationMode::kNearest:
+                for (size_t query_idx = 0; query_idx < num_queries;
+                     ++query_idx) {
+                  results[query_idx] = interpolate::nearestNeighbor(
+                      query_accelerator, {positions_view(query_idx, 0),
+                                          positions_view(query_idx, 1),
+                                          positions_view(query_idx, 2)});
+                }
+                break;
+              case InterpolationMode::kTrilinear:
+                for (size_t query_idx = 0; query_idx < num_queries;
+                     ++query_idx) {
+                  results[query_idx] = interpolate::trilinear(
+                      query_accelerator, {positions_view(query_idx, 0),
+                                          positions_view(query_idx, 1),
+                                          positions_view(query_idx, 2)});
+                }
+                break;
+              default:
+                throw nb::type_error("Unknown interpolation mode.");
+            }
+            // Return results as numpy array
+            return nb::ndarray<nb::numpy, float>{
+                results, {num_queries, 1u}, owner};
+          },
+          "position_list"_a, "mode"_a = InterpolationMode::kTrilinear,
+          "Query the map's value at the given points, using the specified "
+          "interpolation mode.");
 }
 }  // namespace wavemap
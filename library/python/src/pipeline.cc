@@ -1,6 +1,10 @@
 #include "pywavemap/pipeline.h"
 
+#include <chrono>
+#include <future>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
@@ -10,7 +14,60 @@
 using namespace nb::literals;  // NOLINT
 
 namespace wavemap {
+namespace {
+// Handle to the outcome of a measurement submitted to the async pipeline
+struct PipelineAsyncResult {
+  std::shared_future<bool> future;
+
+  bool done() const {
+    return future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+  bool result() const {
+    // Release the GIL while waiting for the worker threads
+    nb::gil_scoped_release release;
+    return future.get();
+  }
+};
+
+template <typename MeasurementT>
+PipelineAsyncResult runPipelineAsync(
+    Pipeline& self, const std::vector<std::string>& integrator_names,
+    const MeasurementT& measurement) {
+  MeasurementT measurement_copy = measurement;
+  // Release the GIL, since the call blocks if the queue is full
+  nb::gil_scoped_release release;
+  return {self.runPipelineAsync(integrator_names, std::move(measurement_copy))
+              .share()};
+}
+}  // namespace
+
 void add_pipeline_bindings(nb::module_& m) {
+  nb::class_<PipelineAsyncResult>(
+      m, "PipelineAsyncResult",
+      "Handle to the outcome of a measurement submitted to the pipeline's "
+      "asynchronous mode.")
+      .def("done", &PipelineAsyncResult::done,
+           "Returns true once the measurement has been processed or dropped.")
+      .def("result", &PipelineAsyncResult::result,
+           "Block until the measurement has been processed, then return "
+           "whether it was integrated successfully. Returns False if it was "
+           "dropped or an integrator does not exist.");
+
+  nb::class_<PipelineAsyncStats>(
+      m, "PipelineAsyncStats",
+      "Statistics describing the pipeline's asynchronous mode. Latencies are "
+      "measured from submission until the measurement was integrated and the "
+      "map operations ran, in seconds.")
+      .def_ro("num_submitted", &PipelineAsyncStats::num_submitted)
+      .def_ro("num_processed", &PipelineAsyncStats::num_processed)
+      .def_ro("num_dropped", &PipelineAsyncStats::num_dropped)
+      .def_ro("queue_depth", &PipelineAsyncStats::queue_depth)
+      .def_ro("max_queue_depth", &PipelineAsyncStats::max_queue_depth)
+      .def_ro("last_latency", &PipelineAsyncStats::last_latency)
+      .def_ro("mean_latency", &PipelineAsyncStats::mean_latency)
+      .def_ro("max_latency", &PipelineAsyncStats::max_latency);
+
   nb::class_<Pipeline>(m, "Pipeline",
                        "A class to build pipelines of measurement integrators "
                        "and map operations.")
@@ -19,8 +76,10 @@ void add_pipeline_bindings(nb::module_& m) {
            "Deregister all the pipeline's measurement integrators and map "
            "operations.")
       .def("has_integrator", &Pipeline::hasIntegrator, "integrator_name"_a,
+           nb::call_guard<nb::gil_scoped_release>(),
            "Returns true if an integrator with the given name has been "
-           "registered.")
+           "registered. Waits for all queued measurements to be processed "
+           "first.")
       .def("remove_integrator", &Pipeline::removeIntegrator,
            "integrator_name"_a,
            "Deregister the integrator with the given name. Returns true if it "
@@ -59,6 +118,45 @@ void add_pipeline_bindings(nb::module_& m) {
            "Integrate a given pointcloud, then run the map operations.")
       .def("run_pipeline", &Pipeline::runPipeline<PosedImage<>>,
            "integrator_names"_a, "posed_image"_a,
-           "Integrate a given depth image, then run the map operations.");
+           "Integrate a given depth image, then run the map operations.")
+      .def(
+          "start_async",
+          [](Pipeline& self, const param::Value& params) -> bool {
+            if (const auto config = PipelineAsyncConfig::from(params);
+                config && config->isValid(true)) {
+              nb::gil_scoped_release release;
+              self.startAsync(config.value());
+              return true;
+            }
+            return false;
+          },
+          nb::sig("def start_async(self, async_params: dict) -> bool"),
+          "async_params"_a,
+          "Start the asynchronous mode, in which measurements are queued and "
+          "integrated on dedicated worker threads, such that the next "
+          "measurement is imported while the map operations run for the "
+          "previous one. The params set the max_queue_size and the "
+          "drop_policy (block, drop_oldest or drop_newest).")
+      .def("stop_async", &Pipeline::stopAsync,
+           nb::call_guard<nb::gil_scoped_release>(),
+           "Finish all queued measurements, then stop the asynchronous mode.")
+      .def("is_async", &Pipeline::isAsync,
+           "Whether the asynchronous mode is running.")
+      .def("wait_for_async", &Pipeline::waitForAsync,
+           nb::call_guard<nb::gil_scoped_release>(),
+           "Block until all queued measurements have been processed.")
+      .def_prop_ro("async_stats", &Pipeline::getAsyncStats,
+                   "Queue depth and latency statistics of the asynchronous "
+                   "mode.")
+      .def("run_pipeline_async", &runPipelineAsync<PosedPointcloud<>>,
+           "integrator_names"_a, "posed_pointcloud"_a,
+           "Queue a pointcloud to be integrated, followed by the map "
+           "operations, on the asynchronous mode's worker threads. Starts the "
+           "asynchronous mode with its default settings if needed.")
+      .def("run_pipeline_async", &runPipelineAsync<PosedImage<>>,
+           "integrator_names"_a, "posed_image"_a,
+           "Queue a depth image to be integrated, followed by the map "
+           "operations, on the asynchronous mode's worker threads. Starts the "
+           "asynchronous mode with its default settings if needed.");
 }
 }  // namespace wavemap
@@ -8,7 +8,8 @@ from ._pywavemap_bindings import (Rotation, Pose, Pointcloud, PosedPointcloud,
 from ._pywavemap_bindings import (Map, HashedWaveletOctree,
                                   HashedChunkedWaveletOctree,
                                   InterpolationMode)
-from ._pywavemap_bindings import Pipeline
+from ._pywavemap_bindings import (Pipeline, PipelineAsyncResult,
+                                  PipelineAsyncStats)
 
 # Binding submodules
 from ._pywavemap_bindings import logging, param, convert
@@ -71,3 +71,88 @@ def test_batched_trilinear_interpolation():
         point_log_odds = test_map.interpolate(point,
                                               InterpolationMode.TRILINEAR)
         assert points_log_odds[point_idx] == point_log_odds
+
+
+def test_run_pipeline_async():
+    import numpy as np
+    import pywavemap as wave
+
+    test_map = wave.Map.create({
+        "type": "hashed_chunked_wavelet_octree",
+        "min_cell_width": {
+            "meters": 0.1
+        }
+    })
+    pipeline = wave.Pipeline(test_map)
+    assert pipeline.add_integrator(
+        "test_integrator", {
+            "projection_model": {
+                "type": "spherical_projector",
+                "elevation": {
+                    "num_cells": 32,
+                    "min_angle": {
+                        "degrees": -30.0
+                    },
+                    "max_angle": {
+                        "degrees": 30.0
+                    }
+                },
+                "azimuth": {
+                    "num_cells": 256,
+                    "min_angle": {
+                        "degrees": -180.0
+                    },
+                    "max_angle": {
+                        "degrees": 180.0
+                    }
+                }
+            },
+            "measurement_model": {
+                "type": "continuous_ray",
+                "range_sigma": {
+                    "meters": 0.05
+                },
+                "scaling_free": 0.2,
+                "scaling_occupied": 0.4
+            },
+            "integration_method": {
+                "type": "hashed_chunked_wavelet_integrator",
+                "min_range": {
+                    "meters": 0.1
+                },
+                "max_range": {
+                    "meters": 10.0
+                }
+            },
+        })
+
+    # Queue measurements without dropping any of them
+    assert pipeline.start_async({"max_queue_size": 2, "drop_policy": "block"})
+    assert pipeline.is_async()
+    num_measurements = 5
+    results = []
+    for _ in range(num_measurements):
+        points = np.random.uniform(-5.0, 5.0, size=(3, 1000))
+        posed_pointcloud = wave.PosedPointcloud(
+            wave.Pose(np.eye(4)), wave.Pointcloud(points.astype(np.float32)))
+        results.append(
+            pipeline.run_pipeline_async(["test_integrator"], posed_pointcloud))
+    assert all(result.result() for result in results)
+    assert all(result.done() for result in results)
+
+    # Check the statistics and that the map was updated
+    pipeline.wait_for_async()
+    stats = pipeline.async_stats
+    assert stats.num_submitted == num_measurements
+    assert stats.num_processed == num_measurements
+    assert stats.num_dropped == 0
+    assert stats.queue_depth == 0
+    assert not test_map.empty
+
+    # Measurements for missing integrators are processed, but fail
+    missing = pipeline.run_pipeline_async(["missing_integrator"],
+                                          posed_pointcloud)
+    assert not missing.result()
+
+    pipeline.stop_async()
+    assert not pipeline.is_async()